@@ -87,6 +87,38 @@ double vtkCompositeAnimationPlayer::GetNextTime(double currentime)
   return VTK_DOUBLE_MAX;
 }
 
+//----------------------------------------------------------------------------
+double vtkCompositeAnimationPlayer::GetTimeAfter(
+  double starttime, double endtime, double currenttime)
+{
+  double time = VTK_DOUBLE_MAX;
+  switch (this->PlayMode)
+    {
+  case SEQUENCE:
+    if (endtime > starttime)
+      {
+      // Same arithmetic as vtkSequenceAnimationPlayer::GetNextTime() so that
+      // the time matches the one that will be played exactly.
+      int numFrames = this->SequenceAnimationPlayer->GetNumberOfFrames();
+      int frameNo = static_cast<int>(
+        (currenttime - starttime) * (numFrames - 1) /
+        (endtime - starttime) + 0.5) + 1;
+      time = starttime + ((endtime - starttime)*frameNo)/(numFrames-1);
+      }
+    break;
+
+  case SNAP_TO_TIMESTEPS:
+    time = this->TimestepsAnimationPlayer->GetNextTimeStep(currenttime);
+    break;
+
+  default:
+    // the next time depends on how long it takes to play this one.
+    break;
+    }
+
+  return (time > currenttime && time <= endtime)? time : VTK_DOUBLE_MAX;
+}
+
 //----------------------------------------------------------------------------
 double vtkCompositeAnimationPlayer::GoToNext(double start, double end, 
   double currenttime)
@@ -61,6 +61,12 @@ public:
   void RemoveAllTimeSteps();
   void SetFramesPerTimestep(int val);
 
+  // Description:
+  // Returns the time played after \c currenttime by the active player, or
+  // VTK_DOUBLE_MAX if it is past \c endtime or can't be known before it is
+  // played, as in real time mode.
+  double GetTimeAfter(double starttime, double endtime, double currenttime);
+
 //BTX
 protected:
   vtkCompositeAnimationPlayer();
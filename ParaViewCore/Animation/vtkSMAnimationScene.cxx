@@ -106,6 +106,15 @@ public:
       }
     }
 
+  void PrefetchAllViews(double time)
+    {
+    VectorOfViews::iterator iter = this->ViewModules.begin();
+    for (; iter != this->ViewModules.end(); ++iter)
+      {
+      iter->GetPointer()->Prefetch(time);
+      }
+    }
+
   void PassUseCache(bool usecache)
     {
     VectorOfViews::iterator iter = this->ViewModules.begin();
@@ -217,7 +226,8 @@ vtkSMAnimationScene::vtkSMAnimationScene()
   this->PlaybackTimeWindow[0] = 1.0;
   this->PlaybackTimeWindow[1] = -1.0;
   this->InTick = false;
-  this->Caching = false;
+  this->Caching = true;
+  this->NumberOfPrefetchedTimeSteps = 1;
   this->LockEndTime = false;
   this->LockStartTime = false;
   this->OverrideStillRender = false;
@@ -493,6 +503,12 @@ void vtkSMAnimationScene::TickInternal(
     {
     this->Internals->StillRenderAllViews();
     }
+
+  // While the frame is shown, let the views compute and cache the next ones.
+  if (this->Caching && this->AnimationPlayer->GetInPlay())
+    {
+    this->PrefetchTimeSteps(currenttime);
+    }
   this->InTick = false;
 
   if (this->Caching)
@@ -501,6 +517,37 @@ void vtkSMAnimationScene::TickInternal(
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkSMAnimationScene::PrefetchTimeSteps(double currenttime)
+{
+  // Views are cached with the scene time as the key. That is only valid while
+  // the views show the scene time, which is not the case when the time keeper
+  // is not following the animation.
+  if (this->NumberOfPrefetchedTimeSteps <= 0 || !this->TimeKeeper ||
+    vtkSMPropertyHelper(this->TimeKeeper, "Time").GetAsDouble() != currenttime)
+    {
+    return;
+    }
+
+  double endtime = this->EndTime;
+  if (this->PlaybackTimeWindow[0] <= this->PlaybackTimeWindow[1])
+    {
+    endtime = std::min(endtime, this->PlaybackTimeWindow[1]);
+    }
+
+  double time = currenttime;
+  for (int cc=0; cc < this->NumberOfPrefetchedTimeSteps; cc++)
+    {
+    time = this->AnimationPlayer->GetTimeAfter(
+      this->StartTime, this->EndTime, time);
+    if (time > endtime)
+      {
+      break;
+      }
+    this->Internals->PrefetchAllViews(time);
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkSMAnimationScene::PrintSelf(ostream& os, vtkIndent indent)
 {
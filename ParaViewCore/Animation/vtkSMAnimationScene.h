@@ -70,10 +70,18 @@ public:
   // Description:
   // Set if caching is enabled.
   // If Caching is true, then on every time-step, this will update the UseCache
-  // and CacheKey properties on each of the views.
+  // and CacheKey properties on each of the views. On by default; the memory
+  // used is bounded by the limit set on vtkCacheSizeKeeper.
   vtkSetMacro(Caching, bool);
   vtkGetMacro(Caching, bool);
 
+  // Description:
+  // Set the number of time steps to cache ahead of the one being shown while
+  // the animation plays. Only used when Caching is true and the time steps to
+  // play next are known in advance, i.e. not in real time mode. Default is 1.
+  vtkSetClampMacro(NumberOfPrefetchedTimeSteps, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfPrefetchedTimeSteps, int);
+
   // Description:
   // Set the time keeper. Time keeper is used to obtain the information about
   // timesteps. This is required to play animation in "Snap To Timesteps" mode.
@@ -158,7 +166,12 @@ protected:
   void TimeKeeperTimeRangeChanged();
   void TimeKeeperTimestepsChanged();
 
+  // Description:
+  // Caches the time steps following \c currenttime in all views.
+  void PrefetchTimeSteps(double currenttime);
+
   bool Caching;
+  int NumberOfPrefetchedTimeSteps;
   bool LockStartTime;
   bool LockEndTime;
   bool InTick;
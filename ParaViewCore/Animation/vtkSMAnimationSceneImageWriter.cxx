@@ -14,12 +14,15 @@
 =========================================================================*/
 #include "vtkSMAnimationSceneImageWriter.h"
 
+#include "vtkConditionVariable.h"
 #include "vtkErrorCode.h"
 #include "vtkGenericMovieWriter.h"
 #include "vtkImageData.h"
 #include "vtkImageIterator.h"
 #include "vtkImageWriter.h"
 #include "vtkJPEGWriter.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
 #include "vtkObjectFactory.h"
 #include "vtkObjectFactory.h"
 #include "vtkPNGWriter.h"
@@ -40,7 +43,9 @@
 #endif
 
 #include <algorithm>
+#include <deque>
 #include <string>
+#include <vector>
 #include <vtksys/SystemTools.hxx>
 
 #ifdef _WIN32
@@ -56,6 +61,95 @@
 #  include "vtkOggTheoraWriter.h"
 #endif
 
+//-----------------------------------------------------------------------------
+class vtkSMAnimationSceneImageWriter::vtkInternals
+{
+public:
+  struct FrameInfo
+    {
+    vtkImageData* Image;
+    std::string FileName;
+    };
+
+  // Information given to each encoder thread.
+  struct EncoderInfo
+    {
+    vtkInternals* Internals;
+    vtkSmartPointer<vtkImageWriter> Writer; // NULL to use the movie writer.
+    int ThreadId;
+    };
+
+  vtkSMAnimationSceneImageWriter* Self;
+  vtkMultiThreader* Threader;
+  std::vector<EncoderInfo*> Encoders;
+
+  // Protects all the members below.
+  vtkMutexLock* Lock;
+  vtkConditionVariable* FrameQueued;
+  vtkConditionVariable* FrameDequeued;
+  std::deque<FrameInfo> Frames;
+  bool Stop;
+  int ErrorCode;
+
+  vtkInternals(vtkSMAnimationSceneImageWriter* self)
+    {
+    this->Self = self;
+    this->Threader = vtkMultiThreader::New();
+    this->Lock = vtkMutexLock::New();
+    this->FrameQueued = vtkConditionVariable::New();
+    this->FrameDequeued = vtkConditionVariable::New();
+    this->Stop = false;
+    this->ErrorCode = 0;
+    }
+
+  ~vtkInternals()
+    {
+    this->Threader->Delete();
+    this->Lock->Delete();
+    this->FrameQueued->Delete();
+    this->FrameDequeued->Delete();
+    }
+
+  static VTK_THREAD_RETURN_TYPE Encode(void* arg)
+    {
+    vtkMultiThreader::ThreadInfo* threadInfo =
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    EncoderInfo* encoder = static_cast<EncoderInfo*>(threadInfo->UserData);
+    vtkInternals* self = encoder->Internals;
+
+    self->Lock->Lock();
+    for (;;)
+      {
+      while (self->Frames.empty() && !self->Stop)
+        {
+        self->FrameQueued->Wait(self->Lock);
+        }
+      if (self->Frames.empty())
+        {
+        // Stopping and all frames are written.
+        break;
+        }
+      FrameInfo frame = self->Frames.front();
+      self->Frames.pop_front();
+      self->FrameDequeued->Broadcast();
+      self->Lock->Unlock();
+
+      int errcode = self->Self->WriteFrame(frame.Image, encoder->Writer,
+        frame.FileName.c_str());
+      frame.Image->Delete();
+
+      self->Lock->Lock();
+      if (errcode && !self->ErrorCode)
+        {
+        self->ErrorCode = errcode;
+        self->FrameDequeued->Broadcast();
+        }
+      }
+    self->Lock->Unlock();
+    return VTK_THREAD_RETURN_VALUE;
+    }
+};
+
 vtkStandardNewMacro(vtkSMAnimationSceneImageWriter);
 vtkCxxSetObjectMacro(vtkSMAnimationSceneImageWriter,
   ImageWriter, vtkImageWriter);
@@ -85,11 +179,18 @@ vtkSMAnimationSceneImageWriter::vtkSMAnimationSceneImageWriter()
 
   this->BackgroundColor[0] = this->BackgroundColor[1] =
     this->BackgroundColor[2] = 0.0;
+
+  this->NumberOfEncoderThreads = 4;
+  this->MaximumNumberOfPendingFrames = 8;
+  this->Internals = new vtkInternals(this);
 }
 
 //-----------------------------------------------------------------------------
 vtkSMAnimationSceneImageWriter::~vtkSMAnimationSceneImageWriter()
 {
+  this->StopEncoderThreads();
+  delete this->Internals;
+
   this->SetMovieWriter(0);
   this->SetImageWriter(0);
 
@@ -121,6 +222,7 @@ bool vtkSMAnimationSceneImageWriter::SaveInitialize(int startCount)
   this->AnimationScene->SetOverrideStillRender(1);
 
   this->FileCount = startCount;
+  this->StartEncoderThreads();
 
 #if !defined(__APPLE__)
   // Iterate over all views and enable offscreen rendering. This avoid toggling
@@ -229,25 +331,74 @@ bool vtkSMAnimationSceneImageWriter::SaveFrame(double vtkNotUsed(time))
     combinedImage.TakeReference(capture);
     }
 
-  int errcode = 0;
+  std::string filename;
   if (this->ImageWriter)
     {
     char number[1024];
     sprintf(number, ".%04d", this->FileCount);
-    std::string filename = this->Prefix;
+    filename = this->Prefix;
     filename = filename + number + this->Suffix;
-    this->ImageWriter->SetInputData(combinedImage);
-    this->ImageWriter->SetFileName(filename.c_str());
-    this->ImageWriter->Write();
-    this->ImageWriter->SetInputData(0);
+    }
 
-    errcode = this->ImageWriter->GetErrorCode();
-    this->FileCount = (!errcode)? this->FileCount + 1 : this->FileCount;
+  int errcode = 0;
+  if (!this->Internals->Encoders.empty() && combinedImage)
+    {
+    // Wait for room in the queue, then hand the frame to the encoders.
+    vtkInternals* internals = this->Internals;
+    internals->Lock->Lock();
+    while (static_cast<int>(internals->Frames.size()) >=
+      this->MaximumNumberOfPendingFrames && !internals->ErrorCode)
+      {
+      internals->FrameDequeued->Wait(internals->Lock);
+      }
+    errcode = internals->ErrorCode;
+    if (!errcode)
+      {
+      vtkInternals::FrameInfo frame;
+      frame.Image = combinedImage;
+      frame.Image->Register(NULL);
+      frame.FileName = filename;
+      internals->Frames.push_back(frame);
+      internals->FrameQueued->Signal();
+      }
+    internals->Lock->Unlock();
+    }
+  else
+    {
+    errcode = this->WriteFrame(combinedImage, this->ImageWriter,
+      filename.c_str());
+    }
+  combinedImage = 0;
 
+  if (errcode)
+    {
+    this->ErrorCode = errcode;
+    return false;
+    }
+  if (this->ImageWriter)
+    {
+    this->FileCount++;
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+int vtkSMAnimationSceneImageWriter::WriteFrame(
+  vtkImageData* image, vtkImageWriter* writer, const char* filename)
+{
+  int errcode = 0;
+  if (writer)
+    {
+    writer->SetInputData(image);
+    writer->SetFileName(filename);
+    writer->Write();
+    writer->SetInputData(0);
+
+    errcode = writer->GetErrorCode();
     }
   else if (this->MovieWriter)
     {
-    this->MovieWriter->SetInputData(combinedImage);
+    this->MovieWriter->SetInputData(image);
     this->MovieWriter->Write();
     this->MovieWriter->SetInputData(0);
 
@@ -274,14 +425,67 @@ bool vtkSMAnimationSceneImageWriter::SaveFrame(double vtkNotUsed(time))
       errcode = alg_error;
       }
     }
-  combinedImage = 0;
+  return errcode;
+}
 
-  if (errcode)
+//-----------------------------------------------------------------------------
+void vtkSMAnimationSceneImageWriter::StartEncoderThreads()
+{
+  vtkInternals* internals = this->Internals;
+  if (!internals->Encoders.empty() || this->NumberOfEncoderThreads <= 0)
     {
-    this->ErrorCode = errcode;
-    return false;
+    return;
     }
-  return true;
+
+  // A movie must get its frames in order, so a single thread encodes them.
+  int numThreads = this->MovieWriter ? 1 :
+    std::min(this->NumberOfEncoderThreads, VTK_MAX_THREADS);
+
+  internals->Stop = false;
+  internals->ErrorCode = 0;
+  for (int cc = 0; cc < numThreads; cc++)
+    {
+    vtkInternals::EncoderInfo* encoder = new vtkInternals::EncoderInfo();
+    encoder->Internals = internals;
+    if (this->ImageWriter)
+      {
+      // Writers are not thread safe, each thread uses its own.
+      encoder->Writer.TakeReference(this->ImageWriter->NewInstance());
+      }
+    encoder->ThreadId = internals->Threader->SpawnThread(
+      &vtkInternals::Encode, encoder);
+    internals->Encoders.push_back(encoder);
+    }
+}
+
+//-----------------------------------------------------------------------------
+int vtkSMAnimationSceneImageWriter::StopEncoderThreads()
+{
+  vtkInternals* internals = this->Internals;
+  if (internals->Encoders.empty())
+    {
+    return 0;
+    }
+
+  internals->Lock->Lock();
+  internals->Stop = true;
+  internals->FrameQueued->Broadcast();
+  internals->Lock->Unlock();
+
+  for (size_t cc = 0; cc < internals->Encoders.size(); cc++)
+    {
+    internals->Threader->TerminateThread(internals->Encoders[cc]->ThreadId);
+    delete internals->Encoders[cc];
+    }
+  internals->Encoders.clear();
+
+  // Frames left behind after an error.
+  while (!internals->Frames.empty())
+    {
+    internals->Frames.front().Image->Delete();
+    internals->Frames.pop_front();
+    }
+  return internals->ErrorCode;
 }
 
 //-----------------------------------------------------------------------------
@@ -289,6 +493,13 @@ bool vtkSMAnimationSceneImageWriter::SaveFinalize()
 {
   this->AnimationScene->SetOverrideStillRender(0);
 
+  // Wait for the pending frames to be written.
+  int errcode = this->StopEncoderThreads();
+  if (errcode)
+    {
+    this->ErrorCode = errcode;
+    }
+
   // TODO: If save failed, we must remove the partially
   // written files.
   if (this->MovieWriter)
@@ -312,7 +523,7 @@ bool vtkSMAnimationSceneImageWriter::SaveFinalize()
       }
     }
 #endif
-  return true;
+  return (errcode == 0);
 }
 
 //-----------------------------------------------------------------------------
@@ -455,6 +666,10 @@ void vtkSMAnimationSceneImageWriter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Subsampling: " << this->Subsampling << endl;
   os << indent << "ErrorCode: " << this->ErrorCode << endl;
   os << indent << "FrameRate: " << this->FrameRate << endl;
+  os << indent << "NumberOfEncoderThreads: "
+    << this->NumberOfEncoderThreads << endl;
+  os << indent << "MaximumNumberOfPendingFrames: "
+    << this->MaximumNumberOfPendingFrames << endl;
   os << indent << "BackgroundColor: " << this->BackgroundColor[0]
     << ", " << this->BackgroundColor[1] << ", " << this->BackgroundColor[2]
     << endl;
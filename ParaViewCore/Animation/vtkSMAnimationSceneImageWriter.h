@@ -20,6 +20,12 @@
 // output's size and alignment is exactly as specified on the GUISize,
 // WindowPosition properties of the view modules. One can optionally specify
 // Magnification to scale the output.
+//
+// Captured frames are handed to a pool of encoder threads so that encoding
+// and writing a frame overlaps with rendering the following ones. Each thread
+// writes images with its own writer, while frames of a movie are encoded by a
+// single thread in order. At most MaximumNumberOfPendingFrames captured frames
+// are kept waiting; capturing a frame blocks until one of them is encoded.
 // .SECTION Notes
 // This class does not support changing the dimensions of the view, one has to 
 // do that before calling Save(). It only provides Magnification which can scale 
@@ -94,6 +100,20 @@ public:
   vtkSetMacro(FrameRate, double);
   vtkGetMacro(FrameRate, double);
 
+  // Description:
+  // Get/Set the number of threads used to encode and write the frames while
+  // the following frames are rendered. Movies are always encoded by a single
+  // thread to keep the frames in order. 0 encodes the frames synchronously.
+  // Default is 4.
+  vtkSetClampMacro(NumberOfEncoderThreads, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfEncoderThreads, int);
+
+  // Description:
+  // Get/Set the maximum number of captured frames waiting to be encoded.
+  // Default is 8.
+  vtkSetClampMacro(MaximumNumberOfPendingFrames, int, 1, VTK_INT_MAX);
+  vtkGetMacro(MaximumNumberOfPendingFrames, int);
+
 
   // Description:
   // Convenience method used to merge a smaller image (\c src) into a 
@@ -133,6 +153,19 @@ protected:
 
   vtkImageData* NewFrame();
 
+  // Description:
+  // Writes the frame using the given image writer and file name, or using
+  // the movie writer if \c writer is NULL. Returns the error code.
+  // May be called from the encoder threads.
+  int WriteFrame(vtkImageData* image, vtkImageWriter* writer,
+                 const char* filename);
+
+  // Description:
+  // Start/stop the encoder threads. StopEncoderThreads() waits for all the
+  // pending frames to be written and returns the first error code.
+  void StartEncoderThreads();
+  int StopEncoderThreads();
+
   vtkSetVector2Macro(ActualSize, int);
   int ActualSize[2];
   int Quality;
@@ -141,6 +174,8 @@ protected:
   int FileCount;
   int ErrorCode;
   int Subsampling;
+  int NumberOfEncoderThreads;
+  int MaximumNumberOfPendingFrames;
 
   char* Prefix;
   char* Suffix;
@@ -156,6 +191,9 @@ protected:
   void SetImageWriter(vtkImageWriter*);
   void SetMovieWriter(vtkGenericMovieWriter*);
 private:
+  class vtkInternals;
+  vtkInternals* Internals;
+
   vtkSMAnimationSceneImageWriter(const vtkSMAnimationSceneImageWriter&); // Not implemented.
   void operator=(const vtkSMAnimationSceneImageWriter&); // Not implemented.
 };
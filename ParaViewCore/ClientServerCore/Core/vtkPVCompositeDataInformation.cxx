@@ -204,30 +204,46 @@ void vtkPVCompositeDataInformation::CopyFromObject(vtkObject* object)
   iter->SkipEmptyNodesOff();
 
   // vtkTimerLog::MarkStartEvent("Copying information from composite data");
-  unsigned int index=0;
-  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem(), index++)
+  // Collect the children first so that their information can be gathered
+  // concurrently.
+  std::vector<vtkDataObject*> children;
+  std::vector<bool> hasName;
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
     {
-    vtkSmartPointer<vtkPVDataInformation> childInfo;
-    vtkDataObject* curDO = iter->GetCurrentDataObject();
-    if (curDO)
-      {
-      childInfo = vtkSmartPointer<vtkPVDataInformation>::New();
-      childInfo->CopyFromObject(curDO);
-      }
-    this->Internal->ChildrenInformation.resize(index+1);
-    this->Internal->ChildrenInformation[index].Info = childInfo;
+    children.push_back(iter->GetCurrentDataObject());
+    vtkPVCompositeDataInformationInternals::vtkNode node;
+    hasName.push_back(false);
     if (iter->HasCurrentMetaData())
       {
       vtkInformation* info = iter->GetCurrentMetaData();
       if (info->Has(vtkCompositeDataSet::NAME()))
         {
-        const char* name = info->Get(vtkCompositeDataSet::NAME());
-        this->Internal->ChildrenInformation[index].Name = name;
-        if (childInfo)
-          {
-          childInfo->SetCompositeDataSetName(name);
-          }
+        node.Name = info->Get(vtkCompositeDataSet::NAME());
+        hasName.back() = true;
+        }
+      }
+    this->Internal->ChildrenInformation.push_back(node);
+    }
+
+  unsigned int numChildren = static_cast<unsigned int>(children.size());
+  std::vector<vtkPVDataInformation*> childInfos(numChildren);
+  if (numChildren > 0)
+    {
+    vtkPVDataInformation::CopyFromBlocks(
+      numChildren, &children[0], &childInfos[0]);
+    }
+  for (unsigned int index=0; index < numChildren; index++)
+    {
+    vtkPVDataInformation* childInfo = childInfos[index];
+    if (childInfo)
+      {
+      vtkPVCompositeDataInformationInternals::vtkNode& node =
+        this->Internal->ChildrenInformation[index];
+      if (hasName[index])
+        {
+        childInfo->SetCompositeDataSetName(node.Name.c_str());
         }
+      node.Info.TakeReference(childInfo);
       }
     }
   // vtkTimerLog::MarkEndEvent("Copying information from composite data");
@@ -248,7 +264,6 @@ void vtkPVCompositeDataInformation::CopyFromAMR(vtkUniformGridAMR* amr)
 
   // we use this to "simulate" a composite tree from AMR
   vtkNew<vtkMultiPieceDataSet> tempMultiPiece;
-  vtkNew<vtkPVDataInformation> tempDSInfo;
 
   for (unsigned int level=0; level < num_levels; level++)
     {
@@ -259,13 +274,23 @@ void vtkPVCompositeDataInformation::CopyFromAMR(vtkUniformGridAMR* amr)
     levelInfo->CopyFromCompositeDataSetInitialize(tempMultiPiece.GetPointer());
 
     // now fill up levelInfo with meta-data about arrays.
+    std::vector<vtkDataObject*> datasets(num_datasets);
+    for (unsigned int idx=0; idx < num_datasets; idx++)
+      {
+      datasets[idx] = amr->GetDataSet(level, idx);
+      }
+    std::vector<vtkPVDataInformation*> dsInfos(num_datasets);
+    if (num_datasets > 0)
+      {
+      vtkPVDataInformation::CopyFromBlocks(
+        num_datasets, &datasets[0], &dsInfos[0]);
+      }
     for (unsigned int idx=0; idx < num_datasets; idx++)
       {
-      vtkUniformGrid* dataset = amr->GetDataSet(level, idx);
-      if (dataset)
+      if (dsInfos[idx])
         {
-        tempDSInfo->CopyFromObject(dataset);
-        levelInfo->AddInformation(tempDSInfo.GetPointer(), 1);
+        levelInfo->AddInformation(dsInfos[idx], 1);
+        dsInfos[idx]->Delete();
         }
       }
     levelInfo->CopyFromCompositeDataSetFinalize(tempMultiPiece.GetPointer());
@@ -36,6 +36,8 @@
 #include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPointSet.h"
 #include "vtkPVArrayInformation.h"
 #include "vtkPVDataInformationHelper.h"
 #include "vtkPVCompositeDataInformation.h"
@@ -43,12 +45,16 @@
 #include "vtkPVInformationKeys.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkSelection.h"
+#include "vtkSmartPointer.h"
+#include "vtkSMPTools.h"
 #include "vtkStructuredGrid.h"
 #include "vtkTable.h"
 #include "vtkUniformGrid.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkMultiProcessStream.h"
+#include "vtkWeakPointer.h"
 
+#include <algorithm>
 #include <vector>
 #include <map>
 #include <string>
@@ -57,6 +63,68 @@ vtkStandardNewMacro(vtkPVDataInformation);
 
 std::map<std::string, std::string> helpers;
 
+namespace
+{
+  bool vtkPVDataInformationUseIncremental = true;
+
+  // Information gathered for leaf datasets of composite datasets, reused as
+  // long as the dataset isn't modified.
+  struct vtkPVDataInformationCacheItem
+    {
+    vtkWeakPointer<vtkDataObject> DataObject;
+    unsigned long MTime;
+    vtkSmartPointer<vtkPVDataInformation> Information;
+    };
+  typedef std::map<vtkDataObject*, vtkPVDataInformationCacheItem>
+    vtkPVDataInformationCacheType;
+  vtkPVDataInformationCacheType vtkPVDataInformationCache;
+  size_t vtkPVDataInformationCachePruneSize = 1024;
+
+  // Collects the objects whose state is updated while gathering the
+  // information for a dataset (arrays cache their ranges, points cache their
+  // bounds). Datasets sharing any of those cannot be processed concurrently.
+  void vtkPVDataInformationGetUpdatedObjects(vtkDataSet* ds,
+    std::vector<vtkObject*>& objects)
+    {
+    vtkPointSet* ps = vtkPointSet::SafeDownCast(ds);
+    if (ps && ps->GetPoints())
+      {
+      objects.push_back(ps->GetPoints());
+      objects.push_back(ps->GetPoints()->GetData());
+      }
+    vtkFieldData* fields[3] =
+      { ds->GetPointData(), ds->GetCellData(), ds->GetFieldData() };
+    for (int cc=0; cc < 3; cc++)
+      {
+      int numArrays = fields[cc]? fields[cc]->GetNumberOfArrays() : 0;
+      for (int idx=0; idx < numArrays; idx++)
+        {
+        if (vtkAbstractArray* array = fields[cc]->GetAbstractArray(idx))
+          {
+          objects.push_back(array);
+          }
+        }
+      }
+    }
+
+  // Gathers information for a range of blocks, used with vtkSMPTools::For().
+  class vtkPVDataInformationCopyFromBlocks
+  {
+  public:
+    std::vector<vtkDataObject*> Blocks;
+    std::vector<unsigned long> MTimes;
+    std::vector<vtkPVDataInformation*> Infos;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      for (vtkIdType cc=begin; cc < end; cc++)
+        {
+        this->Infos[cc]->CopyFromObject(this->Blocks[cc]);
+        }
+      }
+  };
+}
+
 //----------------------------------------------------------------------------
 vtkPVDataInformation::vtkPVDataInformation()
 {
@@ -308,24 +376,144 @@ void vtkPVDataInformation::DeepCopy(vtkPVDataInformation *dataInfo,
   this->SetTimeLabel(dataInfo->GetTimeLabel());
 }
 
+//----------------------------------------------------------------------------
+void vtkPVDataInformation::SetUseIncrementalCompositeInformation(bool val)
+{
+  vtkPVDataInformationUseIncremental = val;
+  if (!val)
+    {
+    vtkPVDataInformationCache.clear();
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVDataInformation::GetUseIncrementalCompositeInformation()
+{
+  return vtkPVDataInformationUseIncremental;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDataInformation::CopyFromBlocks(unsigned int count,
+  vtkDataObject* const* blocks, vtkPVDataInformation** infos)
+{
+  bool incremental = vtkPVDataInformationUseIncremental;
+  vtkPVDataInformationCopyFromBlocks functor;
+  std::vector<vtkObject*> updatedObjects;
+  for (unsigned int cc=0; cc < count; cc++)
+    {
+    vtkDataObject* block = blocks[cc];
+    infos[cc] = block? vtkPVDataInformation::New() : NULL;
+    vtkDataSet* ds = vtkDataSet::SafeDownCast(block);
+    if (!ds)
+      {
+      // Nested composite datasets and other types are processed right away.
+      if (block)
+        {
+        infos[cc]->CopyFromObject(block);
+        }
+      continue;
+      }
+
+    unsigned long mtime = ds->GetMTime();
+    if (incremental)
+      {
+      vtkPVDataInformationCacheType::iterator item =
+        vtkPVDataInformationCache.find(ds);
+      if (item != vtkPVDataInformationCache.end() &&
+        item->second.DataObject.GetPointer() == ds &&
+        item->second.MTime == mtime)
+        {
+        infos[cc]->DeepCopy(item->second.Information, false);
+        infos[cc]->HasTime = item->second.Information->HasTime;
+        infos[cc]->Time = item->second.Information->Time;
+        continue;
+        }
+      }
+
+    vtkPVDataInformationGetUpdatedObjects(ds, updatedObjects);
+    functor.Blocks.push_back(ds);
+    functor.MTimes.push_back(mtime);
+    functor.Infos.push_back(infos[cc]);
+    }
+
+  vtkIdType numBlocks = static_cast<vtkIdType>(functor.Blocks.size());
+  std::sort(updatedObjects.begin(), updatedObjects.end());
+  if (std::adjacent_find(updatedObjects.begin(), updatedObjects.end()) ==
+    updatedObjects.end())
+    {
+    vtkSMPTools::For(0, numBlocks, functor);
+    }
+  else
+    {
+    // Some arrays are shared among datasets, computing their ranges
+    // concurrently is not safe.
+    functor(0, numBlocks);
+    }
+
+  if (incremental && numBlocks > 0)
+    {
+    for (vtkIdType cc=0; cc < numBlocks; cc++)
+      {
+      vtkPVDataInformationCacheItem& item =
+        vtkPVDataInformationCache[functor.Blocks[cc]];
+      item.DataObject = functor.Blocks[cc];
+      item.MTime = functor.MTimes[cc];
+      item.Information = vtkSmartPointer<vtkPVDataInformation>::New();
+      item.Information->DeepCopy(functor.Infos[cc], false);
+      item.Information->HasTime = functor.Infos[cc]->HasTime;
+      item.Information->Time = functor.Infos[cc]->Time;
+      }
+
+    // Forget about the datasets that have been deleted.
+    if (vtkPVDataInformationCache.size() > vtkPVDataInformationCachePruneSize)
+      {
+      vtkPVDataInformationCacheType::iterator iter =
+        vtkPVDataInformationCache.begin();
+      while (iter != vtkPVDataInformationCache.end())
+        {
+        if (iter->second.DataObject.GetPointer() == NULL)
+          {
+          vtkPVDataInformationCache.erase(iter++);
+          }
+        else
+          {
+          ++iter;
+          }
+        }
+      vtkPVDataInformationCachePruneSize = std::max(static_cast<size_t>(1024),
+        2 * vtkPVDataInformationCache.size());
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkPVDataInformation::AddFromMultiPieceDataSet(vtkCompositeDataSet* data)
 {
+  std::vector<vtkDataObject*> pieces;
   vtkCompositeDataIterator* iter = data->NewIterator();
   for(iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
     {
-    vtkDataObject* dobj = iter->GetCurrentDataObject();
-    if (dobj)
+    if (vtkDataObject* dobj = iter->GetCurrentDataObject())
       {
-      vtkPVDataInformation* dinf = vtkPVDataInformation::New();
-      dinf->CopyFromObject(dobj);
-      dinf->SetDataClassName(dobj->GetClassName());
-      dinf->DataSetType = dobj->GetDataObjectType();
-      this->AddInformation(dinf, /*addingParts=*/ 1);
-      dinf->FastDelete();
+      pieces.push_back(dobj);
       }
     }
   iter->Delete();
+
+  unsigned int numPieces = static_cast<unsigned int>(pieces.size());
+  std::vector<vtkPVDataInformation*> infos(numPieces);
+  if (numPieces > 0)
+    {
+    vtkPVDataInformation::CopyFromBlocks(numPieces, &pieces[0], &infos[0]);
+    }
+  for (unsigned int cc=0; cc < numPieces; cc++)
+    {
+    vtkPVDataInformation* dinf = infos[cc];
+    dinf->SetDataClassName(pieces[cc]->GetClassName());
+    dinf->DataSetType = pieces[cc]->GetDataObjectType();
+    this->AddInformation(dinf, /*addingParts=*/ 1);
+    dinf->FastDelete();
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -211,6 +211,13 @@ public:
   vtkGetMacro(SortArrays, bool);
   void SetSortArrays(bool);
 
+  // Description:
+  // When enabled, the information gathered for the leaf datasets of composite
+  // datasets is cached and reused in subsequent gathers for the datasets that
+  // have not been modified since. Enabled by default.
+  static void SetUseIncrementalCompositeInformation(bool);
+  static bool GetUseIncrementalCompositeInformation();
+
 protected:
   vtkPVDataInformation();
   ~vtkPVDataInformation();
@@ -228,6 +235,15 @@ protected:
   void CopyFromSelection(vtkSelection* selection);
   void CopyCommonMetaData(vtkDataObject*, vtkInformation*);
 
+  // Description:
+  // Sets infos[i] to a new instance with the information for blocks[i], or
+  // to NULL if blocks[i] is NULL. The caller is responsible for deleting the
+  // instances. Datasets that don't share any array are processed
+  // concurrently, and cached information is reused for unmodified datasets
+  // when UseIncrementalCompositeInformation is enabled.
+  static void CopyFromBlocks(unsigned int count,
+    vtkDataObject* const* blocks, vtkPVDataInformation** infos);
+
   static vtkPVDataInformationHelper *FindHelper(const char *classname);
 
   // Data information collected from remote processes.
@@ -27,7 +27,59 @@
 
 #include <string.h>
 #include <algorithm>
+#include <string>
 #include <vector>
+#include <vtksys/hash_map.hxx>
+
+namespace
+{
+  // Arrays of a vtkPVDataSetAttributesInformation along with an index from
+  // array names to array indices, used to find matching arrays without
+  // comparing every pair of arrays.
+  struct vtkPVDataSetAttributesInformationIndex
+    {
+    typedef vtksys::hash_map<std::string, std::vector<int> > NameMapType;
+    std::vector<vtkPVArrayInformation*> Arrays;
+    NameMapType Names;
+
+    static std::string GetKey(vtkPVArrayInformation* ai)
+      {
+      return ai->GetName()? ai->GetName() : "";
+      }
+
+    void Add(vtkPVArrayInformation* ai)
+      {
+      this->Names[GetKey(ai)].push_back(static_cast<int>(this->Arrays.size()));
+      this->Arrays.push_back(ai);
+      }
+
+    void Build(vtkCollection* collection)
+      {
+      collection->InitTraversal();
+      while (vtkObject* obj = collection->GetNextItemAsObject())
+        {
+        this->Add(static_cast<vtkPVArrayInformation*>(obj));
+        }
+      }
+
+    // Returns the index of the first array matching ai, or -1.
+    int Find(vtkPVArrayInformation* ai)
+      {
+      NameMapType::iterator iter = this->Names.find(GetKey(ai));
+      if (iter != this->Names.end())
+        {
+        for (size_t cc = 0; cc < iter->second.size(); ++cc)
+          {
+          if (ai->Compare(this->Arrays[iter->second[cc]]))
+            {
+            return iter->second[cc];
+            }
+          }
+        }
+      return -1;
+      }
+    };
+}
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkPVDataSetAttributesInformation);
@@ -348,30 +400,32 @@ vtkPVDataSetAttributesInformation
     newAttributeIndices[idx1] = -1;
     }
 
+  // Arrays are matched by name first, using these indices, instead of
+  // comparing all pairs of arrays.
+  vtkPVDataSetAttributesInformationIndex index1;
+  vtkPVDataSetAttributesInformationIndex index2;
+  index1.Build(this->ArrayInformation);
+  index2.Build(info->ArrayInformation);
+
   // First add ranges from all common arrays
   for (idx1 = 0; idx1 < num1; ++idx1)
     {
-    int found=0;
-    vtkPVArrayInformation* ai1 = this->GetArrayInformation(idx1);
-    for (idx2 = 0; idx2 < num2; ++idx2)
+    vtkPVArrayInformation* ai1 = index1.Arrays[idx1];
+    idx2 = index2.Find(ai1);
+    if (idx2 >= 0)
       {
-      vtkPVArrayInformation* ai2 = info->GetArrayInformation(idx2);
-      if ( ai1->Compare(ai2) )
+      vtkPVArrayInformation* ai2 = index2.Arrays[idx2];
+      // Take union of range.
+      ai1->AddRanges(ai2);
+      // Record default attributes.
+      int attribute1 = this->IsArrayAnAttribute(idx1);
+      int attribute2 = info->IsArrayAnAttribute(idx2);
+      if (attribute1 > -1 && attribute1 == attribute2)
         {
-        // Take union of range.
-        ai1->AddRanges(ai2);
-        found = 1;
-        // Record default attributes.
-        int attribute1 = this->IsArrayAnAttribute(idx1);
-        int attribute2 = info->IsArrayAnAttribute(idx2);
-        if (attribute1 > -1 && attribute1 == attribute2)
-          {
-          newAttributeIndices[attribute1] = idx1;
-          }
-        break;
+        newAttributeIndices[attribute1] = idx1;
         }
       }
-    if (!found)
+    else
       {
       ai1->SetIsPartial(1);
       }
@@ -385,20 +439,11 @@ vtkPVDataSetAttributesInformation
   // Now add arrays that don't exist
   for (idx2 = 0; idx2 < num2; ++idx2)
     {
-    vtkPVArrayInformation* ai2 = info->GetArrayInformation(idx2);
-    int found=0;
-    for (idx1 = 0; idx1 < this->GetNumberOfArrays(); ++idx1)
-      {
-      vtkPVArrayInformation* ai1 = this->GetArrayInformation(idx1);
-      if ( ai1->Compare(ai2) )
-        {
-        found=1;
-        break;
-        }
-      }
-    if (!found)
+    vtkPVArrayInformation* ai2 = index2.Arrays[idx2];
+    if (index1.Find(ai2) < 0)
       {
       ai2->SetIsPartial(1);
+      index1.Add(ai2);
       this->ArrayInformation->AddItem(ai2);
       int attribute = info->IsArrayAnAttribute(idx2);
       if (attribute > -1 && this->AttributeIndices[attribute] == -1)
@@ -22,8 +22,28 @@
 #include "vtkQuadricClustering.h"
 #include "vtkTimerLog.h"
 
+#include <string>
+#include <vector>
 #include <vtksys/ios/sstream>
 
+namespace
+{
+  struct vtkRedistributionPhase
+    {
+    std::string Name;
+    double Time;
+    vtkIdType NumberOfCells;
+    int NumberOfCalls;
+    };
+
+  // Phases in the order they were first reported.
+  std::vector<vtkRedistributionPhase>& vtkGetRedistributionPhases()
+    {
+    static std::vector<vtkRedistributionPhase> phases;
+    return phases;
+    }
+}
+
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkPVTimerInformation);
 
@@ -136,6 +156,36 @@ void vtkPVTimerInformation::Reallocate(int num)
 
 
 
+//----------------------------------------------------------------------------
+void vtkPVTimerInformation::AddRedistributionTime(const char* phase,
+  double seconds, vtkIdType numberOfCells)
+{
+  std::vector<vtkRedistributionPhase>& phases = vtkGetRedistributionPhases();
+  size_t cc = 0;
+  while (cc < phases.size() && phases[cc].Name != phase)
+    {
+    cc++;
+    }
+  if (cc == phases.size())
+    {
+    vtkRedistributionPhase newPhase;
+    newPhase.Name = phase;
+    newPhase.Time = 0.0;
+    newPhase.NumberOfCells = 0;
+    newPhase.NumberOfCalls = 0;
+    phases.push_back(newPhase);
+    }
+  phases[cc].Time += seconds;
+  phases[cc].NumberOfCells += numberOfCells;
+  phases[cc].NumberOfCalls++;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTimerInformation::ResetRedistributionTimes()
+{
+  vtkGetRedistributionPhases().clear();
+}
+
 //----------------------------------------------------------------------------
 // This ignores the object, and gets the log from the timer.
 void vtkPVTimerInformation::CopyFromObject(vtkObject*)
@@ -143,12 +193,27 @@ void vtkPVTimerInformation::CopyFromObject(vtkObject*)
   int length;
   float threshold = this->LogThreshold;
 
+  const std::vector<vtkRedistributionPhase>& phases =
+    vtkGetRedistributionPhases();
   length = vtkTimerLog::GetNumberOfEvents() * 40;
-  if (length > 0)
+  if (length > 0 || !phases.empty())
     {
     vtksys_ios::ostringstream fptr;
     //*fptr << "Hello world !!!\n ()";
-    vtkTimerLog::DumpLogWithIndents(&fptr, threshold);
+    if (length > 0)
+      {
+      vtkTimerLog::DumpLogWithIndents(&fptr, threshold);
+      }
+    if (!phases.empty())
+      {
+      fptr << "Ordered Compositing Redistribution\n";
+      for (size_t cc=0; cc < phases.size(); cc++)
+        {
+        fptr << "    " << phases[cc].Name << ",  " << phases[cc].Time
+             << " seconds, " << phases[cc].NumberOfCalls << " calls, "
+             << phases[cc].NumberOfCells << " cells\n";
+        }
+      }
     fptr << ends;
     this->InsertLog(0, fptr.str().c_str());
     }  
@@ -15,6 +15,8 @@
 // .NAME vtkPVTimerInformation - Holds timer log for all processes.
 // .SECTION Description
 // I am using this information object to gather timer logs from all processes.
+// The log of each process is followed by the breakdown of the time it spent
+// redistributing data for ordered compositing.
 
 #ifndef __vtkPVTimerInformation_h
 #define __vtkPVTimerInformation_h
@@ -63,6 +65,17 @@ public:
   // information itself.
   virtual void CopyParametersToStream(vtkMultiProcessStream&);
   virtual void CopyParametersFromStream(vtkMultiProcessStream&);
+
+  // Description:
+  // Accumulates the time (in seconds) this process spent in a phase of the
+  // redistribution of data for ordered compositing, and the number of cells
+  // the phase handled. The accumulated times are reported after the timer log
+  // until ResetRedistributionTimes() is called, e.g. by
+  // vtkPVTimerLog::ResetLog().
+  static void AddRedistributionTime(const char* phase, double seconds,
+    vtkIdType numberOfCells=0);
+  static void ResetRedistributionTimes();
+
 protected:
   vtkPVTimerInformation();
   ~vtkPVTimerInformation();
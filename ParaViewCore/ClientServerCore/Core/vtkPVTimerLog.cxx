@@ -0,0 +1,42 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVTimerLog.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVTimerLog.h"
+
+#include "vtkObjectFactory.h"
+#include "vtkPVTimerInformation.h"
+
+vtkStandardNewMacro(vtkPVTimerLog);
+//----------------------------------------------------------------------------
+vtkPVTimerLog::vtkPVTimerLog()
+{
+}
+
+//----------------------------------------------------------------------------
+vtkPVTimerLog::~vtkPVTimerLog()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTimerLog::ResetLog()
+{
+  vtkTimerLog::ResetLog();
+  vtkPVTimerInformation::ResetRedistributionTimes();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTimerLog::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+}
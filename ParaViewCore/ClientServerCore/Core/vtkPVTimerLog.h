@@ -0,0 +1,50 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVTimerLog.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVTimerLog - vtkTimerLog that also resets ParaView's timings.
+// .SECTION Description
+// vtkPVTimerLog is the class behind the "TimerLog" proxy used to control the
+// timer log on all processes. Resetting the log also clears the
+// redistribution times accumulated by vtkPVTimerInformation, which are
+// reported along with the log.
+// .SECTION See Also
+// vtkPVTimerInformation
+
+#ifndef __vtkPVTimerLog_h
+#define __vtkPVTimerLog_h
+
+#include "vtkPVClientServerCoreCoreModule.h" //needed for exports
+#include "vtkTimerLog.h"
+
+class VTKPVCLIENTSERVERCORECORE_EXPORT vtkPVTimerLog : public vtkTimerLog
+{
+public:
+  static vtkPVTimerLog* New();
+  vtkTypeMacro(vtkPVTimerLog, vtkTimerLog);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Clears the timer log and the redistribution times.
+  static void ResetLog();
+
+protected:
+  vtkPVTimerLog();
+  ~vtkPVTimerLog();
+
+private:
+  vtkPVTimerLog(const vtkPVTimerLog&); // Not implemented
+  void operator=(const vtkPVTimerLog&); // Not implemented
+};
+
+#endif
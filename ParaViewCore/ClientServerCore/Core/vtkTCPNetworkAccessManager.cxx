@@ -14,6 +14,8 @@
 =========================================================================*/
 #include "vtkTCPNetworkAccessManager.h"
 
+#include "vtkAbstractArray.h"
+#include "vtkByteSwap.h"
 #include "vtkClientSocket.h"
 #include "vtkCommand.h"
 #include "vtkObjectFactory.h"
@@ -29,26 +31,453 @@
 #include <vtksys/SystemInformation.hxx>
 #include <vtksys/SystemTools.hxx>
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <list>
+#include <map>
 #include <string>
 #include <vtksys/ios/sstream>
 #include <vector>
-#include <map>
 
 // set this to 1 if you want to generate a log file with all the raw socket
 // communication.
 #define GENERATE_DEBUG_LOG 0
 
-#define MAX_SOCKETS 256
+// On Linux, epoll is used to wait for network activity, which doesn't limit
+// the number of sockets nor requires passing all of them on every call.
+// Elsewhere, vtkSocket::SelectSockets() is used.
+#if defined(__linux__)
+# define USE_EPOLL 1
+# include <sys/epoll.h>
+# include <unistd.h>
+#else
+# define USE_EPOLL 0
+#endif
+
+#if !defined(_WIN32)
+# include <sys/ioctl.h>
+# include <sys/socket.h>
+#endif
+
+namespace
+{
+  // Returns the number of bytes that can be read from the socket without
+  // blocking, or -1 if unknown.
+  int vtkGetAvailableBytes(int socket)
+    {
+#if defined(_WIN32)
+    (void)socket;
+    return -1;
+#else
+    int available = 0;
+    return ioctl(socket, FIONREAD, &available) == 0? available : -1;
+#endif
+    }
+}
+
+// vtkSocketCommunicator used for the connections created by
+// vtkTCPNetworkAccessManager. It lets the manager read the next RMI ahead,
+// without blocking, as its bytes arrive. The messages read ahead are kept in
+// memory and handed over when ProcessRMIs() receives them, so an RMI is only
+// processed once it has entirely arrived.
+class vtkTCPNetworkAccessManagerCommunicator : public vtkSocketCommunicator
+{
+public:
+  static vtkTCPNetworkAccessManagerCommunicator* New();
+  vtkTypeMacro(vtkTCPNetworkAccessManagerCommunicator, vtkSocketCommunicator);
+
+  // Description:
+  // Reads what has arrived of the next RMI: its trigger message and, when
+  // its arguments are too large to be packed in the trigger, the
+  // RMI_ARG_TAG message that follows. Nothing past that RMI is read. Returns
+  // true when ProcessRMIs() can be called without blocking, or when what
+  // comes next cannot be read ahead (not an RMI, closed connection, bytes to
+  // swap) and ProcessRMIs() has to deal with it. Returns false when more has
+  // to arrive first. The number of bytes read is added to bytes_read.
+  bool ReadAhead(double& bytes_read);
+
+  // Description:
+  // Returns true when an RMI has entirely been read ahead.
+  bool HasReceivedRMI()
+    {
+    return this->Partial.empty() && !this->Messages.empty() &&
+      this->GetExpectedTag() == -1;
+    }
+
+  // Description:
+  // Serves the messages read ahead before reading from the socket. A
+  // message still being read ahead is first read entirely, so that the
+  // socket is at a message boundary. RMI messages read ahead that are not
+  // received now are kept for ProcessRMIs().
+  virtual int ReceiveVoidArray(void* data, vtkIdType maxlength, int type,
+    int remoteHandle, int tag);
+
+protected:
+  vtkTCPNetworkAccessManagerCommunicator() : PartialReceived(0) {}
+  ~vtkTCPNetworkAccessManagerCommunicator() {}
+
+  // Tag of the next message of the RMI being read ahead, or -1 when there
+  // is none to read.
+  int GetExpectedTag();
+
+  // Messages read ahead, tag and length included as sent by
+  // vtkSocketCommunicator.
+  typedef std::vector<char> vtkMessage;
+  std::list<vtkMessage> Messages;
+
+  // Message being read ahead, sized for all of it, and the number of bytes
+  // already read.
+  vtkMessage Partial;
+  size_t PartialReceived;
+
+private:
+  vtkTCPNetworkAccessManagerCommunicator(
+    const vtkTCPNetworkAccessManagerCommunicator&); // Not implemented
+  void operator=(
+    const vtkTCPNetworkAccessManagerCommunicator&); // Not implemented
+};
+
+vtkStandardNewMacro(vtkTCPNetworkAccessManagerCommunicator);
+//----------------------------------------------------------------------------
+int vtkTCPNetworkAccessManagerCommunicator::GetExpectedTag()
+{
+  if (this->Messages.empty())
+    {
+    return vtkMultiProcessController::RMI_TAG;
+    }
+  const vtkMessage& trigger = this->Messages.front();
+  int header[6];
+  if (this->Messages.size() == 1 && trigger.size() == sizeof(header))
+    {
+    // tag and length, followed by the trigger: RMI tag, argument length,
+    // remote process id and propagate flag, in little endian order. The
+    // arguments were not packed in the trigger, they come next.
+    memcpy(header, &trigger[0], sizeof(header));
+    int argLength = header[3];
+    vtkByteSwap::Swap4LE(&argLength);
+    if (header[0] == vtkMultiProcessController::RMI_TAG && argLength > 0)
+      {
+      return vtkMultiProcessController::RMI_ARG_TAG;
+      }
+    }
+  return -1;
+}
+
+//----------------------------------------------------------------------------
+bool vtkTCPNetworkAccessManagerCommunicator::ReadAhead(double& bytes_read)
+{
+#if defined(_WIN32)
+  (void)bytes_read;
+  return true;
+#else
+  if (!this->Socket || !this->Socket->GetConnected() ||
+    this->GetSwapBytesInReceivedData() == vtkSocketCommunicator::SwapOn)
+    {
+    return true;
+    }
+  int socket = this->Socket->GetSocketDescriptor();
+  while (true)
+    {
+    if (this->Partial.empty())
+      {
+      int expected = this->GetExpectedTag();
+      if (expected == -1)
+        {
+        return true;
+        }
+      if (expected == vtkMultiProcessController::RMI_ARG_TAG &&
+        this->HasBufferredMessages())
+        {
+        // the arguments may have been buffered already.
+        return true;
+        }
+      int header[2];
+      ssize_t peeked = recv(socket, reinterpret_cast<char*>(header),
+        sizeof(header), MSG_PEEK | MSG_DONTWAIT);
+      if (peeked < 0 && (errno == EAGAIN || errno == EWOULDBLOCK ||
+          errno == EINTR))
+        {
+        return false;
+        }
+      if (peeked >= 0 && peeked < static_cast<ssize_t>(sizeof(header)))
+        {
+        // closed connection, or the header has not entirely arrived.
+        return peeked == 0;
+        }
+      if (peeked < 0 || header[0] != expected || header[1] < 0)
+        {
+        return true;
+        }
+      this->Partial.resize(sizeof(header) + header[1]);
+      this->PartialReceived = 0;
+      }
+
+    while (this->PartialReceived < this->Partial.size())
+      {
+      ssize_t count = recv(socket, &this->Partial[this->PartialReceived],
+        this->Partial.size() - this->PartialReceived, MSG_DONTWAIT);
+      if (count > 0)
+        {
+        this->PartialReceived += count;
+        bytes_read += count;
+        }
+      else if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK ||
+          errno == EINTR))
+        {
+        return false;
+        }
+      else
+        {
+        // closed connection, ProcessRMIs() reports it.
+        return true;
+        }
+      }
+    this->Messages.push_back(vtkMessage());
+    this->Messages.back().swap(this->Partial);
+    this->PartialReceived = 0;
+    }
+#endif
+}
+
+//----------------------------------------------------------------------------
+int vtkTCPNetworkAccessManagerCommunicator::ReceiveVoidArray(void* data,
+  vtkIdType maxlength, int type, int remoteHandle, int tag)
+{
+  if (!this->Partial.empty())
+    {
+    if (!this->Socket || !this->Socket->Receive(
+        &this->Partial[this->PartialReceived],
+        static_cast<int>(this->Partial.size() - this->PartialReceived)))
+      {
+      vtkErrorMacro("Could not receive message.");
+      this->Partial.clear();
+      this->PartialReceived = 0;
+      return 0;
+      }
+    this->Messages.push_back(vtkMessage());
+    this->Messages.back().swap(this->Partial);
+    this->PartialReceived = 0;
+    }
+
+  for (std::list<vtkMessage>::iterator iter = this->Messages.begin();
+    iter != this->Messages.end(); ++iter)
+    {
+    int header[2];
+    memcpy(header, &(*iter)[0], sizeof(header));
+    if (header[0] != tag)
+      {
+      continue;
+      }
+    int typeSize = vtkAbstractArray::GetDataTypeSize(type);
+    if (typeSize <= 0 || header[1] > maxlength * typeSize)
+      {
+      vtkErrorMacro("Message of " << header[1] << " bytes does not fit in "
+        << maxlength << " words.");
+      this->Messages.erase(iter);
+      return 0;
+      }
+    if (header[1] > 0)
+      {
+      memcpy(data, &(*iter)[sizeof(header)], header[1]);
+      }
+    this->Count = header[1] / typeSize;
+    this->Messages.erase(iter);
+    return 1;
+    }
+
+  return this->Superclass::ReceiveVoidArray(data, maxlength, type,
+    remoteHandle, tag);
+}
 
 class vtkTCPNetworkAccessManager::vtkInternals
 {
 public:
-  typedef std::vector<vtkWeakPointer<vtkSocketController> >
-    VectorOfControllers;
-  VectorOfControllers Controllers;
+  // A connection and the statistics gathered while processing its events.
+  struct vtkConnection
+    {
+    vtkWeakPointer<vtkSocketController> Controller;
+    double CreationTime;
+    // Time the socket was first reported readable since its messages were
+    // last processed, or -1.
+    double ReadyTime;
+    double BytesReceived;
+    int NumberOfEvents;
+    double TotalLatency;
+    double MaximumLatency;
+    };
+  typedef std::vector<vtkConnection> VectorOfConnections;
+  VectorOfConnections Controllers;
   typedef std::map<int, vtkSmartPointer<vtkServerSocket> >
     MapToServerSockets;
   MapToServerSockets ServerSockets;
+
+  // Index of the connection to service first the next time, so that all the
+  // connections get their turn.
+  size_t NextConnection;
+
+#if USE_EPOLL
+  int EpollDescriptor;
+  // Descriptors in the epoll interest list and the socket they were added
+  // for, to notice descriptors reused by new sockets.
+  std::map<int, vtkObject*> RegisteredSockets;
+#endif
+
+  vtkInternals() : NextConnection(0)
+    {
+#if USE_EPOLL
+    this->EpollDescriptor = epoll_create(16);
+#endif
+    }
+
+  ~vtkInternals()
+    {
+#if USE_EPOLL
+    if (this->EpollDescriptor >= 0)
+      {
+      close(this->EpollDescriptor);
+      }
+#endif
+    }
+
+  void AddConnection(vtkSocketController* controller)
+    {
+    vtkConnection connection;
+    connection.Controller = controller;
+    connection.CreationTime = vtkTimerLog::GetUniversalTime();
+    connection.ReadyTime = -1;
+    connection.BytesReceived = 0;
+    connection.NumberOfEvents = 0;
+    connection.TotalLatency = 0;
+    connection.MaximumLatency = 0;
+    this->Controllers.push_back(connection);
+    }
+
+  // Creates a controller whose communicator lets RMIs be read ahead.
+  static vtkSocketController* NewController()
+    {
+    vtkSocketController* controller = vtkSocketController::New();
+    vtkTCPNetworkAccessManagerCommunicator* comm =
+      vtkTCPNetworkAccessManagerCommunicator::New();
+    controller->SetCommunicator(comm);
+    comm->Delete();
+    return controller;
+    }
+
+  vtkConnection* GetConnection(vtkMultiProcessController* controller)
+    {
+    for (size_t cc=0; cc < this->Controllers.size(); cc++)
+      {
+      if (controller != NULL &&
+        this->Controllers[cc].Controller.GetPointer() == controller)
+        {
+        return &this->Controllers[cc];
+        }
+      }
+    return NULL;
+    }
+
+  // Forgets connections whose controller was deleted.
+  void RemoveDeletedConnections()
+    {
+    VectorOfConnections connections;
+    for (size_t cc=0; cc < this->Controllers.size(); cc++)
+      {
+      if (this->Controllers[cc].Controller.GetPointer())
+        {
+        connections.push_back(this->Controllers[cc]);
+        }
+      }
+    if (connections.size() != this->Controllers.size())
+      {
+      this->Controllers.swap(connections);
+      this->NextConnection = 0;
+      }
+    }
+
+  // Waits for activity on sockets. Fills ready with the indices, in
+  // increasing order, of the sockets that are ready. Returns 1 on activity, 0
+  // on timeout and -1 on error.
+  int WaitForSockets(const std::vector<int>& sockets,
+    const std::vector<vtkObject*>& objects, unsigned long timeout_msecs,
+    std::vector<int>& ready)
+    {
+#if USE_EPOLL
+    if (this->EpollDescriptor >= 0)
+      {
+      // Keep the interest list in sync with the sockets. In the steady state,
+      // this doesn't require any system call.
+      std::map<int, int> indices;
+      for (size_t cc=0; cc < sockets.size(); cc++)
+        {
+        indices[sockets[cc]] = static_cast<int>(cc);
+        std::map<int, vtkObject*>::iterator iter =
+          this->RegisteredSockets.find(sockets[cc]);
+        if (iter == this->RegisteredSockets.end() ||
+          iter->second != objects[cc])
+          {
+          epoll_event event;
+          event.events = EPOLLIN;
+          event.data.fd = sockets[cc];
+          if (epoll_ctl(this->EpollDescriptor, EPOLL_CTL_ADD, sockets[cc],
+              &event) != 0 && errno == EEXIST)
+            {
+            epoll_ctl(this->EpollDescriptor, EPOLL_CTL_MOD, sockets[cc],
+              &event);
+            }
+          this->RegisteredSockets[sockets[cc]] = objects[cc];
+          }
+        }
+      std::map<int, vtkObject*>::iterator iter =
+        this->RegisteredSockets.begin();
+      while (iter != this->RegisteredSockets.end())
+        {
+        if (indices.find(iter->first) == indices.end())
+          {
+          // closed sockets are removed by the kernel, this may fail.
+          epoll_event event;
+          epoll_ctl(this->EpollDescriptor, EPOLL_CTL_DEL, iter->first,
+            &event);
+          this->RegisteredSockets.erase(iter++);
+          }
+        else
+          {
+          ++iter;
+          }
+        }
+
+      std::vector<epoll_event> events(sockets.size());
+      int count = epoll_wait(this->EpollDescriptor, &events[0],
+        static_cast<int>(events.size()),
+        timeout_msecs > 0? static_cast<int>(timeout_msecs) : -1);
+      if (count < 0)
+        {
+        return errno == EINTR? 0 : -1;
+        }
+      for (int cc=0; cc < count; cc++)
+        {
+        std::map<int, int>::iterator index = indices.find(events[cc].data.fd);
+        if (index != indices.end())
+          {
+          ready.push_back(index->second);
+          }
+        }
+      std::sort(ready.begin(), ready.end());
+      return ready.empty()? 0 : 1;
+      }
+#else
+    (void)objects;
+#endif
+    // SelectSockets() reports the first socket that is ready.
+    int selected_index = -1;
+    int result = vtkSocket::SelectSockets(&sockets[0],
+      static_cast<int>(sockets.size()), timeout_msecs, &selected_index);
+    if (result > 0)
+      {
+      ready.push_back(selected_index);
+      }
+    return result;
+    }
 };
 
 vtkStandardNewMacro(vtkTCPNetworkAccessManager);
@@ -169,31 +598,38 @@ int vtkTCPNetworkAccessManager::ProcessEvents(unsigned long timeout_msecs)
 int vtkTCPNetworkAccessManager::ProcessEventsInternal(
   unsigned long timeout_msecs, bool do_processing)
 {
-  int sockets_to_select[MAX_SOCKETS];
-  vtkObject* controller_or_server_socket[MAX_SOCKETS];
+  vtkInternals* internals = this->Internals;
+  internals->RemoveDeletedConnections();
+
+  // Connections are listed starting with the one to service next, so that
+  // they are serviced in turn, followed by the server sockets.
+  std::vector<int> sockets_to_select;
+  std::vector<vtkObject*> controller_or_server_socket;
+  std::vector<size_t> connection_index;
 
-  vtkSocketController* ctrlWithBufferToEmpty = NULL;
-  int size=0;
-  vtkInternals::VectorOfControllers::iterator iter1;
-  for (iter1 = this->Internals->Controllers.begin();
-    iter1 != this->Internals->Controllers.end(); ++iter1)
+  // A connection with buffered messages, or with an RMI read ahead, is
+  // serviced right away.
+  int selected_index = -1;
+  size_t numConnections = internals->Controllers.size();
+  for (size_t cc=0; cc < numConnections; cc++)
     {
-    vtkSocketController* controller = iter1->GetPointer();
-    if (!controller)
-      {
-      // skip null controllers.
-      continue;
-      }
+    size_t index = (internals->NextConnection + cc) % numConnections;
+    vtkSocketController* controller =
+      internals->Controllers[index].Controller.GetPointer();
     vtkSocketCommunicator* comm = vtkSocketCommunicator::SafeDownCast(
       controller->GetCommunicator());
     vtkSocket* socket = comm->GetSocket();
     if (socket && socket->GetConnected())
       {
-      sockets_to_select[size] = socket->GetSocketDescriptor();
-      controller_or_server_socket[size] = controller;
-      if(comm->HasBufferredMessages())
+      sockets_to_select.push_back(socket->GetSocketDescriptor());
+      controller_or_server_socket.push_back(controller);
+      connection_index.push_back(index);
+      vtkTCPNetworkAccessManagerCommunicator* tcpComm =
+        vtkTCPNetworkAccessManagerCommunicator::SafeDownCast(comm);
+      if (selected_index == -1 && (comm->HasBufferredMessages() ||
+          (tcpComm && tcpComm->HasReceivedRMI())))
         {
-        ctrlWithBufferToEmpty = controller;
+        selected_index = static_cast<int>(sockets_to_select.size()) - 1;
         if (!do_processing)
           {
           // we do have events to process, but we were told not to process them,
@@ -201,52 +637,89 @@ int vtkTCPNetworkAccessManager::ProcessEventsInternal(
           return 1;
           }
         }
-      size++;
       }
     }
 
   // Only one client connected, so if it fails, just quit...
-  bool can_quit_if_error = (size == 1);
+  bool can_quit_if_error = (sockets_to_select.size() == 1);
 
   // Now add server sockets.
   vtkInternals::MapToServerSockets::iterator iter2;
-  for (iter2 = this->Internals->ServerSockets.begin();
-    iter2 != this->Internals->ServerSockets.end(); ++iter2)
+  for (iter2 = internals->ServerSockets.begin();
+    iter2 != internals->ServerSockets.end(); ++iter2)
     {
     if (iter2->second.GetPointer() &&
       iter2->second.GetPointer()->GetConnected())
       {
-      sockets_to_select[size] =
-        iter2->second.GetPointer()->GetSocketDescriptor();
-      controller_or_server_socket[size] = iter2->second.GetPointer();
-      size++;
+      sockets_to_select.push_back(
+        iter2->second.GetPointer()->GetSocketDescriptor());
+      controller_or_server_socket.push_back(iter2->second.GetPointer());
       }
     }
 
-  if (size == 0 || this->AbortPendingConnectionFlag)
+  if (sockets_to_select.empty() || this->AbortPendingConnectionFlag)
     {
     return -1;
     }
 
-  // Try to empty RMI buffered messages if any
-  if(ctrlWithBufferToEmpty && (ctrlWithBufferToEmpty->ProcessRMIs(0,1) ==
-                               vtkMultiProcessController::RMI_NO_ERROR))
+  if (selected_index == -1)
     {
-    return 1;
-    }
+    std::vector<int> ready;
+    int result = internals->WaitForSockets(sockets_to_select,
+      controller_or_server_socket, timeout_msecs, ready);
+    if (result <= 0)
+      {
+      return result;
+      }
+    if (!do_processing)
+      {
+      // we were told not to do any processing, so just let the caller know
+      // that we have events to process.
+      return 1;
+      }
 
-  int selected_index = -1;
-  int result = vtkSocket::SelectSockets(sockets_to_select, size,
-                                        timeout_msecs, &selected_index);
-  if (result <= 0)
-    {
-    return result;
-    }
-  if (result > 0 && !do_processing)
-    {
-    // we were told not to do any processing, so just let the caller know that
-    // we have events to process.
-    return 1;
+    // Read ahead what has arrived on every ready connection, then service
+    // the first one, in turn, whose next RMI can be processed without
+    // blocking. The others keep what was read until the rest arrives.
+    double now = vtkTimerLog::GetUniversalTime();
+    int server_index = -1;
+    for (size_t cc=0; cc < ready.size(); cc++)
+      {
+      int index = ready[cc];
+      if (index >= static_cast<int>(connection_index.size()))
+        {
+        if (server_index == -1)
+          {
+          server_index = index;
+          }
+        continue;
+        }
+      vtkInternals::vtkConnection& connection =
+        internals->Controllers[connection_index[index]];
+      if (connection.ReadyTime < 0)
+        {
+        connection.ReadyTime = now;
+        }
+      vtkTCPNetworkAccessManagerCommunicator* comm =
+        vtkTCPNetworkAccessManagerCommunicator::SafeDownCast(
+          connection.Controller->GetCommunicator());
+      double bytes_read = 0;
+      bool received = comm? comm->ReadAhead(bytes_read) : true;
+      connection.BytesReceived += bytes_read;
+      if (received && selected_index == -1)
+        {
+        selected_index = index;
+        }
+      }
+    if (selected_index == -1)
+      {
+      if (server_index == -1)
+        {
+        // only parts of RMIs have arrived.
+        return 1;
+        }
+      selected_index = server_index;
+      }
     }
 
   if (controller_or_server_socket[selected_index]->IsA("vtkServerSocket"))
@@ -259,13 +732,43 @@ int vtkTCPNetworkAccessManager::ProcessEventsInternal(
     }
   else
     {
+    vtkInternals::vtkConnection& connection =
+      internals->Controllers[connection_index[selected_index]];
+    internals->NextConnection = connection_index[selected_index] + 1;
+    double latency = connection.ReadyTime < 0? 0 :
+      vtkTimerLog::GetUniversalTime() - connection.ReadyTime;
+    connection.ReadyTime = -1;
+    connection.NumberOfEvents++;
+    connection.TotalLatency += latency;
+    connection.MaximumLatency = std::max(connection.MaximumLatency, latency);
+
+    // What ProcessRMIs() reads from the socket itself, rather than from what
+    // was read ahead.
+    int socket = sockets_to_select[selected_index];
+    int available = vtkGetAvailableBytes(socket);
+
     // We use smart pointer here to make sure the controller will live
     // during the whole ProcessRMIs call. As that call can release
     // the controller while executing.
     vtkSmartPointer<vtkMultiProcessController> controller =
       vtkMultiProcessController::SafeDownCast(
         controller_or_server_socket[selected_index]);
-    result = controller->ProcessRMIs(0, 1);
+    int result = controller->ProcessRMIs(0, 1);
+
+    // ProcessRMIs() may have added connections, look this one up again.
+    vtkInternals::vtkConnection* processed =
+      internals->GetConnection(controller);
+    vtkSocketCommunicator* comm = vtkSocketCommunicator::SafeDownCast(
+        controller->GetCommunicator());
+    if (processed && comm->GetSocket() && comm->GetSocket()->GetConnected())
+      {
+      int remaining = vtkGetAvailableBytes(socket);
+      if (available >= 0 && remaining >= 0 && available > remaining)
+        {
+        processed->BytesReceived += available - remaining;
+        }
+      }
+
     if (result == vtkMultiProcessController::RMI_NO_ERROR)
       {
       // all's well.
@@ -273,8 +776,6 @@ int vtkTCPNetworkAccessManager::ProcessEventsInternal(
       }
 
     // Close cleanly the socket in error
-    vtkSocketCommunicator* comm = vtkSocketCommunicator::SafeDownCast(
-        controller->GetCommunicator());
     comm->CloseConnection();
 
     // Fire an event letting the world know that the connection was closed.
@@ -285,6 +786,36 @@ int vtkTCPNetworkAccessManager::ProcessEventsInternal(
     }
 }
 
+//----------------------------------------------------------------------------
+double vtkTCPNetworkAccessManager::GetReceivedBytesPerSecond(
+  vtkMultiProcessController* connection)
+{
+  vtkInternals::vtkConnection* info = this->Internals->GetConnection(connection);
+  if (!info)
+    {
+    return 0;
+    }
+  double elapsed = vtkTimerLog::GetUniversalTime() - info->CreationTime;
+  return elapsed > 0? info->BytesReceived / elapsed : 0;
+}
+
+//----------------------------------------------------------------------------
+double vtkTCPNetworkAccessManager::GetAverageLatency(
+  vtkMultiProcessController* connection)
+{
+  vtkInternals::vtkConnection* info = this->Internals->GetConnection(connection);
+  return (info && info->NumberOfEvents > 0)?
+    info->TotalLatency / info->NumberOfEvents : 0;
+}
+
+//----------------------------------------------------------------------------
+double vtkTCPNetworkAccessManager::GetMaximumLatency(
+  vtkMultiProcessController* connection)
+{
+  vtkInternals::vtkConnection* info = this->Internals->GetConnection(connection);
+  return info? info->MaximumLatency : 0;
+}
+
 //----------------------------------------------------------------------------
 vtkMultiProcessController* vtkTCPNetworkAccessManager::ConnectToRemote(
   const char* hostname, int port, const char* handshake, int timeout_in_seconds)
@@ -314,7 +845,7 @@ vtkMultiProcessController* vtkTCPNetworkAccessManager::ConnectToRemote(
     vtksys::SystemTools::Delay(1000);
     }
 
-  vtkSocketController* controller = vtkSocketController::New();
+  vtkSocketController* controller = vtkInternals::NewController();
   vtkSocketCommunicator* comm = vtkSocketCommunicator::SafeDownCast(
     controller->GetCommunicator());
 #if GENERATE_DEBUG_LOG
@@ -340,7 +871,7 @@ vtkMultiProcessController* vtkTCPNetworkAccessManager::ConnectToRemote(
       "**********************************************************************\n");
     return NULL;
     }
-  this->Internals->Controllers.push_back(controller);
+  this->Internals->AddConnection(controller);
   return controller;
 }
 
@@ -400,7 +931,7 @@ vtkMultiProcessController* vtkTCPNetworkAccessManager::WaitForConnection(
       return NULL;
       }
 
-    controller = vtkSocketController::New();
+    controller = vtkInternals::NewController();
     vtkSocketCommunicator* comm = vtkSocketCommunicator::SafeDownCast(
       controller->GetCommunicator());
     comm->SetSocket(client_socket);
@@ -427,7 +958,7 @@ vtkMultiProcessController* vtkTCPNetworkAccessManager::WaitForConnection(
 
   if (controller)
     {
-    this->Internals->Controllers.push_back(controller);
+    this->Internals->AddConnection(controller);
     }
 
   if (once)
@@ -483,4 +1014,16 @@ bool vtkTCPNetworkAccessManager::ParaViewHandshake(
 void vtkTCPNetworkAccessManager::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "Connections: " << this->Internals->Controllers.size()
+     << endl;
+  for (size_t cc=0; cc < this->Internals->Controllers.size(); cc++)
+    {
+    vtkMultiProcessController* controller =
+      this->Internals->Controllers[cc].Controller.GetPointer();
+    os << indent.GetNextIndent() << controller
+       << ": bytes/sec: " << this->GetReceivedBytesPerSecond(controller)
+       << ", average latency: " << this->GetAverageLatency(controller)
+       << ", maximum latency: " << this->GetMaximumLatency(controller)
+       << endl;
+    }
 }
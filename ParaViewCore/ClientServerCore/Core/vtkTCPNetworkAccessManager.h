@@ -17,6 +17,15 @@
 // vtkTCPNetworkAccessManager is a concrete implementation of
 // vtkNetworkAccessManager that uses tcp/ip sockets for communication between
 // processes. It supports urls that use "tcp" as their protocol specifier.
+//
+// ProcessEvents() waits for network activity with epoll on Linux (and
+// vtkSocket::SelectSockets() elsewhere), without any limit on the number of
+// sockets. Each connection reads its next RMI (arguments included) ahead,
+// without blocking, into a buffer of its own as its bytes arrive, and the
+// RMI is processed only once it has entirely been received. Connections
+// with a complete RMI are serviced in turn, so a large RMI trickling in on
+// one connection doesn't keep the others waiting. Messages other than RMIs
+// are read by ProcessRMIs().
 
 #ifndef __vtkTCPNetworkAccessManager_h
 #define __vtkTCPNetworkAccessManager_h
@@ -89,6 +98,16 @@ public:
   // Returns true is the manager is currently waiting for any connections.
   virtual bool GetPendingConnectionsPresent();
 
+  // Description:
+  // Statistics gathered by ProcessEvents() for a connection created by this
+  // manager: the number of bytes per second read from its socket since the
+  // connection was established, and the average and maximum latency (in
+  // seconds) between the socket being reported readable and the RMI that
+  // was arriving being processed. All return 0 for unknown connections.
+  double GetReceivedBytesPerSecond(vtkMultiProcessController* connection);
+  double GetAverageLatency(vtkMultiProcessController* connection);
+  double GetMaximumLatency(vtkMultiProcessController* connection);
+
 //BTX
 protected:
   vtkTCPNetworkAccessManager();
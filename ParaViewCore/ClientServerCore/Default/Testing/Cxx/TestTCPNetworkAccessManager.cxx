@@ -0,0 +1,206 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestTCPNetworkAccessManager.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests that vtkTCPNetworkAccessManager processes an RMI only once it has
+// entirely arrived, without an RMI trickling in on one connection keeping
+// another connection waiting, and the statistics it gathers on the way.
+
+#include "vtkByteSwap.h"
+#include "vtkMultiThreader.h"
+#include "vtkNew.h"
+#include "vtkSocket.h"
+#include "vtkSocketCommunicator.h"
+#include "vtkSocketController.h"
+#include "vtkTCPNetworkAccessManager.h"
+
+#include <vtksys/SystemTools.hxx>
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+  const int TAG_A = 2001;
+  const int TAG_B = 2002;
+
+  struct ClientConnections
+    {
+    vtkTCPNetworkAccessManager* Manager;
+    vtkMultiProcessController* A;
+    vtkMultiProcessController* B;
+    };
+
+  VTK_THREAD_RETURN_TYPE Connect(void* arg)
+    {
+    ClientConnections* client = static_cast<ClientConnections*>(
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg)->UserData);
+    const char* url = "tcp://localhost:11141?timeout=10";
+    client->A = client->Manager->NewConnection(url);
+    client->B = client->Manager->NewConnection(url);
+    return VTK_THREAD_RETURN_VALUE;
+    }
+
+  struct ReceivedRMI
+    {
+    int Count;
+    std::vector<char> Arguments;
+    ReceivedRMI() : Count(0) {}
+    };
+
+  void RMICallback(void* localArg, void* remoteArg, int remoteArgLength,
+    int vtkNotUsed(remoteProcessId))
+    {
+    ReceivedRMI* rmi = static_cast<ReceivedRMI*>(localArg);
+    rmi->Count++;
+    rmi->Arguments.assign(static_cast<char*>(remoteArg),
+      static_cast<char*>(remoteArg) + remoteArgLength);
+    }
+
+  // Appends a message the way vtkSocketCommunicator sends it: tag and
+  // length, followed by the data.
+  void AppendMessage(std::vector<char>& stream, int tag, const void* data,
+    int length)
+    {
+    size_t offset = stream.size();
+    stream.resize(offset + 2*sizeof(int) + length);
+    memcpy(&stream[offset], &tag, sizeof(int));
+    memcpy(&stream[offset + sizeof(int)], &length, sizeof(int));
+    memcpy(&stream[offset + 2*sizeof(int)], data, length);
+    }
+
+  // Processes events until rmi has been received or the number of calls runs
+  // out.
+  bool ProcessUntilReceived(vtkTCPNetworkAccessManager* manager,
+    const ReceivedRMI& rmi, int calls)
+    {
+    for (int cc=0; cc < calls && rmi.Count == 0; cc++)
+      {
+      if (manager->ProcessEvents(100) == -1)
+        {
+        return false;
+        }
+      }
+    return rmi.Count > 0;
+    }
+}
+
+#define CHECK(expr) \
+  if (!(expr)) \
+    { \
+    cerr << "ERROR: Failed at line " << __LINE__ << ": " #expr << endl; \
+    status = EXIT_FAILURE; \
+    }
+
+int TestTCPNetworkAccessManager(int, char* [])
+{
+  int status = EXIT_SUCCESS;
+
+  vtkNew<vtkTCPNetworkAccessManager> server;
+  vtkNew<vtkTCPNetworkAccessManager> client;
+
+  // Opens the server socket.
+  const char* url =
+    "tcp://localhost:11141?listen=true&multiple=true&nonblocking=true";
+  vtkMultiProcessController* serverA = server->NewConnection(url);
+
+  ClientConnections connections = { client.GetPointer(), NULL, NULL };
+  vtkNew<vtkMultiThreader> threader;
+  int thread = threader->SpawnThread(&Connect, &connections);
+  vtkMultiProcessController* serverB = NULL;
+  for (int cc=0; cc < 200 && serverB == NULL; cc++)
+    {
+    vtkMultiProcessController* controller = server->NewConnection(url);
+    if (serverA == NULL)
+      {
+      serverA = controller;
+      }
+    else
+      {
+      serverB = controller;
+      }
+    }
+  threader->TerminateThread(thread);
+  if (!serverA || !serverB || !connections.A || !connections.B)
+    {
+    cerr << "ERROR: Failed to connect." << endl;
+    return EXIT_FAILURE;
+    }
+
+  ReceivedRMI rmiA, rmiB;
+  serverA->AddRMICallback(&RMICallback, &rmiA, TAG_A);
+  serverB->AddRMICallback(&RMICallback, &rmiB, TAG_B);
+
+  // An RMI whose arguments are too large to be packed in the trigger, as
+  // vtkMultiProcessController::TriggerRMI() sends it.
+  std::vector<char> arguments(32768);
+  for (size_t cc=0; cc < arguments.size(); cc++)
+    {
+    arguments[cc] = static_cast<char>(cc % 251);
+    }
+  int trigger[4] = { TAG_A, static_cast<int>(arguments.size()), 0, 0 };
+  vtkByteSwap::SwapLERange(trigger, 4);
+  std::vector<char> stream;
+  AppendMessage(stream, vtkMultiProcessController::RMI_TAG, trigger,
+    sizeof(trigger));
+  AppendMessage(stream, vtkMultiProcessController::RMI_ARG_TAG,
+    &arguments[0], static_cast<int>(arguments.size()));
+
+  // Only part of the RMI on A arrives: it must not be processed, nor block.
+  vtkSocket* socketA = vtkSocketCommunicator::SafeDownCast(
+    connections.A->GetCommunicator())->GetSocket();
+  size_t split = stream.size() / 2;
+  socketA->Send(&stream[0], static_cast<int>(split));
+  for (int cc=0; cc < 5; cc++)
+    {
+    server->ProcessEvents(100);
+    }
+  CHECK(rmiA.Count == 0);
+
+  // An RMI on B is processed meanwhile.
+  char argumentsB[] = "B";
+  connections.B->TriggerRMI(1, argumentsB, sizeof(argumentsB), TAG_B);
+  CHECK(ProcessUntilReceived(server.GetPointer(), rmiB, 50));
+  CHECK(rmiA.Count == 0);
+  CHECK(rmiB.Arguments.size() == sizeof(argumentsB) &&
+    strcmp(&rmiB.Arguments[0], argumentsB) == 0);
+
+  // The rest of A arrives later on.
+  vtksys::SystemTools::Delay(200);
+  socketA->Send(&stream[split], static_cast<int>(stream.size() - split));
+  CHECK(ProcessUntilReceived(server.GetPointer(), rmiA, 50));
+  CHECK(rmiA.Count == 1 && rmiA.Arguments == arguments);
+
+  // All the bytes of A were read, over more than 200 ms since it started
+  // arriving, while B was processed as soon as it arrived.
+  cout << "A: " << server->GetReceivedBytesPerSecond(serverA)
+       << " bytes/sec, average latency: " << server->GetAverageLatency(serverA)
+       << " s, maximum latency: " << server->GetMaximumLatency(serverA)
+       << " s" << endl;
+  cout << "B: " << server->GetReceivedBytesPerSecond(serverB)
+       << " bytes/sec, average latency: " << server->GetAverageLatency(serverB)
+       << " s, maximum latency: " << server->GetMaximumLatency(serverB)
+       << " s" << endl;
+  CHECK(server->GetReceivedBytesPerSecond(serverA) > 0);
+  CHECK(server->GetReceivedBytesPerSecond(serverB) > 0);
+  CHECK(server->GetMaximumLatency(serverA) >= 0.15);
+  CHECK(server->GetAverageLatency(serverB) < server->GetMaximumLatency(serverA));
+  CHECK(server->GetReceivedBytesPerSecond(connections.A) == 0);
+  CHECK(server->GetMaximumLatency(NULL) == 0);
+
+  connections.A->Delete();
+  connections.B->Delete();
+  serverA->Delete();
+  serverB->Delete();
+  return status;
+}
@@ -17,6 +17,10 @@
 // .SECTION Description:
 // vtkCacheSizeKeeper keeps track of the amount of memory cached
 // by several vtkPVUpdateSuppressor objects.
+//
+// When an eviction policy is set, vtkPVView::Update() discards cached data
+// (see vtkPVCacheKeeper::EvictEntries()) to keep the cache within the limit
+// instead of stopping caching once the limit is reached.
 
 #ifndef __vtkCacheSizeKeeper_h
 #define __vtkCacheSizeKeeper_h
@@ -67,6 +71,22 @@ public:
   vtkGetMacro(CacheLimit, unsigned long);
   vtkSetMacro(CacheLimit, unsigned long);
 
+//BTX
+  enum EvictionPolicies
+    {
+    NO_EVICTION=0,
+    LEAST_RECENTLY_USED=1,
+    LEAST_FREQUENTLY_USED=2
+    };
+//ETX
+
+  // Description:
+  // Get/Set the policy used to pick the cached data to discard when the cache
+  // exceeds the limit. With NO_EVICTION, caching stops when the cache is full.
+  // Default is LEAST_RECENTLY_USED.
+  vtkSetClampMacro(EvictionPolicy, int, NO_EVICTION, LEAST_FREQUENTLY_USED);
+  vtkGetMacro(EvictionPolicy, int);
+
   // Description:
   // Get/Set if the cache is full. 
   vtkGetMacro(CacheFull, int);
@@ -80,6 +100,7 @@ protected:
   unsigned long CacheSize;
   unsigned long CacheLimit;
   int CacheFull;
+  int EvictionPolicy;
 private:
   vtkCacheSizeKeeper(const vtkCacheSizeKeeper&); // Not implemented.
   void operator=(const vtkCacheSizeKeeper&); // Not implemented.
@@ -324,6 +324,9 @@ int vtkDataLabelRepresentation::RequestData(vtkInformation* request,
   // Pass caching information to the cache keeper.
   this->CacheKeeper->SetCachingEnabled(this->GetUseCache());
   this->CacheKeeper->SetCacheTime(this->GetCacheKey());
+  this->CacheKeeper->SetCacheSource(
+    this->GetNumberOfInputConnections(0) > 0?
+    this->GetInputConnection(0, 0) : NULL, this->GetClassName());
 
   if (inputVector[0]->GetNumberOfInformationObjects()==1)
     {
@@ -24,6 +24,7 @@
 #include "vtkCommand.h"
 #include "vtkCompositeDataDisplayAttributes.h"
 #include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
@@ -31,6 +32,8 @@
 #include "vtkMultiBlockDataSetAlgorithm.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkMultiProcessController.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkProperty.h"
@@ -45,12 +48,17 @@
 #include "vtkSelectionConverter.h"
 #include "vtkSelection.h"
 #include "vtkSelectionNode.h"
+#include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTransform.h"
 #include "vtkUnstructuredGrid.h"
 
 #include <vtksys/SystemTools.hxx>
 
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
 //*****************************************************************************
 // This is used to convert a vtkPolyData to a vtkMultiBlockDataSet. If input is
 // vtkMultiBlockDataSet, then this is simply a pass-through filter. This makes
@@ -92,6 +100,216 @@ protected:
 };
 vtkStandardNewMacro(vtkGeometryRepresentationMultiBlockMaker);
 
+//*****************************************************************************
+namespace
+{
+  // Deep copies input, leaf by leaf for composite datasets, so that the
+  // worker thread shares neither data objects nor points, cells and arrays
+  // with the pipeline and the mappers rendering them.
+  vtkDataObject* vtkNewGeometrySnapshot(vtkDataObject* input)
+    {
+    vtkDataObject* snapshot = input->NewInstance();
+    vtkCompositeDataSet* inputCD = vtkCompositeDataSet::SafeDownCast(input);
+    if (!inputCD)
+      {
+      snapshot->DeepCopy(input);
+      return snapshot;
+      }
+
+    vtkCompositeDataSet* snapshotCD =
+      vtkCompositeDataSet::SafeDownCast(snapshot);
+    snapshotCD->CopyStructure(inputCD);
+    vtkCompositeDataIterator* iter = inputCD->NewIterator();
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+      iter->GoToNextItem())
+      {
+      vtkDataObject* leaf = iter->GetCurrentDataObject();
+      vtkDataObject* clone = leaf->NewInstance();
+      clone->DeepCopy(leaf);
+      snapshotCD->SetDataSet(iter, clone);
+      clone->Delete();
+      }
+    iter->Delete();
+    return snapshot;
+    }
+}
+
+//*****************************************************************************
+// Keeps the LOD pyramid. Every time the geometry or the resolution changes, a
+// new vtkBuild decimates a snapshot of the geometry on a background thread,
+// coarsest level first. Builds that are superseded are aborted and joined
+// once their thread is done.
+class vtkGeometryRepresentation::vtkLODLevels
+{
+public:
+  class vtkBuild
+    {
+  public:
+    // Deep copy of the geometry, so that the pipeline can re-execute and the
+    // mappers render while the levels are being decimated.
+    vtkSmartPointer<vtkDataObject> Input;
+    std::vector<int> Divisions;
+    int UseInputPoints;
+    int CopyCellData;
+    int UseInternalTriangles;
+
+    // Written by the worker thread, under Lock. A level is never replaced
+    // once set, so the main thread can use it after releasing the lock.
+    std::vector<vtkDataObject*> Levels;
+    bool Abort;
+    bool Aborted;
+    bool Done;
+    vtkMutexLock* Lock;
+    int ThreadId;
+
+    vtkBuild() : Abort(false), Aborted(false), Done(false), ThreadId(-1)
+      {
+      this->Lock = vtkMutexLock::New();
+      }
+    ~vtkBuild()
+      {
+      for (size_t cc=0; cc < this->Levels.size(); cc++)
+        {
+        if (this->Levels[cc])
+          {
+          this->Levels[cc]->Delete();
+          }
+        }
+      this->Lock->Delete();
+      }
+    bool IsDone()
+      {
+      this->Lock->Lock();
+      bool done = this->Done;
+      this->Lock->Unlock();
+      return done;
+      }
+    };
+
+  vtkMultiThreader* Threader;
+  std::vector<vtkBuild*> Builds;
+
+  // What the last build was started for.
+  vtkDataObject* Input;
+  unsigned long InputMTime;
+  int Divisions;
+  int NumberOfLevels;
+  unsigned long DecimatorMTime;
+
+  // Level rendered last and coarsest level that fits in the frame time.
+  int LastLevel;
+  int BudgetLevel;
+
+  // Builds that were superseded before all of their levels were decimated.
+  int NumberOfAbortedBuilds;
+
+  vtkLODLevels() : Input(NULL), InputMTime(0), Divisions(0),
+    NumberOfLevels(0), DecimatorMTime(0), LastLevel(-1), BudgetLevel(0),
+    NumberOfAbortedBuilds(0)
+    {
+    this->Threader = vtkMultiThreader::New();
+    }
+  ~vtkLODLevels()
+    {
+    for (size_t cc=0; cc < this->Builds.size(); cc++)
+      {
+      this->Builds[cc]->Lock->Lock();
+      this->Builds[cc]->Abort = true;
+      this->Builds[cc]->Lock->Unlock();
+      }
+    this->Reap(true);
+    this->Threader->Delete();
+    }
+
+  vtkBuild* GetCurrentBuild()
+    {
+    return this->Builds.empty()? NULL : this->Builds.back();
+    }
+
+  // Joins and deletes the builds that are done (or all of them when wait is
+  // true), except for the current one unless wait is true.
+  void Reap(bool wait)
+    {
+    std::vector<vtkBuild*> remaining;
+    for (size_t cc=0; cc < this->Builds.size(); cc++)
+      {
+      vtkBuild* build = this->Builds[cc];
+      bool current = (cc + 1 == this->Builds.size());
+      if (wait || (!current && build->IsDone()))
+        {
+        if (build->ThreadId >= 0)
+          {
+          this->Threader->TerminateThread(build->ThreadId);
+          }
+        this->NumberOfAbortedBuilds += build->Aborted? 1 : 0;
+        delete build;
+        }
+      else
+        {
+        remaining.push_back(build);
+        }
+      }
+    this->Builds.swap(remaining);
+    }
+
+  // Waits for all builds to finish, then deletes all but the current one.
+  void Join()
+    {
+    for (size_t cc=0; cc < this->Builds.size(); cc++)
+      {
+      vtkBuild* build = this->Builds[cc];
+      if (build->ThreadId >= 0)
+        {
+        this->Threader->TerminateThread(build->ThreadId);
+        build->ThreadId = -1;
+        }
+      }
+    this->Reap(false);
+    }
+
+  // Worker thread decimating the levels of a vtkBuild, coarsest first.
+  static VTK_THREAD_RETURN_TYPE DecimateLevels(void* arg)
+    {
+    vtkMultiThreader::ThreadInfo* info =
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    vtkBuild* build = static_cast<vtkBuild*>(info->UserData);
+
+    for (int level = static_cast<int>(build->Levels.size()) - 1;
+      level >= 0; level--)
+      {
+      build->Lock->Lock();
+      bool abort = build->Abort;
+      build->Aborted = abort;
+      build->Lock->Unlock();
+      if (abort)
+        {
+        break;
+        }
+
+      vtkQuadricClustering* decimator = vtkQuadricClustering::New();
+      decimator->SetUseInputPoints(build->UseInputPoints);
+      decimator->SetCopyCellData(build->CopyCellData);
+      decimator->SetUseInternalTriangles(build->UseInternalTriangles);
+      int division = build->Divisions[level];
+      decimator->SetNumberOfDivisions(division, division, division);
+      decimator->SetInputData(build->Input);
+      decimator->Update();
+      vtkDataObject* output = decimator->GetOutputDataObject(0);
+      output->Register(NULL);
+      decimator->Delete();
+
+      build->Lock->Lock();
+      build->Levels[level] = output;
+      build->Lock->Unlock();
+      }
+
+    build->Lock->Lock();
+    build->Done = true;
+    build->Lock->Unlock();
+    return VTK_THREAD_RETURN_VALUE;
+    }
+};
+
 //*****************************************************************************
 
 
@@ -139,6 +357,9 @@ vtkGeometryRepresentation::vtkGeometryRepresentation()
   this->Representation = SURFACE;
 
   this->SuppressLOD = false;
+  this->NumberOfLODLevels = 3;
+  this->LODResolution = 0.5;
+  this->LODLevels = new vtkLODLevels();
   this->DebugString = 0;
   this->SetDebugString(this->GetClassName());
 
@@ -151,6 +372,7 @@ vtkGeometryRepresentation::vtkGeometryRepresentation()
 vtkGeometryRepresentation::~vtkGeometryRepresentation()
 {
   this->SetDebugString(0);
+  delete this->LODLevels;
   this->CacheKeeper->Delete();
   this->GeometryFilter->Delete();
   this->MultiBlockMaker->Delete();
@@ -303,6 +525,30 @@ int vtkGeometryRepresentation::ProcessViewRequest(
         vtkPVRenderView::SetPieceLOD(inInfo, this,
           this->LODOutlineFilter->GetOutputDataObject(0));
         }
+      else if (this->NumberOfLODLevels > 0)
+        {
+        if (inInfo->Has(vtkPVRenderView::LOD_RESOLUTION()))
+          {
+          this->LODResolution =
+            inInfo->Get(vtkPVRenderView::LOD_RESOLUTION());
+          }
+        this->UpdateLODLevels();
+
+        // Never wait for the decimation: render the outline until a level is
+        // ready and let the view know that a better level is on its way.
+        bool pending = false;
+        vtkDataObject* level = this->GetLODLevel(inInfo, pending);
+        if (level == NULL)
+          {
+          this->LODOutlineFilter->Update();
+          level = this->LODOutlineFilter->GetOutputDataObject(0);
+          }
+        vtkPVRenderView::SetPieceLOD(inInfo, this, level);
+        if (pending)
+          {
+          vtkPVRenderView::SetLODPending(inInfo, this);
+          }
+        }
       else
         {
         // HACK to ensure that when Decimator is next employed, it delivers a
@@ -325,6 +571,20 @@ int vtkGeometryRepresentation::ProcessViewRequest(
         }
       }
     }
+  else if (request_type == vtkPVRenderView::REQUEST_PREPARE_LOD())
+    {
+    // The full resolution geometry has just been updated and the view will
+    // use LOD for it. Start decimating the levels right away so that they are
+    // ready, or on their way, by the first interaction.
+    if (!this->SuppressLOD && this->NumberOfLODLevels > 0)
+      {
+      if (inInfo->Has(vtkPVRenderView::LOD_RESOLUTION()))
+        {
+        this->LODResolution = inInfo->Get(vtkPVRenderView::LOD_RESOLUTION());
+        }
+      this->UpdateLODLevels();
+      }
+    }
   else if (request_type == vtkPVView::REQUEST_RENDER())
     {
     vtkAlgorithmOutput* producerPort = vtkPVRenderView::GetPieceProducer(inInfo, this);
@@ -343,6 +603,148 @@ int vtkGeometryRepresentation::ProcessViewRequest(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+void vtkGeometryRepresentation::SetNumberOfLODLevels(int levels)
+{
+  levels = std::max(levels, 0);
+  if (this->NumberOfLODLevels != levels)
+    {
+    this->NumberOfLODLevels = levels;
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkGeometryRepresentation::UpdateLODLevels()
+{
+  vtkLODLevels* lodLevels = this->LODLevels;
+  lodLevels->Reap(false);
+
+  vtkDataObject* input = this->CacheKeeper->GetOutputDataObject(0);
+  int division = static_cast<int>(150 * this->LODResolution) + 10;
+  if (input == NULL ||
+    (lodLevels->GetCurrentBuild() != NULL &&
+     lodLevels->Input == input &&
+     lodLevels->InputMTime == input->GetMTime() &&
+     lodLevels->Divisions == division &&
+     lodLevels->NumberOfLevels == this->NumberOfLODLevels &&
+     lodLevels->DecimatorMTime == this->Decimator->GetMTime()))
+    {
+    return;
+    }
+
+  // The levels being decimated are out of date, there's no point finishing
+  // them.
+  vtkLODLevels::vtkBuild* previous = lodLevels->GetCurrentBuild();
+  if (previous)
+    {
+    previous->Lock->Lock();
+    previous->Abort = true;
+    previous->Lock->Unlock();
+    }
+
+  lodLevels->Input = input;
+  lodLevels->InputMTime = input->GetMTime();
+  lodLevels->Divisions = division;
+  lodLevels->NumberOfLevels = this->NumberOfLODLevels;
+  lodLevels->DecimatorMTime = this->Decimator->GetMTime();
+
+  vtkLODLevels::vtkBuild* build = new vtkLODLevels::vtkBuild();
+  build->Input.TakeReference(vtkNewGeometrySnapshot(input));
+  build->UseInputPoints = this->Decimator->GetUseInputPoints();
+  build->CopyCellData = this->Decimator->GetCopyCellData();
+  build->UseInternalTriangles = this->Decimator->GetUseInternalTriangles();
+  for (int cc=0; cc < this->NumberOfLODLevels; cc++)
+    {
+    build->Divisions.push_back(std::max(division >> cc, 2));
+    }
+  build->Levels.resize(this->NumberOfLODLevels, NULL);
+  build->ThreadId = lodLevels->Threader->SpawnThread(
+    vtkLODLevels::DecimateLevels, build);
+  lodLevels->Builds.push_back(build);
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject* vtkGeometryRepresentation::GetLODLevel(vtkInformation* inInfo,
+  bool& pending)
+{
+  pending = false;
+  vtkLODLevels* lodLevels = this->LODLevels;
+  vtkLODLevels::vtkBuild* build = lodLevels->GetCurrentBuild();
+  if (build == NULL)
+    {
+    return NULL;
+    }
+
+  // Go one level coarser when the last interactive render on the client did
+  // not fit in the time allocated to it and back to finer levels when it was
+  // well within it.
+  int numLevels = static_cast<int>(build->Levels.size());
+  int change = inInfo->Has(vtkPVRenderView::LOD_LEVEL_CHANGE())?
+    inInfo->Get(vtkPVRenderView::LOD_LEVEL_CHANGE()) : 0;
+  if (lodLevels->LastLevel >= 0)
+    {
+    if (change > 0)
+      {
+      lodLevels->BudgetLevel = std::min(lodLevels->LastLevel + 1,
+        numLevels - 1);
+      }
+    else if (change < 0)
+      {
+      lodLevels->BudgetLevel = std::max(lodLevels->BudgetLevel - 1, 0);
+      }
+    }
+  lodLevels->BudgetLevel = std::min(lodLevels->BudgetLevel, numLevels - 1);
+
+  int level = -1;
+  bool coarser = false;
+  bool finer = false;
+  build->Lock->Lock();
+  for (int cc = lodLevels->BudgetLevel; cc < numLevels && level < 0; cc++)
+    {
+    if (build->Levels[cc] != NULL)
+      {
+      level = cc;
+      }
+    }
+  for (int cc = 0; level >= 0 && cc < numLevels; cc++)
+    {
+    coarser |= (cc > level && build->Levels[cc] != NULL);
+    finer |= (cc < level && build->Levels[cc] != NULL);
+    }
+  bool done = build->Done;
+  build->Lock->Unlock();
+
+  // Let the view know whether a level change requested after the next render
+  // can be honored.
+  vtkPVRenderView::SetLODLevelsAvailable(inInfo, this, coarser, finer);
+
+  pending = !done && level != lodLevels->BudgetLevel;
+  lodLevels->LastLevel = level;
+  return level >= 0? build->Levels[level] : NULL;
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject* vtkGeometryRepresentation::WaitForLODLevel(int level)
+{
+  vtkLODLevels* lodLevels = this->LODLevels;
+  lodLevels->Join();
+  vtkLODLevels::vtkBuild* build = lodLevels->GetCurrentBuild();
+  if (build == NULL || level < 0 ||
+    level >= static_cast<int>(build->Levels.size()))
+    {
+    return NULL;
+    }
+  return build->Levels[level];
+}
+
+//----------------------------------------------------------------------------
+int vtkGeometryRepresentation::GetNumberOfAbortedLODBuilds()
+{
+  this->LODLevels->Reap(false);
+  return this->LODLevels->NumberOfAbortedBuilds;
+}
+
 //----------------------------------------------------------------------------
 bool vtkGeometryRepresentation::DoRequestGhostCells(vtkInformation* info)
 {
@@ -410,6 +812,25 @@ int vtkGeometryRepresentation::RequestData(vtkInformation* request,
   this->CacheKeeper->SetCachingEnabled(this->GetUseCache());
   this->CacheKeeper->SetCacheTime(this->GetCacheKey());
 
+  // Representations extracting the same surface from the same input share
+  // the cached data.
+  std::ostringstream signature;
+  signature << this->GetClassName() << " "
+            << this->GeometryFilter->GetClassName();
+  vtkPVGeometryFilter* geomFilter =
+    vtkPVGeometryFilter::SafeDownCast(this->GeometryFilter);
+  if (geomFilter)
+    {
+    signature << " " << geomFilter->GetUseOutline()
+              << " " << geomFilter->GetTriangulate()
+              << " " << geomFilter->GetNonlinearSubdivisionLevel()
+              << " " << geomFilter->GetUseStaticMesh()
+              << " " << geomFilter->GetBlockColorsDistinctValues();
+    }
+  this->CacheKeeper->SetCacheSource(
+    this->GetNumberOfInputConnections(0) > 0?
+    this->GetInputConnection(0, 0) : NULL, signature.str().c_str());
+
   if (inputVector[0]->GetNumberOfInformationObjects()==1)
     {
     vtkInformation* inInfo =
@@ -681,6 +1102,7 @@ void vtkGeometryRepresentation::SetVisibility(bool val)
 void vtkGeometryRepresentation::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfLODLevels: " << this->NumberOfLODLevels << endl;
 }
 
 //****************************************************************************
@@ -867,6 +1289,19 @@ void vtkGeometryRepresentation::SetNonlinearSubdivisionLevel(int val)
   this->MarkModified();
 }
 
+//----------------------------------------------------------------------------
+void vtkGeometryRepresentation::SetUseStaticMesh(bool val)
+{
+  if (vtkPVGeometryFilter::SafeDownCast(this->GeometryFilter))
+    {
+    vtkPVGeometryFilter::SafeDownCast(this->GeometryFilter)->SetUseStaticMesh(val);
+    }
+
+  // since geometry filter needs to execute, we need to mark the representation
+  // modified.
+  this->MarkModified();
+}
+
 //----------------------------------------------------------------------------
 #if !defined(VTK_LEGACY_REMOVE)
 bool vtkGeometryRepresentation::GenerateMetaData(vtkInformation*,
@@ -76,6 +76,30 @@ public:
   virtual void SetSuppressLOD(bool suppress)
     { this->SuppressLOD = suppress; }
 
+  // Description:
+  // Get/Set the number of levels of the LOD pyramid. Level 0 is decimated with
+  // the resolution requested by the view and every following level with half
+  // the number of divisions of the previous one. The levels are decimated on a
+  // background thread, coarsest first, as soon as the full resolution
+  // geometry is updated in a view that uses LOD for it (i.e. past the LOD
+  // threshold), and are reused until the geometry changes again.
+  // Interactive renders use the finest level that is ready and fits in the
+  // frame time, going coarser or finer as the render times measured on the
+  // client require, or the outline while no level is ready. 0 decimates the
+  // geometry synchronously when the LOD is requested. Default is 3.
+  void SetNumberOfLODLevels(int);
+  vtkGetMacro(NumberOfLODLevels, int);
+
+  // Description:
+  // Waits for the LOD levels being decimated in the background and returns
+  // the given level, or NULL if it was not built. Meant for testing.
+  vtkDataObject* WaitForLODLevel(int level);
+
+  // Description:
+  // Returns the number of background LOD builds that were superseded by a
+  // newer one before all of their levels were decimated.
+  int GetNumberOfAbortedLODBuilds();
+
   // Description:
   // Set the lighting properties of the object. vtkGeometryRepresentation
   // overrides these based of the following conditions:
@@ -130,6 +154,7 @@ public:
   virtual void SetUseOutline(int);
   void SetTriangulate(int);
   void SetNonlinearSubdivisionLevel(int);
+  void SetUseStaticMesh(bool);
 
   //***************************************************************************
   // Forwarded to vtkProperty.
@@ -283,11 +308,28 @@ protected:
   bool SuppressLOD;
   bool RequestGhostCellsIfNeeded;
   double DataBounds[6];
+  int NumberOfLODLevels;
+  double LODResolution;
+
+  // Description:
+  // Starts decimating the LOD levels in the background unless the levels
+  // built (or being built) are up to date with the geometry and resolution.
+  void UpdateLODLevels();
+
+  // Description:
+  // Returns the LOD level to render: the finest level that is ready and fits
+  // in the frame time, according to the vtkPVRenderView::LOD_LEVEL_CHANGE()
+  // in inInfo, or NULL when no level is ready yet. pending is set to true when
+  // a better level is still being decimated.
+  vtkDataObject* GetLODLevel(vtkInformation* inInfo, bool& pending);
 
 private:
   vtkGeometryRepresentation(const vtkGeometryRepresentation&); // Not implemented
   void operator=(const vtkGeometryRepresentation&); // Not implemented
 
+  class vtkLODLevels;
+  vtkLODLevels* LODLevels;
+
   friend class vtkSelectionRepresentation;
   char* DebugString;
   vtkSetStringMacro(DebugString);
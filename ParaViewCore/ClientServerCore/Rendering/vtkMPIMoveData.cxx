@@ -14,31 +14,41 @@
 =========================================================================*/
 #include "vtkMPIMoveData.h"
 
+#include "vtkByteSwap.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCharArray.h"
 #include "vtkCompositeDataSet.h"
+#include "vtkDataCompressor.h"
+#include "vtkDataObjectTypes.h"
 #include "vtkDataSetReader.h"
 #include "vtkDirectedGraph.h"
 #include "vtkGenericDataObjectReader.h"
 #include "vtkGenericDataObjectWriter.h"
 #include "vtkGraphReader.h"
 #include "vtkGraphWriter.h"
+#include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMPIMToNSocketConnection.h"
 #include "vtkMultiBlockDataSet.h"
+#include "vtkMultiPieceDataSet.h"
 #include "vtkMultiProcessController.h"
 #include "vtkMultiProcessControllerHelper.h"
+#include "vtkMultiProcessStream.h"
 #include "vtkNonOverlappingAMR.h"
 #include "vtkObjectFactory.h"
 #include "vtkOutlineFilter.h"
 #include "vtkOverlappingAMR.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkProcessModule.h"
 #include "vtkPVConfig.h"
+#include "vtkPVLZDataCompressor.h"
 #include "vtkPVSession.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkSocketCommunicator.h"
 #include "vtkSocketController.h"
@@ -46,10 +56,14 @@
 #include "vtkTimerLog.h"
 #include "vtkToolkits.h"
 #include "vtkUndirectedGraph.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
+#include "vtkZLibDataCompressor.h"
 
 #include "vtk_zlib.h"
 #include <vtksys/ios/sstream>
+#include <algorithm>
+#include <map>
 #include <vector>
 
 #ifdef PARAVIEW_USE_MPI
@@ -59,7 +73,10 @@
 
 #include <vector>
 
-bool vtkMPIMoveData::UseZLibCompression = false;
+int vtkMPIMoveData::CompressionMethod = vtkMPIMoveData::COMPRESSION_NONE;
+bool vtkMPIMoveData::UseByteShuffle = true;
+vtkIdType vtkMPIMoveData::CompressionChunkSize = 1048576;
+double vtkMPIMoveData::MeasuredBandwidth = 0.0;
 
 namespace
 {
@@ -68,6 +85,1061 @@ namespace
     {
     return vtkMultiProcessControllerHelper::MergePieces(pieces, result);
     }
+
+  //---------------------------------------------------------------------------
+  // Native wire format.
+  //
+  // Datasets that are made only of vtkDataArrays (polydata, unstructured
+  // grids, image data and multiblock/multipiece datasets of those) are
+  // marshalled without going through the legacy writer. The buffer is laid out
+  // as:
+  //   "pvmd" | header length (4 bytes, little-endian) | header | payloads...
+  // The header is a vtkMultiProcessStream describing the data object structure
+  // and the arrays, the payloads are the raw array memory, in the order the
+  // arrays appear in the header, each starting at a multiple of
+  // VTK_MPI_MOVE_DATA_NATIVE_ALIGNMENT bytes from the beginning of the buffer.
+  // The same header and payloads can also be sent as separate messages so that
+  // arrays are sent from and received into their own memory.
+  const char VTK_MPI_MOVE_DATA_NATIVE_MAGIC[] = "pvmd";
+  const int VTK_MPI_MOVE_DATA_NATIVE_VERSION = 1;
+  const vtkIdType VTK_MPI_MOVE_DATA_NATIVE_PREFIX_LENGTH = 8;
+  const vtkIdType VTK_MPI_MOVE_DATA_NATIVE_ALIGNMENT = 8;
+
+  inline vtkIdType vtkMPIMoveDataAlign(vtkIdType offset)
+    {
+    return ((offset + VTK_MPI_MOVE_DATA_NATIVE_ALIGNMENT - 1) /
+      VTK_MPI_MOVE_DATA_NATIVE_ALIGNMENT) * VTK_MPI_MOVE_DATA_NATIVE_ALIGNMENT;
+    }
+
+  inline bool vtkMPIMoveDataIsBigEndian()
+    {
+#ifdef VTK_WORDS_BIGENDIAN
+    return true;
+#else
+    return false;
+#endif
+    }
+
+  struct vtkMPIMoveDataSegment
+    {
+    void* Pointer;
+    vtkIdType Length;
+    int WordSize;
+    };
+
+  //---------------------------------------------------------------------------
+  // Builds the header and the list of payload segments for a data object.
+  class vtkMPIMoveDataNativeWriter
+  {
+  public:
+    std::vector<unsigned char> Prefix; // magic + header length + header.
+    std::vector<vtkMPIMoveDataSegment> Segments;
+
+    // Returns false if the data object cannot be encoded natively, in which case
+    // the legacy writer must be used.
+    bool Write(vtkDataObject* data)
+      {
+      this->Header.Reset();
+      this->Segments.clear();
+      this->Header << VTK_MPI_MOVE_DATA_NATIVE_VERSION
+                   << (vtkMPIMoveDataIsBigEndian()? 1 : 0)
+                   << static_cast<int>(sizeof(vtkIdType));
+      if (!this->WriteDataObject(data))
+        {
+        this->Segments.clear();
+        return false;
+        }
+
+      std::vector<unsigned char> header;
+      this->Header.GetRawData(header);
+      vtkTypeUInt32 header_length = static_cast<vtkTypeUInt32>(header.size());
+      this->Prefix.resize(
+        static_cast<size_t>(VTK_MPI_MOVE_DATA_NATIVE_PREFIX_LENGTH) + header.size());
+      memcpy(&this->Prefix[0], VTK_MPI_MOVE_DATA_NATIVE_MAGIC, 4);
+      for (int cc=0; cc < 4; cc++)
+        {
+        this->Prefix[4+cc] = static_cast<unsigned char>(header_length & 0x0ff);
+        header_length = header_length >> 8;
+        }
+      if (!header.empty())
+        {
+        memcpy(&this->Prefix[VTK_MPI_MOVE_DATA_NATIVE_PREFIX_LENGTH],
+          &header[0], header.size());
+        }
+      return true;
+      }
+
+    // Total length of the contiguous buffer.
+    vtkIdType GetContiguousLength() const
+      {
+      vtkIdType length = static_cast<vtkIdType>(this->Prefix.size());
+      for (size_t cc=0; cc < this->Segments.size(); cc++)
+        {
+        length = vtkMPIMoveDataAlign(length) + this->Segments[cc].Length;
+        }
+      return length;
+      }
+
+    // Copies the prefix and all payloads into buffer, which must be at least
+    // GetContiguousLength() bytes long.
+    void CopyToContiguous(char* buffer) const
+      {
+      memcpy(buffer, &this->Prefix[0], this->Prefix.size());
+      vtkIdType offset = static_cast<vtkIdType>(this->Prefix.size());
+      for (size_t cc=0; cc < this->Segments.size(); cc++)
+        {
+        vtkIdType aligned = vtkMPIMoveDataAlign(offset);
+        memset(buffer + offset, 0, aligned - offset);
+        if (this->Segments[cc].Length > 0)
+          {
+          memcpy(buffer + aligned, this->Segments[cc].Pointer,
+            this->Segments[cc].Length);
+          }
+        offset = aligned + this->Segments[cc].Length;
+        }
+      }
+
+  private:
+    vtkMultiProcessStream Header;
+
+    bool WriteArray(vtkAbstractArray* aa, int attribute)
+      {
+      vtkDataArray* array = vtkDataArray::SafeDownCast(aa);
+      if (array == NULL || array->GetDataType() == VTK_BIT)
+        {
+        return false;
+        }
+      const char* name = array->GetName();
+      vtkTypeInt64 numTuples = array->GetNumberOfTuples();
+      this->Header << (name? 1 : 0) << std::string(name? name : "")
+                   << array->GetDataType() << array->GetNumberOfComponents()
+                   << numTuples << attribute;
+
+      vtkMPIMoveDataSegment segment;
+      segment.WordSize = array->GetDataTypeSize();
+      segment.Length = static_cast<vtkIdType>(numTuples) *
+        array->GetNumberOfComponents() * segment.WordSize;
+      segment.Pointer = segment.Length > 0? array->GetVoidPointer(0) : NULL;
+      this->Segments.push_back(segment);
+      return true;
+      }
+
+    bool WriteOptionalArray(vtkDataArray* array)
+      {
+      this->Header << (array? 1 : 0);
+      return array? this->WriteArray(array, -1) : true;
+      }
+
+    bool WriteCellArray(vtkCellArray* cells)
+      {
+      vtkTypeInt64 numCells = cells? cells->GetNumberOfCells() : 0;
+      this->Header << numCells;
+      return this->WriteOptionalArray(cells? cells->GetData() : NULL);
+      }
+
+    bool WriteFieldData(vtkFieldData* fd)
+      {
+      vtkDataSetAttributes* dsa = vtkDataSetAttributes::SafeDownCast(fd);
+      int numArrays = fd? fd->GetNumberOfArrays() : 0;
+      this->Header << numArrays;
+      for (int cc=0; cc < numArrays; cc++)
+        {
+        int attribute = dsa? dsa->IsArrayAnAttribute(cc) : -1;
+        if (!this->WriteArray(fd->GetAbstractArray(cc), attribute))
+          {
+          return false;
+          }
+        }
+      return true;
+      }
+
+    bool WriteChild(vtkInformation* metadata, vtkDataObject* child)
+      {
+      const char* name = (metadata && metadata->Has(vtkCompositeDataSet::NAME()))?
+        metadata->Get(vtkCompositeDataSet::NAME()) : NULL;
+      this->Header << (name? 1 : 0) << std::string(name? name : "");
+      return this->WriteDataObject(child);
+      }
+
+    bool WriteDataObject(vtkDataObject* dobj)
+      {
+      if (dobj == NULL)
+        {
+        this->Header << -1;
+        return true;
+        }
+
+      int type = dobj->GetDataObjectType();
+      this->Header << type;
+      switch (type)
+        {
+      case VTK_POLY_DATA:
+          {
+          vtkPolyData* pd = vtkPolyData::SafeDownCast(dobj);
+          vtkPoints* points = pd->GetPoints();
+          if (!this->WriteOptionalArray(points? points->GetData() : NULL) ||
+            !this->WriteCellArray(pd->GetVerts()) ||
+            !this->WriteCellArray(pd->GetLines()) ||
+            !this->WriteCellArray(pd->GetPolys()) ||
+            !this->WriteCellArray(pd->GetStrips()))
+            {
+            return false;
+            }
+          }
+        break;
+
+      case VTK_UNSTRUCTURED_GRID:
+          {
+          vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(dobj);
+          if (ug->GetFaces() != NULL)
+            {
+            // polyhedral cells are left to the legacy writer.
+            return false;
+            }
+          vtkPoints* points = ug->GetPoints();
+          if (!this->WriteOptionalArray(points? points->GetData() : NULL) ||
+            !this->WriteCellArray(ug->GetCells()) ||
+            !this->WriteOptionalArray(ug->GetCellTypesArray()) ||
+            !this->WriteOptionalArray(ug->GetCellLocationsArray()))
+            {
+            return false;
+            }
+          }
+        break;
+
+      case VTK_IMAGE_DATA:
+          {
+          vtkImageData* id = vtkImageData::SafeDownCast(dobj);
+          int* extent = id->GetExtent();
+          double* origin = id->GetOrigin();
+          double* spacing = id->GetSpacing();
+          for (int cc=0; cc < 6; cc++)
+            {
+            this->Header << extent[cc];
+            }
+          for (int cc=0; cc < 3; cc++)
+            {
+            this->Header << origin[cc] << spacing[cc];
+            }
+          }
+        break;
+
+      case VTK_MULTIBLOCK_DATA_SET:
+          {
+          vtkMultiBlockDataSet* mb = vtkMultiBlockDataSet::SafeDownCast(dobj);
+          unsigned int numBlocks = mb->GetNumberOfBlocks();
+          this->Header << numBlocks;
+          for (unsigned int cc=0; cc < numBlocks; cc++)
+            {
+            if (!this->WriteChild(
+                mb->HasMetaData(cc)? mb->GetMetaData(cc) : NULL,
+                mb->GetBlock(cc)))
+              {
+              return false;
+              }
+            }
+          }
+        break;
+
+      case VTK_MULTIPIECE_DATA_SET:
+          {
+          vtkMultiPieceDataSet* mp = vtkMultiPieceDataSet::SafeDownCast(dobj);
+          unsigned int numPieces = mp->GetNumberOfPieces();
+          this->Header << numPieces;
+          for (unsigned int cc=0; cc < numPieces; cc++)
+            {
+            if (!this->WriteChild(
+                mp->HasMetaData(cc)? mp->GetMetaData(cc) : NULL,
+                mp->GetPiece(cc)))
+              {
+              return false;
+              }
+            }
+          }
+        break;
+
+      default:
+        return false;
+        }
+
+      if (vtkDataSet* ds = vtkDataSet::SafeDownCast(dobj))
+        {
+        if (!this->WriteFieldData(ds->GetPointData()) ||
+          !this->WriteFieldData(ds->GetCellData()))
+          {
+          return false;
+          }
+        }
+      return this->WriteFieldData(dobj->GetFieldData());
+      }
+  };
+
+  //---------------------------------------------------------------------------
+  // Rebuilds a data object from a native header. All arrays are allocated
+  // while parsing the header and their memory is exposed through Segments,
+  // the payloads must then be copied or received directly into them before
+  // calling Finalize().
+  class vtkMPIMoveDataNativeReader
+  {
+  public:
+    vtkMPIMoveDataNativeReader() : SwapBytes(false), Valid(false) {}
+
+    std::vector<vtkMPIMoveDataSegment> Segments;
+
+    // Returns the length of the prefix (magic + header) if buffer starts with
+    // a native header, 0 otherwise.
+    static vtkIdType GetPrefixLength(const char* buffer, vtkIdType length)
+      {
+      if (length < VTK_MPI_MOVE_DATA_NATIVE_PREFIX_LENGTH ||
+        strncmp(buffer, VTK_MPI_MOVE_DATA_NATIVE_MAGIC, 4) != 0)
+        {
+        return 0;
+        }
+      vtkIdType header_length = 0;
+      for (int cc=0; cc < 4; cc++)
+        {
+        header_length = header_length |
+          (static_cast<vtkIdType>(0xff & buffer[4+cc]) << 8*cc);
+        }
+      return VTK_MPI_MOVE_DATA_NATIVE_PREFIX_LENGTH + header_length;
+      }
+
+    // Parses the prefix and returns the new data object, or NULL on error.
+    vtkSmartPointer<vtkDataObject> ReadPrefix(const char* prefix,
+      vtkIdType prefix_length)
+      {
+      this->Segments.clear();
+      this->Grids.clear();
+      this->Header.Reset();
+      this->Valid = false;
+      this->Header.SetRawData(
+        reinterpret_cast<const unsigned char*>(prefix) +
+        VTK_MPI_MOVE_DATA_NATIVE_PREFIX_LENGTH,
+        static_cast<unsigned int>(prefix_length -
+          VTK_MPI_MOVE_DATA_NATIVE_PREFIX_LENGTH));
+
+      int version, big_endian, id_type_size;
+      this->Header >> version >> big_endian >> id_type_size;
+      if (version != VTK_MPI_MOVE_DATA_NATIVE_VERSION)
+        {
+        vtkGenericWarningMacro("Unsupported native data version " << version);
+        return NULL;
+        }
+      if (id_type_size != static_cast<int>(sizeof(vtkIdType)))
+        {
+        vtkGenericWarningMacro("Sender and receiver use different vtkIdType "
+          "sizes. Both must be built with the same VTK_USE_64BIT_IDS setting.");
+        return NULL;
+        }
+      this->SwapBytes = ((big_endian != 0) != vtkMPIMoveDataIsBigEndian());
+      this->Valid = true;
+      vtkSmartPointer<vtkDataObject> dobj = this->ReadDataObject();
+      if (!this->Valid)
+        {
+        return NULL;
+        }
+      return dobj;
+      }
+
+    // Copies the payloads from a contiguous buffer. Returns false if the buffer
+    // is too short.
+    bool CopyFromContiguous(const char* buffer, vtkIdType length,
+      vtkIdType prefix_length)
+      {
+      vtkIdType offset = prefix_length;
+      for (size_t cc=0; cc < this->Segments.size(); cc++)
+        {
+        vtkIdType aligned = vtkMPIMoveDataAlign(offset);
+        if (aligned + this->Segments[cc].Length > length)
+          {
+          return false;
+          }
+        if (this->Segments[cc].Length > 0)
+          {
+          memcpy(this->Segments[cc].Pointer, buffer + aligned,
+            this->Segments[cc].Length);
+          }
+        offset = aligned + this->Segments[cc].Length;
+        }
+      return true;
+      }
+
+    // Returns false if the last ReadPrefix() failed. Note that ReadPrefix() also
+    // returns NULL when a NULL data object was marshalled.
+    bool IsValid() const { return this->Valid; }
+
+    // To be called once all payloads have been filled in.
+    void Finalize()
+      {
+      if (this->SwapBytes)
+        {
+        for (size_t cc=0; cc < this->Segments.size(); cc++)
+          {
+          const vtkMPIMoveDataSegment& segment = this->Segments[cc];
+          if (segment.WordSize > 1 && segment.Length > 0)
+            {
+            vtkByteSwap::SwapVoidRange(segment.Pointer,
+              segment.Length / segment.WordSize, segment.WordSize);
+            }
+          }
+        }
+
+      // vtkUnstructuredGrid::SetCells() looks at the cell types, hence it can
+      // only be called once the arrays are filled.
+      for (size_t cc=0; cc < this->Grids.size(); cc++)
+        {
+        vtkGridCells& item = this->Grids[cc];
+        if (item.Cells && item.Types && item.Locations)
+          {
+          item.Grid->SetCells(item.Types, item.Locations, item.Cells);
+          }
+        }
+      this->Grids.clear();
+      }
+
+  private:
+    struct vtkGridCells
+      {
+      vtkSmartPointer<vtkUnstructuredGrid> Grid;
+      vtkSmartPointer<vtkCellArray> Cells;
+      vtkSmartPointer<vtkUnsignedCharArray> Types;
+      vtkSmartPointer<vtkIdTypeArray> Locations;
+      };
+
+    vtkMultiProcessStream Header;
+    std::vector<vtkGridCells> Grids;
+    bool SwapBytes;
+    bool Valid;
+
+    vtkSmartPointer<vtkDataArray> ReadArray(int* attribute=NULL)
+      {
+      int has_name, type, numComps, attr;
+      std::string name;
+      vtkTypeInt64 numTuples;
+      this->Header >> has_name >> name >> type >> numComps >> numTuples >> attr;
+      if (attribute)
+        {
+        *attribute = attr;
+        }
+
+      vtkSmartPointer<vtkDataArray> array;
+      array.TakeReference(vtkDataArray::CreateDataArray(type));
+      if (!array)
+        {
+        this->Valid = false;
+        return NULL;
+        }
+      array->SetNumberOfComponents(numComps);
+      array->SetNumberOfTuples(static_cast<vtkIdType>(numTuples));
+      if (has_name)
+        {
+        array->SetName(name.c_str());
+        }
+
+      vtkMPIMoveDataSegment segment;
+      segment.WordSize = array->GetDataTypeSize();
+      segment.Length = static_cast<vtkIdType>(numTuples) * numComps *
+        segment.WordSize;
+      segment.Pointer = segment.Length > 0? array->GetVoidPointer(0) : NULL;
+      this->Segments.push_back(segment);
+      return array;
+      }
+
+    vtkSmartPointer<vtkDataArray> ReadOptionalArray()
+      {
+      int present;
+      this->Header >> present;
+      if (!present)
+        {
+        return NULL;
+        }
+      return this->ReadArray();
+      }
+
+    vtkSmartPointer<vtkCellArray> ReadCellArray()
+      {
+      vtkTypeInt64 numCells;
+      this->Header >> numCells;
+      vtkSmartPointer<vtkDataArray> array = this->ReadOptionalArray();
+      vtkIdTypeArray* ia = vtkIdTypeArray::SafeDownCast(array);
+      if (ia == NULL)
+        {
+        return NULL;
+        }
+      vtkSmartPointer<vtkCellArray> cells = vtkSmartPointer<vtkCellArray>::New();
+      cells->SetCells(static_cast<vtkIdType>(numCells), ia);
+      return cells;
+      }
+
+    vtkSmartPointer<vtkPoints> ReadPoints()
+      {
+      vtkSmartPointer<vtkDataArray> array = this->ReadOptionalArray();
+      if (!array)
+        {
+        return NULL;
+        }
+      vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+      points->SetData(array);
+      return points;
+      }
+
+    void ReadFieldData(vtkFieldData* fd)
+      {
+      vtkDataSetAttributes* dsa = vtkDataSetAttributes::SafeDownCast(fd);
+      int numArrays;
+      this->Header >> numArrays;
+      for (int cc=0; cc < numArrays && this->Valid; cc++)
+        {
+        int attribute;
+        vtkSmartPointer<vtkDataArray> array = this->ReadArray(&attribute);
+        if (!array)
+          {
+          return;
+          }
+        int index = fd->AddArray(array);
+        if (dsa && attribute >= 0)
+          {
+          dsa->SetActiveAttribute(index, attribute);
+          }
+        }
+      }
+
+    void ReadChildName(std::string& name, bool& has_name)
+      {
+      int flag;
+      this->Header >> flag >> name;
+      has_name = (flag != 0);
+      }
+
+    vtkSmartPointer<vtkDataObject> ReadDataObject()
+      {
+      int type;
+      this->Header >> type;
+      if (type == -1)
+        {
+        return NULL;
+        }
+
+      vtkSmartPointer<vtkDataObject> dobj;
+      dobj.TakeReference(vtkDataObjectTypes::NewDataObject(type));
+      if (!dobj)
+        {
+        this->Valid = false;
+        return NULL;
+        }
+
+      switch (type)
+        {
+      case VTK_POLY_DATA:
+          {
+          vtkPolyData* pd = vtkPolyData::SafeDownCast(dobj);
+          pd->SetPoints(this->ReadPoints());
+          vtkSmartPointer<vtkCellArray> verts = this->ReadCellArray();
+          vtkSmartPointer<vtkCellArray> lines = this->ReadCellArray();
+          vtkSmartPointer<vtkCellArray> polys = this->ReadCellArray();
+          vtkSmartPointer<vtkCellArray> strips = this->ReadCellArray();
+          if (verts && verts->GetNumberOfCells() > 0)
+            {
+            pd->SetVerts(verts);
+            }
+          if (lines && lines->GetNumberOfCells() > 0)
+            {
+            pd->SetLines(lines);
+            }
+          if (polys && polys->GetNumberOfCells() > 0)
+            {
+            pd->SetPolys(polys);
+            }
+          if (strips && strips->GetNumberOfCells() > 0)
+            {
+            pd->SetStrips(strips);
+            }
+          }
+        break;
+
+      case VTK_UNSTRUCTURED_GRID:
+          {
+          vtkGridCells item;
+          item.Grid = vtkUnstructuredGrid::SafeDownCast(dobj);
+          item.Grid->SetPoints(this->ReadPoints());
+          item.Cells = this->ReadCellArray();
+          item.Types = vtkUnsignedCharArray::SafeDownCast(this->ReadOptionalArray());
+          item.Locations = vtkIdTypeArray::SafeDownCast(this->ReadOptionalArray());
+          this->Grids.push_back(item);
+          }
+        break;
+
+      case VTK_IMAGE_DATA:
+          {
+          vtkImageData* id = vtkImageData::SafeDownCast(dobj);
+          int extent[6];
+          double origin[3], spacing[3];
+          for (int cc=0; cc < 6; cc++)
+            {
+            this->Header >> extent[cc];
+            }
+          for (int cc=0; cc < 3; cc++)
+            {
+            this->Header >> origin[cc] >> spacing[cc];
+            }
+          id->SetExtent(extent);
+          id->SetOrigin(origin);
+          id->SetSpacing(spacing);
+          }
+        break;
+
+      case VTK_MULTIBLOCK_DATA_SET:
+          {
+          vtkMultiBlockDataSet* mb = vtkMultiBlockDataSet::SafeDownCast(dobj);
+          unsigned int numBlocks;
+          this->Header >> numBlocks;
+          mb->SetNumberOfBlocks(numBlocks);
+          for (unsigned int cc=0; cc < numBlocks && this->Valid; cc++)
+            {
+            std::string name;
+            bool has_name;
+            this->ReadChildName(name, has_name);
+            mb->SetBlock(cc, this->ReadDataObject());
+            if (has_name)
+              {
+              mb->GetMetaData(cc)->Set(vtkCompositeDataSet::NAME(), name.c_str());
+              }
+            }
+          }
+        break;
+
+      case VTK_MULTIPIECE_DATA_SET:
+          {
+          vtkMultiPieceDataSet* mp = vtkMultiPieceDataSet::SafeDownCast(dobj);
+          unsigned int numPieces;
+          this->Header >> numPieces;
+          mp->SetNumberOfPieces(numPieces);
+          for (unsigned int cc=0; cc < numPieces && this->Valid; cc++)
+            {
+            std::string name;
+            bool has_name;
+            this->ReadChildName(name, has_name);
+            mp->SetPiece(cc, this->ReadDataObject());
+            if (has_name)
+              {
+              mp->GetMetaData(cc)->Set(vtkCompositeDataSet::NAME(), name.c_str());
+              }
+            }
+          }
+        break;
+
+      default:
+        this->Valid = false;
+        return NULL;
+        }
+
+      if (vtkDataSet* ds = vtkDataSet::SafeDownCast(dobj))
+        {
+        this->ReadFieldData(ds->GetPointData());
+        this->ReadFieldData(ds->GetCellData());
+        }
+      this->ReadFieldData(dobj->GetFieldData());
+      return dobj;
+      }
+  };
+
+  //---------------------------------------------------------------------------
+  // Compressed buffers.
+  //
+  // A compressed buffer starts with the 4 character tag of the codec used,
+  // followed by:
+  //   flags (1 byte) | shuffle word size (1 byte) | 2 reserved bytes |
+  //   uncompressed length (8 bytes) | chunk size (4 bytes) |
+  //   number of chunks (4 bytes) | compressed length of each chunk (4 bytes) |
+  //   chunks...
+  // Integers are little-endian. Chunks are compressed independently so that
+  // they can be processed concurrently. A chunk that does not compress is
+  // stored as is, which is indicated by a compressed length equal to the
+  // chunk length. Buffers tagged "zlib" use the legacy layout:
+  //   "zlib" | uncompressed length (4 bytes) | zlib stream.
+  const vtkIdType VTK_MPI_MOVE_DATA_CODEC_HEADER_LENGTH = 24;
+  const unsigned char VTK_MPI_MOVE_DATA_CODEC_SHUFFLE = 0x1;
+  const int VTK_MPI_MOVE_DATA_SHUFFLE_WORD_SIZE = 4;
+
+  // Buffers smaller than this are never compressed in automatic mode.
+  const vtkIdType VTK_MPI_MOVE_DATA_AUTOMATIC_MINIMUM_LENGTH = 65536;
+
+  struct vtkMPIMoveDataCodec
+    {
+    char Tag[4];
+    vtkMPIMoveData::CompressorNewFunction NewCompressor;
+
+    // Running estimates of the compression ratio and of the throughput (in
+    // uncompressed bytes per second) used to pick a codec automatically.
+    double Ratio;
+    double Throughput;
+    };
+  typedef std::map<int, vtkMPIMoveDataCodec> vtkMPIMoveDataCodecMap;
+
+  vtkDataCompressor* vtkMPIMoveDataNewZLibCompressor()
+    {
+    return vtkZLibDataCompressor::New();
+    }
+
+  vtkDataCompressor* vtkMPIMoveDataNewLZCompressor()
+    {
+    return vtkPVLZDataCompressor::New();
+    }
+
+  void vtkMPIMoveDataAddCodec(vtkMPIMoveDataCodecMap& codecs, int method,
+    const char* tag, vtkMPIMoveData::CompressorNewFunction newCompressor,
+    double ratio, double throughput)
+    {
+    vtkMPIMoveDataCodec& codec = codecs[method];
+    memcpy(codec.Tag, tag, 4);
+    codec.NewCompressor = newCompressor;
+    codec.Ratio = ratio;
+    codec.Throughput = throughput;
+    }
+
+  vtkMPIMoveDataCodecMap& vtkMPIMoveDataGetCodecs()
+    {
+    static vtkMPIMoveDataCodecMap codecs;
+    if (codecs.empty())
+      {
+      // Initial estimates, refined as data gets compressed.
+      vtkMPIMoveDataAddCodec(codecs, vtkMPIMoveData::COMPRESSION_ZLIB, "pvzl",
+        vtkMPIMoveDataNewZLibCompressor, 0.4, 50.0e6);
+      vtkMPIMoveDataAddCodec(codecs, vtkMPIMoveData::COMPRESSION_LZ, "pvlz",
+        vtkMPIMoveDataNewLZCompressor, 0.6, 400.0e6);
+      }
+    return codecs;
+    }
+
+  vtkMPIMoveDataCodec* vtkMPIMoveDataFindCodec(const char* tag)
+    {
+    vtkMPIMoveDataCodecMap& codecs = vtkMPIMoveDataGetCodecs();
+    for (vtkMPIMoveDataCodecMap::iterator iter = codecs.begin();
+      iter != codecs.end(); ++iter)
+      {
+      if (strncmp(iter->second.Tag, tag, 4) == 0)
+        {
+        return &iter->second;
+        }
+      }
+    return NULL;
+    }
+
+  // Returns the method to use to send \c length bytes over a link with the
+  // given bandwidth.
+  int vtkMPIMoveDataResolveCompressionMethod(int method, vtkIdType length,
+    double bandwidth)
+    {
+    if (method != vtkMPIMoveData::COMPRESSION_AUTOMATIC)
+      {
+      return method;
+      }
+    if (bandwidth <= 0.0 || length < VTK_MPI_MOVE_DATA_AUTOMATIC_MINIMUM_LENGTH)
+      {
+      return vtkMPIMoveData::COMPRESSION_NONE;
+      }
+
+    int best = vtkMPIMoveData::COMPRESSION_NONE;
+    double best_time = length / bandwidth;
+    vtkMPIMoveDataCodecMap& codecs = vtkMPIMoveDataGetCodecs();
+    for (vtkMPIMoveDataCodecMap::iterator iter = codecs.begin();
+      iter != codecs.end(); ++iter)
+      {
+      const vtkMPIMoveDataCodec& codec = iter->second;
+      double time = length / codec.Throughput +
+        length * codec.Ratio / bandwidth;
+      if (time < best_time)
+        {
+        best = iter->first;
+        best_time = time;
+        }
+      }
+    return best;
+    }
+
+  inline void vtkMPIMoveDataEncode(unsigned char* buffer, vtkTypeUInt64 value,
+    int numBytes)
+    {
+    for (int cc=0; cc < numBytes; cc++)
+      {
+      buffer[cc] = static_cast<unsigned char>(value & 0xff);
+      value = value >> 8;
+      }
+    }
+
+  inline vtkTypeUInt64 vtkMPIMoveDataDecode(const unsigned char* buffer,
+    int numBytes)
+    {
+    vtkTypeUInt64 value = 0;
+    for (int cc=numBytes-1; cc >= 0; cc--)
+      {
+      value = (value << 8) | buffer[cc];
+      }
+    return value;
+    }
+
+  // Groups the n-th bytes of all the words together.
+  void vtkMPIMoveDataShuffle(const unsigned char* input, vtkIdType length,
+    int wordSize, unsigned char* output)
+    {
+    vtkIdType count = length / wordSize;
+    for (int byte=0; byte < wordSize; byte++)
+      {
+      unsigned char* out = output + byte * count;
+      const unsigned char* in = input + byte;
+      for (vtkIdType cc=0; cc < count; cc++, in += wordSize)
+        {
+        out[cc] = *in;
+        }
+      }
+    memcpy(output + count * wordSize, input + count * wordSize,
+      length - count * wordSize);
+    }
+
+  void vtkMPIMoveDataUnshuffle(const unsigned char* input, vtkIdType length,
+    int wordSize, unsigned char* output)
+    {
+    vtkIdType count = length / wordSize;
+    for (int byte=0; byte < wordSize; byte++)
+      {
+      const unsigned char* in = input + byte * count;
+      unsigned char* out = output + byte;
+      for (vtkIdType cc=0; cc < count; cc++, out += wordSize)
+        {
+        *out = in[cc];
+        }
+      }
+    memcpy(output + count * wordSize, input + count * wordSize,
+      length - count * wordSize);
+    }
+
+  //---------------------------------------------------------------------------
+  // Compresses a range of chunks, used with vtkSMPTools::For().
+  class vtkMPIMoveDataCompressChunks
+  {
+  public:
+    const unsigned char* Input;
+    vtkIdType Length;
+    vtkIdType ChunkSize;
+    int WordSize;
+    vtkMPIMoveData::CompressorNewFunction NewCompressor;
+    std::vector<std::vector<unsigned char> > Chunks;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      vtkDataCompressor* compressor = (*this->NewCompressor)();
+      std::vector<unsigned char> shuffled;
+      for (vtkIdType cc=begin; cc < end; cc++)
+        {
+        const unsigned char* chunk = this->Input + cc * this->ChunkSize;
+        vtkIdType length = std::min(this->ChunkSize,
+          this->Length - cc * this->ChunkSize);
+        if (this->WordSize > 1)
+          {
+          shuffled.resize(length);
+          vtkMPIMoveDataShuffle(chunk, length, this->WordSize, &shuffled[0]);
+          chunk = &shuffled[0];
+          }
+
+        std::vector<unsigned char>& output = this->Chunks[cc];
+        output.resize(compressor->GetMaximumCompressionSpace(length));
+        vtkIdType output_length = static_cast<vtkIdType>(compressor->Compress(
+            chunk, length, &output[0], output.size()));
+        if (output_length <= 0 || output_length >= length)
+          {
+          output.assign(chunk, chunk + length);
+          }
+        else
+          {
+          output.resize(output_length);
+          }
+        }
+      compressor->Delete();
+      }
+  };
+
+  //---------------------------------------------------------------------------
+  // Uncompresses a range of chunks, used with vtkSMPTools::For().
+  class vtkMPIMoveDataUncompressChunks
+  {
+  public:
+    const unsigned char* Input;
+    std::vector<vtkIdType> InputOffsets;
+    std::vector<vtkIdType> InputLengths;
+    unsigned char* Output;
+    vtkIdType Length;
+    vtkIdType ChunkSize;
+    int WordSize;
+    vtkMPIMoveData::CompressorNewFunction NewCompressor;
+    std::vector<unsigned char> Failed;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      vtkDataCompressor* compressor = (*this->NewCompressor)();
+      std::vector<unsigned char> shuffled;
+      for (vtkIdType cc=begin; cc < end; cc++)
+        {
+        const unsigned char* chunk = this->Input + this->InputOffsets[cc];
+        unsigned char* output = this->Output + cc * this->ChunkSize;
+        vtkIdType length = std::min(this->ChunkSize,
+          this->Length - cc * this->ChunkSize);
+        unsigned char* target = output;
+        if (this->WordSize > 1)
+          {
+          shuffled.resize(length);
+          target = &shuffled[0];
+          }
+        if (this->InputLengths[cc] == length)
+          {
+          memcpy(target, chunk, length);
+          }
+        else if (static_cast<vtkIdType>(compressor->Uncompress(chunk,
+              this->InputLengths[cc], target, length)) != length)
+          {
+          this->Failed[cc] = 1;
+          continue;
+          }
+        if (this->WordSize > 1)
+          {
+          vtkMPIMoveDataUnshuffle(target, length, this->WordSize, output);
+          }
+        }
+      compressor->Delete();
+      }
+  };
+
+  //---------------------------------------------------------------------------
+  // Returns a new[]'ed buffer with the compressed data.
+  char* vtkMPIMoveDataCompress(vtkMPIMoveDataCodec& codec, const char* input,
+    vtkIdType length, vtkIdType chunkSize, bool shuffle,
+    vtkIdType& outputLength)
+    {
+    vtkTimerLog::MarkStartEvent("vtkMPIMoveData: Compress");
+    double start = vtkTimerLog::GetUniversalTime();
+
+    int word_size = shuffle? VTK_MPI_MOVE_DATA_SHUFFLE_WORD_SIZE : 1;
+    // Keep chunks a multiple of the word size and addressable on 4 bytes.
+    chunkSize = std::max(chunkSize, static_cast<vtkIdType>(1024));
+    chunkSize = std::min(chunkSize, static_cast<vtkIdType>(1) << 30);
+    chunkSize -= chunkSize % VTK_MPI_MOVE_DATA_SHUFFLE_WORD_SIZE;
+    vtkIdType num_chunks = (length + chunkSize - 1) / chunkSize;
+
+    vtkMPIMoveDataCompressChunks functor;
+    functor.Input = reinterpret_cast<const unsigned char*>(input);
+    functor.Length = length;
+    functor.ChunkSize = chunkSize;
+    functor.WordSize = word_size;
+    functor.NewCompressor = codec.NewCompressor;
+    functor.Chunks.resize(num_chunks);
+    vtkSMPTools::For(0, num_chunks, functor);
+
+    outputLength = VTK_MPI_MOVE_DATA_CODEC_HEADER_LENGTH + 4 * num_chunks;
+    for (vtkIdType cc=0; cc < num_chunks; cc++)
+      {
+      outputLength += static_cast<vtkIdType>(functor.Chunks[cc].size());
+      }
+
+    char* output = new char[outputLength];
+    unsigned char* header = reinterpret_cast<unsigned char*>(output);
+    memcpy(header, codec.Tag, 4);
+    header[4] = shuffle? VTK_MPI_MOVE_DATA_CODEC_SHUFFLE : 0;
+    header[5] = static_cast<unsigned char>(word_size);
+    header[6] = header[7] = 0;
+    vtkMPIMoveDataEncode(header + 8, length, 8);
+    vtkMPIMoveDataEncode(header + 16, chunkSize, 4);
+    vtkMPIMoveDataEncode(header + 20, num_chunks, 4);
+    unsigned char* chunk_lengths = header + VTK_MPI_MOVE_DATA_CODEC_HEADER_LENGTH;
+    char* chunk = output + VTK_MPI_MOVE_DATA_CODEC_HEADER_LENGTH + 4 * num_chunks;
+    for (vtkIdType cc=0; cc < num_chunks; cc++)
+      {
+      size_t chunk_length = functor.Chunks[cc].size();
+      vtkMPIMoveDataEncode(chunk_lengths + 4 * cc, chunk_length, 4);
+      memcpy(chunk, &functor.Chunks[cc][0], chunk_length);
+      chunk += chunk_length;
+      }
+
+    // Update the estimates used in automatic mode.
+    double elapsed = vtkTimerLog::GetUniversalTime() - start;
+    if (length > 0 && elapsed > 0.0)
+      {
+      codec.Ratio = 0.7 * codec.Ratio +
+        0.3 * static_cast<double>(outputLength) / length;
+      codec.Throughput = 0.7 * codec.Throughput + 0.3 * (length / elapsed);
+      }
+    vtkTimerLog::MarkEndEvent("vtkMPIMoveData: Compress");
+    return output;
+    }
+
+  //---------------------------------------------------------------------------
+  // Returns a new[]'ed buffer with the uncompressed data or NULL if \c input
+  // is not a buffer compressed with a registered codec.
+  char* vtkMPIMoveDataUncompress(const char* input, vtkIdType length,
+    vtkIdType& outputLength)
+    {
+    if (length < VTK_MPI_MOVE_DATA_CODEC_HEADER_LENGTH)
+      {
+      return NULL;
+      }
+    vtkMPIMoveDataCodec* codec = vtkMPIMoveDataFindCodec(input);
+    if (!codec)
+      {
+      return NULL;
+      }
+
+    const unsigned char* header = reinterpret_cast<const unsigned char*>(input);
+    int word_size = (header[4] & VTK_MPI_MOVE_DATA_CODEC_SHUFFLE)?
+      static_cast<int>(header[5]) : 1;
+    vtkIdType uncompressed_length =
+      static_cast<vtkIdType>(vtkMPIMoveDataDecode(header + 8, 8));
+    vtkIdType chunk_size =
+      static_cast<vtkIdType>(vtkMPIMoveDataDecode(header + 16, 4));
+    vtkIdType num_chunks =
+      static_cast<vtkIdType>(vtkMPIMoveDataDecode(header + 20, 4));
+    if (word_size < 1 || chunk_size <= 0 || uncompressed_length < 0 ||
+      num_chunks != (uncompressed_length + chunk_size - 1) / chunk_size ||
+      VTK_MPI_MOVE_DATA_CODEC_HEADER_LENGTH + 4 * num_chunks > length)
+      {
+      return NULL;
+      }
+
+    vtkTimerLog::MarkStartEvent("vtkMPIMoveData: Uncompress");
+    vtkMPIMoveDataUncompressChunks functor;
+    functor.Input = header;
+    functor.InputOffsets.resize(num_chunks);
+    functor.InputLengths.resize(num_chunks);
+    vtkIdType offset = VTK_MPI_MOVE_DATA_CODEC_HEADER_LENGTH + 4 * num_chunks;
+    for (vtkIdType cc=0; cc < num_chunks; cc++)
+      {
+      functor.InputOffsets[cc] = offset;
+      functor.InputLengths[cc] = static_cast<vtkIdType>(vtkMPIMoveDataDecode(
+          header + VTK_MPI_MOVE_DATA_CODEC_HEADER_LENGTH + 4 * cc, 4));
+      offset += functor.InputLengths[cc];
+      }
+    if (offset > length)
+      {
+      vtkTimerLog::MarkEndEvent("vtkMPIMoveData: Uncompress");
+      return NULL;
+      }
+
+    char* output = new char[uncompressed_length];
+    functor.Output = reinterpret_cast<unsigned char*>(output);
+    functor.Length = uncompressed_length;
+    functor.ChunkSize = chunk_size;
+    functor.WordSize = word_size;
+    functor.NewCompressor = codec->NewCompressor;
+    functor.Failed.resize(num_chunks, 0);
+    vtkSMPTools::For(0, num_chunks, functor);
+    vtkTimerLog::MarkEndEvent("vtkMPIMoveData: Uncompress");
+
+    if (std::find(functor.Failed.begin(), functor.Failed.end(), 1) !=
+      functor.Failed.end())
+      {
+      delete [] output;
+      return NULL;
+      }
+    outputLength = uncompressed_length;
+    return output;
+    }
 };
 
 
@@ -162,13 +1234,91 @@ void vtkMPIMoveData::InitializeForCommunicationForParaView()
 //----------------------------------------------------------------------------
 void vtkMPIMoveData::SetUseZLibCompression(bool b)
 {
-  vtkMPIMoveData::UseZLibCompression = b;
+  vtkMPIMoveData::SetCompressionMethod(
+    b? vtkMPIMoveData::COMPRESSION_ZLIB : vtkMPIMoveData::COMPRESSION_NONE);
 }
 
 //----------------------------------------------------------------------------
 bool vtkMPIMoveData::GetUseZLibCompression()
 {
-  return vtkMPIMoveData::UseZLibCompression;
+  return vtkMPIMoveData::CompressionMethod == vtkMPIMoveData::COMPRESSION_ZLIB;
+}
+
+//----------------------------------------------------------------------------
+void vtkMPIMoveData::SetCompressionMethod(int method)
+{
+  if (method != vtkMPIMoveData::COMPRESSION_NONE &&
+    method != vtkMPIMoveData::COMPRESSION_AUTOMATIC &&
+    vtkMPIMoveDataGetCodecs().find(method) == vtkMPIMoveDataGetCodecs().end())
+    {
+    vtkGenericWarningMacro("Unknown compression method " << method
+      << ". Compression is disabled.");
+    method = vtkMPIMoveData::COMPRESSION_NONE;
+    }
+  vtkMPIMoveData::CompressionMethod = method;
+}
+
+//----------------------------------------------------------------------------
+int vtkMPIMoveData::GetCompressionMethod()
+{
+  return vtkMPIMoveData::CompressionMethod;
+}
+
+//----------------------------------------------------------------------------
+void vtkMPIMoveData::SetUseByteShuffle(bool b)
+{
+  vtkMPIMoveData::UseByteShuffle = b;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMPIMoveData::GetUseByteShuffle()
+{
+  return vtkMPIMoveData::UseByteShuffle;
+}
+
+//----------------------------------------------------------------------------
+void vtkMPIMoveData::SetCompressionChunkSize(vtkIdType size)
+{
+  vtkMPIMoveData::CompressionChunkSize = size;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkMPIMoveData::GetCompressionChunkSize()
+{
+  return vtkMPIMoveData::CompressionChunkSize;
+}
+
+//----------------------------------------------------------------------------
+double vtkMPIMoveData::GetMeasuredBandwidth()
+{
+  return vtkMPIMoveData::MeasuredBandwidth;
+}
+
+//----------------------------------------------------------------------------
+int vtkMPIMoveData::RegisterCompressor(const char* tag,
+  CompressorNewFunction newCompressor)
+{
+  if (!tag || strlen(tag) != 4 || !newCompressor ||
+    strncmp(tag, "zlib", 4) == 0 ||
+    strncmp(tag, VTK_MPI_MOVE_DATA_NATIVE_MAGIC, 4) == 0)
+    {
+    return -1;
+    }
+
+  vtkMPIMoveDataCodecMap& codecs = vtkMPIMoveDataGetCodecs();
+  int method = vtkMPIMoveData::COMPRESSION_USER;
+  for (vtkMPIMoveDataCodecMap::iterator iter = codecs.begin();
+    iter != codecs.end(); ++iter)
+    {
+    if (strncmp(iter->second.Tag, tag, 4) == 0)
+      {
+      iter->second.NewCompressor = newCompressor;
+      return iter->first;
+      }
+    method = std::max(method, iter->first + 1);
+    }
+  vtkMPIMoveDataAddCodec(codecs, method, tag, newCompressor, 0.5, 100.0e6);
+  return method;
 }
 
 //----------------------------------------------------------------------------
@@ -769,14 +1919,7 @@ void vtkMPIMoveData::DataServerSendToRenderServer(vtkDataObject* output)
     return;
     }
 
-  //int fixme;
-  // We might be able to eliminate this marshal.
-  this->ClearBuffer();
-  this->MarshalDataToBuffer(output);
-
-  com->Send(&(this->NumberOfBuffers), 1, 1, 23480);
-  com->Send(this->BufferLengths, this->NumberOfBuffers, 1, 23481);
-  com->Send(this->Buffers, this->BufferTotalLength, 1, 23482);
+  this->SendDataObject(com, output, 23480);
 }
 
 //-----------------------------------------------------------------------------
@@ -791,24 +1934,7 @@ void vtkMPIMoveData::RenderServerReceiveFromDataServer(vtkDataObject* output)
     return;
     }
 
-  this->ClearBuffer();
-  com->Receive(&(this->NumberOfBuffers), 1, 1, 23480);
-  this->BufferLengths = new vtkIdType[this->NumberOfBuffers];
-  com->Receive(this->BufferLengths, this->NumberOfBuffers, 1, 23481);
-  // Compute additional buffer information.
-  this->BufferOffsets = new vtkIdType[this->NumberOfBuffers];
-  this->BufferTotalLength = 0;
-  for (int idx = 0; idx < this->NumberOfBuffers; ++idx)
-    {
-    this->BufferOffsets[idx] = this->BufferTotalLength;
-    this->BufferTotalLength += this->BufferLengths[idx];
-    }
-  this->Buffers = new char[this->BufferTotalLength];
-  com->Receive(this->Buffers, this->BufferTotalLength, 1, 23482);
-
-  //int fixme;  // Can we avoid this?
-  this->ReconstructDataFromBuffer(output);
-  this->ClearBuffer();
+  this->ReceiveDataObject(com, output, 23480);
 }
 
 //-----------------------------------------------------------------------------
@@ -828,14 +1954,7 @@ void vtkMPIMoveData::DataServerZeroSendToRenderServerZero(vtkDataObject* data)
       return;
       }
 
-    //int fixme;
-    // We might be able to eliminate this marshal.
-    this->ClearBuffer();
-    this->MarshalDataToBuffer(data);
-    com->Send(&(this->NumberOfBuffers), 1, 1, 23480);
-    com->Send(this->BufferLengths, this->NumberOfBuffers, 1, 23481);
-    com->Send(this->Buffers, this->BufferTotalLength, 1, 23482);
-    this->ClearBuffer();
+    this->SendDataObject(com, data, 23480);
     }
 }
 
@@ -855,24 +1974,7 @@ void vtkMPIMoveData::RenderServerZeroReceiveFromDataServerZero(vtkDataObject* da
       return;
       }
 
-    this->ClearBuffer();
-    com->Receive(&(this->NumberOfBuffers), 1, 1, 23480);
-    this->BufferLengths = new vtkIdType[this->NumberOfBuffers];
-    com->Receive(this->BufferLengths, this->NumberOfBuffers, 1, 23481);
-    // Compute additional buffer information.
-    this->BufferOffsets = new vtkIdType[this->NumberOfBuffers];
-    this->BufferTotalLength = 0;
-    for (int idx = 0; idx < this->NumberOfBuffers; ++idx)
-      {
-      this->BufferOffsets[idx] = this->BufferTotalLength;
-      this->BufferTotalLength += this->BufferLengths[idx];
-      }
-    this->Buffers = new char[this->BufferTotalLength];
-    com->Receive(this->Buffers, this->BufferTotalLength, 1, 23482);
-
-    //int fixme;  // Can we avoid this?
-    this->ReconstructDataFromBuffer(data);
-    this->ClearBuffer();
+    this->ReceiveDataObject(com, data, 23480);
     }
 }
 
@@ -889,15 +1991,8 @@ void vtkMPIMoveData::DataServerSendToClient(vtkDataObject* output)
   if (myId == 0)
     {
     vtkTimerLog::MarkStartEvent("Dataserver sending to client");
-    this->ClearBuffer();
-    this->MarshalDataToBuffer(output);
-    this->ClientDataServerSocketController->Send(
-                                     &(this->NumberOfBuffers), 1, 1, 23490);
-    this->ClientDataServerSocketController->Send(this->BufferLengths,
-                                     this->NumberOfBuffers, 1, 23491);
-    this->ClientDataServerSocketController->Send(this->Buffers,
-                                     this->BufferTotalLength, 1, 23492);
-    this->ClearBuffer();
+    this->SendDataObject(
+      this->ClientDataServerSocketController->GetCommunicator(), output, 23490);
     vtkTimerLog::MarkEndEvent("Dataserver sending to client");
     }
 }
@@ -913,24 +2008,7 @@ void vtkMPIMoveData::ClientReceiveFromDataServer(vtkDataObject* output)
     return;
     }
 
-  this->ClearBuffer();
-  com->Receive(&(this->NumberOfBuffers), 1, 1, 23490);
-  this->BufferLengths = new vtkIdType[this->NumberOfBuffers];
-  com->Receive(this->BufferLengths, this->NumberOfBuffers,
-                                  1, 23491);
-  // Compute additional buffer information.
-  this->BufferOffsets = new vtkIdType[this->NumberOfBuffers];
-  this->BufferTotalLength = 0;
-  for (int idx = 0; idx < this->NumberOfBuffers; ++idx)
-    {
-    this->BufferOffsets[idx] = this->BufferTotalLength;
-    this->BufferTotalLength += this->BufferLengths[idx];
-    }
-  this->Buffers = new char[this->BufferTotalLength];
-  com->Receive(this->Buffers, this->BufferTotalLength,
-                                  1, 23492);
-  this->ReconstructDataFromBuffer(output);
-  this->ClearBuffer();
+  this->ReceiveDataObject(com, output, 23490);
 }
 
 
@@ -995,6 +2073,182 @@ void vtkMPIMoveData::RenderServerZeroBroadcast(vtkDataObject* data)
 
 
 
+//-----------------------------------------------------------------------------
+void vtkMPIMoveData::SendDataObject(vtkCommunicator* com, vtkDataObject* data,
+  int tag)
+{
+  this->ClearBuffer();
+
+  // Only the sends are timed, so that the measured bandwidth is that of the
+  // link and not of marshalling or compression.
+  double start = 0.0;
+  vtkIdType sent_length = 0;
+  vtkMPIMoveDataNativeWriter native;
+  if (native.Write(data) &&
+    vtkMPIMoveDataResolveCompressionMethod(vtkMPIMoveData::CompressionMethod,
+      native.GetContiguousLength(), vtkMPIMoveData::MeasuredBandwidth) ==
+    vtkMPIMoveData::COMPRESSION_NONE)
+    {
+    // Send the header followed by each array straight from its own memory,
+    // avoiding marshalling the data into an intermediate buffer. A negative
+    // number of buffers tells the receiver to expect this layout. The
+    // lengths of the header and of the arrays are sent first so that the
+    // receiver can drain the messages even if it fails to decode the header.
+    int numBuffers = -1;
+    std::vector<vtkIdType> lengths;
+    lengths.push_back(static_cast<vtkIdType>(native.Prefix.size()));
+    for (size_t cc=0; cc < native.Segments.size(); cc++)
+      {
+      if (native.Segments[cc].Length > 0)
+        {
+        lengths.push_back(native.Segments[cc].Length);
+        }
+      }
+    vtkIdType num_lengths = static_cast<vtkIdType>(lengths.size());
+    start = vtkTimerLog::GetUniversalTime();
+    com->Send(&numBuffers, 1, 1, tag);
+    com->Send(&num_lengths, 1, 1, tag+1);
+    com->Send(&lengths[0], num_lengths, 1, tag+1);
+    if (lengths[0] > 0)
+      {
+      com->Send(reinterpret_cast<const char*>(&native.Prefix[0]),
+        lengths[0], 1, tag+2);
+      }
+    for (size_t cc=0; cc < native.Segments.size(); cc++)
+      {
+      if (native.Segments[cc].Length > 0)
+        {
+        com->Send(static_cast<const char*>(native.Segments[cc].Pointer),
+          native.Segments[cc].Length, 1, tag+2);
+        }
+      }
+    for (vtkIdType cc=0; cc < num_lengths; cc++)
+      {
+      sent_length += lengths[cc];
+      }
+    }
+  else
+    {
+    this->MarshalDataToBuffer(data, vtkMPIMoveData::MeasuredBandwidth);
+    start = vtkTimerLog::GetUniversalTime();
+    com->Send(&(this->NumberOfBuffers), 1, 1, tag);
+    com->Send(this->BufferLengths, this->NumberOfBuffers, 1, tag+1);
+    com->Send(this->Buffers, this->BufferTotalLength, 1, tag+2);
+    sent_length = this->BufferTotalLength;
+    }
+  double elapsed = vtkTimerLog::GetUniversalTime() - start;
+  this->ClearBuffer();
+
+  // Keep track of the bandwidth of the link to pick a codec in automatic
+  // mode. Small messages are dominated by the latency and are ignored.
+  if (sent_length >= VTK_MPI_MOVE_DATA_AUTOMATIC_MINIMUM_LENGTH &&
+    elapsed > 0.0)
+    {
+    double bandwidth = sent_length / elapsed;
+    vtkMPIMoveData::MeasuredBandwidth =
+      vtkMPIMoveData::MeasuredBandwidth > 0.0?
+      0.7 * vtkMPIMoveData::MeasuredBandwidth + 0.3 * bandwidth : bandwidth;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkMPIMoveData::ReceiveDataObject(vtkCommunicator* com,
+  vtkDataObject* output, int tag)
+{
+  this->ClearBuffer();
+  com->Receive(&(this->NumberOfBuffers), 1, 1, tag);
+  if (this->NumberOfBuffers < 0)
+    {
+    this->NumberOfBuffers = 0;
+
+    // Native layout: the arrays are allocated from the header and each
+    // payload is received directly into the corresponding array.
+    vtkIdType num_lengths = 0;
+    com->Receive(&num_lengths, 1, 1, tag+1);
+    std::vector<vtkIdType> lengths(static_cast<size_t>(num_lengths));
+    if (num_lengths > 0)
+      {
+      com->Receive(&lengths[0], num_lengths, 1, tag+1);
+      }
+    vtkIdType prefix_length = num_lengths > 0? lengths[0] : 0;
+    std::vector<char> prefix(static_cast<size_t>(prefix_length));
+    if (prefix_length > 0)
+      {
+      com->Receive(&prefix[0], prefix_length, 1, tag+2);
+      }
+
+    vtkMPIMoveDataNativeReader native;
+    vtkSmartPointer<vtkDataObject> piece;
+    bool valid = (prefix_length > 0 &&
+      vtkMPIMoveDataNativeReader::GetPrefixLength(&prefix[0], prefix_length) ==
+      prefix_length);
+    if (valid)
+      {
+      piece = native.ReadPrefix(&prefix[0], prefix_length);
+      valid = native.IsValid();
+      }
+
+    // The arrays announced by the header must match the lengths sent.
+    std::vector<char*> targets;
+    for (size_t cc=0; valid && cc < native.Segments.size(); cc++)
+      {
+      if (native.Segments[cc].Length > 0)
+        {
+        valid = (targets.size() + 1 < lengths.size() &&
+          lengths[targets.size() + 1] == native.Segments[cc].Length);
+        targets.push_back(static_cast<char*>(native.Segments[cc].Pointer));
+        }
+      }
+    valid = valid && (targets.size() + 1 == lengths.size());
+    if (!valid)
+      {
+      // Drain the payloads already posted by the sender so that they are
+      // not mistaken for the next transfer.
+      std::vector<char> scratch;
+      for (size_t cc=1; cc < lengths.size(); cc++)
+        {
+        scratch.resize(static_cast<size_t>(lengths[cc]));
+        com->Receive(&scratch[0], lengths[cc], 1, tag+2);
+        }
+      vtkErrorMacro("Failed to decode data received in native format.");
+      output->Initialize();
+      return;
+      }
+    for (size_t cc=0; cc < targets.size(); cc++)
+      {
+      com->Receive(targets[cc], lengths[cc + 1], 1, tag+2);
+      }
+    native.Finalize();
+
+    if (piece)
+      {
+      std::vector<vtkSmartPointer<vtkDataObject> > pieces;
+      pieces.push_back(piece);
+      vtkMPIMoveDataMerge(pieces, output);
+      }
+    else
+      {
+      output->Initialize();
+      }
+    return;
+    }
+
+  this->BufferLengths = new vtkIdType[this->NumberOfBuffers];
+  com->Receive(this->BufferLengths, this->NumberOfBuffers, 1, tag+1);
+  // Compute additional buffer information.
+  this->BufferOffsets = new vtkIdType[this->NumberOfBuffers];
+  this->BufferTotalLength = 0;
+  for (int idx = 0; idx < this->NumberOfBuffers; ++idx)
+    {
+    this->BufferOffsets[idx] = this->BufferTotalLength;
+    this->BufferTotalLength += this->BufferLengths[idx];
+    }
+  this->Buffers = new char[this->BufferTotalLength];
+  com->Receive(this->Buffers, this->BufferTotalLength, 1, tag+2);
+  this->ReconstructDataFromBuffer(output);
+  this->ClearBuffer();
+}
+
 //-----------------------------------------------------------------------------
 void vtkMPIMoveData::ClearBuffer()
 {
@@ -1018,7 +2272,8 @@ void vtkMPIMoveData::ClearBuffer()
 }
 
 //-----------------------------------------------------------------------------
-void vtkMPIMoveData::MarshalDataToBuffer(vtkDataObject* data)
+void vtkMPIMoveData::MarshalDataToBuffer(vtkDataObject* data,
+  double linkBandwidth)
 {
   vtkDataSet* dataSet = vtkDataSet::SafeDownCast(data);
   vtkImageData* imageData = vtkImageData::SafeDownCast(data);
@@ -1031,62 +2286,68 @@ void vtkMPIMoveData::MarshalDataToBuffer(vtkDataObject* data)
     this->NumberOfBuffers = 0;
     }
 
-  // Copy input to isolate reader from the pipeline.
-  vtkDataWriter* writer = vtkGenericDataObjectWriter::New();
-  writer->SetInputData(data);
-  if (imageData)
+  char* raw_buffer = NULL;
+  vtkIdType raw_length = 0;
+
+  vtkMPIMoveDataNativeWriter native;
+  if (native.Write(data))
     {
-    // We add the image extents to the header, since the writer doesn't preserve
-    // the extents.
-    int *extent = imageData->GetExtent();
-    double* origin = imageData->GetOrigin();
-    vtksys_ios::ostringstream stream;
-    stream << "EXTENT " << extent[0] << " " <<
-      extent[1] << " " <<
-      extent[2] << " " <<
-      extent[3] << " " <<
-      extent[4] << " " <<
-      extent[5];
-    stream << " ORIGIN " << origin[0] << " " << origin[1] << " " << origin[2];
-    writer->SetHeader(stream.str().c_str());
+    raw_length = native.GetContiguousLength();
+    raw_buffer = new char[raw_length];
+    native.CopyToContiguous(raw_buffer);
     }
+  else
+    {
+    // Fallback to the legacy writer for types not supported by the native
+    // format. Copy input to isolate reader from the pipeline.
+    vtkDataWriter* writer = vtkGenericDataObjectWriter::New();
+    writer->SetInputData(data);
+    if (imageData)
+      {
+      // We add the image extents to the header, since the writer doesn't
+      // preserve the extents.
+      int *extent = imageData->GetExtent();
+      double* origin = imageData->GetOrigin();
+      vtksys_ios::ostringstream stream;
+      stream << "EXTENT " << extent[0] << " " <<
+        extent[1] << " " <<
+        extent[2] << " " <<
+        extent[3] << " " <<
+        extent[4] << " " <<
+        extent[5];
+      stream << " ORIGIN " << origin[0] << " " << origin[1] << " " << origin[2];
+      writer->SetHeader(stream.str().c_str());
+      }
 
-  writer->SetFileTypeToBinary();
-  writer->WriteToOutputStringOn();
-  writer->Write();
+    writer->SetFileTypeToBinary();
+    writer->WriteToOutputStringOn();
+    writer->Write();
+
+    raw_length = writer->GetOutputStringLength();
+    raw_buffer = writer->RegisterAndGetOutputString();
+    writer->Delete();
+    writer = 0;
+    }
 
   char* buffer =NULL;
   vtkIdType buffer_length = 0;
 
-  if (vtkMPIMoveData::UseZLibCompression)
+  int method = vtkMPIMoveDataResolveCompressionMethod(
+    vtkMPIMoveData::CompressionMethod, raw_length, linkBandwidth);
+  vtkMPIMoveDataCodecMap& codecs = vtkMPIMoveDataGetCodecs();
+  vtkMPIMoveDataCodecMap::iterator codec = codecs.find(method);
+  if (codec != codecs.end())
     {
-    vtkTimerLog::MarkStartEvent("Zlib compress");
-    // Use z-lib compression.
-    uLongf out_size =compressBound(writer->GetOutputStringLength());
-    buffer = new char[out_size + 8]; 
-    memcpy(buffer, "zlib0000", 8);
-
-    compress2(reinterpret_cast<Bytef*>(buffer + 8), 
-      &out_size,
-      reinterpret_cast<const Bytef*>(writer->GetOutputString()),
-      writer->GetOutputStringLength(), /* compression_level */ Z_DEFAULT_COMPRESSION);
-    vtkTimerLog::MarkEndEvent("Zlib compress");
-    int in_size = static_cast<int>(writer->GetOutputStringLength());
-    for (int cc=0; cc < 4; cc++)
-      {
-      // the first 4 bytes in the header are "zlib" which helps the receiver
-      // identify that zlib compression has been used.
-      // the next 4 bytes are the original length since zlib doesn't provide
-      // that to the receiver.
-      buffer[4+cc] = (in_size & 0x0ff);
-      in_size = in_size >> 8;
-      }
-    buffer_length = out_size + 8;
+    buffer = vtkMPIMoveDataCompress(codec->second, raw_buffer, raw_length,
+      vtkMPIMoveData::CompressionChunkSize, vtkMPIMoveData::UseByteShuffle,
+      buffer_length);
+    delete [] raw_buffer;
+    raw_buffer = NULL;
     }
   else
     {
-    buffer_length = writer->GetOutputStringLength();
-    buffer = writer->RegisterAndGetOutputString();
+    buffer_length = raw_length;
+    buffer = raw_buffer;
     }
 
   // Get string.
@@ -1097,9 +2358,6 @@ void vtkMPIMoveData::MarshalDataToBuffer(vtkDataObject* data)
   this->BufferOffsets[0] = 0;
   this->Buffers = buffer;
   this->BufferTotalLength = this->BufferLengths[0];
-
-  writer->Delete();
-  writer = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -1119,8 +2377,15 @@ void vtkMPIMoveData::ReconstructDataFromBuffer(vtkDataObject* data)
     char* bufferArray = this->Buffers+this->BufferOffsets[idx];
     vtkIdType bufferLength = this->BufferLengths[idx];
 
-    char* realBuffer = 0;
-    if (bufferLength > 4 && strncmp(bufferArray, "zlib", 4) == 0)
+    vtkIdType uncompressedLength = 0;
+    char* realBuffer = vtkMPIMoveDataUncompress(
+      bufferArray, bufferLength, uncompressedLength);
+    if (realBuffer)
+      {
+      bufferArray = realBuffer;
+      bufferLength = uncompressedLength;
+      }
+    else if (bufferLength > 4 && strncmp(bufferArray, "zlib", 4) == 0)
       {
       // sender used zlib compression. Decompress it.
       vtkIdType compressed_length = bufferLength - 8; // remove the zlib header.
@@ -1143,6 +2408,31 @@ void vtkMPIMoveData::ReconstructDataFromBuffer(vtkDataObject* data)
       bufferLength = uncompressed_length;
       }
 
+    vtkIdType prefix_length =
+      vtkMPIMoveDataNativeReader::GetPrefixLength(bufferArray, bufferLength);
+    if (prefix_length > 0)
+      {
+      vtkMPIMoveDataNativeReader native;
+      vtkSmartPointer<vtkDataObject> piece;
+      if (prefix_length <= bufferLength)
+        {
+        piece = native.ReadPrefix(bufferArray, prefix_length);
+        }
+      if (!native.IsValid() ||
+        !native.CopyFromContiguous(bufferArray, bufferLength, prefix_length))
+        {
+        vtkErrorMacro("Failed to decode data received in native format.");
+        }
+      else if (piece)
+        {
+        native.Finalize();
+        pieces.push_back(piece);
+        }
+      delete [] realBuffer;
+      realBuffer = 0;
+      continue;
+      }
+
     // Setup a reader.
     vtkDataReader *reader = vtkGenericDataObjectReader::New();
     reader->ReadFromInputStringOn();
@@ -1189,6 +2479,11 @@ void vtkMPIMoveData::ReconstructDataFromBuffer(vtkDataObject* data)
     realBuffer = 0;
     }
 
+  if (pieces.size() == 0)
+    {
+    data->Initialize();
+    return;
+    }
   vtkMPIMoveDataMerge(pieces, data);
 }
 
@@ -1201,6 +2496,9 @@ void vtkMPIMoveData::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "MoveMode: " << this->MoveMode << endl;
   os << indent << "SkipDataServerGatherToZero: " <<
     this->SkipDataServerGatherToZero << endl;
+  os << indent << "CompressionMethod: " << vtkMPIMoveData::CompressionMethod
+    << endl;
+  os << indent << "UseByteShuffle: " << vtkMPIMoveData::UseByteShuffle << endl;
   os << indent << "OutputDataType: ";
   if (this->OutputDataType == VTK_POLY_DATA)
     {
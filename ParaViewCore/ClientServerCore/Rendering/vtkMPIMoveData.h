@@ -19,6 +19,19 @@
 // processes. It can redistributed polydata from M to N processors.
 // Update: This filter can now support delivering vtkUniformGridAMR datasets in
 // PASS_THROUGH and/or COLLECT modes.
+//
+// vtkPolyData, vtkUnstructuredGrid, vtkImageData and vtkMultiBlockDataSet (or
+// vtkMultiPieceDataSet) made of those are marshalled in a native binary format
+// made of a compact header followed by the raw array memory. Other types go
+// through vtkGenericDataObjectWriter/vtkGenericDataObjectReader. When sending
+// over sockets without compression, the arrays are sent from and received
+// into their own memory without any intermediate buffer.
+//
+// Marshalled buffers can be compressed with any codec registered using
+// RegisterCompressor(). Buffers are split in chunks that are compressed
+// concurrently, optionally after shuffling the bytes of each word so that
+// similar bytes of consecutive floats end up next to each other. The codec
+// used is identified by a 4 character tag at the beginning of the buffer.
 
 #ifndef __vtkMPIMoveData_h
 #define __vtkMPIMoveData_h
@@ -26,6 +39,8 @@
 #include "vtkPVClientServerCoreRenderingModule.h" //needed for exports
 #include "vtkPassInputTypeAlgorithm.h"
 
+class vtkCommunicator;
+class vtkDataCompressor;
 class vtkMultiProcessController;
 class vtkSocketController;
 class vtkMPIMToNSocketConnection;
@@ -93,9 +108,62 @@ public:
   // When set to true, zlib compression is used. False by default.
   // This value has any effect only on the data-sender processes. The receiver
   // always checks the received data to see if zlib decompression is required.
+  // This is the same as setting the compression method to COMPRESSION_ZLIB or
+  // COMPRESSION_NONE.
   static void SetUseZLibCompression(bool b);
   static bool GetUseZLibCompression();
 
+//BTX
+  enum CompressionMethods {
+    COMPRESSION_NONE=0,
+    COMPRESSION_ZLIB=1,
+    COMPRESSION_LZ=2,
+    COMPRESSION_AUTOMATIC=3,
+    COMPRESSION_USER=16
+  };
+//ETX
+
+  // Description:
+  // Set the codec used to compress the data sent. COMPRESSION_AUTOMATIC picks,
+  // for each transfer over a socket, the codec (or no compression) expected to
+  // deliver the data the fastest given the measured bandwidth of the link and
+  // the measured ratio and throughput of each codec. Transfers between the
+  // processes of a server are never compressed in that mode. Values returned by
+  // RegisterCompressor() are accepted too. Like UseZLibCompression, this
+  // affects the data-sender processes only. Default is COMPRESSION_NONE.
+  static void SetCompressionMethod(int method);
+  static int GetCompressionMethod();
+
+  // Description:
+  // When set, bytes are shuffled by 4-byte words before compression which
+  // generally improves the compression of float arrays. True by default, as
+  // is the GeometryCompressionByteShuffle setting.
+  static void SetUseByteShuffle(bool b);
+  static bool GetUseByteShuffle();
+
+  // Description:
+  // Size (in bytes) of the chunks compressed concurrently. Default is 1MB.
+  static void SetCompressionChunkSize(vtkIdType size);
+  static vtkIdType GetCompressionChunkSize();
+
+  // Description:
+  // Returns the bandwidth (in bytes per second) measured on the sockets data
+  // was last sent over, or 0 if none has been measured yet.
+  static double GetMeasuredBandwidth();
+
+//BTX
+  // Description:
+  // Register a codec. \c tag is the 4 character tag written at the beginning
+  // of the buffers compressed with this codec; the receiving processes must
+  // register the same codec with the same tag. \c newCompressor must return a
+  // new instance for every call since chunks are compressed concurrently.
+  // Returns the value to pass to SetCompressionMethod() to use the codec, or
+  // -1 if the tag is invalid. Registering an existing tag replaces the codec.
+  typedef vtkDataCompressor* (*CompressorNewFunction)();
+  static int RegisterCompressor(const char* tag,
+    CompressorNewFunction newCompressor);
+//ETX
+
   // Description:
   // vtkMPIMoveData doesn't necessarily generate a valid output data on all the
   // involved processes (depending on the MoveMode and Server ivars). This
@@ -147,6 +215,12 @@ protected:
   void DataServerSendToClient(vtkDataObject* output);
   void ClientReceiveFromDataServer(vtkDataObject* output);
 
+  // Description:
+  // Send/receive a data object over a point-to-point communicator. \c tag is
+  // the first of the 3 consecutive tags used for the transfer.
+  void SendDataObject(vtkCommunicator* com, vtkDataObject* data, int tag);
+  void ReceiveDataObject(vtkCommunicator* com, vtkDataObject* output, int tag);
+
   int        NumberOfBuffers;
   vtkIdType* BufferLengths;
   vtkIdType* BufferOffsets;
@@ -154,7 +228,13 @@ protected:
   vtkIdType  BufferTotalLength;
 
   void ClearBuffer();
-  void MarshalDataToBuffer(vtkDataObject* data);
+
+  // Description:
+  // \c linkBandwidth is the bandwidth (in bytes per second) of the link the
+  // buffer is going to be sent over. It is used to pick the codec when the
+  // compression method is COMPRESSION_AUTOMATIC; 0 disables compression in
+  // that mode.
+  void MarshalDataToBuffer(vtkDataObject* data, double linkBandwidth=0.0);
   void ReconstructDataFromBuffer(vtkDataObject* data);
 
   int MoveMode;
@@ -178,7 +258,10 @@ private:
   vtkMPIMoveData(const vtkMPIMoveData&); // Not implemented
   void operator=(const vtkMPIMoveData&); // Not implemented
 
-  static bool UseZLibCompression;
+  static int CompressionMethod;
+  static bool UseByteShuffle;
+  static vtkIdType CompressionChunkSize;
+  static double MeasuredBandwidth;
 };
 
 #endif
@@ -14,34 +14,145 @@
 =========================================================================*/
 #include "vtkPVCacheKeeper.h"
 
+#include "vtkAlgorithmOutput.h"
 #include "vtkCacheSizeKeeper.h"
 #include "vtkDataObject.h"
+#include "vtkDemandDrivenPipeline.h"
 #include "vtkInformation.h"
+#include "vtkInformationIdTypeKey.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkProcessModule.h"
 #include "vtkPVCacheKeeperPipeline.h"
 #include "vtkSmartPointer.h"
 
+#include <algorithm>
 #include <map>
-//----------------------------------------------------------------------------
-class vtkPVCacheKeeper::vtkCacheMap :
-  public std::map<double, vtkSmartPointer<vtkDataObject> >
+#include <set>
+#include <string>
+#include <vector>
+
+namespace
 {
-public:
-  unsigned long GetActualMemorySize() 
+  // Entries are keyed by the id of the source of the keeper (or of the keeper
+  // itself when it has none), the signature of the source and the cache time.
+  typedef std::pair<std::pair<vtkIdType, std::string>, double>
+    vtkPVCacheKeeperKey;
+
+  // Ids are never reused, unlike the addresses of deleted sources.
+  vtkIdType vtkPVCacheKeeperNextId()
     {
-    unsigned long actual_size = 0;
-    vtkCacheMap::iterator iter;
-    for (iter = this->begin(); iter != this->end(); ++iter)
+    static vtkIdType nextId = 0;
+    return ++nextId;
+    }
+
+  struct vtkPVCacheKeeperEntry
+    {
+    vtkSmartPointer<vtkDataObject> Data;
+    // Size (in KBs) reported to SizeKeeper.
+    unsigned long Size;
+    vtkCacheSizeKeeper* SizeKeeper;
+    // Pipeline MTime of the source when the data was cached. Keepers that
+    // don't own the entry only use it if the source was not modified since.
+    unsigned long ProducerMTime;
+    std::set<vtkPVCacheKeeper*> Owners;
+    vtkTypeUInt64 LastAccess;
+    vtkTypeUInt64 AccessCount;
+
+    vtkPVCacheKeeperEntry() : Size(0), SizeKeeper(NULL), ProducerMTime(0),
+      LastAccess(0), AccessCount(0) {}
+    };
+
+  class vtkPVCacheKeeperStore :
+    public std::map<vtkPVCacheKeeperKey, vtkPVCacheKeeperEntry>
+  {
+  public:
+    vtkPVCacheKeeperStore() : Clock(0) {}
+
+    void Touch(vtkPVCacheKeeperEntry& entry)
+      {
+      entry.LastAccess = ++this->Clock;
+      entry.AccessCount++;
+      }
+
+    void Erase(iterator iter)
       {
-      actual_size += iter->second.GetPointer()->GetActualMemorySize();
+      if (iter->second.SizeKeeper && iter->second.Size > 0)
+        {
+        iter->second.SizeKeeper->FreeCacheSize(iter->second.Size);
+        }
+      this->erase(iter);
       }
-    return actual_size;
+
+    vtkTypeUInt64 Clock;
+  };
+
+  // The cache shared by all the keepers of the process.
+  vtkPVCacheKeeperStore& vtkPVCacheKeeperGetStore()
+    {
+    static vtkPVCacheKeeperStore store;
+    return store;
+    }
+
+
+  // Orders entries from the first to the last to discard.
+  class vtkPVCacheKeeperEvictionOrder
+    {
+  public:
+    int Policy;
+    vtkPVCacheKeeperEvictionOrder(int policy) : Policy(policy) {}
+    bool operator()(vtkPVCacheKeeperStore::iterator a,
+      vtkPVCacheKeeperStore::iterator b) const
+      {
+      if (this->Policy == vtkCacheSizeKeeper::LEAST_FREQUENTLY_USED &&
+        a->second.AccessCount != b->second.AccessCount)
+        {
+        return a->second.AccessCount < b->second.AccessCount;
+        }
+      return a->second.LastAccess < b->second.LastAccess;
+      }
+    };
+
+  void vtkPVCacheKeeperGetEvictionOrder(int policy,
+    std::vector<vtkPVCacheKeeperStore::iterator>& order)
+    {
+    vtkPVCacheKeeperStore& store = vtkPVCacheKeeperGetStore();
+    order.clear();
+    order.reserve(store.size());
+    for (vtkPVCacheKeeperStore::iterator iter = store.begin();
+      iter != store.end(); ++iter)
+      {
+      order.push_back(iter);
+      }
+    std::sort(order.begin(), order.end(),
+      vtkPVCacheKeeperEvictionOrder(policy));
+    }
+}
+
+//----------------------------------------------------------------------------
+// Keys of the entries owned by a keeper, and the source of the keeper. Only
+// the id and the pipeline MTime of the source are kept since the keeper does
+// not hold a reference to it.
+class vtkPVCacheKeeper::vtkCacheMap : public std::set<vtkPVCacheKeeperKey>
+{
+public:
+  vtkIdType Id;
+  vtkIdType SourceId;
+  std::string Signature;
+  unsigned long SourceMTime;
+
+  vtkCacheMap() : Id(vtkPVCacheKeeperNextId()), SourceId(0), SourceMTime(0) {}
+
+  vtkPVCacheKeeperKey GetKey(double cacheTime)
+    {
+    vtkIdType id = this->SourceId? this->SourceId : this->Id;
+    return vtkPVCacheKeeperKey(
+      std::pair<vtkIdType, std::string>(id, this->Signature), cacheTime);
     }
 };
 
 vtkStandardNewMacro(vtkPVCacheKeeper);
+vtkInformationKeyMacro(vtkPVCacheKeeper, SOURCE_ID, IdType);
 vtkCxxSetObjectMacro(vtkPVCacheKeeper, CacheSizeKeeper, vtkCacheSizeKeeper);
 //----------------------------------------------------------------------------
 vtkPVCacheKeeper::vtkPVCacheKeeper()
@@ -65,17 +176,52 @@ vtkPVCacheKeeper::~vtkPVCacheKeeper()
   this->Cache = 0;
 }
 
+//----------------------------------------------------------------------------
+void vtkPVCacheKeeper::SetCacheSource(
+  vtkAlgorithmOutput* source, const char* signature)
+{
+  this->Cache->SourceId = 0;
+  this->Cache->Signature = signature? signature : "";
+  this->Cache->SourceMTime = 0;
+  if (source && source->GetProducer())
+    {
+    vtkAlgorithm* producer = source->GetProducer();
+    // The id lives in the information of the output port, so it goes away
+    // with the producer and a new producer at the same address gets a new one.
+    vtkInformation* portInfo =
+      producer->GetOutputPortInformation(source->GetIndex());
+    if (!portInfo->Has(vtkPVCacheKeeper::SOURCE_ID()))
+      {
+      portInfo->Set(vtkPVCacheKeeper::SOURCE_ID(), vtkPVCacheKeeperNextId());
+      }
+    this->Cache->SourceId = portInfo->Get(vtkPVCacheKeeper::SOURCE_ID());
+    vtkDemandDrivenPipeline* ddp =
+      vtkDemandDrivenPipeline::SafeDownCast(producer->GetExecutive());
+    this->Cache->SourceMTime =
+      ddp? ddp->GetPipelineMTime() : producer->GetMTime();
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkPVCacheKeeper::RemoveAllCaches()
 {
   // cout << this << " RemoveAllCaches" << endl;
-  unsigned long freed_size = this->Cache->GetActualMemorySize();
-  this->Cache->clear();
-  if (freed_size > 0 && this->CacheSizeKeeper)
+  vtkPVCacheKeeperStore& store = vtkPVCacheKeeperGetStore();
+  vtkCacheMap::iterator key;
+  for (key = this->Cache->begin(); key != this->Cache->end(); ++key)
     {
-    // Tell the cache size keeper about the newly freed memory size.
-    this->CacheSizeKeeper->FreeCacheSize(freed_size);
+    vtkPVCacheKeeperStore::iterator iter = store.find(*key);
+    if (iter != store.end())
+      {
+      iter->second.Owners.erase(this);
+      if (iter->second.Owners.empty())
+        {
+        // Tell the cache size keeper about the newly freed memory size.
+        store.Erase(iter);
+        }
+      }
     }
+  this->Cache->clear();
 
   // this method should never mark the filter modified !!!
 }
@@ -83,30 +229,115 @@ void vtkPVCacheKeeper::RemoveAllCaches()
 //----------------------------------------------------------------------------
 bool vtkPVCacheKeeper::IsCached(double cacheTime)
 {
-  vtkPVCacheKeeper::vtkCacheMap::iterator iter = this->Cache->find(cacheTime);
-  return (iter != this->Cache->end());
+  vtkPVCacheKeeperStore& store = vtkPVCacheKeeperGetStore();
+  vtkPVCacheKeeperStore::iterator iter =
+    store.find(this->Cache->GetKey(cacheTime));
+  if (iter == store.end())
+    {
+    return false;
+    }
+  return (iter->second.Owners.find(this) != iter->second.Owners.end() ||
+    (this->Cache->SourceId != 0 &&
+     iter->second.ProducerMTime == this->Cache->SourceMTime));
 }
 
 //----------------------------------------------------------------------------
 bool vtkPVCacheKeeper::SaveData(vtkDataObject* output)
 {
+  if (this->CacheSizeKeeper && this->CacheSizeKeeper->GetCacheLimit() == 0)
+    {
+    // caching is disabled.
+    return false;
+    }
   if (!this->CacheSizeKeeper  || !this->CacheSizeKeeper->GetCacheFull())
     {
     vtkSmartPointer<vtkDataObject> cache;
     cache.TakeReference(output->NewInstance());
     cache->ShallowCopy(output);
-    (*this->Cache)[this->CacheTime] = cache;
+
+    vtkPVCacheKeeperKey key = this->Cache->GetKey(this->CacheTime);
+    vtkPVCacheKeeperStore& store = vtkPVCacheKeeperGetStore();
+    vtkPVCacheKeeperStore::iterator iter = store.find(key);
+    if (iter == store.end())
+      {
+      iter = store.insert(vtkPVCacheKeeperStore::value_type(
+          key, vtkPVCacheKeeperEntry())).first;
+      }
+    else if (iter->second.SizeKeeper && iter->second.Size > 0)
+      {
+      // the source was modified since the entry was saved by another
+      // keeper, the entry is replaced.
+      iter->second.SizeKeeper->FreeCacheSize(iter->second.Size);
+      }
+    vtkPVCacheKeeperEntry& entry = iter->second;
+    entry.Data = cache;
+    entry.Size = cache->GetActualMemorySize();
+    entry.SizeKeeper = this->CacheSizeKeeper;
+    entry.ProducerMTime = this->Cache->SourceMTime;
+    entry.Owners.insert(this);
+    store.Touch(entry);
+    this->Cache->insert(key);
 
     if (this->CacheSizeKeeper)
       {
       // Register used cache size.
-      this->CacheSizeKeeper->AddCacheSize(cache->GetActualMemorySize());
+      this->CacheSizeKeeper->AddCacheSize(entry.Size);
       }
     return true;
     }
   return false;
 }
 
+//----------------------------------------------------------------------------
+vtkIdType vtkPVCacheKeeper::GetNumberOfEntriesToEvict(
+  unsigned long limit, int evictionPolicy)
+{
+  if (evictionPolicy == vtkCacheSizeKeeper::NO_EVICTION)
+    {
+    return 0;
+    }
+
+  std::vector<vtkPVCacheKeeperStore::iterator> order;
+  vtkPVCacheKeeperGetEvictionOrder(evictionPolicy, order);
+
+  unsigned long size = 0;
+  for (size_t cc = 0; cc < order.size(); ++cc)
+    {
+    size += order[cc]->second.Size;
+    }
+  vtkIdType count = 0;
+  while (size > limit && count < static_cast<vtkIdType>(order.size()))
+    {
+    size -= order[count]->second.Size;
+    count++;
+    }
+  return count;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVCacheKeeper::EvictEntries(vtkIdType count, int evictionPolicy)
+{
+  if (count <= 0 || evictionPolicy == vtkCacheSizeKeeper::NO_EVICTION)
+    {
+    return;
+    }
+
+  std::vector<vtkPVCacheKeeperStore::iterator> order;
+  vtkPVCacheKeeperGetEvictionOrder(evictionPolicy, order);
+  vtkPVCacheKeeperStore& store = vtkPVCacheKeeperGetStore();
+  for (vtkIdType cc = 0;
+    cc < count && cc < static_cast<vtkIdType>(order.size()); ++cc)
+    {
+    std::set<vtkPVCacheKeeper*>::iterator owner;
+    for (owner = order[cc]->second.Owners.begin();
+      owner != order[cc]->second.Owners.end(); ++owner)
+      {
+      (*owner)->Cache->erase(order[cc]->first);
+      }
+    store.Erase(order[cc]);
+    }
+}
+
 //----------------------------------------------------------------------------
 vtkExecutive* vtkPVCacheKeeper::CreateDefaultExecutive()
 {
@@ -162,7 +393,14 @@ int vtkPVCacheKeeper::RequestData(vtkInformation* vtkNotUsed(reqInfo),
     {
     if (this->IsCached(this->CacheTime))
       {
-      output->ShallowCopy((*this->Cache)[this->CacheTime]);
+      vtkPVCacheKeeperKey key = this->Cache->GetKey(this->CacheTime);
+      vtkPVCacheKeeperStore& store = vtkPVCacheKeeperGetStore();
+      vtkPVCacheKeeperEntry& entry = store[key];
+      // the entry may have been cached by another keeper with the same source.
+      entry.Owners.insert(this);
+      this->Cache->insert(key);
+      store.Touch(entry);
+      output->ShallowCopy(entry.Data);
       //cout << this << " using Cache: " << this->CacheTime << endl;
       }
     else
@@ -184,6 +422,9 @@ int vtkPVCacheKeeper::RequestData(vtkInformation* vtkNotUsed(reqInfo),
 void vtkPVCacheKeeper::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "CachingEnabled: " << this->CachingEnabled << endl;
+  os << indent << "CacheTime: " << this->CacheTime << endl;
+  os << indent << "NumberOfCachedTimes: " << this->Cache->size() << endl;
 }
 
 
@@ -20,6 +20,14 @@
 // then this filter shuts the update request, otherwise propagates the update
 // and then cache the result for later use.  The current time step is set using
 // SetCacheTime().
+//
+// Cached data is stored in a cache shared by all the vtkPVCacheKeeper
+// instances of the process, keyed by the source set with SetCacheSource() and
+// the cache time. Representations of the same upstream output port that
+// process it the same way hence share the data cached for a given time. The
+// cache records how recently and
+// how frequently each entry is used so that vtkPVView can discard entries
+// when the cache exceeds the limit set on vtkCacheSizeKeeper.
 // .SECTION See Also
 // vtkPVCacheKeeperPipeline
 
@@ -30,6 +38,7 @@
 #include "vtkDataObjectAlgorithm.h"
 
 class vtkCacheSizeKeeper;
+class vtkInformationIdTypeKey;
 
 class VTKPVCLIENTSERVERCORERENDERING_EXPORT vtkPVCacheKeeper : public vtkDataObjectAlgorithm
 {
@@ -61,6 +70,36 @@ public:
   vtkGetMacro(CachingEnabled, bool);
   vtkBooleanMacro(CachingEnabled, bool);
 
+  // Description:
+  // Set the output port upstream of the representation using this keeper,
+  // and a signature of what the representation does to the data before it
+  // reaches the keeper. Keepers with the same source and signature share the
+  // data cached for a given time, as long as the upstream pipeline was not
+  // modified since it was cached. Representations call this before each
+  // Update(). Without a source, a keeper only uses the data it cached itself.
+  void SetCacheSource(vtkAlgorithmOutput* source, const char* signature);
+
+  // Description:
+  // Key set on the information of an output port passed to SetCacheSource()
+  // to identify it in the cache. Ids are unique for the life of the process,
+  // so a source allocated where a deleted one was never sees its entries.
+  static vtkInformationIdTypeKey* SOURCE_ID();
+
+  // Description:
+  // Returns the number of entries of the cache of this process that need to
+  // be discarded, in the order set by \c evictionPolicy (see
+  // vtkCacheSizeKeeper::EvictionPolicies), for the cache to fit in \c limit
+  // KBs.
+  static vtkIdType GetNumberOfEntriesToEvict(unsigned long limit,
+    int evictionPolicy);
+
+  // Description:
+  // Discards the first \c count entries of the cache of this process in the
+  // order set by \c evictionPolicy. Since the entries are used in the same
+  // order on all processes, discarding the same number of entries on all
+  // processes keeps the processes in agreement on what is cached.
+  static void EvictEntries(vtkIdType count, int evictionPolicy);
+
 //BTX
 protected:
   vtkPVCacheKeeper();
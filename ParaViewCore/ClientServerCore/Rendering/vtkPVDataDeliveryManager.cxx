@@ -27,6 +27,7 @@
 #include "vtkPVDataRepresentation.h"
 #include "vtkPVRenderView.h"
 #include "vtkPVStreamingMacros.h"
+#include "vtkPVTimerInformation.h"
 #include "vtkPVTrivialProducer.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
@@ -93,6 +94,10 @@ public:
     // Data object for a streamed piece.
     vtkSmartPointer<vtkDataObject> StreamedPiece;
 
+    // Filter redistributing the data. It is kept so that it can reuse the
+    // regions it assigned to the cells.
+    vtkSmartPointer<vtkOrderedCompositeDistributor> Redistributor;
+
     unsigned long TimeStamp;
     unsigned long ActualMemorySize;
   public:
@@ -150,6 +155,16 @@ public:
       return this->RedistributedDataObject.GetPointer();
       }
 
+    vtkOrderedCompositeDistributor* GetRedistributor()
+      {
+      if (!this->Redistributor)
+        {
+        this->Redistributor =
+          vtkSmartPointer<vtkOrderedCompositeDistributor>::New();
+        }
+      return this->Redistributor.GetPointer();
+      }
+
     vtkPVTrivialProducer* GetProducer(bool use_redistributed_data)
       {
       if (use_redistributed_data && this->Redistributable)
@@ -223,6 +238,9 @@ public:
     }
 
   ItemsMapType ItemsMap;
+
+  // Kept so that the kd-tree can be reused when the data barely changes.
+  vtkSmartPointer<vtkKdTreeManager> KdTreeManager;
 };
 
 //*****************************************************************************
@@ -232,6 +250,7 @@ vtkStandardNewMacro(vtkPVDataDeliveryManager);
 vtkPVDataDeliveryManager::vtkPVDataDeliveryManager()
   : Internals(new vtkInternals())
 {
+  this->KdTreeReuseTolerance = 0.01;
 }
 
 //----------------------------------------------------------------------------
@@ -558,10 +577,24 @@ void vtkPVDataDeliveryManager::RedistributeDataForOrderedCompositing(
   if (this->RenderView->GetUpdateTimeStamp() > this->RedistributionTimeStamp)
     {
     vtkTimerLog::MarkStartEvent("Regenerate Kd-Tree");
+    vtkNew<vtkTimerLog> timer;
+    timer->StartTimer();
     // need to re-generate the kd-tree.
     this->RedistributionTimeStamp.Modified();
 
-    vtkNew<vtkKdTreeManager> cutsGenerator;
+    if (!this->Internals->KdTreeManager)
+      {
+      this->Internals->KdTreeManager = vtkSmartPointer<vtkKdTreeManager>::New();
+      }
+    vtkKdTreeManager* cutsGenerator = this->Internals->KdTreeManager;
+    cutsGenerator->RemoveAllDataObjects();
+    cutsGenerator->SetReuseTolerance(this->KdTreeReuseTolerance);
+    const int defaultExtent[6] = { 0, 1, 0, 1, 0, 1 };
+    const double defaultOrigin[3] = { 0, 0, 0 };
+    const double defaultSpacing[3] = { 1, 1, 1 };
+    cutsGenerator->SetStructuredDataInformation(
+      NULL, defaultExtent, defaultOrigin, defaultSpacing);
+
     vtkInternals::ItemsMapType::iterator iter;
     for (iter = this->Internals->ItemsMap.begin();
       iter != this->Internals->ItemsMap.end(); ++iter)
@@ -588,6 +621,10 @@ void vtkPVDataDeliveryManager::RedistributeDataForOrderedCompositing(
     cutsGenerator->GenerateKdTree();
     this->KdTree = cutsGenerator->GetKdTree();
 
+    timer->StopTimer();
+    vtkPVTimerInformation::AddRedistributionTime(
+      cutsGenerator->GetKdTreeReused()? "Reuse Kd-Tree" : "Regenerate Kd-Tree",
+      timer->GetElapsedTime());
     vtkTimerLog::MarkEndEvent("Regenerate Kd-Tree");
     }
 
@@ -631,13 +668,32 @@ void vtkPVDataDeliveryManager::RedistributeDataForOrderedCompositing(
     // release old memory (not necessarily, but try).
     item.SetRedistributedDataObject(NULL);
 
-    vtkNew<vtkOrderedCompositeDistributor> redistributor;
+    vtkOrderedCompositeDistributor* redistributor = item.GetRedistributor();
     redistributor->SetController(vtkMultiProcessController::GetGlobalController());
     redistributor->SetInputData(item.GetDeliveredDataObject());
     redistributor->SetPKdTree(this->KdTree);
     redistributor->SetPassThrough(0);
+    // the kd-tree may have been rebuilt in place.
+    redistributor->Modified();
     redistributor->Update();
-    item.SetRedistributedDataObject(redistributor->GetOutputDataObject(0));
+
+    // the redistributor's output is reused on the next update, hand over a
+    // copy.
+    vtkDataObject* output = redistributor->GetOutputDataObject(0);
+    vtkSmartPointer<vtkDataObject> redistributed;
+    redistributed.TakeReference(output->NewInstance());
+    redistributed->ShallowCopy(output);
+    item.SetRedistributedDataObject(redistributed);
+
+    vtkPVTimerInformation::AddRedistributionTime("Assign Cells to Regions",
+      redistributor->GetAssignmentTime(),
+      redistributor->GetNumberOfKeptCells() +
+      redistributor->GetNumberOfExchangedCells());
+    vtkPVTimerInformation::AddRedistributionTime("Exchange Cells",
+      redistributor->GetExchangeTime(),
+      redistributor->GetNumberOfExchangedCells());
+    vtkPVTimerInformation::AddRedistributionTime("Merge Cells",
+      redistributor->GetMergeTime(), redistributor->GetNumberOfKeptCells());
     }
   vtkTimerLog::MarkEndEvent("Redistributing Data for Ordered Compositing");
 }
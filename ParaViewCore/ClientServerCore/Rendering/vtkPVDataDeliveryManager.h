@@ -128,9 +128,17 @@ public:
 
   // Description:
   // Called by the view on ever render when ordered compositing is to be used to
-  // ensure that the geometries are redistributed, as needed.
+  // ensure that the geometries are redistributed, as needed. The time spent in
+  // each phase of the redistribution is accumulated in vtkPVTimerInformation.
   void RedistributeDataForOrderedCompositing(bool use_lod);
 
+  // Description:
+  // Get/Set the relative tolerance within which changes of the bounds and of
+  // the number of cells of the redistributable data keep the current kd-tree
+  // (see vtkKdTreeManager::SetReuseTolerance()). Default is 0.01.
+  vtkSetClampMacro(KdTreeReuseTolerance, double, 0.0, 1.0);
+  vtkGetMacro(KdTreeReuseTolerance, double);
+
   // Description:
   // Pass the structured-meta-data for determining rendering order for ordered
   // compositing.
@@ -191,6 +199,7 @@ protected:
 
   vtkWeakPointer<vtkPVRenderView> RenderView;
   vtkSmartPointer<vtkPKdTree> KdTree;
+  double KdTreeReuseTolerance;
 
   vtkTimeStamp RedistributionTimeStamp;
 private:
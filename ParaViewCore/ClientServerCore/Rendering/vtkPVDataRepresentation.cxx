@@ -196,6 +196,28 @@ bool vtkPVDataRepresentation::GetUsingCacheForUpdate()
   return false;
 }
 
+//----------------------------------------------------------------------------
+bool vtkPVDataRepresentation::Prefetch(double time)
+{
+  if (!this->GetVisibility() || !this->UseCache || this->ForceUseCache ||
+    !this->UpdateTimeValid || this->NeedUpdate ||
+    !this->IsCached(this->CacheKey) || this->IsCached(time))
+    {
+    return false;
+    }
+
+  double updateTime = this->UpdateTime;
+  double cacheKey = this->CacheKey;
+  this->SetUpdateTime(time);
+  this->SetCacheKey(time);
+  this->Update();
+
+  this->SetUpdateTime(updateTime);
+  this->SetCacheKey(cacheKey);
+  this->Update();
+  return true;
+}
+
 //----------------------------------------------------------------------------
 vtkAlgorithmOutput* vtkPVDataRepresentation::GetInternalOutputPort(int port,
                                                                    int conn)
@@ -140,6 +140,14 @@ public:
   // entry is cached.
   bool GetUsingCacheForUpdate();
 
+  // Description:
+  // Updates the representation for \c time and caches the result under the
+  // cache key \c time, then goes back to the current time. This is only done
+  // when the representation is visible, up to date and its current time is
+  // cached, so that going back doesn't execute the pipeline. Returns true if
+  // \c time was updated. Called by vtkPVView::Prefetch().
+  virtual bool Prefetch(double time);
+
   vtkGetMacro(NeedUpdate,  bool);
 
   // Description:
@@ -140,10 +140,12 @@ vtkStandardNewMacro(vtkPVRenderView);
 vtkInformationKeyMacro(vtkPVRenderView, USE_LOD, Integer);
 vtkInformationKeyMacro(vtkPVRenderView, USE_OUTLINE_FOR_LOD, Integer);
 vtkInformationKeyMacro(vtkPVRenderView, LOD_RESOLUTION, Double);
+vtkInformationKeyMacro(vtkPVRenderView, LOD_LEVEL_CHANGE, Integer);
 vtkInformationKeyMacro(vtkPVRenderView, NEED_ORDERED_COMPOSITING, Integer);
 vtkInformationKeyMacro(vtkPVRenderView, RENDER_EMPTY_IMAGES, Integer);
 vtkInformationKeyMacro(vtkPVRenderView, REQUEST_STREAMING_UPDATE, Request);
 vtkInformationKeyMacro(vtkPVRenderView, REQUEST_PROCESS_STREAMED_PIECE, Request);
+vtkInformationKeyMacro(vtkPVRenderView, REQUEST_PREPARE_LOD, Request);
 vtkInformationKeyRestrictedMacro(
   vtkPVRenderView, VIEW_PLANES, DoubleVector, 24);
 
@@ -169,6 +171,10 @@ vtkPVRenderView::vtkPVRenderView()
   this->StillRenderProcesses = vtkPVSession::NONE;
   this->InteractiveRenderProcesses = vtkPVSession::NONE;
   this->UsedLODForLastRender = false;
+  this->LODPending = false;
+  this->LODLevelChange = 0;
+  this->LODCoarserLevelAvailable = false;
+  this->LODFinerLevelAvailable = false;
   this->UseLODForInteractiveRender = false;
   this->UseDistributedRenderingForStillRender = false;
   this->UseDistributedRenderingForInteractiveRender = false;
@@ -1045,6 +1051,15 @@ void vtkPVRenderView::Update()
   // Synchronize data bounds.
   this->SynchronizeGeometryBounds();
 
+  // Let representations start decimating the new geometry now rather than on
+  // the first interaction.
+  if (this->UseLODForInteractiveRender && !this->UseOutlineForLODRendering)
+    {
+    this->RequestInformation->Set(LOD_RESOLUTION(), this->LODResolution);
+    this->CallProcessViewRequest(vtkPVRenderView::REQUEST_PREPARE_LOD(),
+      this->RequestInformation, this->ReplyInformationVector);
+    }
+
   vtkTimerLog::MarkEndEvent("RenderView::Update");
 
   this->UpdateTimeStamp.Modified();
@@ -1070,6 +1085,7 @@ void vtkPVRenderView::UpdateLOD()
   // Update LOD geometry.
 
   this->RequestInformation->Set(LOD_RESOLUTION(), this->LODResolution);
+  this->RequestInformation->Set(LOD_LEVEL_CHANGE(), this->LODLevelChange);
   if (this->UseOutlineForLODRendering)
     {
     this->RequestInformation->Set(USE_OUTLINE_FOR_LOD(), 1);
@@ -1078,11 +1094,29 @@ void vtkPVRenderView::UpdateLOD()
   // reset flags that representations set in REQUEST_UPDATE_LOD() pass.
   this->DistributedRenderingRequiredLOD = false;
   this->NonDistributedRenderingRequiredLOD = false;
+  this->LODPending = false;
+  this->LODCoarserLevelAvailable = false;
+  this->LODFinerLevelAvailable = false;
 
   this->CallProcessViewRequest(
     vtkPVView::REQUEST_UPDATE_LOD(),
     this->RequestInformation, this->ReplyInformationVector);
 
+  // LOD geometries are generated in the background on the data-server. Let
+  // all processes know if some of them are still being generated.
+  vtkIdType lod_pending = this->LODPending? 1 : 0;
+  this->SynchronizedWindows->Reduce(lod_pending,
+    vtkPVSynchronizedRenderWindows::MAX_OP);
+  this->LODPending = (lod_pending != 0);
+  vtkIdType lod_coarser = this->LODCoarserLevelAvailable? 1 : 0;
+  this->SynchronizedWindows->Reduce(lod_coarser,
+    vtkPVSynchronizedRenderWindows::MAX_OP);
+  this->LODCoarserLevelAvailable = (lod_coarser != 0);
+  vtkIdType lod_finer = this->LODFinerLevelAvailable? 1 : 0;
+  this->SynchronizedWindows->Reduce(lod_finer,
+    vtkPVSynchronizedRenderWindows::MAX_OP);
+  this->LODFinerLevelAvailable = (lod_finer != 0);
+
   double local_size = this->GetDeliveryManager()->GetVisibleDataSize(true) / 1024.0;
   this->SynchronizedWindows->SynchronizeSize(local_size);
   // cout << "LOD Geometry size: " << local_size << endl;
@@ -1263,6 +1297,23 @@ void vtkPVRenderView::Render(bool interactive, bool skip_rendering)
     {
     this->AboutToRenderOnLocalProcess(interactive);
     this->GetRenderWindow()->Render();
+
+    // Ask for coarser LOD levels when the frame took longer than the time
+    // allocated to it, and for finer ones when it took a fraction of it.
+    if (use_lod_rendering &&
+      this->SynchronizedWindows->GetLocalProcessIsDriver())
+      {
+      double time =
+        this->RenderView->GetRenderer()->GetLastRenderTimeInSeconds();
+      double rate = this->GetRenderWindow()->GetDesiredUpdateRate();
+      double allocated = rate > 0.0? 1.0 / rate : 0.0;
+      this->LODLevelChange = 0;
+      if (time > 0.0 && allocated > 0.0)
+        {
+        this->LODLevelChange = time > allocated? 1 :
+          (4 * time < allocated? -1 : 0);
+        }
+      }
     }
 
   if (!this->MakingSelection)
@@ -1357,6 +1408,42 @@ void vtkPVRenderView::SetPieceLOD(vtkInformation* info,
   view->GetDeliveryManager()->SetPiece(repr, data, true);
 }
 
+//----------------------------------------------------------------------------
+void vtkPVRenderView::SetLODPending(vtkInformation* info,
+  vtkPVDataRepresentation* vtkNotUsed(repr))
+{
+  vtkPVRenderView* view = vtkPVRenderView::SafeDownCast(info->Get(VIEW()));
+  if (!view)
+    {
+    vtkGenericWarningMacro("Missing VIEW().");
+    return;
+    }
+
+  view->LODPending = true;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVRenderView::SetLODLevelsAvailable(vtkInformation* info,
+  vtkPVDataRepresentation* vtkNotUsed(repr), bool coarser, bool finer)
+{
+  vtkPVRenderView* view = vtkPVRenderView::SafeDownCast(info->Get(VIEW()));
+  if (!view)
+    {
+    vtkGenericWarningMacro("Missing VIEW().");
+    return;
+    }
+
+  view->LODCoarserLevelAvailable |= coarser;
+  view->LODFinerLevelAvailable |= finer;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVRenderView::GetLODLevelChangeAvailable()
+{
+  return (this->LODLevelChange > 0 && this->LODCoarserLevelAvailable) ||
+    (this->LODLevelChange < 0 && this->LODFinerLevelAvailable);
+}
+
 //----------------------------------------------------------------------------
 vtkAlgorithmOutput* vtkPVRenderView::GetPieceProducerLOD(vtkInformation* info,
     vtkPVDataRepresentation* repr)
@@ -226,6 +226,12 @@ public:
   // pass.
   static vtkInformationIntegerKey* USE_OUTLINE_FOR_LOD();
 
+  // Description:
+  // Indicates in REQUEST_UPDATE_LOD() pass whether representations that keep
+  // several levels of detail should switch to a coarser (1) or finer (-1)
+  // level, based on the time the last interactive render took on the client.
+  static vtkInformationIntegerKey* LOD_LEVEL_CHANGE();
+
   // Description:
   // Representation can publish this key in their REQUEST_INFORMATION()
   // pass to indicate that the representation needs to disable
@@ -251,6 +257,13 @@ public:
   // Pass to relay the streamed "piece" to the representations.
   static vtkInformationRequestKey* REQUEST_PROCESS_STREAMED_PIECE();
 
+  // Description:
+  // Pass made at the end of Update() when interactive renders will use LOD,
+  // so that representations can start generating their LOD geometry in the
+  // background before the first REQUEST_UPDATE_LOD(). LOD_RESOLUTION() is
+  // set.
+  static vtkInformationRequestKey* REQUEST_PREPARE_LOD();
+
   // Description:
   // Make a selection. This will result in setting up of this->LastSelection
   // which can be accessed using GetLastSelection().
@@ -342,6 +355,10 @@ public:
     vtkPVDataRepresentation* repr, vtkDataObject* data);
   static vtkAlgorithmOutput* GetPieceProducerLOD(vtkInformation* info,
     vtkPVDataRepresentation* repr);
+  static void SetLODPending(vtkInformation* info,
+    vtkPVDataRepresentation* repr);
+  static void SetLODLevelsAvailable(vtkInformation* info,
+    vtkPVDataRepresentation* repr, bool coarser, bool finer);
   static void MarkAsRedistributable(
     vtkInformation* info, vtkPVDataRepresentation* repr, bool value=true);
   static void SetGeometryBounds(vtkInformation* info,
@@ -494,6 +511,29 @@ public:
   // Asks representations to update their LOD geometries.
   virtual void UpdateLOD();
 
+  // Description:
+  // Returns true when, during the last UpdateLOD(), some representation on
+  // any process provided a LOD geometry while a better one was still being
+  // generated in the background. UpdateLOD() should then be called again
+  // before the next interactive render.
+  vtkGetMacro(LODPending, bool);
+
+  // Description:
+  // Get/Set the LOD level change requested from representations in
+  // UpdateLOD(): 1 for coarser levels, -1 for finer ones and 0 to keep the
+  // current ones. It is computed on the client after every interactive render
+  // using LOD, by comparing the render time with the time allocated to
+  // interactive frames, and must be passed on to the other processes before
+  // UpdateLOD() is called.
+  vtkSetClampMacro(LODLevelChange, int, -1, 1);
+  vtkGetMacro(LODLevelChange, int);
+
+  // Description:
+  // Returns true when the LOD level change computed after the last
+  // interactive render can be honored by some representation, i.e. when
+  // UpdateLOD() should be called again before the next interactive render.
+  bool GetLODLevelChangeAvailable();
+
   // Description:
   // Returns whether the view will use LOD rendering for the next
   // InteractiveRender() call based on the geometry sizes determined by the most
@@ -703,6 +743,10 @@ protected:
   bool UseLightKit;
 
   bool UsedLODForLastRender;
+  bool LODPending;
+  int LODLevelChange;
+  bool LODCoarserLevelAvailable;
+  bool LODFinerLevelAvailable;
   bool UseLODForInteractiveRender;
   bool UseOutlineForLODRendering;
   bool UseDistributedRenderingForStillRender;
@@ -15,6 +15,7 @@
 #include "vtkPVRenderViewSettings.h"
 
 #include "vtkMapper.h"
+#include "vtkMPIMoveData.h"
 #include "vtkObjectFactory.h"
 
 #include <cassert>
@@ -104,6 +105,20 @@ void vtkPVRenderViewSettings::SetZShift(double val)
   this->Modified();
 }
 
+//----------------------------------------------------------------------------
+void vtkPVRenderViewSettings::SetGeometryCompressionMethod(int method)
+{
+  vtkMPIMoveData::SetCompressionMethod(method);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVRenderViewSettings::SetGeometryCompressionByteShuffle(bool val)
+{
+  vtkMPIMoveData::SetUseByteShuffle(val);
+  this->Modified();
+}
+
 //----------------------------------------------------------------------------
 void vtkPVRenderViewSettings::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -62,6 +62,15 @@ public:
   vtkSetMacro(OutlineThreshold, vtkIdType);
   vtkGetMacro(OutlineThreshold, vtkIdType);
 
+  // Description:
+  // Codec used to compress the geometry delivered between processes. Accepts
+  // the values of vtkMPIMoveData::CompressionMethods.
+  void SetGeometryCompressionMethod(int method);
+
+  // Description:
+  // Shuffle bytes before compressing the geometry delivered between processes.
+  void SetGeometryCompressionByteShuffle(bool val);
+
 //BTX
 protected:
   vtkPVRenderViewSettings();
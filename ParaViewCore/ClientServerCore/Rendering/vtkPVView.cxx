@@ -21,6 +21,7 @@
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkProcessModule.h"
+#include "vtkPVCacheKeeper.h"
 #include "vtkPVDataRepresentation.h"
 #include "vtkPVOptions.h"
 #include "vtkPVSession.h"
@@ -258,14 +259,7 @@ void vtkPVView::Update()
   // Ensure that cache size if synchronized among the processes.
   if (this->GetUseCache())
     {
-    vtkCacheSizeKeeper* cacheSizeKeeper = vtkCacheSizeKeeper::GetInstance();
-    unsigned int cache_full = 0;
-    if (cacheSizeKeeper->GetCacheSize() > cacheSizeKeeper->GetCacheLimit())
-      {
-      cache_full = 1;
-      }
-    this->SynchronizedWindows->SynchronizeSize(cache_full);
-    cacheSizeKeeper->SetCacheFull(cache_full > 0);
+    this->SynchronizeCacheSize();
     }
 
   this->CallProcessViewRequest(vtkPVView::REQUEST_UPDATE(),
@@ -273,6 +267,57 @@ void vtkPVView::Update()
   vtkTimerLog::MarkEndEvent("vtkPVView::Update");
 }
 
+//----------------------------------------------------------------------------
+void vtkPVView::Prefetch(double time)
+{
+  if (!this->GetUseCache() || !this->ViewTimeValid || this->CacheKey == time)
+    {
+    return;
+    }
+
+  vtkTimerLog::MarkStartEvent("vtkPVView::Prefetch");
+  // Every process must prefetch the same times, so whether the cache is full
+  // is agreed upon first, as in Update().
+  this->SynchronizeCacheSize();
+  if (!vtkCacheSizeKeeper::GetInstance()->GetCacheFull())
+    {
+    for (int cc=0; cc < this->GetNumberOfRepresentations(); cc++)
+      {
+      vtkPVDataRepresentation* pvrepr =
+        vtkPVDataRepresentation::SafeDownCast(this->GetRepresentation(cc));
+      if (pvrepr)
+        {
+        pvrepr->Prefetch(time);
+        }
+      }
+    }
+  vtkTimerLog::MarkEndEvent("vtkPVView::Prefetch");
+}
+
+//----------------------------------------------------------------------------
+void vtkPVView::SynchronizeCacheSize()
+{
+  vtkCacheSizeKeeper* cacheSizeKeeper = vtkCacheSizeKeeper::GetInstance();
+  int policy = cacheSizeKeeper->GetEvictionPolicy();
+  if (policy != vtkCacheSizeKeeper::NO_EVICTION)
+    {
+    // Discard the same least recently (or frequently) used entries on all
+    // processes so that they keep agreeing on which times are cached.
+    vtkIdType count = vtkPVCacheKeeper::GetNumberOfEntriesToEvict(
+      cacheSizeKeeper->GetCacheLimit(), policy);
+    this->SynchronizedWindows->Reduce(count,
+      vtkPVSynchronizedRenderWindows::MAX_OP);
+    vtkPVCacheKeeper::EvictEntries(count, policy);
+    }
+  unsigned int cache_full = 0;
+  if (cacheSizeKeeper->GetCacheSize() > cacheSizeKeeper->GetCacheLimit())
+    {
+    cache_full = 1;
+    }
+  this->SynchronizedWindows->SynchronizeSize(cache_full);
+  cacheSizeKeeper->SetCacheFull(cache_full > 0);
+}
+
 //----------------------------------------------------------------------------
 void vtkPVView::CallProcessViewRequest(
   vtkInformationRequestKey* type, vtkInformation* inInfo, vtkInformationVector* outVec)
@@ -147,6 +147,15 @@ public:
   // instead use ProcessViewRequest() for all vtkPVDataRepresentations.
   virtual void Update();
 
+  // Description:
+  // Caches the data of the representations for \c time, under the cache key
+  // \c time, without changing what the view shows. Used by the animation
+  // scene to compute the next time steps while the current one is displayed.
+  // Does nothing unless UseCache is true, the cache is not full and the
+  // current time step is cached.
+  // @CallOnAllProcessess
+  virtual void Prefetch(double time);
+
   // Description:
   // Returns true if the application is currently in tile display mode.
   bool InTileDisplayMode();
@@ -200,6 +209,12 @@ protected:
   void CallProcessViewRequest(
     vtkInformationRequestKey* passType,
     vtkInformation* request, vtkInformationVector* reply);
+
+  // Description:
+  // Discards the cache entries over the limit and agrees with the other
+  // processes on whether the cache is full.
+  void SynchronizeCacheSize();
+
   double ViewTime;
 
   double CacheKey;
@@ -39,6 +39,7 @@
 #include "vtkVolumeRepresentationPreprocessor.h"
 
 #include <map>
+#include <sstream>
 #include <string>
 
 class vtkUnstructuredGridVolumeRepresentation::vtkInternals
@@ -159,6 +160,13 @@ int vtkUnstructuredGridVolumeRepresentation::RequestData(vtkInformation* request
   this->CacheKeeper->SetCachingEnabled(this->GetUseCache());
   this->CacheKeeper->SetCacheTime(this->GetCacheKey());
 
+  std::ostringstream signature;
+  signature << this->GetClassName() << " "
+            << this->Preprocessor->GetExtractedBlockIndex();
+  this->CacheKeeper->SetCacheSource(
+    this->GetNumberOfInputConnections(0) > 0?
+    this->GetInputConnection(0, 0) : NULL, signature.str().c_str());
+
   if (inputVector[0]->GetNumberOfInformationObjects()==1)
     {
     this->Preprocessor->SetInputConnection(
@@ -0,0 +1,182 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    BenchmarkClientServerStream.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Measures the throughput of building and parsing small streams, like the
+// ones sent for every property push, and compares inserting a large array in
+// a stream by copy and by reference.
+
+#include "vtkClientServerStream.h"
+#include "vtkTimerLog.h"
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+  const int NumberOfStreams = 200000;
+  const int NumberOfValues = 1000000;
+
+  // Builds a stream similar to the ones vtkSMProperty pushes.
+  void BuildPropertyStream(vtkClientServerStream& stream, int cc)
+    {
+    double values[3] = { cc, cc + 1, cc + 2 };
+    stream << vtkClientServerStream::Invoke
+           << vtkClientServerID(cc + 1)
+           << "SetPosition"
+           << vtkClientServerStream::InsertArray(values, 3)
+           << vtkClientServerStream::End;
+    }
+
+  // Parses the data of a property stream back, returns whether the values
+  // are the expected ones.
+  bool ParsePropertyStream(vtkClientServerStream& stream,
+    const vtkClientServerStream& source, int cc)
+    {
+    const unsigned char* data;
+    size_t length;
+    source.GetData(&data, &length);
+    double values[3];
+    const char* method = NULL;
+    return stream.SetData(data, length) &&
+      stream.GetArgument(0, 1, &method) &&
+      strcmp(method, "SetPosition") == 0 &&
+      stream.GetArgument(0, 2, values, 3) && values[2] == cc + 2;
+    }
+}
+
+int BenchmarkClientServerStream(int, char*[])
+{
+  int errors = 0;
+  vtkTimerLog* timer = vtkTimerLog::New();
+
+  // A new stream for every message, as done by most of the code.
+  timer->StartTimer();
+  for (int cc=0; cc < NumberOfStreams; cc++)
+    {
+    vtkClientServerStream stream;
+    BuildPropertyStream(stream, cc);
+    vtkClientServerStream parsed;
+    if (!ParsePropertyStream(parsed, stream, cc))
+      {
+      errors++;
+      }
+    }
+  timer->StopTimer();
+  double newTime = timer->GetElapsedTime();
+
+  // The same streams, reset for every message.
+  vtkClientServerStream stream;
+  vtkClientServerStream parsed;
+  timer->StartTimer();
+  for (int cc=0; cc < NumberOfStreams; cc++)
+    {
+    stream.Reset();
+    BuildPropertyStream(stream, cc);
+    if (!ParsePropertyStream(parsed, stream, cc))
+      {
+      errors++;
+      }
+    }
+  timer->StopTimer();
+  double resetTime = timer->GetElapsedTime();
+
+  cout << "Streams built and parsed: " << NumberOfStreams << endl;
+  cout << "New streams:   " << NumberOfStreams / newTime << " streams/s"
+       << endl;
+  cout << "Reset streams: " << NumberOfStreams / resetTime << " streams/s"
+       << endl;
+
+  // A large array, copied when inserted or when the data is needed.
+  std::vector<double> values(NumberOfValues);
+  for (int cc=0; cc < NumberOfValues; cc++)
+    {
+    values[cc] = cc;
+    }
+  const unsigned char* copyData;
+  const unsigned char* referenceData;
+  size_t copyLength;
+  size_t referenceLength;
+
+  vtkClientServerStream copyStream;
+  timer->StartTimer();
+  copyStream << vtkClientServerStream::Invoke
+             << vtkClientServerID(1) << "SetValues"
+             << vtkClientServerStream::InsertArray(&values[0], NumberOfValues)
+             << vtkClientServerStream::End;
+  timer->StopTimer();
+  double copyInsertTime = timer->GetElapsedTime();
+  timer->StartTimer();
+  copyStream.GetData(&copyData, &copyLength);
+  timer->StopTimer();
+  double copyTime = copyInsertTime + timer->GetElapsedTime();
+
+  vtkClientServerStream referenceStream;
+  timer->StartTimer();
+  referenceStream << vtkClientServerStream::Invoke
+                  << vtkClientServerID(1) << "SetValues"
+                  << vtkClientServerStream::InsertArrayReference(
+                    vtkClientServerStream::InsertArray(&values[0],
+                      NumberOfValues))
+                  << vtkClientServerStream::End;
+  timer->StopTimer();
+  double referenceInsertTime = timer->GetElapsedTime();
+  timer->StartTimer();
+  referenceStream.GetData(&referenceData, &referenceLength);
+  timer->StopTimer();
+  double referenceTime = referenceInsertTime + timer->GetElapsedTime();
+
+  cout << "Array of " << NumberOfValues << " doubles:" << endl;
+  cout << "  By copy:      insert " << copyInsertTime * 1.0e3 << " ms, total "
+       << copyTime * 1.0e3 << " ms" << endl;
+  cout << "  By reference: insert " << referenceInsertTime * 1.0e3
+       << " ms, total " << referenceTime * 1.0e3 << " ms" << endl;
+
+  if (copyLength != referenceLength ||
+    memcmp(copyData, referenceData, copyLength) != 0)
+    {
+    cerr << "Arrays inserted by reference are not serialized as copies."
+         << endl;
+    errors++;
+    }
+
+  // Arguments around arrays inserted by reference are read back.
+  vtkClientServerStream mixed;
+  mixed << vtkClientServerStream::Invoke
+        << vtkClientServerID(2) << "SetValues"
+        << vtkClientServerStream::InsertArrayReference(
+          vtkClientServerStream::InsertArray(&values[0], NumberOfValues))
+        << 42
+        << vtkClientServerStream::InsertArrayReference(
+          vtkClientServerStream::InsertArray(&values[0], 1000))
+        << vtkClientServerStream::End;
+  std::vector<double> readBack(NumberOfValues);
+  vtkTypeUInt32 length = 0;
+  int answer = 0;
+  if (!mixed.GetArgument(0, 3, &answer) || answer != 42 ||
+    !mixed.GetArgumentLength(0, 2, &length) || length != static_cast<vtkTypeUInt32>(NumberOfValues) ||
+    !mixed.GetArgument(0, 2, &readBack[0], length) ||
+    readBack[NumberOfValues - 1] != NumberOfValues - 1 ||
+    !mixed.GetArgument(0, 4, &readBack[0], 1000) || readBack[999] != 999)
+    {
+    cerr << "Arguments inserted by reference were not read back." << endl;
+    errors++;
+    }
+
+  if (errors)
+    {
+    cerr << errors << " streams were not parsed correctly." << endl;
+    }
+  timer->Delete();
+  return errors == 0? 0 : 1;
+}
@@ -0,0 +1,135 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    BenchmarkGetIDFromObject.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Registers a large number of objects with the interpreter and compares the
+// cost of vtkClientServerInterpreter::GetIDFromObject() with a linear scan of
+// all the IDs, which is how reverse lookups used to be done.
+
+#include "vtkClientServerInterpreter.h"
+#include "vtkClientServerStream.h"
+#include "vtkObject.h"
+#include "vtkTimerLog.h"
+
+#include <vector>
+
+namespace
+{
+  const vtkTypeUInt32 NumberOfObjects = 100000;
+
+  vtkClientServerID LinearSearch(vtkClientServerInterpreter* interpreter,
+    vtkObjectBase* key)
+    {
+    vtkClientServerID result;
+    for (vtkTypeUInt32 cc=1; cc <= NumberOfObjects; cc++)
+      {
+      vtkObjectBase* obj;
+      const vtkClientServerStream* message =
+        interpreter->GetMessageFromID(vtkClientServerID(cc));
+      if (message && message->GetArgument(0, 0, &obj) && obj == key)
+        {
+        result.ID = cc;
+        break;
+        }
+      }
+    return result;
+    }
+}
+
+int BenchmarkGetIDFromObject(int, char*[])
+{
+  vtkClientServerInterpreter* interpreter = vtkClientServerInterpreter::New();
+
+  std::vector<vtkObject*> objects(NumberOfObjects);
+  for (vtkTypeUInt32 cc=0; cc < NumberOfObjects; cc++)
+    {
+    objects[cc] = vtkObject::New();
+    objects[cc]->Register(NULL);
+    // NewInstance() takes over the reference from New().
+    interpreter->NewInstance(objects[cc], vtkClientServerID(cc + 1));
+    }
+
+  int errors = 0;
+  vtkTimerLog* timer = vtkTimerLog::New();
+
+  // Linear scan, for reference. The scan is so slow that only a sample of
+  // the objects is looked up.
+  const vtkTypeUInt32 linearLookups = 100;
+  timer->StartTimer();
+  for (vtkTypeUInt32 cc=0; cc < linearLookups; cc++)
+    {
+    vtkTypeUInt32 index = (cc * 7919) % NumberOfObjects;
+    if (LinearSearch(interpreter, objects[index]).ID != index + 1)
+      {
+      errors++;
+      }
+    }
+  timer->StopTimer();
+  double linearTime = timer->GetElapsedTime() / linearLookups;
+
+  timer->StartTimer();
+  for (vtkTypeUInt32 cc=0; cc < NumberOfObjects; cc++)
+    {
+    if (interpreter->GetIDFromObject(objects[cc]).ID != cc + 1)
+      {
+      errors++;
+      }
+    }
+  timer->StopTimer();
+  double indexedTime = timer->GetElapsedTime() / NumberOfObjects;
+
+  cout << "Objects registered: " << NumberOfObjects << endl;
+  cout << "Linear scan lookup:  " << linearTime * 1.0e6 << " us" << endl;
+  cout << "Indexed lookup:      " << indexedTime * 1.0e6 << " us" << endl;
+
+  // Assigned IDs and deleted IDs must be reflected in the index.
+  vtkClientServerStream stream;
+  stream << vtkClientServerStream::Assign
+         << vtkClientServerID(NumberOfObjects + 1) << objects[0]
+         << vtkClientServerStream::End;
+  for (vtkTypeUInt32 cc=0; cc < NumberOfObjects; cc += 2)
+    {
+    stream << vtkClientServerStream::Delete << vtkClientServerID(cc + 1)
+           << vtkClientServerStream::End;
+    }
+  if (!interpreter->ProcessStream(stream))
+    {
+    cerr << "Failed to process stream." << endl;
+    errors++;
+    }
+  for (vtkTypeUInt32 cc=1; cc < NumberOfObjects; cc++)
+    {
+    vtkTypeUInt32 expected = (cc % 2 == 0)? 0 : cc + 1;
+    if (interpreter->GetIDFromObject(objects[cc]).ID != expected)
+      {
+      errors++;
+      }
+    }
+  if (interpreter->GetIDFromObject(objects[0]).ID != NumberOfObjects + 1)
+    {
+    errors++;
+    }
+
+  if (errors)
+    {
+    cerr << errors << " lookups returned an unexpected ID." << endl;
+    }
+
+  interpreter->Delete();
+  for (vtkTypeUInt32 cc=0; cc < NumberOfObjects; cc++)
+    {
+    objects[cc]->Delete();
+    }
+  timer->Delete();
+  return errors == 0? 0 : 1;
+}
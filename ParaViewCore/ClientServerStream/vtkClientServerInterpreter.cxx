@@ -73,9 +73,44 @@ public:
   typedef std::map<std::string, const NewInstanceFunction*> NewInstanceFunctionsType;
   typedef std::map<std::string, const CommandFunction*> ClassToFunctionMapType;
   typedef std::map<vtkTypeUInt32, vtkClientServerStream*> IDToMessageMapType;
+  typedef std::multimap<vtkObjectBase*, vtkTypeUInt32> ObjectToIDMapType;
   NewInstanceFunctionsType NewInstanceFunctions;
   ClassToFunctionMapType ClassToFunctionMap;
   IDToMessageMapType IDToMessageMap;
+
+  // Reverse index of IDToMessageMap for messages whose first argument is an
+  // object. An object may be stored under several IDs.
+  ObjectToIDMapType ObjectToIDMap;
+
+  // Store/remove a message in IDToMessageMap, keeping ObjectToIDMap in sync.
+  void AddMessage(vtkTypeUInt32 id, vtkClientServerStream* message)
+    {
+    this->IDToMessageMap[id] = message;
+    vtkObjectBase* obj;
+    if(message->GetArgument(0, 0, &obj) && obj)
+      {
+      this->ObjectToIDMap.insert(ObjectToIDMapType::value_type(obj, id));
+      }
+    }
+  void RemoveMessage(vtkTypeUInt32 id, vtkClientServerStream* message)
+    {
+    this->IDToMessageMap.erase(id);
+    vtkObjectBase* obj;
+    if(message->GetArgument(0, 0, &obj) && obj)
+      {
+      std::pair<ObjectToIDMapType::iterator, ObjectToIDMapType::iterator>
+        range = this->ObjectToIDMap.equal_range(obj);
+      for(ObjectToIDMapType::iterator iter = range.first;
+          iter != range.second; ++iter)
+        {
+        if(iter->second == id)
+          {
+          this->ObjectToIDMap.erase(iter);
+          break;
+          }
+        }
+      }
+    }
 };
 
 //----------------------------------------------------------------------------
@@ -162,17 +197,22 @@ vtkClientServerInterpreter::GetObjectFromID(vtkClientServerID id, int noerror)
 vtkClientServerID
 vtkClientServerInterpreter::GetIDFromObject(vtkObjectBase* key)
 {
-  // Search the hash table for the given object.
+  // Look up the object in the reverse index. When the object is stored
+  // under several IDs, the smallest one is returned.
   vtkClientServerID result;
-  vtkClientServerInterpreterInternals::IDToMessageMapType::iterator hi;
-  for(hi = this->Internal->IDToMessageMap.begin();
-      hi != this->Internal->IDToMessageMap.end(); ++hi)
+  if(!key)
     {
-    vtkObjectBase* obj;
-    if(hi->second->GetArgument(0, 0, &obj) && obj == key)
+    return result;
+    }
+  typedef vtkClientServerInterpreterInternals::ObjectToIDMapType::iterator
+    IteratorType;
+  std::pair<IteratorType, IteratorType> range =
+    this->Internal->ObjectToIDMap.equal_range(key);
+  for(IteratorType iter = range.first; iter != range.second; ++iter)
+    {
+    if(result.ID == 0 || iter->second < result.ID)
       {
-      result.ID = hi->first;
-      break;
+      result.ID = iter->second;
       }
     }
   return result;
@@ -516,7 +556,7 @@ vtkClientServerInterpreter
       }
 
     // Remove the ID from the map.
-    this->Internal->IDToMessageMap.erase(id.ID);
+    this->Internal->RemoveMessage(id.ID, item);
 
     // Delete the entry's value.
     delete item;
@@ -591,7 +631,7 @@ vtkClientServerInterpreter
     // remains unchanged.
     vtkClientServerStream* tmp;
     tmp = new vtkClientServerStream(*this->LastResultMessage, this);
-    this->Internal->IDToMessageMap[id.ID] = tmp;
+    this->Internal->AddMessage(id.ID, tmp);
     return 1;
     }
   else
@@ -742,7 +782,7 @@ int vtkClientServerInterpreter::NewInstance(vtkObjectBase* obj,
   // have to be checked.
   vtkClientServerStream* entry =
     new vtkClientServerStream(*this->LastResultMessage, this);
-  this->Internal->IDToMessageMap[id.ID] = entry;
+  this->Internal->AddMessage(id.ID, entry);
   return 1;
 }
 
@@ -94,7 +94,9 @@ public:
 
   // Description:
   // Return an ID given a pointer to a vtkObjectBase (or 0 if object
-  // is not found)
+  // is not found). If the object was assigned to several IDs, the smallest
+  // one is returned. This uses an index maintained as objects are added and
+  // removed and does not depend on the number of IDs in use.
   vtkClientServerID GetIDFromObject(vtkObjectBase* key);
 
   // Description:
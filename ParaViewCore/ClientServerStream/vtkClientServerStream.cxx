@@ -18,6 +18,7 @@
 #include "vtkArrayIterator.h"
 #include "vtkArrayIteratorIncludes.h"
 #include "vtkByteSwap.h"
+#include "vtkSimpleCriticalSection.h"
 #include "vtkSmartPointer.h"
 #include "vtkType.h"
 #include "vtkTypeTraits.h"
@@ -83,12 +84,26 @@ VTK_CLIENT_SERVER_TYPE_TRAIT(vtkTypeFloat64, float64);
 class vtkClientServerStreamInternals
 {
 public:
-  vtkClientServerStreamInternals(vtkObjectBase* owner): Objects(owner) {}
+  vtkClientServerStreamInternals(vtkObjectBase* owner): Objects(owner),
+    ReferencedSize(0)
+    {
+    this->AcquireBuffers();
+    }
   vtkClientServerStreamInternals(const vtkClientServerStreamInternals& r,
                                  vtkObjectBase* owner):
-    Data(r.Data), ValueOffsets(r.ValueOffsets),
-    MessageIndexes(r.MessageIndexes), Objects(r.Objects, owner),
-    StartIndex(r.StartIndex), Invalid(r.Invalid), String(r.String) {}
+    Objects(r.Objects, owner), StartIndex(r.StartIndex), Invalid(r.Invalid),
+    String(r.String), ReferencedSize(0)
+    {
+    // Assigning to pooled buffers reuses their memory.
+    this->AcquireBuffers();
+    this->Data = r.Data;
+    this->ValueOffsets = r.ValueOffsets;
+    this->MessageIndexes = r.MessageIndexes;
+    }
+  ~vtkClientServerStreamInternals()
+    {
+    this->ReleaseBuffers();
+    }
 
   // Actual binary data in the stream.
   typedef std::vector<unsigned char> DataType;
@@ -175,6 +190,62 @@ public:
   // Buffer for return value from StreamToString.
   std::string String;
 
+  // Arrays inserted by reference. Their data is not in Data yet, Offset is
+  // where it will be once Flush() copies it.
+  struct ReferenceType
+  {
+    DataType::size_type Offset;
+    const unsigned char* Data;
+    size_t Size;
+  };
+  std::vector<ReferenceType> References;
+  size_t ReferencedSize;
+
+  // Arrays smaller than this are copied even when inserted by reference.
+  static const size_t MinimumReferenceSize = 4096;
+
+  // Data of streams larger than this is freed on Reset() and is not pooled.
+  static const size_t MaximumPooledSize = 65536;
+
+  // Size of the stream, counting the arrays inserted by reference.
+  DataType::difference_type GetSize() const
+    {
+    return static_cast<DataType::difference_type>(
+      this->Data.size() + this->ReferencedSize);
+    }
+
+  // Copies the arrays inserted by reference in Data. Everything reading Data
+  // must call this first.
+  void Flush()
+    {
+    if(this->References.empty())
+      {
+      return;
+      }
+
+    // Grow Data and move the bytes that follow each reference out of the
+    // way, last reference first, so that everything is moved only once.
+    DataType::size_type end = this->Data.size();
+    this->Data.resize(end + this->ReferencedSize);
+    unsigned char* data = &*this->Data.begin();
+    size_t shift = this->ReferencedSize;
+    for(std::vector<ReferenceType>::reverse_iterator r =
+          this->References.rbegin(); r != this->References.rend(); ++r)
+      {
+      shift -= r->Size;
+      DataType::size_type start = r->Offset - shift;
+      memmove(data + r->Offset + r->Size, data + start, end - start);
+      memcpy(data + r->Offset, r->Data, r->Size);
+      end = start;
+      }
+    this->References.clear();
+    this->ReferencedSize = 0;
+    }
+
+  // Get buffers from, and give them back to, the pool.
+  void AcquireBuffers();
+  void ReleaseBuffers();
+
   // Access to protected members of vtkClientServerStream.
   static vtkClientServerStream& Write(vtkClientServerStream& css,
                                       const void* data, size_t length)
@@ -188,6 +259,94 @@ const vtkClientServerStreamInternals::ValueOffsetsType::size_type
 vtkClientServerStreamInternals::InvalidStartIndex =
 static_cast<vtkClientServerStreamInternals::ValueOffsetsType::size_type>(-1);
 
+//----------------------------------------------------------------------------
+// Buffers of the streams that were destroyed. Streams are created and
+// destroyed at a high rate (e.g. one per property push), taking their
+// buffers from here saves most of the allocations.
+class vtkClientServerStreamBufferPool
+{
+public:
+  struct Buffers
+  {
+    vtkClientServerStreamInternals::DataType Data;
+    vtkClientServerStreamInternals::ValueOffsetsType ValueOffsets;
+    vtkClientServerStreamInternals::MessageIndexesType MessageIndexes;
+  };
+
+  // The pool is never destroyed so that streams destroyed at exit, after
+  // static objects, can still use it.
+  static vtkClientServerStreamBufferPool& GetInstance()
+    {
+    static vtkClientServerStreamBufferPool* instance =
+      new vtkClientServerStreamBufferPool;
+    return *instance;
+    }
+
+  // Swaps the buffers of the stream with pooled ones, if any.
+  void Acquire(vtkClientServerStreamInternals* internal)
+    {
+    Buffers* buffers = 0;
+    this->Lock.Lock();
+    if(!this->Free.empty())
+      {
+      buffers = this->Free.back();
+      this->Free.pop_back();
+      }
+    this->Lock.Unlock();
+    if(buffers)
+      {
+      internal->Data.swap(buffers->Data);
+      internal->ValueOffsets.swap(buffers->ValueOffsets);
+      internal->MessageIndexes.swap(buffers->MessageIndexes);
+      delete buffers;
+      }
+    }
+
+  // Takes the buffers of a stream unless they are too large or the pool is
+  // full.
+  void Release(vtkClientServerStreamInternals* internal)
+    {
+    if(internal->Data.capacity() == 0 ||
+       internal->Data.capacity() >
+       vtkClientServerStreamInternals::MaximumPooledSize)
+      {
+      return;
+      }
+    Buffers* buffers = new Buffers;
+    buffers->Data.swap(internal->Data);
+    buffers->ValueOffsets.swap(internal->ValueOffsets);
+    buffers->MessageIndexes.swap(internal->MessageIndexes);
+    buffers->Data.clear();
+    buffers->ValueOffsets.clear();
+    buffers->MessageIndexes.clear();
+    this->Lock.Lock();
+    if(this->Free.size() < MaximumNumberOfBuffers)
+      {
+      this->Free.push_back(buffers);
+      buffers = 0;
+      }
+    this->Lock.Unlock();
+    delete buffers;
+    }
+
+private:
+  static const size_t MaximumNumberOfBuffers = 64;
+  vtkSimpleCriticalSection Lock;
+  std::vector<Buffers*> Free;
+};
+
+//----------------------------------------------------------------------------
+void vtkClientServerStreamInternals::AcquireBuffers()
+{
+  vtkClientServerStreamBufferPool::GetInstance().Acquire(this);
+}
+
+//----------------------------------------------------------------------------
+void vtkClientServerStreamInternals::ReleaseBuffers()
+{
+  vtkClientServerStreamBufferPool::GetInstance().Release(this);
+}
+
 //----------------------------------------------------------------------------
 vtkClientServerStream::vtkClientServerStream(vtkObjectBase* owner)
 {
@@ -208,6 +367,7 @@ vtkClientServerStream::vtkClientServerStream(const vtkClientServerStream& r,
                                              vtkObjectBase* owner)
 {
   // Allocate and copy the internal representation of the stream.
+  r.Internal->Flush();
   this->Internal = new vtkClientServerStreamInternals(*r.Internal, owner);
 }
 
@@ -215,6 +375,7 @@ vtkClientServerStream::vtkClientServerStream(const vtkClientServerStream& r,
 vtkClientServerStream&
 vtkClientServerStream::operator=(const vtkClientServerStream& that)
 {
+  that.Internal->Flush();
   *this->Internal = *that.Internal;
   return *this;
 }
@@ -242,8 +403,9 @@ vtkClientServerStream::Write(const void* data, size_t length)
     }
 
   // Copy the value into the data.
-  this->Internal->Data.resize(this->Internal->Data.size() + length);
-  memcpy(&*(this->Internal->Data.end() - length), data, length);
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  this->Internal->Data.insert(this->Internal->Data.end(), bytes,
+                              bytes + length);
   return *this;
 }
 
@@ -256,8 +418,19 @@ void vtkClientServerStream::Reserve(size_t size)
 //----------------------------------------------------------------------------
 void vtkClientServerStream::Reset()
 {
-  // Empty the entire stream.
-  vtkClientServerStreamInternals::DataType().swap(this->Internal->Data);
+  // Empty the entire stream. Keep the memory for the next messages unless
+  // the stream grew large.
+  if(this->Internal->Data.capacity() >
+     vtkClientServerStreamInternals::MaximumPooledSize)
+    {
+    vtkClientServerStreamInternals::DataType().swap(this->Internal->Data);
+    }
+  else
+    {
+    this->Internal->Data.clear();
+    }
+  this->Internal->References.clear();
+  this->Internal->ReferencedSize = 0;
 
   this->Internal->ValueOffsets.erase(this->Internal->ValueOffsets.begin(),
                                      this->Internal->ValueOffsets.end());
@@ -298,7 +471,7 @@ vtkClientServerStream::operator << (vtkClientServerStream::Commands t)
 
   // The command counts as the first value in the message.
   this->Internal->ValueOffsets.push_back(
-    this->Internal->Data.end()-this->Internal->Data.begin());
+    this->Internal->GetSize());
 
   // Store the command in the stream.
   vtkTypeUInt32 data = static_cast<vtkTypeUInt32>(t);
@@ -333,7 +506,7 @@ vtkClientServerStream::operator << (vtkClientServerStream::Types t)
   // All values write their type first.  Mark the start of this type
   // and optional value.
   this->Internal->ValueOffsets.push_back(
-    this->Internal->Data.end()-this->Internal->Data.begin());
+    this->Internal->GetSize());
 
   // Store the type in the stream.
   vtkTypeUInt32 data = static_cast<vtkTypeUInt32>(t);
@@ -348,7 +521,7 @@ vtkClientServerStream::operator << (vtkClientServerStream::Argument a)
     {
     // Mark the start of this type and optional value.
     this->Internal->ValueOffsets.push_back(
-      this->Internal->Data.end()-this->Internal->Data.begin());
+      this->Internal->GetSize());
 
     // If the argument is a vtk_object_pointer, we need to store a
     // reference to the object.
@@ -385,6 +558,38 @@ vtkClientServerStream::operator << (vtkClientServerStream::Array a)
   return *this;
 }
 
+//----------------------------------------------------------------------------
+vtkClientServerStream::ArrayReference
+vtkClientServerStream::InsertArrayReference(vtkClientServerStream::Array a)
+{
+  vtkClientServerStream::ArrayReference r = { a };
+  return r;
+}
+
+//----------------------------------------------------------------------------
+vtkClientServerStream&
+vtkClientServerStream::operator << (vtkClientServerStream::ArrayReference r)
+{
+  const vtkClientServerStream::Array& a = r.Value;
+  if(a.Type == vtkClientServerStream::string_value || !a.Data ||
+     a.Size < vtkClientServerStreamInternals::MinimumReferenceSize)
+    {
+    // Not worth it.
+    return *this << a;
+    }
+
+  // Store the array type and length, and remember where the data goes.
+  *this << a.Type;
+  this->Write(&a.Length, sizeof(a.Length));
+  vtkClientServerStreamInternals::ReferenceType reference;
+  reference.Offset = this->Internal->GetSize();
+  reference.Data = static_cast<const unsigned char*>(a.Data);
+  reference.Size = a.Size;
+  this->Internal->References.push_back(reference);
+  this->Internal->ReferencedSize += a.Size;
+  return *this;
+}
+
 //----------------------------------------------------------------------------
 vtkClientServerStream&
 vtkClientServerStream::operator << (const vtkClientServerStream& css)
@@ -1407,6 +1612,7 @@ int vtkClientServerStream::GetData(const unsigned char** data,
   // Do not return data unless stream is valid.
   if(!this->Internal->Invalid)
     {
+    this->Internal->Flush();
     if(data)
       {
       *data = &*this->Internal->Data.begin();
@@ -1787,6 +1993,7 @@ vtkClientServerStream::GetValue(int message, int value) const
       this->Internal->MessageIndexes[message];
 
     // Return a pointer to the value-th value in the message.
+    this->Internal->Flush();
     const unsigned char* data = &*this->Internal->Data.begin();
     return data + this->Internal->ValueOffsets[index + value];
     }
@@ -20,6 +20,10 @@
 // and the message represented will remain unchanged.  Messages are
 // used to represent both commands and results for
 // vtkClientServerInterpreter, but they may be used for any purpose.
+//
+// The memory of streams is reused: Reset() keeps it for the next messages,
+// and destroyed streams give it back to a pool from which new streams take
+// it, so that building many short-lived streams does not allocate.
 
 #ifndef __vtkClientServerStream_h
 #define __vtkClientServerStream_h
@@ -80,7 +84,8 @@ public:
   void Reserve(size_t size);
 
   // Description:
-  // Reset the stream to an empty state.
+  // Reset the stream to an empty state. The memory is kept for the next
+  // messages, unless the stream grew large.
   void Reset();
 
   // Description:
@@ -220,12 +225,21 @@ public:
     const void* Data;
   };
 
+  // Description:
+  // Proxy-object returned by InsertArrayReference and used to insert array
+  // data into the stream without copying it.
+  struct ArrayReference
+  {
+    Array Value;
+  };
+
   // Description:
   // Stream operators for special types.
   vtkClientServerStream& operator << (vtkClientServerStream::Commands);
   vtkClientServerStream& operator << (vtkClientServerStream::Types);
   vtkClientServerStream& operator << (vtkClientServerStream::Argument);
   vtkClientServerStream& operator << (vtkClientServerStream::Array);
+  vtkClientServerStream& operator << (vtkClientServerStream::ArrayReference);
   vtkClientServerStream& operator << (const vtkClientServerStream&);
   vtkClientServerStream& operator << (vtkClientServerID);
   vtkClientServerStream& operator << (vtkObjectBase*);
@@ -278,6 +292,17 @@ public:
   static vtkClientServerStream::Array InsertArray(const float*, int);
   static vtkClientServerStream::Array InsertArray(const double*, int);
 
+  // Description:
+  // Insert an array by reference, e.g.
+  //   stream << vtkClientServerStream::InsertArrayReference(
+  //     vtkClientServerStream::InsertArray(values, count));
+  // The stream keeps a pointer to the array data and copies it only when
+  // the stream data is needed, by GetData() when the stream is sent or by
+  // the reading methods. The array must not be modified or freed until
+  // then. Small arrays are copied right away.
+  static vtkClientServerStream::ArrayReference InsertArrayReference(
+    vtkClientServerStream::Array);
+
   // Description:
   // Construct the entire stream from the given data.  This destroys
   // any data already in the stream.  Returns whether the stream is
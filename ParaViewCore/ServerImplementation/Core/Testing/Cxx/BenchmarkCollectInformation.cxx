@@ -0,0 +1,136 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    BenchmarkCollectInformation.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Reports the latency of collecting a vtkPVDataInformation from all ranks
+// using both vtkPVSessionCore::CollectInformationModes and checks that the
+// two modes produce the same summary. Run with increasing number of ranks to
+// get the latency against rank count.
+
+#include <mpi.h>
+
+#include "vtkMPIController.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPVDataInformation.h"
+#include "vtkPVSessionCore.h"
+#include "vtkSphereSource.h"
+#include "vtkTimerLog.h"
+
+#include <cstdlib>
+
+namespace
+{
+class vtkBenchmarkSessionCore : public vtkPVSessionCore
+{
+public:
+  static vtkBenchmarkSessionCore* New();
+  vtkTypeMacro(vtkBenchmarkSessionCore, vtkPVSessionCore);
+
+  bool Collect(vtkPVInformation* info, int mode)
+    { return this->CollectInformation(info, mode); }
+
+protected:
+  vtkBenchmarkSessionCore() {}
+  ~vtkBenchmarkSessionCore() {}
+};
+vtkStandardNewMacro(vtkBenchmarkSessionCore);
+
+// Returns the maximum, over all ranks, of the average time to collect the
+// information in the given mode.
+double TimeCollect(vtkMultiProcessController* controller,
+  vtkBenchmarkSessionCore* core, vtkPolyData* data, int mode,
+  int iterations, vtkPVDataInformation* result)
+{
+  vtkNew<vtkTimerLog> timer;
+  controller->Barrier();
+  timer->StartTimer();
+  for (int cc=0; cc < iterations; cc++)
+    {
+    result->Initialize();
+    result->CopyFromObject(data);
+    core->Collect(result, mode);
+    }
+  timer->StopTimer();
+
+  double local = timer->GetElapsedTime() / iterations;
+  double global = 0.0;
+  controller->Reduce(&local, &global, 1, vtkCommunicator::MAX_OP, 0);
+  return global;
+}
+}
+
+int BenchmarkCollectInformation(int argc, char* argv[])
+{
+  MPI_Init(&argc, &argv);
+
+  vtkNew<vtkMPIController> controller;
+  controller->Initialize(&argc, &argv, 1);
+  vtkMultiProcessController::SetGlobalController(controller.GetPointer());
+
+  int rank = controller->GetLocalProcessId();
+  int nranks = controller->GetNumberOfProcesses();
+  const int iterations = 20;
+
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(32);
+  sphere->SetPhiResolution(32);
+  sphere->SetCenter(rank, 0, 0);
+  sphere->Update();
+
+  int retVal = EXIT_SUCCESS;
+  {
+  vtkNew<vtkBenchmarkSessionCore> core;
+  vtkNew<vtkPVDataInformation> gathered;
+  vtkNew<vtkPVDataInformation> reduced;
+
+  double gatherTime = TimeCollect(controller.GetPointer(), core.GetPointer(),
+    sphere->GetOutput(), vtkPVSessionCore::GATHER_TO_ROOT, iterations,
+    gathered.GetPointer());
+  double reduceTime = TimeCollect(controller.GetPointer(), core.GetPointer(),
+    sphere->GetOutput(), vtkPVSessionCore::TREE_REDUCTION, iterations,
+    reduced.GetPointer());
+
+  if (rank == 0)
+    {
+    cout << "Ranks: " << nranks
+         << " GATHER_TO_ROOT: " << gatherTime << " s"
+         << " TREE_REDUCTION: " << reduceTime << " s" << endl;
+
+    vtkIdType expected = nranks * sphere->GetOutput()->GetNumberOfPoints();
+    double* gbounds = gathered->GetBounds();
+    double* rbounds = reduced->GetBounds();
+    if (gathered->GetNumberOfPoints() != expected ||
+      reduced->GetNumberOfPoints() != expected ||
+      gathered->GetNumberOfCells() != reduced->GetNumberOfCells() ||
+      gbounds[0] != rbounds[0] || gbounds[1] != rbounds[1])
+      {
+      cerr << "ERROR: collected information mismatch. Expected "
+           << expected << " points, got " << gathered->GetNumberOfPoints()
+           << " (gather) and " << reduced->GetNumberOfPoints()
+           << " (reduction)." << endl;
+      retVal = EXIT_FAILURE;
+      }
+    }
+  controller->Broadcast(&retVal, 1, 0);
+
+  // The root session core breaks the satellites' RMI loop when deleted.
+  if (rank > 0)
+    {
+    controller->ProcessRMIs();
+    }
+  }
+
+  controller->Finalize();
+  return retVal;
+}
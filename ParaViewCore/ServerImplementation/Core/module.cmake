@@ -8,4 +8,7 @@ vtk_module(vtkPVServerImplementationCore
     vtksys
   TEST_LABELS
     PARAVIEW
+  TEST_DEPENDS
+    vtkFiltersSources
+    vtkTestingCore
 )
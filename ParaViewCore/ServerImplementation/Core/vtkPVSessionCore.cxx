@@ -41,6 +41,7 @@
 #include <fstream>
 #include <set>
 #include <string>
+#include <vector>
 #include <vtksys/ios/sstream>
 
 
@@ -260,6 +261,7 @@ vtkPVSessionCore::vtkPVSessionCore()
     vtkClientServerInterpreterInitializer::GetInitializer()->NewInterpreter();
   this->MPIMToNSocketConnection = NULL;
   this->SymmetricMPIMode = false;
+  this->CollectInformationMode = TREE_REDUCTION;
 
   vtkPVSessionCoreInterpreterHelper* helper =
     vtkPVSessionCoreInterpreterHelper::New();
@@ -554,6 +556,9 @@ void vtkPVSessionCore::PushStateSatelliteCallback()
 void vtkPVSessionCore::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "CollectInformationMode: "
+     << (this->CollectInformationMode == TREE_REDUCTION?
+       "TREE_REDUCTION" : "GATHER_TO_ROOT") << endl;
 }
 
 //----------------------------------------------------------------------------
@@ -891,7 +896,8 @@ bool vtkPVSessionCore::GatherInformation( vtkTypeUInt32 location,
                                                       ROOT_SATELLITE_RMI_TAG);
 
     vtkMultiProcessStream stream;
-    stream << information->GetClassName() << globalid;
+    stream << information->GetClassName() << globalid
+           << this->CollectInformationMode;
 
     // serialize information parameters so all processes have the same ivars.
     information->CopyParametersToStream(stream);
@@ -910,7 +916,8 @@ void vtkPVSessionCore::GatherInformationStatelliteCallback()
 
   std::string classname;
   vtkTypeUInt32 globalid;
-  stream >> classname >> globalid;
+  int mode;
+  stream >> classname >> globalid >> mode;
 
   vtkSmartPointer<vtkObject> o;
   o.TakeReference(vtkPVInstantiator::CreateInstance(classname.c_str()));
@@ -919,13 +926,13 @@ void vtkPVSessionCore::GatherInformationStatelliteCallback()
     {
     info->CopyParametersFromStream(stream);
     this->GatherInformationInternal(info, globalid);
-    this->CollectInformation(info);
+    this->CollectInformation(info, mode);
     }
   else
     {
     vtkErrorMacro("Could not gather information on Satellite.");
     // let the parent know, otherwise root will hang.
-    this->CollectInformation(NULL);
+    this->CollectInformation(NULL, mode);
     }
 }
 
@@ -938,20 +945,95 @@ void vtkPVSessionCore::GatherInformationStatelliteCallback()
     }                                  \
 }
 
-bool vtkPVSessionCore::CollectInformation(vtkPVInformation* info)
+bool vtkPVSessionCore::CollectInformation(vtkPVInformation* info, int mode)
 {
-  // Sanity checks
-  assert("pre: NULL PV information!" && (info != NULL) );
+  if (this->ParallelController->GetNumberOfProcesses() == 1)
+    {
+    /* short-circuit */
+    return true;
+    }
 
-  // STEP 0: temporary variables
+  return (mode == GATHER_TO_ROOT)?
+    this->GatherInformationToRoot(info) : this->ReduceInformation(info);
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVSessionCore::ReduceInformation(vtkPVInformation* info)
+{
   int rank   = this->ParallelController->GetLocalProcessId();
   int nranks = this->ParallelController->GetNumberOfProcesses();
 
-  if( nranks == 1 )
+  // Binomial tree: at step k, ranks with the k-th bit set send their partial
+  // summary to (rank - 2^k) and are done, the others receive from
+  // (rank + 2^k). Children are visited in increasing rank order, hence the
+  // merge order matches the one of the rank-0 gather.
+  std::vector<unsigned char> rcvbuffer;
+  vtkClientServerStream rcvStream;
+  for (int mask = 1; mask < nranks; mask <<= 1)
     {
-    /* short-circuit */
-    return true;
+    if ((rank & mask) != 0)
+      {
+      int parent = rank - mask;
+      vtkClientServerStream stream;
+      const unsigned char* data = NULL;
+      size_t length = 0;
+      if (info)
+        {
+        info->CopyToStream(&stream);
+        stream.GetData(&data, &length);
+        }
+
+      // A zero length tells the parent there is nothing to merge, which is
+      // what happens when the information could not be created here.
+      vtkIdType sendLength = static_cast<vtkIdType>(length);
+      this->ParallelController->Send(&sendLength, 1, parent,
+        ROOT_SATELLITE_INFO_TAG);
+      if (sendLength > 0)
+        {
+        this->ParallelController->Send(data, sendLength, parent,
+          ROOT_SATELLITE_INFO_TAG);
+        }
+      break;
+      }
+
+    int child = rank + mask;
+    if (child >= nranks)
+      {
+      continue;
+      }
+
+    vtkIdType rcvLength = 0;
+    this->ParallelController->Receive(&rcvLength, 1, child,
+      ROOT_SATELLITE_INFO_TAG);
+    if (rcvLength <= 0)
+      {
+      continue;
+      }
+
+    rcvbuffer.resize(static_cast<size_t>(rcvLength));
+    this->ParallelController->Receive(&rcvbuffer[0], rcvLength, child,
+      ROOT_SATELLITE_INFO_TAG);
+    if (info)
+      {
+      rcvStream.SetData(&rcvbuffer[0], rcvbuffer.size());
+      vtkPVInformation* tempInfo = info->NewInstance();
+      tempInfo->CopyFromStream(&rcvStream);
+      info->AddInformation(tempInfo);
+      tempInfo->Delete();
+      }
     }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVSessionCore::GatherInformationToRoot(vtkPVInformation* info)
+{
+  // Sanity checks
+  assert("pre: NULL PV information!" && (info != NULL) );
+
+  // STEP 0: temporary variables
+  int rank   = this->ParallelController->GetLocalProcessId();
+  int nranks = this->ParallelController->GetNumberOfProcesses();
 
   vtkIdType *rcvcounts     = NULL;   /* significant only at rank 0 */
   vtkIdType *offSet        = NULL;   /* significant only at rank 0 */
@@ -139,6 +139,23 @@ public:
   // b = a + 10;
   virtual vtkTypeUInt32 GetNextChunkGlobalUniqueIdentifier(vtkTypeUInt32 chunkSize);
 
+  // Description:
+  // Get/Set how information is collected from the MPI satellites in
+  // GatherInformation(). In GATHER_TO_ROOT mode, every rank sends its
+  // serialized information to the root which then merges all of them in turn.
+  // In TREE_REDUCTION mode (default), the ranks are arranged in a binomial tree
+  // and each rank merges the information from its children before forwarding
+  // the summary to its parent, hence the root only ever receives log(N)
+  // partial summaries. The mode of the root process is forwarded to the
+  // satellites with each request, so this only needs to be set on the root.
+  enum CollectInformationModes
+    {
+    GATHER_TO_ROOT = 0,
+    TREE_REDUCTION = 1
+    };
+  vtkSetClampMacro(CollectInformationMode, int, GATHER_TO_ROOT, TREE_REDUCTION);
+  vtkGetMacro(CollectInformationMode, int);
+
 //BTX
 
   enum MessageTypes
@@ -190,8 +207,22 @@ protected:
                                   vtkTypeUInt32 globalid );
 
   // Description:
-  // Gather informations across MPI satellites.
-  bool CollectInformation(vtkPVInformation*);
+  // Gather informations across MPI satellites. Dispatches to
+  // GatherInformationToRoot() or ReduceInformation() based on \c mode.
+  bool CollectInformation(vtkPVInformation*, int mode);
+  bool CollectInformation(vtkPVInformation* info)
+    { return this->CollectInformation(info, this->CollectInformationMode); }
+
+  // Description:
+  // Gather the serialized information from all satellites to the root and
+  // merge it there (GATHER_TO_ROOT mode).
+  bool GatherInformationToRoot(vtkPVInformation*);
+
+  // Description:
+  // Merge the information from all satellites using a binomial tree
+  // (TREE_REDUCTION mode). Children are merged in rank order so the result is
+  // the same as merging each rank's information in turn on the root.
+  bool ReduceInformation(vtkPVInformation*);
 
   // Description:
   // Increment reference count of a local vtkSIObject.
@@ -217,6 +248,7 @@ protected:
   vtkWeakPointer<vtkMultiProcessController> ParallelController;
   vtkClientServerInterpreter* Interpreter;
   vtkMPIMToNSocketConnection* MPIMToNSocketConnection;
+  int CollectInformationMode;
 
 private:
   vtkPVSessionCore(const vtkPVSessionCore&); // Not implemented
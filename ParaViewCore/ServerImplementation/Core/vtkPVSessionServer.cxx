@@ -479,25 +479,28 @@ void vtkPVSessionServer::OnClientServerMessageRMI(void* message, int message_len
   switch (type)
     {
   case vtkPVSessionServer::PUSH:
+  case vtkPVSessionServer::REGISTER_SI:
+  case vtkPVSessionServer::UNREGISTER_SI:
       {
       std::string string;
       stream >> string;
-      vtkSMMessage msg;
-      msg.ParseFromString(string);
-
-//      cout << "=================================" << endl;
-//      msg.PrintDebugString();
-//      cout << "=================================" << endl;
+      this->ProcessClientMessage(type, string);
+      }
+    break;
 
-      // Do we skip the processing ?
-      if(!this->Internal->StoreShareOnly(&msg))
+  case vtkPVSessionServer::BATCH:
+      {
+      // The messages of a transaction on the client, they are applied in
+      // order before any other request of the client is processed.
+      int count;
+      stream >> count;
+      for (int cc=0; cc < count; cc++)
         {
-        this->PushState(&msg);
+        int messageType;
+        std::string string;
+        stream >> messageType >> string;
+        this->ProcessClientMessage(messageType, string);
         }
-
-      // Notify when ProxyManager state has changed
-      // or any other state change
-      this->NotifyOtherClients(&msg);
       }
     break;
 
@@ -520,25 +523,6 @@ void vtkPVSessionServer::OnClientServerMessageRMI(void* message, int message_len
       this->Internal->GetActiveController()->Send( css, 1, vtkPVSessionServer::REPLY_PULL);
       }
     break;
-  case vtkPVSessionServer::REGISTER_SI:
-      {
-      std::string string;
-      stream >> string;
-      vtkSMMessage msg;
-      msg.ParseFromString(string);
-      this->RegisterSIObject(&msg);
-      }
-    break;
-  case vtkPVSessionServer::UNREGISTER_SI:
-      {
-      std::string string;
-      stream >> string;
-      vtkSMMessage msg;
-      msg.ParseFromString(string);
-      this->UnRegisterSIObject(&msg);
-      }
-    break;
-
   case vtkPVSessionServer::EXECUTE_STREAM:
       {
       int ignore_errors, size;
@@ -572,6 +556,40 @@ void vtkPVSessionServer::OnClientServerMessageRMI(void* message, int message_len
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkPVSessionServer::ProcessClientMessage(int type,
+  const std::string& string)
+{
+  vtkSMMessage msg;
+  msg.ParseFromString(string);
+  switch (type)
+    {
+  case vtkPVSessionServer::PUSH:
+//      cout << "=================================" << endl;
+//      msg.PrintDebugString();
+//      cout << "=================================" << endl;
+
+      // Do we skip the processing ?
+      if(!this->Internal->StoreShareOnly(&msg))
+        {
+        this->PushState(&msg);
+        }
+
+      // Notify when ProxyManager state has changed
+      // or any other state change
+      this->NotifyOtherClients(&msg);
+    break;
+
+  case vtkPVSessionServer::REGISTER_SI:
+      this->RegisterSIObject(&msg);
+    break;
+
+  case vtkPVSessionServer::UNREGISTER_SI:
+      this->UnRegisterSIObject(&msg);
+    break;
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkPVSessionServer::SendLastResultToClient()
 {
@@ -25,6 +25,7 @@
 
 #include "vtkPVServerImplementationCoreModule.h" //needed for exports
 #include "vtkPVSessionBase.h"
+#include <string> // needed for std::string
 
 class vtkMultiProcessController;
 class vtkMultiProcessStream;
@@ -75,6 +76,7 @@ public:
     REGISTER_SI                     = 16,
     UNREGISTER_SI                   = 17,
     LAST_RESULT                     = 18,
+    BATCH                           = 19,
     SERVER_NOTIFICATION_MESSAGE_RMI = 55624,
     CLIENT_SERVER_MESSAGE_RMI       = 55625,
     CLOSE_SESSION                   = 55626,
@@ -119,6 +121,11 @@ protected:
   // Sends the last result to client.
   void SendLastResultToClient();
 
+  // Description:
+  // Applies a PUSH, REGISTER_SI or UNREGISTER_SI message, sent on its own or
+  // as a part of a BATCH.
+  void ProcessClientMessage(int type, const std::string& message);
+
   vtkMPIMToNSocketConnection* MPIMToNSocketConnection;
 
   bool MultipleConnection;
@@ -123,6 +123,16 @@ public:
   // vtkPVSession::CLIENT_AND_SERVERS suitable for builtin-mode.
   virtual ServerFlags GetProcessRoles();
 
+  // Description:
+  // Transactions coalesce the messages pushed to the servers. Sessions
+  // connected to remote servers keep them until the outermost
+  // EndTransaction() and then send them as one message per server. Any
+  // request that needs the servers sends the pending messages first.
+  // Transactions can be nested. The implementation provided by this class
+  // does nothing since builtin sessions do not send messages.
+  virtual void BeginTransaction() {}
+  virtual void EndTransaction() {}
+
 //BTX
   // Description:
   // Push the state message. Overridden to ensure that the information in the
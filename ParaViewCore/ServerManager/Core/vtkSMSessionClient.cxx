@@ -47,10 +47,21 @@
 
 #include <assert.h>
 #include <set>
+#include <utility>
+#include <vector>
 
 //****************************************************************************/
 //                    Internal Classes and typedefs
 //****************************************************************************/
+// Messages queued during a transaction, with their type, for each server.
+class vtkSMSessionClient::vtkPendingMessages
+{
+public:
+  typedef std::vector<std::pair<int, std::string> > MessagesType;
+  MessagesType DataServer;
+  MessagesType RenderServer;
+};
+
 namespace
 {
   void RMICallback(void *localArg,
@@ -92,6 +103,8 @@ vtkSMSessionClient::vtkSMSessionClient() : Superclass(false)
   // Default value
   this->NoMoreDelete = false;
   this->NotBusy = 0;
+  this->TransactionDepth = 0;
+  this->PendingMessages = new vtkPendingMessages();
 }
 
 //----------------------------------------------------------------------------
@@ -120,11 +133,17 @@ vtkSMSessionClient::~vtkSMSessionClient()
 
   delete this->ServerLastInvokeResult;
   this->ServerLastInvokeResult = NULL;
+
+  delete this->PendingMessages;
+  this->PendingMessages = NULL;
 }
 
 //----------------------------------------------------------------------------
 vtkMultiProcessController* vtkSMSessionClient::GetController(ServerFlags processType)
 {
+  // The caller is going to communicate with the server directly.
+  this->FlushPendingMessages();
+
   switch (processType)
     {
   case CLIENT:
@@ -456,6 +475,7 @@ bool vtkSMSessionClient::IsMPIInitialized(vtkTypeUInt32 servers)
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::CloseSession()
 {
+  this->FlushPendingMessages();
   if (this->DataServerController)
     {
     this->DataServerController->TriggerRMIOnAllChildren(
@@ -525,16 +545,10 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
     }
   if (num_controllers > 0)
     {
-    vtkMultiProcessStream stream;
-    stream << static_cast<int>(vtkPVSessionServer::PUSH);
-    stream << message->SerializeAsString();
-    std::vector<unsigned char> raw_message;
-    stream.GetRawData(raw_message);
+    std::string string = message->SerializeAsString();
     for (int cc=0; cc < num_controllers; cc++)
       {
-      controllers[cc]->TriggerRMIOnAllChildren(
-          &raw_message[0], static_cast<int>(raw_message.size()),
-          vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+      this->SendToServer(controllers[cc], vtkPVSessionServer::PUSH, string);
       }
     }
 
@@ -566,14 +580,8 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
         msg.set_share_only(true);
         msg.set_client_id(this->ServerInformation->GetClientId());
 
-        vtkMultiProcessStream stream;
-        stream << static_cast<int>(vtkPVSessionServer::PUSH);
-        stream << msg.SerializeAsString();
-        std::vector<unsigned char> raw_message;
-        stream.GetRawData(raw_message);
-        this->DataServerController->TriggerRMIOnAllChildren(
-            &raw_message[0], static_cast<int>(raw_message.size()),
-            vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+        this->SendToServer(this->DataServerController,
+          vtkPVSessionServer::PUSH, msg.SerializeAsString());
         }
       else if(!remoteObject)
         {
@@ -624,6 +632,7 @@ void vtkSMSessionClient::PullState(vtkSMMessage* message)
 
   if (controller)
     {
+    this->FlushPendingMessages();
     vtkMultiProcessStream stream;
     stream << static_cast<int>(vtkPVSessionServer::PULL);
     stream << message->SerializeAsString();
@@ -676,6 +685,8 @@ void vtkSMSessionClient::ExecuteStream(
 
   if ( num_controllers > 0)
     {
+    // The stream is sent with its own RMI, it cannot be queued.
+    this->FlushPendingMessages();
     const unsigned char* data;
     size_t size;
     cssstream.GetData(&data, &size);
@@ -726,6 +737,7 @@ const vtkClientServerStream& vtkSMSessionClient::GetLastResult(vtkTypeUInt32 loc
 
   if (controller)
     {
+    this->FlushPendingMessages();
     this->ServerLastInvokeResult->Reset();
 
     vtkMultiProcessStream stream;
@@ -810,6 +822,7 @@ bool vtkSMSessionClient::GatherInformation(
 
   if (controller)
     {
+    this->FlushPendingMessages();
     controller->TriggerRMIOnAllChildren(
       &raw_message[0], static_cast<int>(raw_message.size()),
       vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
@@ -876,16 +889,11 @@ void vtkSMSessionClient::UnRegisterSIObject(vtkSMMessage* message)
     }
   if (num_controllers > 0)
     {
-    vtkMultiProcessStream stream;
-    stream << static_cast<int>(vtkPVSessionServer::UNREGISTER_SI);
-    stream << message->SerializeAsString();
-    std::vector<unsigned char> raw_message;
-    stream.GetRawData(raw_message);
+    std::string string = message->SerializeAsString();
     for (int cc=0; cc < num_controllers; cc++)
       {
-      controllers[cc]->TriggerRMIOnAllChildren(
-        &raw_message[0], static_cast<int>(raw_message.size()),
-        vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+      this->SendToServer(controllers[cc], vtkPVSessionServer::UNREGISTER_SI,
+        string);
       }
     }
 
@@ -920,18 +928,13 @@ void vtkSMSessionClient::RegisterSIObject(vtkSMMessage* message)
     }
   if (num_controllers > 0)
     {
-    vtkMultiProcessStream stream;
-    stream << static_cast<int>(vtkPVSessionServer::REGISTER_SI);
-    stream << message->SerializeAsString();
-    std::vector<unsigned char> raw_message;
-    stream.GetRawData(raw_message);
+    std::string string = message->SerializeAsString();
     for (int cc=0; cc < num_controllers; cc++)
       {
       if(controllers[cc] != NULL)
         {
-        controllers[cc]->TriggerRMIOnAllChildren(
-              &raw_message[0], static_cast<int>(raw_message.size()),
-            vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+        this->SendToServer(controllers[cc], vtkPVSessionServer::REGISTER_SI,
+          string);
         }
       }
     }
@@ -942,6 +945,83 @@ void vtkSMSessionClient::RegisterSIObject(vtkSMMessage* message)
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::BeginTransaction()
+{
+  ++this->TransactionDepth;
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::EndTransaction()
+{
+  if (this->TransactionDepth <= 0)
+    {
+    vtkWarningMacro("EndTransaction() called without BeginTransaction().");
+    return;
+    }
+  if (--this->TransactionDepth == 0)
+    {
+    this->FlushPendingMessages();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::SendToServer(vtkMultiProcessController* controller,
+  int type, const std::string& message)
+{
+  if (this->TransactionDepth > 0)
+    {
+    vtkPendingMessages::MessagesType& pending =
+      (controller == this->DataServerController)?
+      this->PendingMessages->DataServer :
+      this->PendingMessages->RenderServer;
+    pending.push_back(std::pair<int, std::string>(type, message));
+    return;
+    }
+
+  vtkMultiProcessStream stream;
+  stream << type << message;
+  std::vector<unsigned char> raw_message;
+  stream.GetRawData(raw_message);
+  controller->TriggerRMIOnAllChildren(
+    &raw_message[0], static_cast<int>(raw_message.size()),
+    vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::FlushPendingMessages()
+{
+  vtkMultiProcessController* controllers[2] = {
+    this->DataServerController, this->RenderServerController };
+  vtkPendingMessages::MessagesType* pendings[2] = {
+    &this->PendingMessages->DataServer,
+    &this->PendingMessages->RenderServer };
+  for (int cc=0; cc < 2; cc++)
+    {
+    vtkPendingMessages::MessagesType& pending = *pendings[cc];
+    if (pending.empty())
+      {
+      continue;
+      }
+    if (controllers[cc])
+      {
+      vtkMultiProcessStream stream;
+      stream << static_cast<int>(vtkPVSessionServer::BATCH)
+             << static_cast<int>(pending.size());
+      for (size_t kk=0; kk < pending.size(); kk++)
+        {
+        stream << pending[kk].first << pending[kk].second;
+        }
+      std::vector<unsigned char> raw_message;
+      stream.GetRawData(raw_message);
+      controllers[cc]->TriggerRMIOnAllChildren(
+        &raw_message[0], static_cast<int>(raw_message.size()),
+        vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+      }
+    pending.clear();
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -23,6 +23,7 @@
 
 #include "vtkPVServerManagerCoreModule.h" //needed for exports
 #include "vtkSMSession.h"
+#include <string> // needed for std::string
 
 class vtkMultiProcessController;
 class vtkPVServerInformation;
@@ -87,6 +88,14 @@ public:
   // applicable.
   virtual void Initialize();
 
+  // Description:
+  // Overridden to queue the messages pushed to the servers during a
+  // transaction (state pushes and registration of server-side objects) and to
+  // send them as a single message per server when the outermost transaction
+  // ends. The server applies them in order before any other request.
+  virtual void BeginTransaction();
+  virtual void EndTransaction();
+
 //BTX
   // Description:
   // Push the state.
@@ -200,6 +209,18 @@ protected:
   // render-server exists.
   vtkTypeUInt32 GetRealLocation(vtkTypeUInt32);
 
+  // Description:
+  // Sends a PUSH, REGISTER_SI or UNREGISTER_SI message to the server, or
+  // queues it during a transaction.
+  void SendToServer(vtkMultiProcessController* controller, int type,
+    const std::string& message);
+
+  // Description:
+  // Sends the messages queued during a transaction. This is called before
+  // any other communication with the servers so that the order of the
+  // messages is kept.
+  void FlushPendingMessages();
+
   // Both maybe the same when connected to pvserver.
   vtkMultiProcessController* RenderServerController;
   vtkMultiProcessController* DataServerController;
@@ -241,6 +262,10 @@ private:
   int NotBusy;
   vtkTypeUInt32 LastGlobalID;
   vtkTypeUInt32 LastGlobalIDAvailable;
+
+  int TransactionDepth;
+  class vtkPendingMessages;
+  vtkPendingMessages* PendingMessages;
 //ETX
 };
 
@@ -894,6 +894,7 @@ void vtkSMSessionProxyManager::UpdateRegisteredProxies(const char* groupname,
     this->Internals->RegisteredProxyMap.find(groupname);
   if ( it != this->Internals->RegisteredProxyMap.end() )
     {
+    this->BeginTransaction();
     vtkSMProxyManagerProxyMapType::iterator it2 = it->second.begin();
     for (; it2 != it->second.end(); it2++)
       {
@@ -910,6 +911,7 @@ void vtkSMSessionProxyManager::UpdateRegisteredProxies(const char* groupname,
           }
         }
       }
+    this->EndTransaction();
     }
 }
 
@@ -918,6 +920,8 @@ void vtkSMSessionProxyManager::UpdateRegisteredProxies(int modified_only /*=1*/)
 {
   vtksys::RegularExpression prototypesRe("_prototypes$");
 
+  this->BeginTransaction();
+
   vtkSMSessionProxyManagerInternals::ProxyGroupType::iterator it =
     this->Internals->RegisteredProxyMap.begin();
   for (; it != this->Internals->RegisteredProxyMap.end(); it++)
@@ -946,6 +950,7 @@ void vtkSMSessionProxyManager::UpdateRegisteredProxies(int modified_only /*=1*/)
         }
       }
     }
+  this->EndTransaction();
 }
 
 //---------------------------------------------------------------------------
@@ -964,6 +969,24 @@ void vtkSMSessionProxyManager::UpdateProxyInOrder(vtkSMProxy* proxy)
   this->UpdateInputProxies = 0;
 }
 
+//---------------------------------------------------------------------------
+void vtkSMSessionProxyManager::BeginTransaction()
+{
+  if (this->Session)
+    {
+    this->Session->BeginTransaction();
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkSMSessionProxyManager::EndTransaction()
+{
+  if (this->Session)
+    {
+    this->Session->EndTransaction();
+    }
+}
+
 //---------------------------------------------------------------------------
 int vtkSMSessionProxyManager::GetNumberOfLinks()
 {
@@ -1199,7 +1222,11 @@ void vtkSMSessionProxyManager::LoadXMLState( vtkPVXMLElement* rootElement,
     {
     spLoader = loader;
     }
-  if (spLoader->LoadState(rootElement, keepOriginalIds))
+  // Coalesce the messages of all the proxies created by the state.
+  this->BeginTransaction();
+  bool loaded = spLoader->LoadState(rootElement, keepOriginalIds) != 0;
+  this->EndTransaction();
+  if (loaded)
     {
     vtkSMProxyManager::LoadStateInformation info;
     info.RootElement = rootElement;
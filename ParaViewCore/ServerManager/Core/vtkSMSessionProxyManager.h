@@ -281,6 +281,18 @@ public:
   void UpdateRegisteredProxiesInOrder(int modified_only=1);
   void UpdateProxyInOrder(vtkSMProxy* proxy);
 
+  // Description:
+  // Starts/ends a transaction. Between the two calls, the proxy creations,
+  // property pushes and registrations are not sent to the server one at a
+  // time: they are queued and sent as one message to each server at the
+  // outermost EndTransaction(), and applied there in order. Requests that
+  // need an answer from the server, e.g. gathering information, send the
+  // queued messages first. Transactions can be nested, every
+  // BeginTransaction() must be followed by an EndTransaction().
+  // LoadXMLState() and UpdateRegisteredProxies() use a transaction.
+  void BeginTransaction();
+  void EndTransaction();
+
   // Description:
   // Get the number of registered links with the server manager.
   int GetNumberOfLinks();
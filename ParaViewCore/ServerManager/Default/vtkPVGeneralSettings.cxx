@@ -46,8 +46,9 @@ vtkPVGeneralSettings::vtkPVGeneralSettings()
   DefaultViewType(NULL),
   TransferFunctionResetMode(vtkPVGeneralSettings::GROW_ON_APPLY),
   ScalarBarMode(vtkPVGeneralSettings::AUTOMATICALLY_HIDE_SCALAR_BARS),
-  CacheGeometryForAnimation(false),
+  CacheGeometryForAnimation(true),
   AnimationGeometryCacheLimit(0),
+  AnimationGeometryCacheEvictionPolicy(vtkCacheSizeKeeper::LEAST_RECENTLY_USED),
   PropertiesPanelMode(vtkPVGeneralSettings::ALL_IN_ONE)
 {
   this->SetDefaultViewType("RenderView");
@@ -142,6 +143,17 @@ void vtkPVGeneralSettings::SetAnimationGeometryCacheLimit(unsigned long val)
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkPVGeneralSettings::SetAnimationGeometryCacheEvictionPolicy(int val)
+{
+  vtkCacheSizeKeeper::GetInstance()->SetEvictionPolicy(val);
+  if (this->AnimationGeometryCacheEvictionPolicy != val)
+    {
+    this->AnimationGeometryCacheEvictionPolicy = val;
+    this->Modified();
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkPVGeneralSettings::SetScalarBarMode(int val)
 {
@@ -206,5 +218,7 @@ void vtkPVGeneralSettings::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "ScalarBarMode: " << this->ScalarBarMode << "\n";
   os << indent << "CacheGeometryForAnimation: " << this->CacheGeometryForAnimation << "\n";
   os << indent << "AnimationGeometryCacheLimit: " << this->AnimationGeometryCacheLimit << "\n";
+  os << indent << "AnimationGeometryCacheEvictionPolicy: "
+     << this->AnimationGeometryCacheEvictionPolicy << "\n";
   os << indent << "PropertiesPanelMode: " << this->PropertiesPanelMode << "\n";
 }
@@ -123,6 +123,12 @@ public:
   void SetAnimationGeometryCacheLimit(unsigned long val);
   vtkGetMacro(AnimationGeometryCacheLimit, unsigned long);
 
+  // Description:
+  // Set the policy used to discard cached geometry when the animation cache
+  // limit is exceeded (see vtkCacheSizeKeeper::EvictionPolicies).
+  void SetAnimationGeometryCacheEvictionPolicy(int val);
+  vtkGetMacro(AnimationGeometryCacheEvictionPolicy, int);
+
   // Description:
   // Forwarded for vtkSMParaViewPipelineControllerWithRendering.
   void SetInheritRepresentationProperties(bool val);
@@ -161,6 +167,7 @@ protected:
   int ScalarBarMode;
   bool CacheGeometryForAnimation;
   unsigned long AnimationGeometryCacheLimit;
+  int AnimationGeometryCacheEvictionPolicy;
   int PropertiesPanelMode;
 
 private:
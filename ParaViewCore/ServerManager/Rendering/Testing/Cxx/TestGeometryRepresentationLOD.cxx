@@ -0,0 +1,167 @@
+/*=========================================================================
+
+Program:   ParaView
+Module:    TestGeometryRepresentationLOD.cxx
+
+Copyright (c) Kitware, Inc.
+All rights reserved.
+See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests that the LOD levels of vtkGeometryRepresentation are decimated in the
+// background as soon as the view is updated past the LOD threshold, that
+// each level is coarser than the previous one and that a build superseded
+// by a newer one is aborted.
+
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkCompositeRepresentation.h"
+#include "vtkDataSet.h"
+#include "vtkGeometryRepresentation.h"
+#include "vtkInitializationHelper.h"
+#include "vtkNew.h"
+#include "vtkProcessModule.h"
+#include "vtkPVDataInformation.h"
+#include "vtkSMParaViewPipelineController.h"
+#include "vtkSMPropertyHelper.h"
+#include "vtkSMSession.h"
+#include "vtkSMSessionProxyManager.h"
+#include "vtkSMSourceProxy.h"
+#include "vtkSMViewProxy.h"
+#include "vtkSmartPointer.h"
+
+namespace
+{
+  vtkIdType GetNumberOfCells(vtkDataObject* dobj)
+    {
+    vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(dobj);
+    if (cd == NULL)
+      {
+      vtkDataSet* ds = vtkDataSet::SafeDownCast(dobj);
+      return ds? ds->GetNumberOfCells() : 0;
+      }
+    vtkIdType numCells = 0;
+    vtkCompositeDataIterator* iter = cd->NewIterator();
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+      iter->GoToNextItem())
+      {
+      numCells += GetNumberOfCells(iter->GetCurrentDataObject());
+      }
+    iter->Delete();
+    return numCells;
+    }
+}
+
+int TestGeometryRepresentationLOD(int argc, char* argv[])
+{
+  (void) argc;
+  vtkInitializationHelper::Initialize(argv[0], vtkProcessModule::PROCESS_CLIENT);
+
+  vtkNew<vtkSMParaViewPipelineController> controller;
+
+  // Create a new session.
+  vtkSMSession* session = vtkSMSession::New();
+  vtkSMSessionProxyManager* pxm = session->GetSessionProxyManager();
+  if (!controller->InitializeSession(session))
+    {
+    cerr << "ERROR: Failed to initialize ParaView session." << endl;
+    return EXIT_FAILURE;
+    }
+
+  int status = EXIT_SUCCESS;
+    {
+    // A sphere big enough for each level to take a while to decimate.
+    vtkSmartPointer<vtkSMSourceProxy> sphere;
+    sphere.TakeReference(vtkSMSourceProxy::SafeDownCast(
+        pxm->NewProxy("sources", "SphereSource")));
+    controller->PreInitializeProxy(sphere);
+    vtkSMPropertyHelper(sphere, "ThetaResolution").Set(1024);
+    vtkSMPropertyHelper(sphere, "PhiResolution").Set(1024);
+    sphere->UpdateVTKObjects();
+    controller->PostInitializeProxy(sphere);
+    controller->RegisterPipelineProxy(sphere);
+
+    vtkSmartPointer<vtkSMViewProxy> view;
+    view.TakeReference(vtkSMViewProxy::SafeDownCast(
+        pxm->NewProxy("views", "RenderView")));
+    controller->PreInitializeProxy(view);
+    controller->PostInitializeProxy(view);
+    vtkSMPropertyHelper(view, "LODThreshold").Set(0.0);
+    view->UpdateVTKObjects();
+    controller->RegisterViewProxy(view);
+
+    vtkSmartPointer<vtkSMProxy> repr;
+    repr.TakeReference(view->CreateDefaultRepresentation(sphere, 0));
+    controller->PreInitializeProxy(repr);
+    vtkSMPropertyHelper(repr, "Input").Set(sphere);
+    vtkSMPropertyHelper(repr, "NumberOfLODLevels").Set(3);
+    controller->PostInitializeProxy(repr);
+    controller->RegisterRepresentationProxy(repr);
+    vtkSMPropertyHelper(view, "Representations").Add(repr);
+    view->UpdateVTKObjects();
+
+    vtkCompositeRepresentation* composite =
+      vtkCompositeRepresentation::SafeDownCast(repr->GetClientSideObject());
+    vtkGeometryRepresentation* geometry = composite?
+      vtkGeometryRepresentation::SafeDownCast(
+        composite->GetActiveRepresentation()) : NULL;
+    if (geometry == NULL)
+      {
+      cerr << "ERROR: Failed at line " << __LINE__ << endl;
+      return EXIT_FAILURE;
+      }
+
+    // Updating the view starts the build, no interaction or LOD request is
+    // needed. Asking for a different number of levels right away supersedes
+    // it while its first levels are being decimated.
+    view->Update();
+    vtkSMPropertyHelper(repr, "NumberOfLODLevels").Set(4);
+    repr->UpdateVTKObjects();
+    view->Update();
+
+    vtkIdType numCells = sphere->GetDataInformation()->GetNumberOfCells();
+    vtkIdType previous = numCells;
+    for (int level = 0; level < 4; level++)
+      {
+      vtkDataObject* lod = geometry->WaitForLODLevel(level);
+      vtkIdType numLODCells = lod? GetNumberOfCells(lod) : 0;
+      cout << "Level " << level << ": " << numLODCells << " cells, full "
+           << "resolution: " << numCells << " cells." << endl;
+      if (lod == NULL || numLODCells <= 0 || numLODCells >= previous)
+        {
+        cerr << "ERROR: Level " << level << " is missing or not coarser "
+             << "than the previous one." << endl;
+        status = EXIT_FAILURE;
+        }
+      previous = numLODCells;
+      }
+    if (geometry->WaitForLODLevel(4) != NULL)
+      {
+      cerr << "ERROR: Failed at line " << __LINE__ << endl;
+      status = EXIT_FAILURE;
+      }
+
+    if (geometry->GetNumberOfAbortedLODBuilds() != 1)
+      {
+      cerr << "ERROR: The superseded build was not aborted." << endl;
+      status = EXIT_FAILURE;
+      }
+
+    // Nothing changed, so updating again must reuse the levels.
+    vtkDataObject* finest = geometry->WaitForLODLevel(0);
+    view->Update();
+    if (geometry->WaitForLODLevel(0) != finest)
+      {
+      cerr << "ERROR: Failed at line " << __LINE__ << endl;
+      status = EXIT_FAILURE;
+      }
+    }
+
+  session->Delete();
+  vtkInitializationHelper::Finalize();
+  return status;
+}
@@ -202,7 +202,19 @@ void vtkSMRenderViewProxy::UpdateLOD()
 {
   if (this->ObjectsCreated && this->NeedsUpdateLOD)
     {
+    // The LOD level change is based on the render times measured on the
+    // client, pass it on to the servers along with the request.
+    vtkPVRenderView* view = vtkPVRenderView::SafeDownCast(
+      this->GetClientSideObject());
     vtkClientServerStream stream;
+    if (view)
+      {
+      stream << vtkClientServerStream::Invoke
+             << VTKOBJECT(this)
+             << "SetLODLevelChange"
+             << view->GetLODLevelChange()
+             << vtkClientServerStream::End;
+      }
     stream << vtkClientServerStream::Invoke
            << VTKOBJECT(this)
            << "UpdateLOD"
@@ -211,7 +223,14 @@ void vtkSMRenderViewProxy::UpdateLOD()
     this->ExecuteStream(stream);
     this->GetSession()->CleanupPendingProgress();
 
-    this->NeedsUpdateLOD = false;
+    // When some LOD geometries are still being generated in the background,
+    // ask for them again on the next interactive render. The level change
+    // has been applied, the next render measures it again.
+    this->NeedsUpdateLOD = view? view->GetLODPending() : false;
+    if (view)
+      {
+      view->SetLODLevelChange(0);
+      }
     }
 }
 
@@ -284,6 +303,15 @@ vtkTypeUInt32 vtkSMRenderViewProxy::PreRender(bool interactive)
 //-----------------------------------------------------------------------------
 void vtkSMRenderViewProxy::PostRender(bool interactive)
 {
+  // Ask for other LOD levels when the render time calls for it.
+  vtkPVRenderView* rv = vtkPVRenderView::SafeDownCast(
+    this->GetClientSideObject());
+  if (interactive && rv && rv->GetUsedLODForLastRender() &&
+    rv->GetLODLevelChangeAvailable())
+    {
+    this->NeedsUpdateLOD = true;
+    }
+
   vtkSMProxy* cameraProxy = this->GetSubProxy("ActiveCamera");
   cameraProxy->UpdatePropertyInformation();
   this->SynchronizeCameraProperties();
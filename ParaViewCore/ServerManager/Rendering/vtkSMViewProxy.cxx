@@ -244,6 +244,20 @@ void vtkSMViewProxy::InteractiveRender()
   this->InvokeEvent(vtkCommand::EndEvent, &interactive);
 }
 
+//----------------------------------------------------------------------------
+void vtkSMViewProxy::Prefetch(double time)
+{
+  if (this->ObjectsCreated)
+    {
+    vtkClientServerStream stream;
+    stream << vtkClientServerStream::Invoke
+           << VTKOBJECT(this)
+           << "Prefetch" << time
+           << vtkClientServerStream::End;
+    this->ExecuteStream(stream);
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkSMViewProxy::Update()
 {
@@ -65,6 +65,11 @@ public:
   // Called vtkPVView::Update on the server-side.
   virtual void Update();
 
+  // Description:
+  // Calls vtkPVView::Prefetch on the server-side. The client doesn't wait for
+  // it to complete.
+  virtual void Prefetch(double time);
+
   // Description:
   // Returns true if the view can display the data produced by the producer's
   // port. Internally calls GetRepresentationType() and returns true only if the
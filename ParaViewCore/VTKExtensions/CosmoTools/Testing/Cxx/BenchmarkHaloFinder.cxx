@@ -0,0 +1,178 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    BenchmarkHaloFinder.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Times the serial friends-of-friends halo finder, the k-d tree on one
+// thread against the chaining mesh on several, for increasing numbers of
+// particles, and checks that every run gives the same halo tags.
+
+#include "CosmoHaloFinder.h"
+
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkTimerLog.h"
+
+#include <iostream>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Particles scattered in a box with a mean spacing of one, most of them
+// bunched in clumps so that the halos have a range of sizes.
+void makeParticles(int count,
+                   std::vector<POSVEL_T>& xx,
+                   std::vector<POSVEL_T>& yy,
+                   std::vector<POSVEL_T>& zz)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(8775070);
+
+  double side = pow((double)count, 1.0 / 3.0);
+  int nclump = count / 500 + 1;
+  std::vector<double> center(3 * nclump);
+  for (int c = 0; c < 3 * nclump; c++)
+    {
+    center[c] = random->GetRangeValue(0.0, side);
+    random->Next();
+    }
+
+  xx.resize(count);
+  yy.resize(count);
+  zz.resize(count);
+  std::vector<POSVEL_T>* loc[3] = { &xx, &yy, &zz };
+  for (int p = 0; p < count; p++)
+    {
+    int c = (int)(random->GetValue() * nclump);
+    random->Next();
+    bool inClump = random->GetValue() < 0.7;
+    random->Next();
+    double radius = 0.5 + 2.0 * random->GetValue();
+    random->Next();
+    for (int dim = 0; dim < 3; dim++)
+      {
+      double value;
+      if (inClump)
+        {
+        double offset = -1.5;
+        for (int n = 0; n < 3; n++)
+          {
+          offset += random->GetValue();
+          random->Next();
+          }
+        value = center[3 * c + dim] + radius * offset;
+        }
+      else
+        {
+        value = random->GetRangeValue(0.0, side);
+        random->Next();
+        }
+      (*loc[dim])[p] = (POSVEL_T)value;
+      }
+    }
+}
+
+// Runs the halo finder and returns the elapsed time
+double findHalos(int count, int nthreads,
+                 std::vector<POSVEL_T>& xx,
+                 std::vector<POSVEL_T>& yy,
+                 std::vector<POSVEL_T>& zz,
+                 std::vector<int>& haloTag)
+{
+  std::vector<int> haloStart(count);
+  std::vector<int> haloList(count);
+  haloTag.resize(count);
+
+  cosmotk::CosmoHaloFinder finder;
+  finder.np = (int)ceil(pow((double)count, 1.0 / 3.0));
+  finder.rL = (POSVEL_T)finder.np;
+  finder.bb = 0.2f;
+  finder.nmin = 1;
+  finder.pmin = 10;
+  finder.periodic = false;
+  finder.setParticleLocations(&xx[0], &yy[0], &zz[0]);
+  finder.setHaloLocations(&haloTag[0], &haloStart[0], &haloList[0]);
+  finder.setNumberOfParticles(count);
+  finder.setMyProc(0);
+  finder.setNumberOfThreads(nthreads);
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  finder.Finding();
+  timer->StopTimer();
+
+  return timer->GetElapsedTime();
+}
+
+}
+
+int BenchmarkHaloFinder(int, char*[])
+{
+  if (!cosmotk::CosmoHaloFinder::isThreaded())
+    {
+    std::cout
+      << "BenchmarkHaloFinder built without OpenMP, "
+      << "every run uses a single thread" << std::endl;
+    }
+
+  const int nsizes = 3;
+  const int sizes[nsizes] = { 1 << 15, 1 << 17, 1 << 19 };
+  const int nruns = 4;
+  const int threads[nruns] = { 1, 2, 4, 8 };
+
+  int retVal = 0;
+  for (int s = 0; s < nsizes; s++)
+    {
+    std::vector<POSVEL_T> xx, yy, zz;
+    makeParticles(sizes[s], xx, yy, zz);
+
+    std::vector<int> serialTag;
+    for (int r = 0; r < nruns; r++)
+      {
+      std::vector<int> haloTag;
+      double time =
+        findHalos(sizes[s], threads[r], xx, yy, zz, haloTag);
+
+      int nhalo = 0;
+      for (int p = 0; p < sizes[s]; p++)
+        {
+        if (haloTag[p] == p)
+          {
+          nhalo++;
+          }
+        }
+
+      std::cout
+        << "BenchmarkHaloFinder particles " << sizes[s]
+        << " threads " << threads[r]
+        << " halos " << nhalo
+        << " time " << time << "s" << std::endl;
+
+      if (r == 0)
+        {
+        serialTag.swap(haloTag);
+        }
+      else if (haloTag != serialTag)
+        {
+        std::cerr
+          << "Error: halo tags with " << threads[r]
+          << " threads differ from the k-d tree for "
+          << sizes[s] << " particles" << std::endl;
+        retVal = 1;
+        }
+      }
+    }
+
+  return retVal;
+}
@@ -12,6 +12,8 @@ vtk_module(vtkPVVTKExtensionsCosmoTools
    KIT
       vtkPVExtensions
    TEST_DEPENDS
+      vtkCommonSystem
+      vtkCosmoHaloFinder
       vtkTestingCore
       vtkTestingRendering
       vtkParallelMPI
@@ -45,13 +45,18 @@ MPI_Comm GetMPICommunicator(vtkMultiProcessController *mpc)
   return( comm );
 }
 
+namespace
+{
+
 //==============================================================================
-vtkDataArray* GetVtkDataArray(
-      std::string name, int type, void* rawBuffer, int N)
+// Description:
+// Creates a single-component data array matching the given GenericIO type
+// and returns the size of one element in dataSize, or NULL if the type is
+// not supported.
+vtkDataArray* NewDataArrayForType(int type, size_t& dataSize)
 {
-  assert("pre: cannot read from null buffer!" && (rawBuffer != NULL) );
   vtkDataArray *dataArray = NULL;
-  size_t dataSize = 0;
+  dataSize = 0;
 
   switch( type )
     {
@@ -84,13 +89,28 @@ vtkDataArray* GetVtkDataArray(
      dataSize  = sizeof(float);
      break;
     default:
-     dataSize = 0;
      return NULL;
     } // END switch
 
   assert("pre: null data array!" && (dataArray != NULL) );
-
   dataArray->SetNumberOfComponents(1);
+  return( dataArray );
+}
+
+}
+
+//==============================================================================
+vtkDataArray* GetVtkDataArray(
+      std::string name, int type, void* rawBuffer, int N)
+{
+  assert("pre: cannot read from null buffer!" && (rawBuffer != NULL) );
+  size_t dataSize = 0;
+  vtkDataArray *dataArray = NewDataArrayForType(type,dataSize);
+  if (dataArray == NULL)
+    {
+    return NULL;
+    }
+
   dataArray->SetNumberOfTuples( N );
   dataArray->SetName(name.c_str());
   if (N > 0)
@@ -102,6 +122,24 @@ vtkDataArray* GetVtkDataArray(
   return( dataArray );
 }
 
+//==============================================================================
+vtkDataArray* GetVtkDataArrayReference(
+      std::string name, int type, void* rawBuffer, int N)
+{
+  assert("pre: cannot read from null buffer!" && (rawBuffer != NULL) );
+  size_t dataSize = 0;
+  vtkDataArray *dataArray = NewDataArrayForType(type,dataSize);
+  if (dataArray == NULL)
+    {
+    return NULL;
+    }
+
+  // save=1: the array never frees the raw buffer, the caller owns it.
+  dataArray->SetVoidArray(rawBuffer,N,1);
+  dataArray->SetName(name.c_str());
+  return( dataArray );
+}
+
 //==============================================================================
 double GetDoubleFromRawBuffer(
       const int type, void* buffer, vtkIdType buffer_idx)
@@ -78,6 +78,14 @@ MPI_Comm GetMPICommunicator(vtkMultiProcessController *mpc);
 vtkDataArray* GetVtkDataArray(
       std::string name, int type, void* rawBuffer, int N);
 
+//==============================================================================
+// Description:
+// Same as GetVtkDataArray, except that the returned array references the
+// rawbuffer instead of copying it. The caller remains responsible for the
+// buffer and must keep it alive for as long as the array is in use.
+vtkDataArray* GetVtkDataArrayReference(
+      std::string name, int type, void* rawBuffer, int N);
+
 //==============================================================================
 // Description:
 // This method accesses the user-supplied buffer at the given index and
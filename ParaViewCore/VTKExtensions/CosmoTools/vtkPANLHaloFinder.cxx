@@ -219,6 +219,7 @@ vtkPANLHaloFinder::vtkPANLHaloFinder()
   this->NP = 1024;
   this->NMin = 1;
   this->PMin = 10000;
+  this->NumberOfThreads = 1;
   this->MinFOFSubhaloSize = 10000;
   this->MinCandidateSize = 200;
   this->NumSPHNeighbors = 64;
@@ -375,6 +376,7 @@ void vtkPANLHaloFinder::ExecuteHaloFinder(vtkUnstructuredGrid *allParticles,
 {
   this->Internal->haloFinder = new cosmotk::CosmoHaloFinderP();
   this->Internal->haloFinder->setParameters("",this->RL,this->DeadSize,this->NP,this->PMin,this->BB,this->NMin);
+  this->Internal->haloFinder->setNumberOfThreads(this->NumberOfThreads);
   this->Internal->haloFinder->setParticles(
       this->Internal->xx.size(),&this->Internal->xx[0],&this->Internal->yy[0],
       &this->Internal->zz[0],&this->Internal->vx[0],&this->Internal->vy[0],
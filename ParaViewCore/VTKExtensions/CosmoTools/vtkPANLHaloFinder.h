@@ -122,6 +122,14 @@ public:
   vtkSetMacro(NMin,int)
   vtkGetMacro(NMin,int)
 
+  // Description:
+  // Gets/Sets the number of threads used to find the halos on each process.
+  // More than one thread only applies when NMin is 1, and when the halo
+  // finder is built with OpenMP.
+  // Default: 1
+  vtkSetMacro(NumberOfThreads,int)
+  vtkGetMacro(NumberOfThreads,int)
+
   // Description:
   // Gets/Sets the minimum number of particles required for a halo candidate to
   // be considered a halo and output
@@ -227,6 +235,7 @@ protected:
   int NP;
   int NMin;
   int PMin;
+  int NumberOfThreads;
   long MinFOFSubhaloSize;
   int MinCandidateSize;
   int NumSPHNeighbors;
@@ -21,9 +21,11 @@
 #include "vtkDataArraySelection.h"
 #include "vtkGenericIOUtilities.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationKey.h"
 #include "vtkInformationDoubleKey.h"
+#include "vtkInformationObjectBaseKey.h"
 #include "vtkInformationVector.h"
 #include "vtkMultiProcessController.h"
 #include "vtkMultiBlockDataSet.h"
@@ -41,8 +43,8 @@
 #include "GenericIOReader.h"
 #include "GenericIOUtilities.h"
 
+#include <algorithm>
 #include <map>
-#include <set>
 #include <stdexcept>
 #include <utility>
 #include <vector>
@@ -53,6 +55,32 @@
 //#define DEBUG
 
 namespace {
+//------------------------------------------------------------------------------
+// Reference-counted owner of a raw GenericIO variable buffer. The block cache
+// holds one reference and every point data array adopting the buffer holds
+// another one through vtkPGenericIOMultiBlockReader::RAW_BUFFER(), so the
+// buffer outlives whichever of the two is released last.
+class vtkGenericIORawBuffer : public vtkObject
+{
+public:
+  static vtkGenericIORawBuffer* New();
+  vtkTypeMacro(vtkGenericIORawBuffer,vtkObject)
+
+  void* Buffer;
+
+protected:
+  vtkGenericIORawBuffer() : Buffer(NULL) {}
+  ~vtkGenericIORawBuffer()
+  {
+    delete [] static_cast< char* >(this->Buffer);
+  }
+
+private:
+  vtkGenericIORawBuffer(const vtkGenericIORawBuffer&); // Not implemented.
+  void operator=(const vtkGenericIORawBuffer&); // Not implemented.
+};
+vtkStandardNewMacro(vtkGenericIORawBuffer)
+
 struct block_t
 {
   vtkTypeUInt64 GlobalId;
@@ -62,6 +90,7 @@ struct block_t
   int ProcessId;
 
   std::map< std::string, void* > RawCache;
+  std::map< std::string, vtkSmartPointer< vtkGenericIORawBuffer > > RawOwners;
   std::map< std::string, bool > VariableStatus;
 };
 
@@ -152,24 +181,15 @@ public:
     this->VariableGenericIOType.clear();
     this->VariableInformation.clear();
 
-    for (std::map< int, block_t >::iterator blockItr = this->Blocks.begin();
-          blockItr != this->Blocks.end(); ++blockItr)
-      {
-      std::map< std::string, void* >::iterator varItr = blockItr->second.RawCache.begin();
-      for ( ; varItr != blockItr->second.RawCache.end(); ++varItr)
-        {
-        if (varItr->second != NULL )
-          {
-          delete [] static_cast< char* >(varItr->second);
-          }
-        }
-      }
+    // The raw buffers are released through their owners, so the ones still
+    // referenced by arrays of a previous output stay valid.
     this->Blocks.clear();
 
   }
 };
 
 vtkStandardNewMacro(vtkPGenericIOMultiBlockReader)
+vtkInformationKeyMacro(vtkPGenericIOMultiBlockReader,RAW_BUFFER,ObjectBase)
 //------------------------------------------------------------------------------
 vtkPGenericIOMultiBlockReader::vtkPGenericIOMultiBlockReader()
 {
@@ -602,6 +622,10 @@ void vtkPGenericIOMultiBlockReader::LoadRawVariableDataForBlock(
   dataBlock.RawCache[varName] =
     gio::GenericIOUtilities::AllocateVariableArray(
       this->MetaData->VariableInformation[varName],dataBlock.NumberOfElements);
+  vtkSmartPointer< vtkGenericIORawBuffer > owner =
+    vtkSmartPointer< vtkGenericIORawBuffer >::New();
+  owner->Buffer = dataBlock.RawCache[varName];
+  dataBlock.RawOwners[varName] = owner;
 
   this->Reader->AddVariable(
     this->MetaData->VariableInformation[varName],dataBlock.RawCache[varName]);
@@ -693,28 +717,98 @@ void vtkPGenericIOMultiBlockReader::LoadRawDataForBlock(int blockId)
 #endif
 }
 
+namespace {
 //------------------------------------------------------------------------------
-void vtkPGenericIOMultiBlockReader::GetPointFromRawData(
-        int xType, void* xBuffer, int yType, void* yBuffer, int zType, void* zBuffer,
-        vtkIdType idx, double pnt[3])
+// Copies one coordinate column into the interleaved (x,y,z) point buffer.
+// When ids is not NULL only the listed particles are gathered, in order.
+// The loops are kept free of branches and calls so that the compiler can
+// vectorize them.
+template< typename T >
+void InterleaveComponent(const T* column, vtkIdType n, const vtkIdType* ids,
+                         int component, double* pnts)
 {
-  void* buffer[3] = {xBuffer, yBuffer, zBuffer};
-
-  int type[3] = {xType, yType, zType};
+  double* out = pnts + component;
+  if (ids == NULL)
+    {
+    for (vtkIdType i = 0; i < n; ++i)
+      {
+      out[3*i] = static_cast< double >(column[i]);
+      }
+    }
+  else
+    {
+    for (vtkIdType i = 0; i < n; ++i)
+      {
+      out[3*i] = static_cast< double >(column[ids[i]]);
+      }
+    }
+}
 
-  for( int i=0; i < 3; ++i )
+//------------------------------------------------------------------------------
+// Appends to selected the indices of the particles whose halo id is one of
+// the (sorted, unique) requested halo ids.
+template< typename T >
+void SelectParticlesInHalos(const T* haloIds, vtkIdType n,
+                            const std::vector< vtkIdType >& requested,
+                            std::vector< vtkIdType >& selected)
+{
+  for (vtkIdType i = 0; i < n; ++i)
     {
-//    type = this->MetaData->VariableGenericIOType[ name[i] ];
-//    void *rawBuffer = this->MetaData->Blocks[ blockId ].RawCache[ name[i] ];
-    assert("pre: raw buffer is NULL!" && (buffer[i] != NULL) );
+    if (std::binary_search(requested.begin(), requested.end(),
+                           static_cast< vtkIdType >(haloIds[i])))
+      {
+      selected.push_back(i);
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+// Dispatches on the GenericIO type of a raw buffer. Returns false if the type
+// is not supported.
+#define vtkGenericIOTypeMacro(type, call)                       \
+  switch (type)                                                 \
+    {                                                           \
+    case gio::GENERIC_IO_INT32_TYPE:                            \
+      { typedef int32_t GIO_TT; call; } break;                  \
+    case gio::GENERIC_IO_INT64_TYPE:                            \
+      { typedef int64_t GIO_TT; call; } break;                  \
+    case gio::GENERIC_IO_UINT32_TYPE:                           \
+      { typedef uint32_t GIO_TT; call; } break;                 \
+    case gio::GENERIC_IO_UINT64_TYPE:                           \
+      { typedef uint64_t GIO_TT; call; } break;                 \
+    case gio::GENERIC_IO_DOUBLE_TYPE:                           \
+      { typedef double GIO_TT; call; } break;                   \
+    case gio::GENERIC_IO_FLOAT_TYPE:                            \
+      { typedef float GIO_TT; call; } break;                    \
+    default:                                                    \
+      return false;                                             \
+    }
+
+bool InterleaveRawComponent(int type, void* column, vtkIdType n,
+                            const vtkIdType* ids, int component, double* pnts)
+{
+  assert("pre: raw buffer is NULL!" && (column != NULL));
+  vtkGenericIOTypeMacro(type,
+    InterleaveComponent(static_cast< GIO_TT* >(column), n, ids, component, pnts));
+  return true;
+}
 
-    pnt[i] = vtkGenericIOUtilities::GetDoubleFromRawBuffer(type[i],buffer[i],idx);
-    } // END for all dimensions
+bool SelectRawParticlesInHalos(int type, void* haloIds, vtkIdType n,
+                               const std::vector< vtkIdType >& requested,
+                               std::vector< vtkIdType >& selected)
+{
+  assert("pre: raw buffer is NULL!" && (haloIds != NULL));
+  vtkGenericIOTypeMacro(type,
+    SelectParticlesInHalos(static_cast< GIO_TT* >(haloIds), n, requested, selected));
+  return true;
+}
+
+#undef vtkGenericIOTypeMacro
 }
 
 //------------------------------------------------------------------------------
 void vtkPGenericIOMultiBlockReader::LoadCoordinatesForBlock(
-    vtkUnstructuredGrid *grid, std::set< vtkIdType >& pointsInSelectedHalos,
+    vtkUnstructuredGrid *grid, std::vector< vtkIdType >& pointsInSelectedHalos,
     int blockId)
 {
   assert("pre: metadata is NULL!" && (this->MetaData != NULL));
@@ -722,111 +816,113 @@ void vtkPGenericIOMultiBlockReader::LoadCoordinatesForBlock(
   assert("pre: block is not owned by this process!" &&
     this->MetaData->HasBlock(blockId));
 
-  std::string xaxis = std::string(this->XAxisVariableName);
-  xaxis = vtkGenericIOUtilities::trim(xaxis);
-
-  std::string yaxis = std::string(this->YAxisVariableName);
-  yaxis = vtkGenericIOUtilities::trim(yaxis);
-
-  std::string zaxis = std::string(this->ZAxisVariableName);
-  zaxis = vtkGenericIOUtilities::trim(zaxis);
+  std::string axis[3];
+  axis[0] = std::string(this->XAxisVariableName);
+  axis[1] = std::string(this->YAxisVariableName);
+  axis[2] = std::string(this->ZAxisVariableName);
+  for (int i = 0; i < 3; ++i)
+    {
+    axis[i] = vtkGenericIOUtilities::trim(axis[i]);
+    }
 
-  if( !this->MetaData->HasVariable(xaxis) ||
-       !this->MetaData->HasVariable(yaxis) ||
-       !this->MetaData->HasVariable(zaxis))
+  if( !this->MetaData->HasVariable(axis[0]) ||
+       !this->MetaData->HasVariable(axis[1]) ||
+       !this->MetaData->HasVariable(axis[2]))
     {
     vtkErrorMacro(<< "Don't have one or more coordinate arrays!\n");
     return;
     }
   block_t& dataBlock = this->MetaData->Blocks[blockId];
 
-  int xType = this->MetaData->VariableGenericIOType[xaxis];
-  void* xBuffer = dataBlock.RawCache[xaxis];
-  int yType = this->MetaData->VariableGenericIOType[yaxis];
-  void* yBuffer = dataBlock.RawCache[yaxis];
-  int zType = this->MetaData->VariableGenericIOType[zaxis];
-  void* zBuffer = dataBlock.RawCache[zaxis];
-
+  vtkIdType nparticles = static_cast< vtkIdType >(dataBlock.NumberOfElements);
+  const vtkIdType* selected = NULL;
 
-  int nparticles = dataBlock.NumberOfElements;
+  if (this->HaloList->GetNumberOfIds() != 0)
+    {
+    // Sort the requested halo ids once so that each particle is tested with a
+    // binary search instead of a scan over the whole list.
+    std::vector< vtkIdType > requested(
+      this->HaloList->GetPointer(0),
+      this->HaloList->GetPointer(0) + this->HaloList->GetNumberOfIds());
+    std::sort(requested.begin(), requested.end());
+    requested.erase(std::unique(requested.begin(), requested.end()),
+                    requested.end());
 
-  vtkSmartPointer< vtkCellArray > cells =
-      vtkSmartPointer< vtkCellArray >::New();
-  cells->Allocate(cells->EstimateSize(nparticles,1));
+    std::string haloVarName = std::string(this->HaloIdVariableName);
+    haloVarName = vtkGenericIOUtilities::trim(haloVarName);
+    if (!SelectRawParticlesInHalos(
+          this->MetaData->VariableGenericIOType[haloVarName],
+          dataBlock.RawCache[haloVarName], nparticles, requested,
+          pointsInSelectedHalos))
+      {
+      vtkErrorMacro(<< "Unsupported type for halo id variable "
+                    << haloVarName << "!\n");
+      return;
+      }
+    nparticles = static_cast< vtkIdType >(pointsInSelectedHalos.size());
+    selected = pointsInSelectedHalos.empty() ? NULL : &pointsInSelectedHalos[0];
+    }
 
   vtkSmartPointer< vtkPoints > pnts =
       vtkSmartPointer< vtkPoints >::New();
   pnts->SetDataTypeToDouble();
   pnts->SetNumberOfPoints( nparticles );
 
-
-  double pnt[3];
-  vtkIdType idx = 0;
-  if (this->HaloList->GetNumberOfIds() == 0)
-    {
-    for( ;idx < nparticles; ++idx)
-      {
-      this->GetPointFromRawData(xType, xBuffer, yType, yBuffer, zType, zBuffer,
-                                idx, pnt);
-      pnts->SetPoint(idx,pnt);
-      cells->InsertNextCell(1,&idx);
-      } // END for all points
-    }
-  else
+  if (nparticles > 0)
     {
-    std::string haloVarName = std::string(this->HaloIdVariableName);
-    haloVarName = vtkGenericIOUtilities::trim(haloVarName);
-    int haloType = this->MetaData->VariableGenericIOType[haloVarName];
-    void* haloBuffer = dataBlock.RawCache[haloVarName];
-    for (vtkIdType i = 0; idx < nparticles; ++idx)
+    double* pntBuffer = static_cast< double* >(pnts->GetVoidPointer(0));
+    for (int i = 0; i < 3; ++i)
       {
-      vtkIdType haloId = vtkGenericIOUtilities::GetIdFromRawBuffer(haloType,haloBuffer,idx);
-      bool isInRequestedHalo = false;
-      for (vtkIdType j = 0; j < this->GetNumberOfRequestedHaloIds(); ++j)
-        {
-        if (haloId == this->HaloList->GetId(j))
-          {
-          isInRequestedHalo = true;
-          pointsInSelectedHalos.insert(idx);
-          break;
-          }
-        }
-      if (isInRequestedHalo)
+      if (!InterleaveRawComponent(
+            this->MetaData->VariableGenericIOType[axis[i]],
+            dataBlock.RawCache[axis[i]], nparticles, selected, i, pntBuffer))
         {
-        this->GetPointFromRawData(xType,xBuffer,yType,yBuffer,zType,zBuffer,idx,pnt);
-        pnts->SetPoint(i,pnt);
-        cells->InsertNextCell(1,&i);
-        ++i;
+        vtkErrorMacro(<< "Unsupported type for coordinate variable "
+                      << axis[i] << "!\n");
+        return;
         }
       }
-    pnts->SetNumberOfPoints(pointsInSelectedHalos.size());
     }
 
+  // Every particle is a vertex: build the (1,id) connectivity in one pass
+  // rather than inserting the cells one at a time.
+  vtkSmartPointer< vtkIdTypeArray > connectivity =
+      vtkSmartPointer< vtkIdTypeArray >::New();
+  connectivity->SetNumberOfTuples(2*nparticles);
+  vtkIdType* conn = connectivity->GetPointer(0);
+  for (vtkIdType idx = 0; idx < nparticles; ++idx)
+    {
+    conn[2*idx]   = 1;
+    conn[2*idx+1] = idx;
+    }
+
+  vtkSmartPointer< vtkCellArray > cells =
+      vtkSmartPointer< vtkCellArray >::New();
+  cells->SetCells(nparticles,connectivity);
+
   grid->SetPoints(pnts);
 
   grid->SetCells(VTK_VERTEX,cells);
-
-  grid->Squeeze();
 }
 
 namespace {
 template< typename T >
-void GetOnlyDataInHalo(vtkDataArray* allData, vtkDataArray* haloData, std::set< vtkIdType > pointsInHalo)
+void GetOnlyDataInHalo(vtkDataArray* allData, vtkDataArray* haloData,
+                       const std::vector< vtkIdType >& pointsInHalo)
 {
-  T* data = (T*) allData->GetVoidPointer(0);
-  T* filteredData = (T*) haloData->GetVoidPointer(0);
-  vtkIdType i = 0;
-  for (std::set< vtkIdType >::iterator itr = pointsInHalo.begin();
-       itr != pointsInHalo.end(); ++itr)
+  const T* data = static_cast< T* >(allData->GetVoidPointer(0));
+  T* filteredData = static_cast< T* >(haloData->GetVoidPointer(0));
+  vtkIdType n = static_cast< vtkIdType >(pointsInHalo.size());
+  for (vtkIdType i = 0; i < n; ++i)
     {
-    filteredData[i++] = data[*itr];
+    filteredData[i] = data[pointsInHalo[i]];
     }
 }
 }
 
 //------------------------------------------------------------------------------
 void vtkPGenericIOMultiBlockReader::LoadDataArraysForBlock(
-    vtkUnstructuredGrid *grid, const std::set< vtkIdType >& pointsInSelectedHalos,
+    vtkUnstructuredGrid *grid, const std::vector< vtkIdType >& pointsInSelectedHalos,
     int blockId)
 {
   assert("pre: metadata is NULL!" && (this->MetaData != NULL));
@@ -847,14 +943,24 @@ void vtkPGenericIOMultiBlockReader::LoadDataArraysForBlock(
     if( this->PointDataArraySelection->ArrayIsEnabled(name) )
       {
       std::string varName( name );
+      // The array references the cached raw buffer rather than copying it;
+      // the buffer owner rides along in the array information.
       vtkSmartPointer< vtkDataArray > dataArray;
       dataArray.TakeReference(
-          vtkGenericIOUtilities::GetVtkDataArray(
+          vtkGenericIOUtilities::GetVtkDataArrayReference(
               varName,
               this->MetaData->VariableGenericIOType[ varName ],
               dataBlock.RawCache[ varName ],
               dataBlock.NumberOfElements
               ));
+      if (!dataArray)
+        {
+        vtkErrorMacro(<< "Unsupported type for variable " << varName << "!\n");
+        continue;
+        }
+      dataArray->GetInformation()->Set(
+        vtkPGenericIOMultiBlockReader::RAW_BUFFER(),
+        dataBlock.RawOwners[ varName ]);
       if (this->HaloList->GetNumberOfIds() != 0)
         {
         vtkSmartPointer< vtkDataArray > onlyDataInHalo;
@@ -886,7 +992,7 @@ vtkUnstructuredGrid* vtkPGenericIOMultiBlockReader::LoadBlock(int blockId)
   this->LoadRawDataForBlock(blockId);
 
   vtkUnstructuredGrid* grid = vtkUnstructuredGrid::New();
-  std::set< vtkIdType > pointsInSelectedHalos;
+  std::vector< vtkIdType > pointsInSelectedHalos;
 
   // STEP 2: Load coordinates
   this->LoadCoordinatesForBlock(grid,pointsInSelectedHalos,blockId);
@@ -20,7 +20,7 @@
 #include "vtkPVVTKExtensionsCosmoToolsModule.h"
 #include "vtkMultiBlockDataSetAlgorithm.h" // parent class
 
-#include <set>
+#include <vector> // for std::vector
 
 class vtkCallbackCommand;
 class vtkDataArraySelection;
@@ -29,6 +29,7 @@ class vtkStringArray;
 class vtkIdList;
 class vtkUnstructuredGrid;
 class vtkInformationDoubleKey;
+class vtkInformationObjectBaseKey;
 
 // GenericIO forward declarations
 namespace gio
@@ -168,6 +169,12 @@ public:
   // Otherwise all points will be read in.
   void SetRequestedHaloId(vtkIdType i, vtkIdType haloId);
 
+  // Description:
+  // Key set on the information of point data arrays that reference the
+  // reader's raw GenericIO buffers instead of holding a copy. The object
+  // stored under it keeps the buffer alive for as long as the array.
+  static vtkInformationObjectBaseKey* RAW_BUFFER();
+
 
 protected:
   vtkPGenericIOMultiBlockReader();
@@ -203,16 +210,16 @@ protected:
 
   void LoadRawDataForBlock(int blockId);
 
-  void GetPointFromRawData(
-      int xType, void* xBuffer, int yType, void* yBuffer, int zType,
-      void* zBuffer, vtkIdType id, double point[3]);
-
+  // Description:
+  // Fills the points and vertex cells of the grid from the raw coordinate
+  // buffers of the block. When halos are requested, the sorted indices of
+  // the particles that belong to them are returned in pointsInSelectedHalos.
   void LoadCoordinatesForBlock(vtkUnstructuredGrid* grid,
-                               std::set< vtkIdType >& pointsInSelectedHalos,
+                               std::vector< vtkIdType >& pointsInSelectedHalos,
                                int blockId);
 
   void LoadDataArraysForBlock(vtkUnstructuredGrid* grid,
-                              const std::set<vtkIdType>& pointsInSelectedHalos,
+                              const std::vector<vtkIdType>& pointsInSelectedHalos,
                               int blockId);
 
   vtkUnstructuredGrid* LoadBlock(int blockId);
@@ -46,8 +46,11 @@
 #include "vtkIntArray.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnsignedCharArray.h"
+#include "vtkAppendFilter.h"
+#include "vtkSMPTools.h"
 #include <math.h>
 #include <ctime>
+#include <algorithm>
 
 
 vtkStandardNewMacro(vtkAMRDualClip);
@@ -1353,6 +1356,7 @@ vtkAMRDualClip::vtkAMRDualClip()
   this->EnableDegenerateCells = 1;
   this->EnableMultiProcessCommunication = 0;
   this->EnableMergePoints = 0;
+  this->MaximumNumberOfChunks = 64;
 
   this->Controller = NULL;
   this->SetController(vtkMultiProcessController::GetGlobalController());
@@ -1370,6 +1374,11 @@ vtkAMRDualClip::vtkAMRDualClip()
 //----------------------------------------------------------------------------
 vtkAMRDualClip::~vtkAMRDualClip()
 {
+  if (this->Helper)
+    {
+    this->Helper->Delete();
+    this->Helper = 0;
+    }
   if (this->BlockLocator)
     {
     delete this->BlockLocator;
@@ -1389,6 +1398,8 @@ void vtkAMRDualClip::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "EnableDegenerateCells: "
      << this->EnableDegenerateCells << endl;
   os << indent << "EnableMergePoints: " << this->EnableMergePoints << endl;
+  os << indent << "MaximumNumberOfChunks: "
+     << this->MaximumNumberOfChunks << endl;
   os << indent << "Controller: " << this->Controller << endl;
 }
 
@@ -1496,12 +1507,12 @@ vtkAMRDualClip::DoRequestData(vtkNonOverlappingAMR* hbdsInput,
 
   mpds->SetNumberOfPieces(0);
 
-  if(this->Helper)
+  // The helper caches the blocks and the ghost values of the input, when only
+  // the iso value changed, Initialize and SetupData do not communicate.
+  if (this->Helper == 0)
     {
-    this->Helper->Delete();
+    this->Helper = vtkAMRDualGridHelper::New();
     }
-
-  this->Helper = vtkAMRDualGridHelper::New();
   this->Helper->SetEnableDegenerateCells(this->EnableDegenerateCells);
   if (this->EnableMultiProcessCommunication)
     {
@@ -1546,23 +1557,32 @@ vtkAMRDualClip::DoRequestData(vtkNonOverlappingAMR* hbdsInput,
   int blockId;
 
   // Add each block.
-  for (int level = 0; level < numLevels; ++level)
+  if (this->EnableMergePoints)
     {
-    numBlocks = this->Helper->GetNumberOfBlocksInLevel(level);
-    for (blockId = 0; blockId < numBlocks; ++blockId)
+    for (int level = 0; level < numLevels; ++level)
       {
-      vtkAMRDualGridHelperBlock* block = this->Helper->GetBlock(level, blockId);
-      this->ProcessBlock(block, blockId, arrayNameToProcess);
+      numBlocks = this->Helper->GetNumberOfBlocksInLevel(level);
+      for (blockId = 0; blockId < numBlocks; ++blockId)
+        {
+        vtkAMRDualGridHelperBlock* block = this->Helper->GetBlock(level, blockId);
+        this->ProcessBlock(block, blockId, arrayNameToProcess);
+        }
       }
+    mesh->SetCells(VTK_TETRA,this->Cells);
+    }
+  else
+    {
+    mesh->SetCells(VTK_TETRA,this->Cells);
+    this->ProcessBlocksInParallel(hbdsInput, arrayNameToProcess);
     }
+  // Level masks are computed for the iso value, they cannot be reused.
+  this->DeleteBlockLocators();
 
   this->BlockIdCellArray->Delete();
   this->BlockIdCellArray = 0;
   this->LevelMaskPointArray->Delete();
   this->LevelMaskPointArray = 0;
 
-  mesh->SetCells(VTK_TETRA,this->Cells);
-
   mesh->Delete();
   this->Mesh = 0;
   this->Points->Delete();
@@ -1571,12 +1591,156 @@ vtkAMRDualClip::DoRequestData(vtkNonOverlappingAMR* hbdsInput,
   this->Cells = 0;
 
   mpds->Delete();
-  this->Helper->Delete();
-  this->Helper = 0;
 
   return mbdsOutput0;
 }
 
+//----------------------------------------------------------------------------
+// Clips chunks of blocks, each chunk with its own filter so that the mesh
+// and the locator are not shared between threads.  The blocks and the helper
+// are only read.
+class vtkAMRDualClip::vtkBlockChunks
+{
+public:
+  vtkAMRDualClip** Workers;
+  vtkAMRDualGridHelperBlock** Blocks;
+  int* BlockIds;
+  int NumberOfBlocks;
+  int ChunkSize;
+  const char* ArrayName;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
+      {
+      vtkAMRDualClip* worker = this->Workers[chunk];
+      int first = static_cast<int>(chunk) * this->ChunkSize;
+      int last = std::min(first + this->ChunkSize, this->NumberOfBlocks);
+      for (int ii = first; ii < last; ++ii)
+        {
+        worker->ProcessBlock(this->Blocks[ii], this->BlockIds[ii],
+                             this->ArrayName);
+        }
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+void vtkAMRDualClip::ProcessBlocksInParallel(
+  vtkNonOverlappingAMR* hbdsInput, const char* arrayNameToProcess)
+{
+  // Only the blocks of this process have images to clip.
+  std::vector<vtkAMRDualGridHelperBlock*> blocks;
+  std::vector<int> blockIds;
+  int numLevels = this->Helper->GetNumberOfLevels();
+  for (int level = 0; level < numLevels; ++level)
+    {
+    int numBlocks = this->Helper->GetNumberOfBlocksInLevel(level);
+    for (int blockId = 0; blockId < numBlocks; ++blockId)
+      {
+      vtkAMRDualGridHelperBlock* block = this->Helper->GetBlock(level, blockId);
+      if (block->Image)
+        {
+        blocks.push_back(block);
+        blockIds.push_back(blockId);
+        }
+      }
+    }
+  if (blocks.empty())
+    {
+    return;
+    }
+
+  // The chunks are appended in order, the output does not depend on the
+  // number of threads.
+  int numBlocks = static_cast<int>(blocks.size());
+  int chunkSize = (numBlocks + this->MaximumNumberOfChunks - 1) /
+    this->MaximumNumberOfChunks;
+  int numChunks = (numBlocks + chunkSize - 1) / chunkSize;
+
+  // The workers are created here, vtkObjects are not created in the threads.
+  std::vector<vtkAMRDualClip*> workers(numChunks);
+  for (int chunk = 0; chunk < numChunks; ++chunk)
+    {
+    vtkAMRDualClip* worker = vtkAMRDualClip::New();
+    worker->IsoValue = this->IsoValue;
+    worker->EnableInternalDecimation = this->EnableInternalDecimation;
+    worker->EnableDegenerateCells = this->EnableDegenerateCells;
+    worker->EnableMergePoints = 0;
+    worker->Helper = this->Helper;
+    worker->Mesh = vtkUnstructuredGrid::New();
+    worker->Points = vtkPoints::New();
+    worker->Cells = vtkCellArray::New();
+    worker->Mesh->SetPoints(worker->Points);
+    worker->BlockIdCellArray = vtkIntArray::New();
+    worker->BlockIdCellArray->SetName("BlockIds");
+    worker->Mesh->GetCellData()->AddArray(worker->BlockIdCellArray);
+    worker->LevelMaskPointArray = vtkUnsignedCharArray::New();
+    worker->LevelMaskPointArray->SetName("LevelMask");
+    worker->Mesh->GetPointData()->AddArray(worker->LevelMaskPointArray);
+    worker->InitializeCopyAttributes(hbdsInput, worker->Mesh);
+    workers[chunk] = worker;
+    }
+
+  vtkBlockChunks functor;
+  functor.Workers = &workers[0];
+  functor.Blocks = &blocks[0];
+  functor.BlockIds = &blockIds[0];
+  functor.NumberOfBlocks = numBlocks;
+  functor.ChunkSize = chunkSize;
+  functor.ArrayName = arrayNameToProcess;
+  vtkSMPTools::For(0, numChunks, 1, functor);
+
+  vtkAppendFilter* append = vtkAppendFilter::New();
+  for (int chunk = 0; chunk < numChunks; ++chunk)
+    {
+    vtkAMRDualClip* worker = workers[chunk];
+    worker->Mesh->SetCells(VTK_TETRA, worker->Cells);
+    append->AddInputData(worker->Mesh);
+    worker->Helper = 0;
+    worker->BlockIdCellArray->Delete();
+    worker->BlockIdCellArray = 0;
+    worker->LevelMaskPointArray->Delete();
+    worker->LevelMaskPointArray = 0;
+    worker->Points->Delete();
+    worker->Points = 0;
+    worker->Cells->Delete();
+    worker->Cells = 0;
+    }
+  append->Update();
+  if (append->GetOutput()->GetNumberOfCells() > 0)
+    {
+    this->Mesh->ShallowCopy(append->GetOutput());
+    }
+  append->Delete();
+
+  for (int chunk = 0; chunk < numChunks; ++chunk)
+    {
+    workers[chunk]->Mesh->Delete();
+    workers[chunk]->Mesh = 0;
+    workers[chunk]->Delete();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkAMRDualClip::DeleteBlockLocators()
+{
+  int numLevels = this->Helper->GetNumberOfLevels();
+  for (int level = 0; level < numLevels; ++level)
+    {
+    int numBlocks = this->Helper->GetNumberOfBlocksInLevel(level);
+    for (int blockId = 0; blockId < numBlocks; ++blockId)
+      {
+      vtkAMRDualGridHelperBlock* block = this->Helper->GetBlock(level, blockId);
+      if (block->UserData)
+        {
+        delete (vtkAMRDualClipLocator*)(block->UserData);
+        block->UserData = 0;
+        }
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 // The only data specific stuff we need to do for the contour.
 //----------------------------------------------------------------------------
@@ -72,11 +72,27 @@ public:
   // Description:
   // This flag causes blocks to share locators so there are no
   // boundary edges between blocks. It does not eliminate
-  // boundary edges between processes.
+  // boundary edges between processes. The blocks sharing locators are
+  // clipped one after the other, only without this flag are they clipped
+  // in parallel.
   vtkSetMacro(EnableMergePoints,int);
   vtkGetMacro(EnableMergePoints,int);
   vtkBooleanMacro(EnableMergePoints,int);
 
+  // Description:
+  // Without EnableMergePoints, the blocks of this process are split in at
+  // most this many chunks, clipped in parallel and appended in order.
+  // The output does not depend on it, 1 clips the blocks serially.
+  // Default is 64.
+  vtkSetClampMacro(MaximumNumberOfChunks,int,1,VTK_INT_MAX);
+  vtkGetMacro(MaximumNumberOfChunks,int);
+
+  //BTX
+  // Description:
+  // The dual grid helper kept between requests, NULL before the first one.
+  vtkGetObjectMacro(Helper, vtkAMRDualGridHelper);
+  //ETX
+
   vtkGetObjectMacro(Controller, vtkMultiProcessController);
   virtual void SetController(vtkMultiProcessController *);
 
@@ -92,6 +108,7 @@ protected:
   int EnableDegenerateCells;
   int EnableMultiProcessCommunication;
   int EnableMergePoints;
+  int MaximumNumberOfChunks;
 
   // Needed for copying cell data to point data.
   vtkUnstructuredGrid* Mesh;
@@ -116,6 +133,20 @@ protected:
   void ProcessBlock(vtkAMRDualGridHelperBlock* block, int blockId,
                     const char* arrayName);
 
+  // Description:
+  // Without EnableMergePoints the blocks do not share anything, chunks of
+  // blocks are clipped by their own filter on the threads of vtkSMPTools
+  // and appended to the mesh in order.
+  void ProcessBlocksInParallel(vtkNonOverlappingAMR* input,
+                               const char* arrayName);
+  class vtkBlockChunks;
+  friend class vtkBlockChunks;
+
+  // Description:
+  // Deletes the locators left on the blocks of the helper, the helper
+  // outlives the request.
+  void DeleteBlockLocators();
+
   void ProcessDualCell(
     vtkAMRDualGridHelperBlock* block, int blockId,
     int x, int y, int z,
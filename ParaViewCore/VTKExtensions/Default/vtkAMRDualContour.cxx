@@ -34,6 +34,8 @@
 #include "vtkPointData.h"
 #include "vtkFloatArray.h"
 #include "vtkPolyData.h"
+#include "vtkAppendPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkImageData.h"
 #include "vtkUniformGrid.h"
 #include "vtkUnstructuredGrid.h"
@@ -46,6 +48,7 @@
 #include "vtkUnsignedCharArray.h"
 #include <math.h>
 #include <ctime>
+#include <algorithm>
 
 
 vtkStandardNewMacro(vtkAMRDualContour);
@@ -537,6 +540,7 @@ vtkAMRDualContour::vtkAMRDualContour()
   this->EnableCapping = 1;
   this->EnableMultiProcessCommunication = 1;
   this->EnableMergePoints = 1;
+  this->MaximumNumberOfChunks = 64;
   this->TriangulateCap = 1;
 
   this->Controller = NULL;
@@ -555,6 +559,11 @@ vtkAMRDualContour::vtkAMRDualContour()
 //----------------------------------------------------------------------------
 vtkAMRDualContour::~vtkAMRDualContour()
 {
+  if (this->Helper)
+    {
+    this->Helper->Delete();
+    this->Helper = 0;
+    }
   if (this->BlockLocator)
     {
     delete this->BlockLocator;
@@ -575,6 +584,8 @@ void vtkAMRDualContour::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "EnableMultiProcessCommunication: "
      << this->EnableMultiProcessCommunication << endl;
   os << indent << "EnableMergePoints: " << this->EnableMergePoints << endl;
+  os << indent << "MaximumNumberOfChunks: "
+     << this->MaximumNumberOfChunks << endl;
   os << indent << "TriangulateCap: " << this->TriangulateCap << endl;
   os << indent << "SkipGhostCopy: " << this->SkipGhostCopy << endl;
 }
@@ -675,12 +686,12 @@ int vtkAMRDualContour::RequestData(
 
 void vtkAMRDualContour::InitializeRequest (vtkNonOverlappingAMR* hbdsInput)
 {
-  if(this->Helper)
+  // The helper caches the blocks and the ghost values of the input, when only
+  // the iso value changed, Initialize and SetupData do not communicate.
+  if (this->Helper == 0)
     {
-    this->Helper->Delete();
+    this->Helper = vtkAMRDualGridHelper::New();
     }
-
-  this->Helper = vtkAMRDualGridHelper::New();
   this->Helper->SetEnableDegenerateCells(this->EnableDegenerateCells);
   this->Helper->SetSkipGhostCopy(this->SkipGhostCopy);
   if (this->EnableMultiProcessCommunication)
@@ -696,8 +707,7 @@ void vtkAMRDualContour::InitializeRequest (vtkNonOverlappingAMR* hbdsInput)
 
 void vtkAMRDualContour::FinalizeRequest ()
 {
-  this->Helper->Delete();
-  this->Helper = 0;
+  // The helper is kept for the next request.
 }
 
 vtkMultiBlockDataSet*
@@ -731,14 +741,22 @@ vtkAMRDualContour::DoRequestData(vtkNonOverlappingAMR* hbdsInput,
   int numLevels = hbdsInput->GetNumberOfLevels();
 
   // Add each block.
-  for (int level = 0; level < numLevels; ++level)
+  if (this->EnableMergePoints)
     {
-    int numBlocks = this->Helper->GetNumberOfBlocksInLevel(level);
-    for (int blockId = 0; blockId < numBlocks; ++blockId)
+    for (int level = 0; level < numLevels; ++level)
       {
-      vtkAMRDualGridHelperBlock* block = this->Helper->GetBlock(level, blockId);
-      this->ProcessBlock(block, blockId, arrayNameToProcess);
+      int numBlocks = this->Helper->GetNumberOfBlocksInLevel(level);
+      for (int blockId = 0; blockId < numBlocks; ++blockId)
+        {
+        vtkAMRDualGridHelperBlock* block = this->Helper->GetBlock(level, blockId);
+        this->ProcessBlock(block, blockId, arrayNameToProcess);
+        }
       }
+    this->DeleteBlockLocators();
+    }
+  else
+    {
+    this->ProcessBlocksInParallel(hbdsInput, arrayNameToProcess);
     }
 
   this->FinalizeCopyAttributes(this->Mesh);
@@ -757,6 +775,148 @@ vtkAMRDualContour::DoRequestData(vtkNonOverlappingAMR* hbdsInput,
   return mbdsOutput0;
 }
 
+//----------------------------------------------------------------------------
+// Contours chunks of blocks, each chunk with its own filter so that the mesh
+// and the locator are not shared between threads.  The blocks and the helper
+// are only read.
+class vtkAMRDualContour::vtkBlockChunks
+{
+public:
+  vtkAMRDualContour** Workers;
+  vtkAMRDualGridHelperBlock** Blocks;
+  int* BlockIds;
+  int NumberOfBlocks;
+  int ChunkSize;
+  const char* ArrayName;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
+      {
+      vtkAMRDualContour* worker = this->Workers[chunk];
+      int first = static_cast<int>(chunk) * this->ChunkSize;
+      int last = std::min(first + this->ChunkSize, this->NumberOfBlocks);
+      for (int ii = first; ii < last; ++ii)
+        {
+        worker->ProcessBlock(this->Blocks[ii], this->BlockIds[ii],
+                             this->ArrayName);
+        }
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+void vtkAMRDualContour::ProcessBlocksInParallel(
+  vtkNonOverlappingAMR* hbdsInput, const char* arrayNameToProcess)
+{
+  // Only the blocks of this process have images to contour.
+  std::vector<vtkAMRDualGridHelperBlock*> blocks;
+  std::vector<int> blockIds;
+  int numLevels = this->Helper->GetNumberOfLevels();
+  for (int level = 0; level < numLevels; ++level)
+    {
+    int numBlocks = this->Helper->GetNumberOfBlocksInLevel(level);
+    for (int blockId = 0; blockId < numBlocks; ++blockId)
+      {
+      vtkAMRDualGridHelperBlock* block = this->Helper->GetBlock(level, blockId);
+      if (block->Image)
+        {
+        blocks.push_back(block);
+        blockIds.push_back(blockId);
+        }
+      }
+    }
+  if (blocks.empty())
+    {
+    return;
+    }
+
+  // The chunks are appended in order, the output does not depend on the
+  // number of threads.
+  int numBlocks = static_cast<int>(blocks.size());
+  int chunkSize = (numBlocks + this->MaximumNumberOfChunks - 1) /
+    this->MaximumNumberOfChunks;
+  int numChunks = (numBlocks + chunkSize - 1) / chunkSize;
+
+  // The workers are created here, vtkObjects are not created in the threads.
+  std::vector<vtkAMRDualContour*> workers(numChunks);
+  for (int chunk = 0; chunk < numChunks; ++chunk)
+    {
+    vtkAMRDualContour* worker = vtkAMRDualContour::New();
+    worker->IsoValue = this->IsoValue;
+    worker->EnableCapping = this->EnableCapping;
+    worker->EnableDegenerateCells = this->EnableDegenerateCells;
+    worker->EnableMergePoints = 0;
+    worker->TriangulateCap = this->TriangulateCap;
+    worker->Helper = this->Helper;
+    worker->Mesh = vtkPolyData::New();
+    worker->Points = vtkPoints::New();
+    worker->Faces = vtkCellArray::New();
+    worker->Mesh->SetPoints(worker->Points);
+    worker->Mesh->SetPolys(worker->Faces);
+    worker->InitializeCopyAttributes(hbdsInput, worker->Mesh);
+    worker->BlockIdCellArray = vtkIntArray::New();
+    worker->BlockIdCellArray->SetName("BlockIds");
+    worker->Mesh->GetCellData()->AddArray(worker->BlockIdCellArray);
+    workers[chunk] = worker;
+    }
+
+  vtkBlockChunks functor;
+  functor.Workers = &workers[0];
+  functor.Blocks = &blocks[0];
+  functor.BlockIds = &blockIds[0];
+  functor.NumberOfBlocks = numBlocks;
+  functor.ChunkSize = chunkSize;
+  functor.ArrayName = arrayNameToProcess;
+  vtkSMPTools::For(0, numChunks, 1, functor);
+
+  vtkAppendPolyData* append = vtkAppendPolyData::New();
+  for (int chunk = 0; chunk < numChunks; ++chunk)
+    {
+    vtkAMRDualContour* worker = workers[chunk];
+    append->AddInputData(worker->Mesh);
+    worker->Helper = 0;
+    worker->BlockIdCellArray->Delete();
+    worker->BlockIdCellArray = 0;
+    worker->Points->Delete();
+    worker->Points = 0;
+    worker->Faces->Delete();
+    worker->Faces = 0;
+    }
+  append->Update();
+  if (append->GetOutput()->GetNumberOfCells() > 0)
+    {
+    this->Mesh->ShallowCopy(append->GetOutput());
+    }
+  append->Delete();
+
+  for (int chunk = 0; chunk < numChunks; ++chunk)
+    {
+    workers[chunk]->Mesh->Delete();
+    workers[chunk]->Mesh = 0;
+    workers[chunk]->Delete();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkAMRDualContour::DeleteBlockLocators()
+{
+  int numLevels = this->Helper->GetNumberOfLevels();
+  for (int level = 0; level < numLevels; ++level)
+    {
+    int numBlocks = this->Helper->GetNumberOfBlocksInLevel(level);
+    for (int blockId = 0; blockId < numBlocks; ++blockId)
+      {
+      vtkAMRDualGridHelperBlock* block = this->Helper->GetBlock(level, blockId);
+      if (block->UserData)
+        {
+        delete (vtkAMRDualContourEdgeLocator*)(block->UserData);
+        block->UserData = 0;
+        }
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkAMRDualContour::ShareBlockLocatorWithNeighbors(
   vtkAMRDualGridHelperBlock* block)
@@ -78,11 +78,27 @@ public:
   // Description:
   // This flag causes blocks to share locators so there are no
   // boundary edges between blocks. It does not eliminate
-  // boundary edges between processes.
+  // boundary edges between processes. The blocks sharing locators are
+  // contoured one after the other, only without this flag are they contoured
+  // in parallel.
   vtkSetMacro(EnableMergePoints,int);
   vtkGetMacro(EnableMergePoints,int);
   vtkBooleanMacro(EnableMergePoints,int);
 
+  // Description:
+  // Without EnableMergePoints, the blocks of this process are split in at
+  // most this many chunks, contoured in parallel and appended in order.
+  // The output does not depend on it, 1 contours the blocks serially.
+  // Default is 64.
+  vtkSetClampMacro(MaximumNumberOfChunks,int,1,VTK_INT_MAX);
+  vtkGetMacro(MaximumNumberOfChunks,int);
+
+  //BTX
+  // Description:
+  // The dual grid helper kept between requests, NULL before the first one.
+  vtkGetObjectMacro(Helper, vtkAMRDualGridHelper);
+  //ETX
+
   // Description:
   // A flag that causes the polygons on the capping surfaces to be triagulated.
   vtkSetMacro(TriangulateCap,int);
@@ -112,6 +128,7 @@ protected:
   int EnableCapping;
   int EnableMultiProcessCommunication;
   int EnableMergePoints;
+  int MaximumNumberOfChunks;
   int TriangulateCap;
   int SkipGhostCopy;
 
@@ -119,7 +136,9 @@ protected:
   virtual int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
 
   // Description:
-  // This should be called before any number of calls to DoRequestData 
+  // This should be called before any number of calls to DoRequestData.
+  // The dual grid helper is kept between requests, it only rebuilds the
+  // blocks and exchanges ghost values when the input changed.
   void InitializeRequest (vtkNonOverlappingAMR* input);
 
   // Description:
@@ -141,6 +160,20 @@ protected:
   void ProcessBlock(vtkAMRDualGridHelperBlock* block, int blockId,
                     const char* arrayName);
 
+  // Description:
+  // Without EnableMergePoints the blocks do not share anything, chunks of
+  // blocks are contoured by their own filter on the threads of vtkSMPTools
+  // and appended to the mesh in order.
+  void ProcessBlocksInParallel(vtkNonOverlappingAMR* input,
+                               const char* arrayName);
+  class vtkBlockChunks;
+  friend class vtkBlockChunks;
+
+  // Description:
+  // Deletes the locators left on the blocks of the helper, the helper
+  // outlives the request.
+  void DeleteBlockLocators();
+
 
   void ProcessDualCell(
     vtkAMRDualGridHelperBlock* block, int blockId,
@@ -15,6 +15,7 @@
 #include "vtkAMRDualGridHelper.h"
 #include "vtkObjectFactory.h"
 #include "vtkMultiProcessController.h"
+#include "vtkCommunicator.h"
 #include "vtkDummyController.h"
 #include "vtkImageData.h"
 #include "vtkUniformGrid.h"
@@ -732,6 +733,12 @@ vtkAMRDualGridHelper::vtkAMRDualGridHelper()
   this->EnableDegenerateCells = 1;
   this->EnableAsynchronousCommunication = 1;
   this->NumberOfBlocksInThisProcess = 0;
+  this->InitializedInput = 0;
+  this->InitializedInputMTime = 0;
+  this->InitializedEnableDegenerateCells = 0;
+  this->InitializedController = 0;
+  this->NumberOfBlockBuilds = 0;
+  this->NumberOfGhostExchanges = 0;
   for (ii = 0; ii < 3; ++ii)
     {
     this->StandardBlockDimensions[ii] = 0;
@@ -752,24 +759,42 @@ vtkAMRDualGridHelper::vtkAMRDualGridHelper()
 //----------------------------------------------------------------------------
 vtkAMRDualGridHelper::~vtkAMRDualGridHelper()
 {
-  int ii;
-  int numberOfLevels = (int)(this->Levels.size());
-
   this->SetArrayName(0);
 
-  for (ii = 0; ii < numberOfLevels; ++ii)
+  this->ClearLevels();
+
+  this->Controller->UnRegister(this);
+  this->Controller = NULL;
+}
+//----------------------------------------------------------------------------
+void vtkAMRDualGridHelper::ClearLevels()
+{
+  int numberOfLevels = (int)(this->Levels.size());
+  for (int ii = 0; ii < numberOfLevels; ++ii)
     {
     delete this->Levels[ii];
     this->Levels[ii] = 0;
     }
+  this->Levels.clear();
 
   // Todo: See if we really need this.
   this->NumberOfBlocksInThisProcess = 0;
 
   this->DegenerateRegionQueue.clear();
 
-  this->Controller->UnRegister(this);
-  this->Controller = NULL;
+  this->InitializedInput = 0;
+  this->InitializedInputMTime = 0;
+  this->InitializedController = 0;
+  this->ExchangedArrays.clear();
+}
+//----------------------------------------------------------------------------
+bool vtkAMRDualGridHelper::IsInitializedWith(vtkNonOverlappingAMR* input)
+{
+  return input != 0 &&
+    this->InitializedInput == input &&
+    this->InitializedInputMTime == input->GetMTime() &&
+    this->InitializedEnableDegenerateCells == this->EnableDegenerateCells &&
+    this->InitializedController == this->Controller;
 }
 //----------------------------------------------------------------------------
 void vtkAMRDualGridHelper::PrintSelf(ostream& os, vtkIndent indent)
@@ -2241,6 +2266,21 @@ int vtkAMRDualGridHelper::Initialize (vtkNonOverlappingAMR* input)
 {
 vtkTimerLogSmartMarkEvent markevent("vtkAMRDualGridHelper::Initialize", this->Controller);
 
+  // The blocks are shared between processes below, all of them have to
+  // agree on reusing the blocks they already have.
+  int reuse = this->IsInitializedWith(input)? 1 : 0;
+  if (this->Controller->GetNumberOfProcesses() > 1)
+    {
+    int localReuse = reuse;
+    this->Controller->AllReduce(&localReuse, &reuse, 1,
+      vtkCommunicator::MIN_OP);
+    }
+  if (reuse)
+    {
+    return VTK_OK;
+    }
+  this->ClearLevels();
+
   int blockId, numBlocks;
   int numLevels = input->GetNumberOfLevels();
 
@@ -2323,6 +2363,12 @@ vtkTimerLogSmartMarkEvent markevent("vtkAMRDualGridHelper::Initialize", this->Co
     // All processes will have all blocks (but not image data).
     this->ShareBlocks();
     }
+
+  this->InitializedInput = input;
+  this->InitializedInputMTime = input->GetMTime();
+  this->InitializedEnableDegenerateCells = this->EnableDegenerateCells;
+  this->InitializedController = this->Controller;
+  ++this->NumberOfBlockBuilds;
   return VTK_OK;
 }
 
@@ -2376,8 +2422,23 @@ vtkTimerLogSmartMarkEvent markevent("vtkAMRDualGridHelper::SetupData", this->Con
   // Plan for meshing between blocks.
   this->AssignSharedRegions();
 
-  // Copy regions on level boundaries between processes.
-  this->ProcessRegionRemoteCopyQueue(false);
+  // Copy regions on level boundaries between processes.  The values copied
+  // for this array are still in the blocks when they come from the cache.
+  // Initialize agreed on the cache, and the array is the same on all the
+  // processes, so they all skip the communication together.
+  if (this->ArrayName && this->ExchangedArrays.count(this->ArrayName))
+    {
+    this->ClearRegionRemoteCopyQueue();
+    }
+  else
+    {
+    this->ProcessRegionRemoteCopyQueue(false);
+    ++this->NumberOfGhostExchanges;
+    if (this->ArrayName && !this->SkipGhostCopy)
+      {
+      this->ExchangedArrays.insert(this->ArrayName);
+      }
+    }
 
   // Setup faces for seeding connectivity between blocks.
   //this->CreateFaces();
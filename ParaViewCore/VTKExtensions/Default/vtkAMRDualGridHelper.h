@@ -29,6 +29,8 @@
 #include "vtkObject.h"
 #include <vector>
 #include <map>
+#include <set>
+#include <string>
 
 class vtkDataArray;
 class vtkIntArray;
@@ -80,9 +82,25 @@ public:
   vtkGetObjectMacro(Controller, vtkMultiProcessController);
   virtual void SetController(vtkMultiProcessController *);
 
+  // Description:
+  // Initialize builds the blocks of every level and shares them between
+  // processes, SetupData assigns the regions shared between blocks and
+  // exchanges the ghost values of the array between processes.
+  // Both are cached: the blocks are kept until the input, its modification
+  // time, the controller or EnableDegenerateCells change, and the ghost values
+  // exchanged for an array are kept with them.  A helper kept between
+  // executions (for example when only an iso value changes) skips the
+  // communication.  These are collective calls.
   int                       Initialize(vtkNonOverlappingAMR* input);
   int                       SetupData(vtkNonOverlappingAMR* input,
                                        const char* arrayName);
+
+  // Description:
+  // The number of times Initialize built the blocks, and SetupData exchanged
+  // ghost values between processes, since the helper was created.  Neither
+  // changes when the cache is used.
+  vtkGetMacro(NumberOfBlockBuilds, int);
+  vtkGetMacro(NumberOfGhostExchanges, int);
   const double*             GetGlobalOrigin() { return this->GlobalOrigin;}
   const double*             GetRootSpacing() { return this->RootSpacing;}
   int                       GetNumberOfBlocks() { return this->NumberOfBlocksInThisProcess;}
@@ -219,6 +237,19 @@ private:
 
   int EnableAsynchronousCommunication;
 
+  // The key of the cached blocks.  The input is not referenced, it is only
+  // compared with the next one.
+  bool IsInitializedWith(vtkNonOverlappingAMR* input);
+  void ClearLevels();
+  vtkNonOverlappingAMR* InitializedInput;
+  unsigned long InitializedInputMTime;
+  int InitializedEnableDegenerateCells;
+  vtkMultiProcessController* InitializedController;
+  // Arrays which ghost values were exchanged with the cached blocks.
+  std::set<std::string> ExchangedArrays;
+  int NumberOfBlockBuilds;
+  int NumberOfGhostExchanges;
+
 private:
   vtkAMRDualGridHelper(const vtkAMRDualGridHelper&);  // Not implemented.
   void operator=(const vtkAMRDualGridHelper&);  // Not implemented.
@@ -32,8 +32,8 @@ public:
   void PrintSelf(ostream& os, vtkIndent indent);
   static vtkEquivalenceSet *New();
   
-  void Initialize();
-  void AddEquivalence(int id1, int id2);
+  virtual void Initialize();
+  virtual void AddEquivalence(int id1, int id2);
 
   // The length of the equivalent array...
   // The Domain of the equivalance map is [0, numberOfMembers).
@@ -51,7 +51,7 @@ public:
   // You cannot add anymore equivalences after this is called.
   virtual int ResolveEquivalences();
 
-  void DeepCopy(vtkEquivalenceSet* in);
+  virtual void DeepCopy(vtkEquivalenceSet* in);
 
   // Needed for sending the set over MPI.
   // Be very careful with the pointer.  
@@ -27,6 +27,8 @@
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTable.h"
@@ -34,6 +36,7 @@
 #include <vector>
 #include <map>
 #include <string>
+#include <utility>
 
 struct vtkEHInternals
 {
@@ -47,8 +50,119 @@ struct vtkEHInternals
   typedef std::map<std::string, ArrayValuesType> ArrayMapType;
   ArrayMapType ArrayValues;
   int FieldAssociation;
+
+  // The sketch used by UseApproximateBinning, with the arrays and their
+  // modification times, the component and the range it was computed for.
+  struct SketchType
+    {
+    typedef std::vector<std::pair<vtkDataArray*, unsigned long> > ArraysType;
+    ArraysType Arrays;
+    int Component;
+    double Range[2];
+    std::vector<vtkIdType> Counts;
+    };
+  SketchType Sketch;
 };
 
+inline int vtkExtractHistogramClamp(int value, int min, int max)
+{
+  value = value < min ? min : value;
+  value = value > max ? max : value;
+  return value;
+}
+
+//-----------------------------------------------------------------------------
+// Counts the values of a component into per-thread bins.
+template <class T>
+class vtkExtractHistogramBinner
+{
+public:
+  vtkExtractHistogramBinner(const T* values, int numComps, int comp,
+    double min, double max, int binCount)
+    : Values(values), NumberOfComponents(numComps), Component(comp),
+      Min(min), BinDelta((max - min) / binCount), BinCount(binCount)
+    {
+    }
+
+  void Initialize()
+    {
+    this->Bins.Local().assign(this->BinCount, 0);
+    }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    std::vector<vtkIdType>& bins = this->Bins.Local();
+    const T* value = this->Values + begin * this->NumberOfComponents +
+      this->Component;
+    for (vtkIdType i = begin; i < end; ++i, value += this->NumberOfComponents)
+      {
+      int index = static_cast<int>(
+        (static_cast<double>(*value) - this->Min) / this->BinDelta);
+      // If the value is equal to max, include it in the last bin.
+      index = ::vtkExtractHistogramClamp(index, 0, this->BinCount-1);
+      ++bins[index];
+      }
+    }
+
+  void Reduce()
+    {
+    }
+
+  const T* Values;
+  int NumberOfComponents;
+  int Component;
+  double Min;
+  double BinDelta;
+  int BinCount;
+  vtkSMPThreadLocal<std::vector<vtkIdType> > Bins;
+};
+
+//-----------------------------------------------------------------------------
+template <class T>
+void vtkExtractHistogramBinValues(const T* values, vtkIdType numTuples,
+  int numComps, int comp, double min, double max, int binCount,
+  vtkIdType* counts)
+{
+  vtkExtractHistogramBinner<T> binner(values, numComps, comp, min, max,
+    binCount);
+  vtkSMPTools::For(0, numTuples, binner);
+  typename vtkSMPThreadLocal<std::vector<vtkIdType> >::iterator iter;
+  for (iter = binner.Bins.begin(); iter != binner.Bins.end(); ++iter)
+    {
+    for (int i = 0; i < binCount; ++i)
+      {
+      counts[i] += (*iter)[i];
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Adds the number of values of the component in each of the binCount bins
+// spanning [min, max] to counts.
+static void vtkExtractHistogramBinArray(vtkDataArray* data_array, int comp,
+  double min, double max, int binCount, vtkIdType* counts)
+{
+  vtkIdType num_of_tuples = data_array->GetNumberOfTuples();
+  int num_of_comps = data_array->GetNumberOfComponents();
+  switch (data_array->GetDataType())
+    {
+    vtkTemplateMacro(vtkExtractHistogramBinValues(
+        static_cast<VTK_TT*>(data_array->GetVoidPointer(0)), num_of_tuples,
+        num_of_comps, comp, min, max, binCount, counts));
+    default:
+      {
+      double bin_delta = (max - min) / binCount;
+      for (vtkIdType i = 0; i < num_of_tuples; ++i)
+        {
+        const double value = data_array->GetComponent(i, comp);
+        int index = static_cast<int>((value - min) / bin_delta);
+        index = ::vtkExtractHistogramClamp(index, 0, binCount-1);
+        ++counts[index];
+        }
+      }
+    }
+}
+
 vtkStandardNewMacro(vtkExtractHistogram);
 //-----------------------------------------------------------------------------
 vtkExtractHistogram::vtkExtractHistogram() :
@@ -66,6 +180,8 @@ vtkExtractHistogram::vtkExtractHistogram() :
   this->UseCustomBinRanges = false;
   this->CustomBinRanges[0] = 0;
   this->CustomBinRanges[1] = 100;
+  this->UseApproximateBinning = false;
+  this->SketchBinCount = 25600;
 }
 
 //-----------------------------------------------------------------------------
@@ -84,6 +200,9 @@ void vtkExtractHistogram::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "UseCustomBinRanges: " << this->UseCustomBinRanges << endl;
   os << indent << "CustomBinRanges: " <<
     this->CustomBinRanges[0] << ", " << this->CustomBinRanges[1] << endl;
+  os << indent << "UseApproximateBinning: "
+     << this->UseApproximateBinning << endl;
+  os << indent << "SketchBinCount: " << this->SketchBinCount << endl;
 }
 
 //-----------------------------------------------------------------------------
@@ -268,13 +387,6 @@ void vtkExtractHistogram::FillBinExtents(vtkDoubleArray* bin_extents,
 }
 
 
-inline int vtkExtractHistogramClamp(int value, int min, int max)
-{
-  value = value < min ? min : value;
-  value = value > max ? max : value;
-  return value;
-}
-
 //-----------------------------------------------------------------------------
 void vtkExtractHistogram::BinAnArray(vtkDataArray *data_array,
                                      vtkIntArray *bin_values,
@@ -290,6 +402,19 @@ void vtkExtractHistogram::BinAnArray(vtkDataArray *data_array,
     return;
     }
 
+  if (!this->CalculateAverages)
+    {
+    std::vector<vtkIdType> counts(this->BinCount, 0);
+    ::vtkExtractHistogramBinArray(data_array, this->Component, min, max,
+      this->BinCount, &counts[0]);
+    for (int i = 0; i < this->BinCount; ++i)
+      {
+      bin_values->SetValue(i,
+        bin_values->GetValue(i) + static_cast<int>(counts[i]));
+      }
+    return;
+    }
+
   int num_of_tuples = data_array->GetNumberOfTuples();
   double bin_delta = (max-min)/this->BinCount;
   for(int i = 0; i != num_of_tuples; ++i)
@@ -332,6 +457,56 @@ void vtkExtractHistogram::BinAnArray(vtkDataArray *data_array,
     }
 }
 
+//-----------------------------------------------------------------------------
+void vtkExtractHistogram::BinFromSketch(vtkDataArray** arrays, int numArrays,
+                                        vtkIntArray *bin_values,
+                                        double min, double max)
+{
+  vtkEHInternals::SketchType& sketch = this->Internal->Sketch;
+  vtkEHInternals::SketchType::ArraysType sketchArrays;
+  for (int i = 0; i < numArrays; ++i)
+    {
+    if (arrays[i] &&
+      this->Component >= 0 &&
+      this->Component < arrays[i]->GetNumberOfComponents())
+      {
+      sketchArrays.push_back(std::make_pair(arrays[i], arrays[i]->GetMTime()));
+      }
+    }
+
+  if (sketchArrays != sketch.Arrays ||
+    sketch.Component != this->Component ||
+    sketch.Range[0] != min || sketch.Range[1] != max ||
+    sketch.Counts.size() != static_cast<size_t>(this->SketchBinCount))
+    {
+    sketch.Arrays = sketchArrays;
+    sketch.Component = this->Component;
+    sketch.Range[0] = min;
+    sketch.Range[1] = max;
+    sketch.Counts.assign(this->SketchBinCount, 0);
+    for (size_t i = 0; i < sketchArrays.size(); ++i)
+      {
+      this->UpdateProgress(0.10 + 0.90*i/sketchArrays.size());
+      ::vtkExtractHistogramBinArray(sketchArrays[i].first, this->Component,
+        min, max, this->SketchBinCount, &sketch.Counts[0]);
+      }
+    }
+
+  // Each sketch bin goes to the bin that contains its center.
+  double sketch_delta = (max-min)/this->SketchBinCount;
+  double bin_delta = (max-min)/this->BinCount;
+  for (int i = 0; i < this->SketchBinCount; ++i)
+    {
+    if (sketch.Counts[i] > 0)
+      {
+      int index = static_cast<int>((i + 0.5) * sketch_delta / bin_delta);
+      index = ::vtkExtractHistogramClamp(index, 0, this->BinCount-1);
+      bin_values->SetValue(index, bin_values->GetValue(index) +
+        static_cast<int>(sketch.Counts[i]));
+      }
+    }
+}
+
 //-----------------------------------------------------------------------------
 int vtkExtractHistogram::RequestData(vtkInformation* /*request*/,
                                      vtkInformationVector** inputVector,
@@ -373,8 +548,11 @@ int vtkExtractHistogram::RequestData(vtkInformation* /*request*/,
   if (!this->InitializeBinExtents(inputVector, bin_extents, min, max))
     {
     this->Internal->ArrayValues.clear();
+    this->Internal->Sketch.Arrays.clear();
+    this->Internal->Sketch.Counts.clear();
     return 1;
     }
+  bool useSketch = this->UseApproximateBinning && !this->CalculateAverages;
 
   output_data->GetRowData()->AddArray(bin_extents);
   output_data->GetRowData()->AddArray(bin_values);
@@ -385,23 +563,43 @@ int vtkExtractHistogram::RequestData(vtkInformation* /*request*/,
   if (cdin)
     {
     //for composite datasets visit each leaf dataset and add in its counts
+    std::vector<vtkDataArray*> arrays;
     vtkCompositeDataIterator *cdit = cdin->NewIterator();
     cdit->InitTraversal();
     while(!cdit->IsDoneWithTraversal())
       {
       vtkDataObject *dObj = cdit->GetCurrentDataObject();
       vtkDataArray* data_array = this->GetInputArrayToProcess(0, dObj);
-      this->BinAnArray(data_array, bin_values, min, max,
-        this->GetInputFieldData(dObj));
+      if (useSketch)
+        {
+        arrays.push_back(data_array);
+        }
+      else
+        {
+        this->BinAnArray(data_array, bin_values, min, max,
+          this->GetInputFieldData(dObj));
+        }
       cdit->GoToNextItem();
       }
     cdit->Delete();
+    if (useSketch)
+      {
+      this->BinFromSketch(arrays.empty()? NULL : &arrays[0],
+        static_cast<int>(arrays.size()), bin_values, min, max);
+      }
     }
   else
     {
     vtkDataArray* data_array = this->GetInputArrayToProcess(0, inputVector);
-    this->BinAnArray(data_array, bin_values, min, max,
-      this->GetInputFieldData(input));
+    if (useSketch)
+      {
+      this->BinFromSketch(&data_array, 1, bin_values, min, max);
+      }
+    else
+      {
+      this->BinAnArray(data_array, bin_values, min, max,
+        this->GetInputFieldData(input));
+      }
     }
 
   if (this->CalculateAverages)
@@ -34,6 +34,11 @@ struct vtkEHInternals;
 // will have contain a vtkDoubleArray named "bin_extents" which contains
 // the boundaries between each histogram bin, and a vtkUnsignedLongArray
 // named "bin_values" which will contain the value for each bin.
+//
+// The values are binned concurrently, each thread counting into its own
+// bins. With UseApproximateBinning, the values are binned once into a fine
+// sketch that is kept while the arrays are not modified, so that a change of
+// BinCount does not require another pass over the values.
 
 class VTKPVVTKEXTENSIONSDEFAULT_EXPORT vtkExtractHistogram : public vtkTableAlgorithm
 {
@@ -73,6 +78,23 @@ public:
   vtkSetMacro(CalculateAverages, int);
   vtkGetMacro(CalculateAverages, int);
   vtkBooleanMacro(CalculateAverages, int);
+
+  // Description:
+  // When set to true, the values are binned into a sketch of SketchBinCount
+  // bins spanning the bin range and the histogram is computed from the
+  // sketch, which is reused until the binned array, the component or the
+  // range change. Counts are exact when BinCount divides SketchBinCount, and
+  // otherwise off by at most one sketch bin. Ignored when CalculateAverages
+  // is set. By default, set to false.
+  vtkSetMacro(UseApproximateBinning, bool);
+  vtkGetMacro(UseApproximateBinning, bool);
+  vtkBooleanMacro(UseApproximateBinning, bool);
+
+  // Description:
+  // Number of bins of the sketch used when UseApproximateBinning is true.
+  // 25600 by default, which is a multiple of the common bin counts.
+  vtkSetClampMacro(SketchBinCount, int, 1, VTK_INT_MAX);
+  vtkGetMacro(SketchBinCount, int);
   
 protected: 
   vtkExtractHistogram();
@@ -107,11 +129,21 @@ protected:
 
   void FillBinExtents(vtkDoubleArray* bin_extents, double min, double max);
 
+  // Description:
+  // Adds the counts of the arrays to bin_values from the sketch, which is
+  // updated first if the arrays were modified since it was computed.
+  void BinFromSketch(
+    vtkDataArray** arrays, int numArrays,
+    vtkIntArray *vals,
+    double min, double max);
+
   double CustomBinRanges[2];
   bool UseCustomBinRanges;
   int Component;
   int BinCount;
   int CalculateAverages;
+  bool UseApproximateBinning;
+  int SketchBinCount;
 
   vtkEHInternals* Internal;
   
@@ -21,19 +21,79 @@
 #include "vtkCompositeDataSet.h"
 #include "vtkDataSet.h"
 #include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
 #include "vtkMultiProcessController.h"
+#include "vtkMultiProcessStream.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPointData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPTools.h"
 #include "vtkTriangle.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// The cells of a block are integrated in at most VTK_INTEGRATE_MAX_CHUNKS
+// chunks of at least VTK_INTEGRATE_MIN_CHUNK_SIZE cells.
+#define VTK_INTEGRATE_MIN_CHUNK_SIZE 1024
+#define VTK_INTEGRATE_MAX_CHUNKS 256
+
+namespace
+{
+// Adds value to the compensated sum (sum, compensation), keeping the rounding
+// error of the addition in compensation (Kahan-Babuska summation).
+inline void vtkIntegrateAttributesAdd(double& sum, double& compensation,
+  double value)
+{
+  double total = sum + value;
+  if (fabs(sum) >= fabs(value))
+    {
+    compensation += (sum - total) + value;
+    }
+  else
+    {
+    compensation += (value - total) + sum;
+    }
+  sum = total;
+}
+
+// Returns the number of components of all the arrays of da.
+size_t vtkIntegrateAttributesNumberOfValues(vtkDataSetAttributes* da)
+{
+  size_t numValues = 0;
+  for (int i = 0; i < da->GetNumberOfArrays(); ++i)
+    {
+    numValues += da->GetArray(i)->GetNumberOfComponents();
+    }
+  return numValues;
+}
+
+// Combines the (sum, compensation) pairs of two processes.
+class vtkIntegrateAttributesSumOperation : public vtkCommunicator::Operation
+{
+public:
+  virtual void Function(const void* A, void* B, vtkIdType length, int)
+    {
+    const double* a = static_cast<const double*>(A);
+    double* b = static_cast<double*>(B);
+    for (vtkIdType i = 0; i + 1 < length; i += 2)
+      {
+      vtkIntegrateAttributesAdd(b[i], b[i+1], a[i]);
+      b[i+1] += a[i+1];
+      }
+    }
+  virtual int Commutative() { return 1; }
+};
+}
+
 
 vtkStandardNewMacro(vtkIntegrateAttributes);
 
@@ -44,6 +104,129 @@ public:
   vtkFieldList(int numInputs) : vtkDataSetAttributes::FieldList(numInputs) { }
   void SetFieldIndex(int i, int index)
       { this->vtkDataSetAttributes::FieldList::SetFieldIndex(i, index); }
+
+  // Offset of the sums of each field in the values of a vtkAccumulator, or
+  // -1 for the fields that are not integrated.
+  std::vector<int> Offsets;
+};
+
+//-----------------------------------------------------------------------------
+class vtkIntegrateAttributes::vtkCompensatedSum
+{
+public:
+  vtkCompensatedSum() : Sum(0.0), Compensation(0.0) {}
+
+  void Add(double value)
+    {
+    vtkIntegrateAttributesAdd(this->Sum, this->Compensation, value);
+    }
+  void Add(const vtkCompensatedSum& other)
+    {
+    vtkIntegrateAttributesAdd(this->Sum, this->Compensation, other.Sum);
+    this->Compensation += other.Compensation;
+    }
+  double GetValue() const { return this->Sum + this->Compensation; }
+
+  double Sum;
+  double Compensation;
+};
+
+//-----------------------------------------------------------------------------
+// The integrated values of a set of cells, for the highest dimension found.
+// PointValues and CellValues hold the components of the output point and
+// cell arrays, one array after the other.
+class vtkIntegrateAttributes::vtkAccumulator
+{
+public:
+  vtkAccumulator() : Dimension(0) {}
+
+  void Initialize(size_t numPointValues, size_t numCellValues, int dim)
+    {
+    this->Dimension = dim;
+    this->Sum = vtkCompensatedSum();
+    this->SumCenter[0] = this->SumCenter[1] = this->SumCenter[2] =
+      vtkCompensatedSum();
+    this->PointValues.assign(numPointValues, vtkCompensatedSum());
+    this->CellValues.assign(numCellValues, vtkCompensatedSum());
+    }
+
+  // Returns true if cells of dimension dim are integrated. Results of a
+  // lower dimension are thrown out.
+  bool CompareDimension(int dim)
+    {
+    if (this->Dimension < dim)
+      {
+      this->Initialize(this->PointValues.size(), this->CellValues.size(),
+        dim);
+      return true;
+      }
+    return this->Dimension == dim;
+    }
+
+  void Merge(const vtkAccumulator& other)
+    {
+    if (!this->CompareDimension(other.Dimension))
+      {
+      return;
+      }
+    this->Sum.Add(other.Sum);
+    for (int i = 0; i < 3; ++i)
+      {
+      this->SumCenter[i].Add(other.SumCenter[i]);
+      }
+    for (size_t i = 0; i < this->PointValues.size(); ++i)
+      {
+      this->PointValues[i].Add(other.PointValues[i]);
+      }
+    for (size_t i = 0; i < this->CellValues.size(); ++i)
+      {
+      this->CellValues[i].Add(other.CellValues[i]);
+      }
+    }
+
+  vtkCompensatedSum* GetPointValues()
+    {
+    return this->PointValues.empty()? NULL : &this->PointValues[0];
+    }
+  vtkCompensatedSum* GetCellValues()
+    {
+    return this->CellValues.empty()? NULL : &this->CellValues[0];
+    }
+
+  int Dimension;
+  vtkCompensatedSum Sum;
+  vtkCompensatedSum SumCenter[3];
+  std::vector<vtkCompensatedSum> PointValues;
+  std::vector<vtkCompensatedSum> CellValues;
+};
+
+//-----------------------------------------------------------------------------
+// Integrates chunks of cells of a block, each one in its own accumulator.
+class vtkIntegrateAttributes::vtkIntegrateChunks
+{
+public:
+  vtkIntegrateAttributes* Self;
+  vtkDataSet* Input;
+  vtkIdType NumberOfCells;
+  vtkIdType ChunkSize;
+  vtkAccumulator* Chunks;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    vtkIdList* cellPtIds = vtkIdList::New();
+    vtkGenericCell* cell = vtkGenericCell::New();
+    vtkPoints* cellPoints = vtkPoints::New();
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
+      {
+      vtkIdType first = chunk * this->ChunkSize;
+      vtkIdType last = std::min(first + this->ChunkSize, this->NumberOfCells);
+      this->Self->IntegrateCells(this->Input, this->Chunks[chunk],
+        first, last, cellPtIds, cell, cellPoints);
+      }
+    cellPtIds->Delete();
+    cell->Delete();
+    cellPoints->Delete();
+    }
 };
 
 //-----------------------------------------------------------------------------
@@ -106,44 +289,81 @@ int vtkIntegrateAttributes::FillInputPortInformation(int port,
 }
 
 //-----------------------------------------------------------------------------
-int vtkIntegrateAttributes::CompareIntegrationDimension(vtkDataSet* output,
+int vtkIntegrateAttributes::CompareIntegrationDimension(vtkAccumulator& sums,
                                                         int dim)
 {
-  // higher dimension prevails
-  if (this->IntegrationDimension < dim)
-    { // Throw out results from lower dimension.
-    this->Sum = 0;
-    this->SumCenter[0] = this->SumCenter[1] = this->SumCenter[2] = 0.0;
-    this->ZeroAttributes(output->GetPointData());
-    this->ZeroAttributes(output->GetCellData());
-    this->IntegrationDimension = dim;
-    return 1;
-    }
+  // higher dimension prevails, results from lower dimension are thrown out.
   // Skip this cell if we are inetrgrting a higher dimension.
-  return (this->IntegrationDimension == dim);
+  return sums.CompareDimension(dim)? 1 : 0;
 }
 
 //----------------------------------------------------------------------------
 void vtkIntegrateAttributes::ExecuteBlock(
-  vtkDataSet* input, vtkUnstructuredGrid* output,
+  vtkDataSet* input, vtkAccumulator& sums,
   int fieldset_index,
   vtkIntegrateAttributes::vtkFieldList& pdList,
   vtkIntegrateAttributes::vtkFieldList& cdList)
 {
-  vtkUnsignedCharArray* ghostArray = input->GetCellGhostArray();
-
   // This is sort of a hack since it's incredibly painful to change all the
   // signatures to take the pdList, cdList and fieldset_index.
   this->PointFieldList = &pdList;
   this->CellFieldList = &cdList;
   this->FieldListIndex = fieldset_index;
 
-  vtkIdList* cellPtIds = vtkIdList::New();
   vtkIdType numCells = input->GetNumberOfCells();
+  if (numCells > 0)
+    {
+    // Makes the dataset build its cells, if needed, before they are
+    // accessed concurrently.
+    input->GetCellType(0);
+    }
+
+  // The number of chunks only depends on the number of cells and the chunks
+  // are merged in order, hence the sums don't depend on the number of
+  // threads.
+  vtkIdType numChunks = std::min(
+    static_cast<vtkIdType>((numCells + VTK_INTEGRATE_MIN_CHUNK_SIZE - 1) /
+      VTK_INTEGRATE_MIN_CHUNK_SIZE),
+    static_cast<vtkIdType>(VTK_INTEGRATE_MAX_CHUNKS));
+  if (numChunks > 0)
+    {
+    std::vector<vtkAccumulator> chunks(numChunks);
+    for (vtkIdType i = 0; i < numChunks; ++i)
+      {
+      chunks[i].Initialize(sums.PointValues.size(), sums.CellValues.size(),
+        sums.Dimension);
+      }
+
+    vtkIntegrateChunks functor;
+    functor.Self = this;
+    functor.Input = input;
+    functor.NumberOfCells = numCells;
+    functor.ChunkSize = (numCells + numChunks - 1) / numChunks;
+    functor.Chunks = &chunks[0];
+    vtkSMPTools::For(0, numChunks, 1, functor);
+
+    for (vtkIdType i = 0; i < numChunks; ++i)
+      {
+      sums.Merge(chunks[i]);
+      }
+    }
+
+  this->PointFieldList = NULL;
+  this->CellFieldList = NULL;
+  this->FieldListIndex = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkIntegrateAttributes::IntegrateCells(
+  vtkDataSet* input, vtkAccumulator& sums,
+  vtkIdType firstCellId, vtkIdType lastCellId,
+  vtkIdList* cellPtIds, vtkGenericCell* cell, vtkPoints* cellPoints)
+{
+  vtkUnsignedCharArray* ghostArray = input->GetCellGhostArray();
+
   vtkIdType cellId;
-  vtkPoints *cellPoints = 0; // needed if we need to split 3D cells
   int cellType;
-  for (cellId = 0; cellId < numCells; ++cellId)
+  for (cellId = firstCellId; cellId < lastCellId; ++cellId)
     {
     cellType = input->GetCellType(cellId);
     // Make sure we are not integrating ghost cells.
@@ -164,20 +384,20 @@ void vtkIntegrateAttributes::ExecuteBlock(
       case VTK_POLY_LINE:
       case VTK_LINE:
       {
-      if (this->CompareIntegrationDimension(output, 1))
+      if (this->CompareIntegrationDimension(sums, 1))
         {
         input->GetCellPoints(cellId, cellPtIds);
-        this->IntegratePolyLine(input, output, cellId, cellPtIds);
+        this->IntegratePolyLine(input, sums, cellId, cellPtIds);
         }
       }
       break;
 
       case VTK_TRIANGLE:
       {
-      if (this->CompareIntegrationDimension(output, 2))
+      if (this->CompareIntegrationDimension(sums, 2))
         {
         input->GetCellPoints(cellId, cellPtIds);
-        this->IntegrateTriangle(input,output,cellId,cellPtIds->GetId(0),
+        this->IntegrateTriangle(input,sums,cellId,cellPtIds->GetId(0),
                                 cellPtIds->GetId(1),cellPtIds->GetId(2));
         }
       }
@@ -185,63 +405,63 @@ void vtkIntegrateAttributes::ExecuteBlock(
 
       case VTK_TRIANGLE_STRIP:
       {
-      if (this->CompareIntegrationDimension(output, 2))
+      if (this->CompareIntegrationDimension(sums, 2))
         {
         input->GetCellPoints(cellId, cellPtIds);
-        this->IntegrateTriangleStrip(input, output, cellId, cellPtIds);
+        this->IntegrateTriangleStrip(input, sums, cellId, cellPtIds);
         }
       }
       break;
 
       case VTK_POLYGON:
       {
-      if (this->CompareIntegrationDimension(output, 2))
+      if (this->CompareIntegrationDimension(sums, 2))
         {
         input->GetCellPoints(cellId, cellPtIds);
-        this->IntegratePolygon(input, output, cellId, cellPtIds);
+        this->IntegratePolygon(input, sums, cellId, cellPtIds);
         }
       }
       break;
 
       case VTK_PIXEL:
       {
-      if (this->CompareIntegrationDimension(output, 2))
+      if (this->CompareIntegrationDimension(sums, 2))
         {
         input->GetCellPoints(cellId, cellPtIds);
-        this->IntegratePixel(input, output, cellId, cellPtIds);
+        this->IntegratePixel(input, sums, cellId, cellPtIds);
         }
       }
       break;
 
       case VTK_QUAD:
       {
-      if (this->CompareIntegrationDimension(output, 2))
+      if (this->CompareIntegrationDimension(sums, 2))
         {
         vtkIdType pt1Id, pt2Id, pt3Id;
         input->GetCellPoints(cellId, cellPtIds);
         pt1Id = cellPtIds->GetId(0);
         pt2Id = cellPtIds->GetId(1);
         pt3Id = cellPtIds->GetId(2);
-        this->IntegrateTriangle(input, output, cellId, pt1Id, pt2Id, pt3Id);
+        this->IntegrateTriangle(input, sums, cellId, pt1Id, pt2Id, pt3Id);
         pt2Id = cellPtIds->GetId(3);
-        this->IntegrateTriangle(input, output, cellId, pt1Id, pt2Id, pt3Id);
+        this->IntegrateTriangle(input, sums, cellId, pt1Id, pt2Id, pt3Id);
         }
       }
       break;
 
       case VTK_VOXEL:
       {
-      if (this->CompareIntegrationDimension(output, 3))
+      if (this->CompareIntegrationDimension(sums, 3))
         {
         input->GetCellPoints(cellId, cellPtIds);
-        this->IntegrateVoxel(input, output, cellId, cellPtIds);
+        this->IntegrateVoxel(input, sums, cellId, cellPtIds);
         }
       }
       break;
 
       case VTK_TETRA:
       {
-      if (this->CompareIntegrationDimension(output, 3))
+      if (this->CompareIntegrationDimension(sums, 3))
         {
         vtkIdType pt1Id, pt2Id, pt3Id, pt4Id;
         input->GetCellPoints(cellId, cellPtIds);
@@ -249,7 +469,7 @@ void vtkIntegrateAttributes::ExecuteBlock(
         pt2Id = cellPtIds->GetId(1);
         pt3Id = cellPtIds->GetId(2);
         pt4Id = cellPtIds->GetId(3);
-        this->IntegrateTetrahedron(input, output, cellId, pt1Id, pt2Id,
+        this->IntegrateTetrahedron(input, sums, cellId, pt1Id, pt2Id,
                                    pt3Id, pt4Id);
         }
       }
@@ -258,35 +478,29 @@ void vtkIntegrateAttributes::ExecuteBlock(
       default:
       {
       // We need to explicitly get the cell
-      vtkCell *cell = input->GetCell(cellId);
+      input->GetCell(cellId, cell);
       int cellDim = cell->GetCellDimension();
       if (cellDim == 0)
         {
         continue;
         }
-      if (!this->CompareIntegrationDimension(output, cellDim))
+      if (!this->CompareIntegrationDimension(sums, cellDim))
         {
         continue;
         }
 
-      // We will need a place to store points from the cell's
-      // triangulate function
-      if (!cellPoints)
-        {
-        cellPoints = vtkPoints::New();
-        }
-
+      // cellPoints stores the points from the cell's triangulate function
       cell->Triangulate(1, cellPtIds, cellPoints);
       switch (cellDim)
         {
         case 1:
-          this->IntegrateGeneral1DCell(input, output, cellId, cellPtIds);
+          this->IntegrateGeneral1DCell(input, sums, cellId, cellPtIds);
           break;
         case 2:
-          this->IntegrateGeneral2DCell(input, output, cellId, cellPtIds);
+          this->IntegrateGeneral2DCell(input, sums, cellId, cellPtIds);
           break;
         case 3:
-          this->IntegrateGeneral3DCell(input, output, cellId, cellPtIds);
+          this->IntegrateGeneral3DCell(input, sums, cellId, cellPtIds);
           break;
         default:
           vtkWarningMacro("Unsupported Cell Dimension = "
@@ -295,15 +509,6 @@ void vtkIntegrateAttributes::ExecuteBlock(
       }
       }
     }
-  cellPtIds->Delete();
-  if (cellPoints)
-    {
-    cellPoints->Delete();
-    }
-
-  this->PointFieldList = NULL;
-  this->CellFieldList = NULL;
-  this->FieldListIndex = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -328,6 +533,7 @@ int vtkIntegrateAttributes::RequestData(vtkInformation*,
   vtkDataObject* input = inInfo->Get(vtkDataObject::DATA_OBJECT());
   vtkCompositeDataSet *compositeInput = vtkCompositeDataSet::SafeDownCast(input);
   vtkDataSet *dsInput = vtkDataSet::SafeDownCast(input);
+  vtkAccumulator sums;
   if (compositeInput)
     {
     vtkCompositeDataIterator* iter = compositeInput->NewIterator();
@@ -399,6 +605,9 @@ int vtkIntegrateAttributes::RequestData(vtkInformation*,
     // Now initialize the output for the intersected set of arrays.
     this->AllocateAttributes(pdList, output->GetPointData());
     this->AllocateAttributes(cdList, output->GetCellData());
+    sums.Initialize(
+      vtkIntegrateAttributesNumberOfValues(output->GetPointData()),
+      vtkIntegrateAttributesNumberOfValues(output->GetCellData()), 0);
 
     index = 0;
     // Now execute for each block.
@@ -409,7 +618,7 @@ int vtkIntegrateAttributes::RequestData(vtkInformation*,
       vtkDataSet* ds = vtkDataSet::SafeDownCast(dobj);
       if (ds && ds->GetNumberOfPoints() > 0)
         {
-        this->ExecuteBlock(ds, output, index, pdList, cdList);
+        this->ExecuteBlock(ds, sums, index, pdList, cdList);
         index++;
         }
       }
@@ -426,7 +635,10 @@ int vtkIntegrateAttributes::RequestData(vtkInformation*,
     cdList.InitializeFieldList(dsInput->GetCellData());
     this->AllocateAttributes(pdList, output->GetPointData());
     this->AllocateAttributes(cdList, output->GetCellData());
-    this->ExecuteBlock(dsInput, output, 0, pdList, cdList);
+    sums.Initialize(
+      vtkIntegrateAttributesNumberOfValues(output->GetPointData()),
+      vtkIntegrateAttributesNumberOfValues(output->GetCellData()), 0);
+    this->ExecuteBlock(dsInput, sums, 0, pdList, cdList);
     }
   else
     {
@@ -438,11 +650,41 @@ int vtkIntegrateAttributes::RequestData(vtkInformation*,
     return 0;
     }
 
-  // Here is the trick:  The satellites need a point and vertex to
-  // marshal the attributes.
+  // Sum the results of all processes, all of them get the global sums.
+  this->AllReduceSums(sums, output);
+
+  this->IntegrationDimension = sums.Dimension;
+  this->Sum = sums.Sum.GetValue();
+  for (int i = 0; i < 3; ++i)
+    {
+    this->SumCenter[i] = sums.SumCenter[i].GetValue();
+    }
+  vtkDataSetAttributes* outAttributes[2] =
+    { output->GetPointData(), output->GetCellData() };
+  vtkCompensatedSum* values[2] =
+    { sums.GetPointValues(), sums.GetCellValues() };
+  for (int i = 0; i < 2; ++i)
+    {
+    for (int j = 0; j < outAttributes[i]->GetNumberOfArrays(); ++j)
+      {
+      vtkDataArray* outArray = outAttributes[i]->GetArray(j);
+      int numComponents = outArray->GetNumberOfComponents();
+      for (int k = 0; k < numComponents; ++k)
+        {
+        outArray->SetComponent(0, k, values[i][k].GetValue());
+        }
+      values[i] += numComponents;
+      }
+    }
+
+  if (this->Controller && this->Controller->GetLocalProcessId() > 0)
+    {
+    // The satellites have empty data.
+    output->Initialize();
+    return 1;
+    }
 
   // Generate point and vertex.  Add extra attributes for area too.
-  // Satellites do not need the area attribute, but it does not hurt.
   double pt[3];
   vtkPoints* newPoints = vtkPoints::New();
   newPoints->SetNumberOfPoints(1);
@@ -491,122 +733,142 @@ int vtkIntegrateAttributes::RequestData(vtkInformation*,
     }
   sumArray->Delete();
 
-  int globalMin = this->PieceNodeMinToNode0 (output);
-  int processId = this->Controller->GetLocalProcessId();
-  int numProcs = this->Controller->GetNumberOfProcesses();
-  if (globalMin == numProcs)
+  return 1;
+}
+
+//-----------------------------------------------------------------------------
+void vtkIntegrateAttributes::AllReduceSums(vtkAccumulator& sums,
+                                           vtkUnstructuredGrid* output)
+{
+  if (!this->Controller || this->Controller->GetNumberOfProcesses() <= 1)
     {
-    // there is no data in any of the processors
-    return 1;
+    return;
     }
-  if (processId > 0)
+  int numProcs = this->Controller->GetNumberOfProcesses();
+  int processId = this->Controller->GetLocalProcessId();
+
+  // Results from lower dimension are thrown out.
+  int dimension = sums.Dimension;
+  int globalDimension = 0;
+  this->Controller->AllReduce(&dimension, &globalDimension, 1,
+                              vtkCommunicator::MAX_OP);
+  sums.CompareDimension(globalDimension);
+
+  // The first process that has arrays broadcasts their names and number of
+  // components.
+  vtkDataSetAttributes* outAttributes[2] =
+    { output->GetPointData(), output->GetCellData() };
+  int localId = (outAttributes[0]->GetNumberOfArrays() > 0 ||
+    outAttributes[1]->GetNumberOfArrays() > 0)? processId : numProcs;
+  int layoutId = numProcs;
+  this->Controller->AllReduce(&localId, &layoutId, 1,
+                              vtkCommunicator::MIN_OP);
+  vtkMultiProcessStream layout;
+  if (layoutId < numProcs)
     {
-    if (processId != globalMin)
+    if (processId == layoutId)
       {
-      this->SendPiece (output);
+      for (int i = 0; i < 2; ++i)
+        {
+        int numArrays = outAttributes[i]->GetNumberOfArrays();
+        layout << numArrays;
+        for (int j = 0; j < numArrays; ++j)
+          {
+          vtkDataArray* array = outAttributes[i]->GetArray(j);
+          layout << std::string(array->GetName()? array->GetName() : "")
+                 << array->GetNumberOfComponents();
+          }
+        }
       }
+    this->Controller->Broadcast(layout, layoutId);
     }
-  else
+
+  // Local (sum, compensation) pairs in the broadcasted order, arrays that
+  // are missing contribute zeros.
+  std::vector<double> local;
+  local.push_back(sums.Sum.Sum);
+  local.push_back(sums.Sum.Compensation);
+  for (int i = 0; i < 3; ++i)
     {
-    for (int id = 1; id < numProcs; ++id)
+    local.push_back(sums.SumCenter[i].Sum);
+    local.push_back(sums.SumCenter[i].Compensation);
+    }
+  std::vector<std::string> names[2];
+  std::vector<int> components[2];
+  if (layoutId < numProcs)
+    {
+    for (int i = 0; i < 2; ++i)
       {
-      if (id != globalMin)
+      // Offsets of the local arrays in the local sums.
+      std::vector<int> offsets(outAttributes[i]->GetNumberOfArrays(), 0);
+      for (int j = 1; j < outAttributes[i]->GetNumberOfArrays(); ++j)
         {
-        this->ReceivePiece (output, id);
+        offsets[j] = offsets[j-1] +
+          outAttributes[i]->GetArray(j-1)->GetNumberOfComponents();
+        }
+      const vtkCompensatedSum* values = (i == 0)?
+        sums.GetPointValues() : sums.GetCellValues();
+
+      int numArrays;
+      layout >> numArrays;
+      names[i].resize(numArrays);
+      components[i].resize(numArrays);
+      for (int j = 0; j < numArrays; ++j)
+        {
+        layout >> names[i][j] >> components[i][j];
+        int index = -1;
+        vtkDataArray* array = names[i][j].empty()? NULL :
+          outAttributes[i]->GetArray(names[i][j].c_str(), index);
+        bool found = array &&
+          array->GetNumberOfComponents() == components[i][j];
+        for (int k = 0; k < components[i][j]; ++k)
+          {
+          local.push_back(found? values[offsets[index] + k].Sum : 0.0);
+          local.push_back(found? values[offsets[index] + k].Compensation : 0.0);
+          }
         }
       }
-
-    // now that we have all of the sums from each process
-    // set the point location with the global value
-    if (this->Sum != 0.0)
-      {
-      pt[0] = this->SumCenter[0] / this->Sum;
-      pt[1] = this->SumCenter[1] / this->Sum;
-      pt[2] = this->SumCenter[2] / this->Sum;
-      }
-    else
-      {
-      pt[0] = this->SumCenter[0];
-      pt[1] = this->SumCenter[1];
-      pt[2] = this->SumCenter[2];
-      }
-    output->GetPoints()->SetPoint(0, pt);
     }
 
-  return 1;
-}
+  std::vector<double> global(local.size(), 0.0);
+  vtkIntegrateAttributesSumOperation operation;
+  this->Controller->AllReduce(&local[0], &global[0],
+    static_cast<vtkIdType>(local.size()), &operation);
 
-int vtkIntegrateAttributes::PieceNodeMinToNode0(vtkUnstructuredGrid *data)
-{
-  int numProcs = this->Controller->GetNumberOfProcesses();
-  int processId = this->Controller->GetLocalProcessId();
-  int localMin = (data->GetNumberOfCells() == 0 ? numProcs : processId);
-  int globalMin = numProcs;
-  if (numProcs == 1)
-    {
-    return 0;
-    }
-  this->Controller->AllReduce (&localMin, &globalMin, 1,
-                               vtkCommunicator::MIN_OP);
-  if (globalMin == 0 || globalMin == numProcs)
+  // Replace the local sums and arrays by the global ones.
+  size_t pos = 0;
+  sums.Sum.Sum = global[pos++];
+  sums.Sum.Compensation = global[pos++];
+  for (int i = 0; i < 3; ++i)
     {
-    return globalMin;
+    sums.SumCenter[i].Sum = global[pos++];
+    sums.SumCenter[i].Compensation = global[pos++];
     }
-  if (processId == 0)
+  for (int i = 0; i < 2; ++i)
     {
-    this->ReceivePiece(data, globalMin);
-    }
-  else if (processId == globalMin)
-    {
-    this->SendPiece (data);
-    }
-  return globalMin;
-}
-
-void vtkIntegrateAttributes::SendPiece(vtkUnstructuredGrid *src)
-{
-  double msg[5];
-  msg[0] = (double)(this->IntegrationDimension);
-  msg[1] = this->Sum;
-  msg[2] = this->SumCenter[0];
-  msg[3] = this->SumCenter[1];
-  msg[4] = this->SumCenter[2];
-  this->Controller->Send(msg, 5, 0, vtkIntegrateAttributes::IntegrateAttrInfo);
-  this->Controller->Send(src, 0, vtkIntegrateAttributes::IntegrateAttrData);
-  // Done sending.  Reset src so satellites will have empty data.
-  src->Initialize();
-}
-
-void vtkIntegrateAttributes::ReceivePiece (vtkUnstructuredGrid *mergeTo,
-                                           int fromId)
-{
-  double msg[5];
-  this->Controller->Receive(msg,
-                            5,
-                            fromId,
-                            vtkIntegrateAttributes::IntegrateAttrInfo);
-  vtkUnstructuredGrid* tmp = vtkUnstructuredGrid::New();
-  this->Controller->Receive(tmp,
-                            fromId,
-                            vtkIntegrateAttributes::IntegrateAttrData);
-  if (this->CompareIntegrationDimension(mergeTo, (int)(msg[0])))
-    {
-    this->Sum += msg[1];
-    this->SumCenter[0] += msg[2];
-    this->SumCenter[1] += msg[3];
-    this->SumCenter[2] += msg[4];
-    this->IntegrateSatelliteData(tmp->GetPointData(),
-                                 mergeTo->GetPointData());
-    this->IntegrateSatelliteData(tmp->GetCellData(),
-                                 mergeTo->GetCellData());
+    outAttributes[i]->Initialize();
+    std::vector<vtkCompensatedSum>& values = (i == 0)?
+      sums.PointValues : sums.CellValues;
+    values.clear();
+    for (size_t j = 0; j < names[i].size(); ++j)
+      {
+      vtkDoubleArray* outArray = vtkDoubleArray::New();
+      outArray->SetNumberOfComponents(components[i][j]);
+      outArray->SetNumberOfTuples(1);
+      outArray->SetName(names[i][j].c_str());
+      outAttributes[i]->AddArray(outArray);
+      outArray->Delete();
+      for (int k = 0; k < components[i][j]; ++k)
+        {
+        vtkCompensatedSum value;
+        value.Sum = global[pos++];
+        value.Compensation = global[pos++];
+        values.push_back(value);
+        }
+      }
     }
-  tmp->Delete();
-  tmp = 0;
 }
 
-
-
-
 //-----------------------------------------------------------------------------
 void vtkIntegrateAttributes::AllocateAttributes(
   vtkIntegrateAttributes::vtkFieldList& fieldList,
@@ -634,119 +896,115 @@ void vtkIntegrateAttributes::AllocateAttributes(
     outArray->Delete();
     // Should we set scalars, vectors ...
     }
-}
 
-//-----------------------------------------------------------------------------
-void vtkIntegrateAttributes::ZeroAttributes(vtkDataSetAttributes* outda)
-{
-  int numArrays, i, numComponents, j;
-  vtkDataArray* outArray;
-  numArrays = outda->GetNumberOfArrays();
-  for (i = 0; i < numArrays; ++i)
+  // The sums of the arrays follow the order of the output arrays.
+  std::vector<int> arrayOffsets(outda->GetNumberOfArrays(), 0);
+  int offset = 0;
+  for (int i = 0; i < outda->GetNumberOfArrays(); ++i)
     {
-    outArray = outda->GetArray(i);
-    numComponents = outArray->GetNumberOfComponents();
-    for (j = 0; j < numComponents; ++j)
+    arrayOffsets[i] = offset;
+    offset += outda->GetArray(i)->GetNumberOfComponents();
+    }
+  fieldList.Offsets.assign(numArrays, -1);
+  for (int i = 0; i < numArrays; ++i)
+    {
+    int arrayIndex = fieldList.GetFieldIndex(i);
+    if (arrayIndex >= 0)
       {
-      outArray->SetComponent(0, j, 0.0);
+      fieldList.Offsets[i] = arrayOffsets[arrayIndex];
       }
     }
 }
+
 //-----------------------------------------------------------------------------
 void vtkIntegrateAttributes::IntegrateData1(vtkDataSetAttributes* inda,
-  vtkDataSetAttributes* outda,
+  vtkCompensatedSum* outValues,
   vtkIdType pt1Id, double k,
   vtkIntegrateAttributes::vtkFieldList& fieldList, int index)
 {
   int numArrays, i, numComponents, j;
   vtkDataArray* inArray;
-  vtkDataArray* outArray;
+  vtkCompensatedSum* outArray;
   numArrays = fieldList.GetNumberOfFields();
-  double vIn1, dv, vOut;
+  double vIn1, dv;
   for (i = 0; i < numArrays; ++i)
     {
-    if (fieldList.GetFieldIndex(i) < 0)
+    if (fieldList.Offsets[i] < 0)
       {
       continue;
       }
     // We could template for speed.
     inArray = inda->GetArray(fieldList.GetDSAIndex(index, i));
-    outArray = outda->GetArray(fieldList.GetFieldIndex(i));
+    outArray = outValues + fieldList.Offsets[i];
     numComponents = inArray->GetNumberOfComponents();
     for (j = 0; j < numComponents; ++j)
       {
       vIn1 = inArray->GetComponent(pt1Id, j);
-      vOut = outArray->GetComponent(0, j);
       dv = vIn1;
-      vOut += dv*k;
-      outArray->SetComponent(0, j, vOut);
+      outArray[j].Add(dv*k);
       }
     }
 }
 //-----------------------------------------------------------------------------
 void vtkIntegrateAttributes::IntegrateData2(vtkDataSetAttributes* inda,
-  vtkDataSetAttributes* outda,
+  vtkCompensatedSum* outValues,
   vtkIdType pt1Id, vtkIdType pt2Id, double k,
   vtkIntegrateAttributes::vtkFieldList& fieldList, int index)
 {
   int numArrays, i, numComponents, j;
   vtkDataArray* inArray;
-  vtkDataArray* outArray;
+  vtkCompensatedSum* outArray;
   numArrays = fieldList.GetNumberOfFields();
-  double vIn1, vIn2, dv, vOut;
+  double vIn1, vIn2, dv;
   for (i = 0; i < numArrays; ++i)
     {
-    if (fieldList.GetFieldIndex(i) < 0)
+    if (fieldList.Offsets[i] < 0)
       {
       continue;
       }
     // We could template for speed.
     inArray = inda->GetArray(fieldList.GetDSAIndex(index, i));
-    outArray = outda->GetArray(fieldList.GetFieldIndex(i));
+    outArray = outValues + fieldList.Offsets[i];
     numComponents = inArray->GetNumberOfComponents();
     for (j = 0; j < numComponents; ++j)
       {
       vIn1 = inArray->GetComponent(pt1Id, j);
       vIn2 = inArray->GetComponent(pt2Id, j);
-      vOut = outArray->GetComponent(0, j);
       dv = 0.5*(vIn1+vIn2);
-      vOut += dv*k;
-      outArray->SetComponent(0, j, vOut);
+      outArray[j].Add(dv*k);
       }
     }
 }
 //-----------------------------------------------------------------------------
 // Is the extra performance worth duplicating this code with IntergrateData2.
 void vtkIntegrateAttributes::IntegrateData3(vtkDataSetAttributes* inda,
-  vtkDataSetAttributes* outda,
+  vtkCompensatedSum* outValues,
   vtkIdType pt1Id, vtkIdType pt2Id,
   vtkIdType pt3Id, double k,
   vtkIntegrateAttributes::vtkFieldList& fieldList, int index)
 {
   int numArrays, i, numComponents, j;
   vtkDataArray* inArray;
-  vtkDataArray* outArray;
+  vtkCompensatedSum* outArray;
   numArrays = fieldList.GetNumberOfFields();
-  double vIn1, vIn2, vIn3, dv, vOut;
+  double vIn1, vIn2, vIn3, dv;
   for (i = 0; i < numArrays; ++i)
     {
-    if (fieldList.GetFieldIndex(i) < 0)
+    if (fieldList.Offsets[i] < 0)
       {
       continue;
       }
     // We could template for speed.
     inArray = inda->GetArray(fieldList.GetDSAIndex(index, i));
-    outArray = outda->GetArray(fieldList.GetFieldIndex(i));
+    outArray = outValues + fieldList.Offsets[i];
     numComponents = inArray->GetNumberOfComponents();
     for (j = 0; j < numComponents; ++j)
       {
       vIn1 = inArray->GetComponent(pt1Id, j);
       vIn2 = inArray->GetComponent(pt2Id, j);
       vIn3 = inArray->GetComponent(pt3Id, j);
-      vOut = outArray->GetComponent(0, j);
       dv = (vIn1+vIn2+vIn3)/3.0;
-      vOut += dv*k;
-      outArray->SetComponent(0, j, vOut);
+      outArray[j].Add(dv*k);
       }
     }
 }
@@ -754,7 +1012,7 @@ void vtkIntegrateAttributes::IntegrateData3(vtkDataSetAttributes* inda,
 //-----------------------------------------------------------------------------
 // Is the extra performance worth duplicating this code with IntergrateData2.
 void vtkIntegrateAttributes::IntegrateData4(vtkDataSetAttributes* inda,
-  vtkDataSetAttributes* outda,
+  vtkCompensatedSum* outValues,
   vtkIdType pt1Id, vtkIdType pt2Id,
   vtkIdType pt3Id, vtkIdType pt4Id,
   double k,
@@ -762,18 +1020,18 @@ void vtkIntegrateAttributes::IntegrateData4(vtkDataSetAttributes* inda,
 {
   int numArrays, i, numComponents, j;
   vtkDataArray* inArray;
-  vtkDataArray* outArray;
+  vtkCompensatedSum* outArray;
   numArrays = fieldList.GetNumberOfFields();
-  double vIn1, vIn2, vIn3, vIn4, dv, vOut;
+  double vIn1, vIn2, vIn3, vIn4, dv;
   for (i = 0; i < numArrays; ++i)
     {
-    if (fieldList.GetFieldIndex(i) < 0)
+    if (fieldList.Offsets[i] < 0)
       {
       continue;
       }
     // We could template for speed.
     inArray = inda->GetArray(fieldList.GetDSAIndex(index, i));
-    outArray = outda->GetArray(fieldList.GetFieldIndex(i));
+    outArray = outValues + fieldList.Offsets[i];
     numComponents = inArray->GetNumberOfComponents();
     for (j = 0; j < numComponents; ++j)
       {
@@ -781,65 +1039,15 @@ void vtkIntegrateAttributes::IntegrateData4(vtkDataSetAttributes* inda,
       vIn2 = inArray->GetComponent(pt2Id, j);
       vIn3 = inArray->GetComponent(pt3Id, j);
       vIn4 = inArray->GetComponent(pt4Id, j);
-      vOut = outArray->GetComponent(0, j);
       dv = (vIn1+vIn2+vIn3+vIn4) * 0.25;
-      vOut += dv*k;
-      outArray->SetComponent(0, j, vOut);
-      }
-    }
-}
-
-//-----------------------------------------------------------------------------
-// Used to sum arrays from all processes.
-void vtkIntegrateAttributes::IntegrateSatelliteData(
-  vtkDataSetAttributes* sendingProcAttributes,
-  vtkDataSetAttributes* proc0Attributes)
-{
-  // if the sending processor has no data
-  if (sendingProcAttributes->GetNumberOfArrays() == 0)
-    {
-    return;
-    }
-
-  // when processor 0 that has no data, receives data from the min
-  // processor that has data
-  if (proc0Attributes->GetNumberOfArrays() == 0)
-    {
-    proc0Attributes->DeepCopy (sendingProcAttributes);
-    return;
-    }
-
-  int numArrays, i, numComponents, j;
-  vtkDataArray* inArray;
-  vtkDataArray* outArray;
-  numArrays = proc0Attributes->GetNumberOfArrays();
-  double vIn, vOut;
-  for (i = 0; i < numArrays; ++i)
-    {
-    outArray = proc0Attributes->GetArray(i);
-    numComponents = outArray->GetNumberOfComponents();
-    // Protect against arrays in a different order.
-    const char* name = outArray->GetName();
-    if (name && name[0] != '\0')
-      {
-      inArray = sendingProcAttributes->GetArray(name);
-      if (inArray && inArray->GetNumberOfComponents() == numComponents)
-        {
-        // We could template for speed.
-        for (j = 0; j < numComponents; ++j)
-          {
-          vIn = inArray->GetComponent(0, j);
-          vOut = outArray->GetComponent(0, j);
-          outArray->SetComponent(0,j,vOut+vIn);
-          }
-        }
+      outArray[j].Add(dv*k);
       }
     }
 }
 
 //-----------------------------------------------------------------------------
 void vtkIntegrateAttributes::IntegratePolyLine(vtkDataSet* input,
-                                               vtkUnstructuredGrid* output,
+                                               vtkAccumulator& sums,
                                                vtkIdType cellId,
                                                vtkIdList* ptIds)
 {
@@ -858,22 +1066,22 @@ void vtkIntegrateAttributes::IntegratePolyLine(vtkDataSet* input,
 
     // Compute the length of the line.
     length = sqrt(vtkMath::Distance2BetweenPoints(pt1, pt2));
-    this->Sum += length;
+    sums.Sum.Add(length);
 
     // Compute the middle, which is really just another attribute.
     mid[0] = (pt1[0]+pt2[0])*0.5;
     mid[1] = (pt1[1]+pt2[1])*0.5;
     mid[2] = (pt1[2]+pt2[2])*0.5;
     // Add weighted to sumCenter.
-    this->SumCenter[0] += mid[0]*length;
-    this->SumCenter[1] += mid[1]*length;
-    this->SumCenter[2] += mid[2]*length;
+    sums.SumCenter[0].Add(mid[0]*length);
+    sums.SumCenter[1].Add(mid[1]*length);
+    sums.SumCenter[2].Add(mid[2]*length);
 
     // Now integrate the rest of the attributes.
-    this->IntegrateData2(input->GetPointData(), output->GetPointData(),
+    this->IntegrateData2(input->GetPointData(), sums.GetPointValues(),
                          pt1Id, pt2Id, length,
                          *this->PointFieldList, this->FieldListIndex);
-    this->IntegrateData1(input->GetCellData(), output->GetCellData(),
+    this->IntegrateData1(input->GetCellData(), sums.GetCellValues(),
                          cellId, length,
                          *this->CellFieldList, this->FieldListIndex);
     }
@@ -882,7 +1090,7 @@ void vtkIntegrateAttributes::IntegratePolyLine(vtkDataSet* input,
 //-----------------------------------------------------------------------------
 void
 vtkIntegrateAttributes::IntegrateGeneral1DCell(vtkDataSet* input,
-                                               vtkUnstructuredGrid* output,
+                                               vtkAccumulator& sums,
                                                vtkIdType cellId,
                                                vtkIdList* ptIds)
 {
@@ -911,22 +1119,22 @@ vtkIntegrateAttributes::IntegrateGeneral1DCell(vtkDataSet* input,
 
     // Compute the length of the line.
     length = sqrt(vtkMath::Distance2BetweenPoints(pt1, pt2));
-    this->Sum += length;
+    sums.Sum.Add(length);
 
     // Compute the middle, which is really just another attribute.
     mid[0] = (pt1[0]+pt2[0])*0.5;
     mid[1] = (pt1[1]+pt2[1])*0.5;
     mid[2] = (pt1[2]+pt2[2])*0.5;
     // Add weighted to sumCenter.
-    this->SumCenter[0] += mid[0]*length;
-    this->SumCenter[1] += mid[1]*length;
-    this->SumCenter[2] += mid[2]*length;
+    sums.SumCenter[0].Add(mid[0]*length);
+    sums.SumCenter[1].Add(mid[1]*length);
+    sums.SumCenter[2].Add(mid[2]*length);
 
     // Now integrate the rest of the attributes.
-    this->IntegrateData2(input->GetPointData(), output->GetPointData(),
+    this->IntegrateData2(input->GetPointData(), sums.GetPointValues(),
                          pt1Id, pt2Id, length,
                          *this->PointFieldList, this->FieldListIndex);
-    this->IntegrateData1(input->GetCellData(), output->GetCellData(),
+    this->IntegrateData1(input->GetCellData(), sums.GetCellValues(),
                          cellId, length,
                          *this->CellFieldList, this->FieldListIndex);
     }
@@ -934,7 +1142,7 @@ vtkIntegrateAttributes::IntegrateGeneral1DCell(vtkDataSet* input,
 
 //-----------------------------------------------------------------------------
 void vtkIntegrateAttributes::IntegrateTriangleStrip(vtkDataSet* input,
-                                                    vtkUnstructuredGrid* output,
+                                                    vtkAccumulator& sums,
                                                     vtkIdType cellId,
                                                     vtkIdList* ptIds)
 {
@@ -947,14 +1155,14 @@ void vtkIntegrateAttributes::IntegrateTriangleStrip(vtkDataSet* input,
     pt1Id = ptIds->GetId(triIdx);
     pt2Id = ptIds->GetId(triIdx+1);
     pt3Id = ptIds->GetId(triIdx+2);
-    this->IntegrateTriangle(input, output, cellId, pt1Id, pt2Id, pt3Id);
+    this->IntegrateTriangle(input, sums, cellId, pt1Id, pt2Id, pt3Id);
     }
 }
 
 //-----------------------------------------------------------------------------
 // Works for convex polygons, and interpoaltion is not correct.
 void vtkIntegrateAttributes::IntegratePolygon(vtkDataSet* input,
-                                              vtkUnstructuredGrid* output,
+                                              vtkAccumulator& sums,
                                               vtkIdType cellId,
                                               vtkIdList* ptIds)
 {
@@ -967,14 +1175,14 @@ void vtkIntegrateAttributes::IntegratePolygon(vtkDataSet* input,
     {
     pt2Id = ptIds->GetId(triIdx+1);
     pt3Id = ptIds->GetId(triIdx+2);
-    this->IntegrateTriangle(input, output, cellId, pt1Id, pt2Id, pt3Id);
+    this->IntegrateTriangle(input, sums, cellId, pt1Id, pt2Id, pt3Id);
     }
 }
 
 //-----------------------------------------------------------------------------
 // For axis alligned rectangular cells
 void vtkIntegrateAttributes::IntegratePixel(vtkDataSet* input,
-                                            vtkUnstructuredGrid* output,
+                                            vtkAccumulator& sums,
                                             vtkIdType cellId,
                                             vtkIdList* cellPtIds)
 {
@@ -1000,27 +1208,27 @@ void vtkIntegrateAttributes::IntegratePixel(vtkDataSet* input,
       (pts[0][2] - pts[2][2]);
 
   a = fabs(l*w);
-  this->Sum += a;
+  sums.Sum.Add(a);
   // Compute the middle, which is really just another attribute.
   mid[0] = (pts[0][0]+pts[1][0]+pts[2][0]+pts[3][0])*0.25;
   mid[1] = (pts[0][1]+pts[1][1]+pts[2][1]+pts[3][1])*0.25;
   mid[2] = (pts[0][2]+pts[1][2]+pts[2][2]+pts[3][2])*0.25;
   // Add weighted to sumCenter.
-  this->SumCenter[0] += mid[0]*a;
-  this->SumCenter[1] += mid[1]*a;
-  this->SumCenter[2] += mid[2]*a;
+  sums.SumCenter[0].Add(mid[0]*a);
+  sums.SumCenter[1].Add(mid[1]*a);
+  sums.SumCenter[2].Add(mid[2]*a);
 
   // Now integrate the rest of the attributes.
-  this->IntegrateData4(input->GetPointData(), output->GetPointData(),
+  this->IntegrateData4(input->GetPointData(), sums.GetPointValues(),
                        pt1Id, pt2Id, pt3Id, pt4Id, a,
                        *this->PointFieldList, this->FieldListIndex);
-  this->IntegrateData1(input->GetCellData(), output->GetCellData(), cellId, a,
+  this->IntegrateData1(input->GetCellData(), sums.GetCellValues(), cellId, a,
     *this->CellFieldList, this->FieldListIndex);
 }
 
 //-----------------------------------------------------------------------------
 void vtkIntegrateAttributes::IntegrateTriangle(vtkDataSet* input,
-                                               vtkUnstructuredGrid* output,
+                                               vtkAccumulator& sums,
                                                vtkIdType cellId,
                                                vtkIdType pt1Id,
                                                vtkIdType pt2Id,
@@ -1051,29 +1259,29 @@ void vtkIntegrateAttributes::IntegrateTriangle(vtkDataSet* input,
     {
     return;
     }
-  this->Sum += k;
+  sums.Sum.Add(k);
 
   // Compute the middle, which is really just another attribute.
   mid[0] = (pt1[0]+pt2[0]+pt3[0])/3.0;
   mid[1] = (pt1[1]+pt2[1]+pt3[1])/3.0;
   mid[2] = (pt1[2]+pt2[2]+pt3[2])/3.0;
   // Add weighted to sumCenter.
-  this->SumCenter[0] += mid[0]*k;
-  this->SumCenter[1] += mid[1]*k;
-  this->SumCenter[2] += mid[2]*k;
+  sums.SumCenter[0].Add(mid[0]*k);
+  sums.SumCenter[1].Add(mid[1]*k);
+  sums.SumCenter[2].Add(mid[2]*k);
 
   // Now integrate the rest of the attributes.
-  this->IntegrateData3(input->GetPointData(), output->GetPointData(),
+  this->IntegrateData3(input->GetPointData(), sums.GetPointValues(),
                        pt1Id, pt2Id, pt3Id, k,
                        *this->PointFieldList, this->FieldListIndex);
-  this->IntegrateData1(input->GetCellData(), output->GetCellData(), cellId, k,
+  this->IntegrateData1(input->GetCellData(), sums.GetCellValues(), cellId, k,
     *this->CellFieldList, this->FieldListIndex);
 }
 
 //-----------------------------------------------------------------------------
 void
 vtkIntegrateAttributes::IntegrateGeneral2DCell(vtkDataSet* input,
-                                               vtkUnstructuredGrid* output,
+                                               vtkAccumulator& sums,
                                                vtkIdType cellId,
                                                vtkIdList* ptIds)
 {
@@ -1096,14 +1304,14 @@ vtkIntegrateAttributes::IntegrateGeneral2DCell(vtkDataSet* input,
     pt1Id = ptIds->GetId(triIdx++);
     pt2Id = ptIds->GetId(triIdx++);
     pt3Id = ptIds->GetId(triIdx++);
-    this->IntegrateTriangle(input, output, cellId, pt1Id, pt2Id, pt3Id);
+    this->IntegrateTriangle(input, sums, cellId, pt1Id, pt2Id, pt3Id);
     }
 }
 
 //-----------------------------------------------------------------------------
 // For Tetrahedral cells
 void vtkIntegrateAttributes::IntegrateTetrahedron(vtkDataSet* input,
-                                                  vtkUnstructuredGrid* output,
+                                                  vtkAccumulator& sums,
                                                   vtkIdType cellId,
                                                   vtkIdType pt1Id,
                                                   vtkIdType pt2Id,
@@ -1132,19 +1340,19 @@ void vtkIntegrateAttributes::IntegrateTetrahedron(vtkDataSet* input,
   // Calulate the volume of the tet which is 1/6 * the box product
   vtkMath::Cross(a,b,n);
   v = vtkMath::Dot(c, n) / 6.0;
-  this->Sum += v;
+  sums.Sum.Add(v);
 
   // Add weighted to sumCenter.
-  this->SumCenter[0] += mid[0]*v;
-  this->SumCenter[1] += mid[1]*v;
-  this->SumCenter[2] += mid[2]*v;
+  sums.SumCenter[0].Add(mid[0]*v);
+  sums.SumCenter[1].Add(mid[1]*v);
+  sums.SumCenter[2].Add(mid[2]*v);
 
   // Integrate the attributes on the cell itself
-  this->IntegrateData1(input->GetCellData(), output->GetCellData(), cellId, v,
+  this->IntegrateData1(input->GetCellData(), sums.GetCellValues(), cellId, v,
     *this->CellFieldList, this->FieldListIndex);
 
   // Integrate the attributes associated with the points
-  this->IntegrateData4(input->GetPointData(), output->GetPointData(),
+  this->IntegrateData4(input->GetPointData(), sums.GetPointValues(),
                        pt1Id, pt2Id, pt3Id, pt4Id, v,
                        *this->PointFieldList, this->FieldListIndex);
 
@@ -1153,7 +1361,7 @@ void vtkIntegrateAttributes::IntegrateTetrahedron(vtkDataSet* input,
 //-----------------------------------------------------------------------------
 // For axis alligned hexahedral cells
 void vtkIntegrateAttributes::IntegrateVoxel(vtkDataSet* input,
-                                            vtkUnstructuredGrid* output,
+                                            vtkAccumulator& sums,
                                             vtkIdType cellId,
                                             vtkIdList* cellPtIds)
 {
@@ -1177,7 +1385,7 @@ void vtkIntegrateAttributes::IntegrateVoxel(vtkDataSet* input,
   w = pts[2][1] - pts[0][1];
   h = pts[4][2] - pts[0][2];
   v = fabs(l*w*h);
-  this->Sum += v;
+  sums.Sum.Add(v);
 
   // Partially Compute the middle, which is really just another attribute.
   mid[0] = (pts[0][0]+pts[1][0]+pts[2][0]+pts[3][0])*0.125;
@@ -1185,14 +1393,14 @@ void vtkIntegrateAttributes::IntegrateVoxel(vtkDataSet* input,
   mid[2] = (pts[0][2]+pts[1][2]+pts[2][2]+pts[3][2])*0.125;
 
   // Integrate the attributes on the cell itself
-  this->IntegrateData1(input->GetCellData(), output->GetCellData(), cellId, v,
+  this->IntegrateData1(input->GetCellData(), sums.GetCellValues(), cellId, v,
     *this->CellFieldList, this->FieldListIndex);
 
   // Integrate the attributes associated with the points on the bottom face
   // note that since IntegrateData4 is going to weigh everything by 1/4
   // we need to pass down 1/2 the volume so they will be weighted by 1/8
 
-  this->IntegrateData4(input->GetPointData(), output->GetPointData(),
+  this->IntegrateData4(input->GetPointData(), sums.GetPointValues(),
                        pt1Id, pt2Id, pt3Id, pt4Id, v*0.5,
                        *this->PointFieldList, this->FieldListIndex);
 
@@ -1210,14 +1418,14 @@ void vtkIntegrateAttributes::IntegrateVoxel(vtkDataSet* input,
 
 
   // Add weighted to sumCenter.
-  this->SumCenter[0] += mid[0]*v;
-  this->SumCenter[1] += mid[1]*v;
-  this->SumCenter[2] += mid[2]*v;
+  sums.SumCenter[0].Add(mid[0]*v);
+  sums.SumCenter[1].Add(mid[1]*v);
+  sums.SumCenter[2].Add(mid[2]*v);
 
   // Integrate the attributes associated with the points on the top face
   // note that since IntegrateData4 is going to weigh everything by 1/4
   // we need to pass down 1/2 the volume so they will be weighted by 1/8
-  this->IntegrateData4(input->GetPointData(), output->GetPointData(),
+  this->IntegrateData4(input->GetPointData(), sums.GetPointValues(),
                        pt1Id, pt2Id, pt3Id, pt5Id, v*0.5,
                        *this->PointFieldList, this->FieldListIndex);
 }
@@ -1225,7 +1433,7 @@ void vtkIntegrateAttributes::IntegrateVoxel(vtkDataSet* input,
 //-----------------------------------------------------------------------------
 void
 vtkIntegrateAttributes::IntegrateGeneral3DCell(vtkDataSet* input,
-                                               vtkUnstructuredGrid* output,
+                                               vtkAccumulator& sums,
                                                vtkIdType cellId,
                                                vtkIdList* ptIds)
 {
@@ -1250,7 +1458,7 @@ vtkIntegrateAttributes::IntegrateGeneral3DCell(vtkDataSet* input,
     pt2Id = ptIds->GetId(tetIdx++);
     pt3Id = ptIds->GetId(tetIdx++);
     pt4Id = ptIds->GetId(tetIdx++);
-    this->IntegrateTetrahedron(input, output, cellId, pt1Id, pt2Id, pt3Id,
+    this->IntegrateTetrahedron(input, sums, cellId, pt1Id, pt2Id, pt3Id,
                                pt4Id);
     }
 }
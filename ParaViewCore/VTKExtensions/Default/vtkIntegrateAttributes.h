@@ -21,6 +21,12 @@
 // The output of this filter is a single point and vertex.  The attributes
 // for this point and cell will contain the integration results
 // for the corresponding input attributes.
+//
+// Cells are integrated concurrently, in chunks whose number only depends on
+// the number of cells, and every sum is compensated so that the results are
+// reproducible whatever the number of threads. In parallel, the sums of all
+// processes are combined with an AllReduce, the output of the satellites is
+// empty.
 
 #ifndef __vtkIntegrateAttributes_h
 #define __vtkIntegrateAttributes_h
@@ -29,11 +35,13 @@
 #include "vtkUnstructuredGridAlgorithm.h"
 
 class vtkDataSet;
+class vtkGenericCell;
 class vtkIdList;
 class vtkInformation;
 class vtkInformationVector;
 class vtkDataSetAttributes;
 class vtkMultiProcessController;
+class vtkPoints;
 
 class VTKPVVTKEXTENSIONSDEFAULT_EXPORT vtkIntegrateAttributes : public vtkUnstructuredGridAlgorithm
 {
@@ -46,6 +54,9 @@ public:
 
 //BTX
 protected:
+  class vtkCompensatedSum;
+  class vtkAccumulator;
+
   vtkIntegrateAttributes();
   ~vtkIntegrateAttributes();
 
@@ -61,7 +72,7 @@ protected:
   virtual int FillInputPortInformation(int, vtkInformation*);
 
 
-  int CompareIntegrationDimension(vtkDataSet* output, int dim);
+  int CompareIntegrationDimension(vtkAccumulator& sums, int dim);
   int IntegrationDimension;
 
   // The length, area or volume of the data set.  Computed by Execute;
@@ -70,79 +81,85 @@ protected:
   double SumCenter[3];
 
   void IntegratePolyLine(vtkDataSet* input,
-                         vtkUnstructuredGrid* output,
+                         vtkAccumulator& sums,
                          vtkIdType cellId, vtkIdList* cellPtIds);
   void IntegratePolygon(vtkDataSet* input,
-                         vtkUnstructuredGrid* output,
+                         vtkAccumulator& sums,
                          vtkIdType cellId, vtkIdList* cellPtIds);
   void IntegrateTriangleStrip(vtkDataSet* input,
-                         vtkUnstructuredGrid* output,
+                         vtkAccumulator& sums,
                          vtkIdType cellId, vtkIdList* cellPtIds);
   void IntegrateTriangle(vtkDataSet* input,
-                         vtkUnstructuredGrid* output,
+                         vtkAccumulator& sums,
                          vtkIdType cellId, vtkIdType pt1Id,
                          vtkIdType pt2Id, vtkIdType pt3Id);
   void IntegrateTetrahedron(vtkDataSet* input,
-                            vtkUnstructuredGrid* output,
+                            vtkAccumulator& sums,
                             vtkIdType cellId, vtkIdType pt1Id,
                             vtkIdType pt2Id, vtkIdType pt3Id,
                             vtkIdType pt4Id);
   void IntegratePixel(vtkDataSet* input,
-                      vtkUnstructuredGrid* output,
+                      vtkAccumulator& sums,
                       vtkIdType cellId, vtkIdList* cellPtIds);
   void IntegrateVoxel(vtkDataSet* input,
-                      vtkUnstructuredGrid* output,
+                      vtkAccumulator& sums,
                       vtkIdType cellId, vtkIdList* cellPtIds);
   void IntegrateGeneral1DCell(vtkDataSet* input,
-                              vtkUnstructuredGrid* output,
+                              vtkAccumulator& sums,
                               vtkIdType cellId,
                               vtkIdList* cellPtIds);
   void IntegrateGeneral2DCell(vtkDataSet* input,
-                              vtkUnstructuredGrid* output,
+                              vtkAccumulator& sums,
                               vtkIdType cellId,
                               vtkIdList* cellPtIds);
   void IntegrateGeneral3DCell(vtkDataSet* input,
-                              vtkUnstructuredGrid* output,
+                              vtkAccumulator& sums,
                               vtkIdType cellId,
                               vtkIdList* cellPtIds);
-  void IntegrateSatelliteData(vtkDataSetAttributes* inda,
-                              vtkDataSetAttributes* outda);
-  void ZeroAttributes(vtkDataSetAttributes* outda);
-  int PieceNodeMinToNode0 (vtkUnstructuredGrid *data);
-  void SendPiece(vtkUnstructuredGrid *src);
-  void ReceivePiece (vtkUnstructuredGrid *mergeTo, int fromId);
+  void IntegrateCells(vtkDataSet* input, vtkAccumulator& sums,
+                      vtkIdType firstCellId, vtkIdType lastCellId,
+                      vtkIdList* cellPtIds, vtkGenericCell* cell,
+                      vtkPoints* cellPoints);
+
+  // Description:
+  // Sums the results of all processes. The attributes of output are replaced
+  // by the ones of the first process that has attributes, and the processes
+  // only contribute the arrays with the same name and number of components.
+  void AllReduceSums(vtkAccumulator& sums, vtkUnstructuredGrid* output);
 
 private:
   vtkIntegrateAttributes(const vtkIntegrateAttributes&);  // Not implemented.
   void operator=(const vtkIntegrateAttributes&);  // Not implemented.
 
   class vtkFieldList;
+  class vtkIntegrateChunks;
+  friend class vtkIntegrateChunks;
   vtkFieldList* CellFieldList;
   vtkFieldList* PointFieldList;
   int FieldListIndex;
 
   void AllocateAttributes(
     vtkFieldList& fieldList, vtkDataSetAttributes* outda);
-  void ExecuteBlock(vtkDataSet* input, vtkUnstructuredGrid* output,
+  void ExecuteBlock(vtkDataSet* input, vtkAccumulator& sums,
     int fieldset_index, vtkFieldList& pdList, vtkFieldList& cdList);
 
   void IntegrateData1(vtkDataSetAttributes* inda,
-                      vtkDataSetAttributes* outda,
+                      vtkCompensatedSum* outValues,
                       vtkIdType pt1Id, double k,
                       vtkFieldList& fieldlist,
                       int fieldlist_index);
   void IntegrateData2(vtkDataSetAttributes* inda,
-                      vtkDataSetAttributes* outda,
+                      vtkCompensatedSum* outValues,
                       vtkIdType pt1Id, vtkIdType pt2Id, double k,
                       vtkFieldList& fieldlist,
                       int fieldlist_index);
   void IntegrateData3(vtkDataSetAttributes* inda,
-                      vtkDataSetAttributes* outda, vtkIdType pt1Id,
+                      vtkCompensatedSum* outValues, vtkIdType pt1Id,
                       vtkIdType pt2Id, vtkIdType pt3Id, double k,
                       vtkFieldList& fieldlist,
                       int fieldlist_index);
   void IntegrateData4(vtkDataSetAttributes* inda,
-                      vtkDataSetAttributes* outda, vtkIdType pt1Id,
+                      vtkCompensatedSum* outValues, vtkIdType pt1Id,
                       vtkIdType pt2Id, vtkIdType pt3Id, vtkIdType pt4Id,
                       double k,
                       vtkFieldList& fieldlist,
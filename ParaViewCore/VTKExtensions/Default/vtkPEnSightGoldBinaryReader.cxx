@@ -16,7 +16,124 @@
 
 #include <sys/stat.h>
 #include <ctype.h>
+#include <stdio.h>
 #include <string>
+#include <streambuf>
+
+#if !defined(_WIN32)
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <unistd.h>
+# define VTK_PENSIGHT_USE_MMAP
+#endif
+
+namespace
+{
+  // Stream buffer over a file mapped in memory. Seeking only moves the read
+  // pointer and reading copies from the mapping, the pages being brought in
+  // by the kernel as they are accessed.
+  class vtkPEnSightGoldBinaryReaderMappedBuffer : public std::streambuf
+  {
+  public:
+    vtkPEnSightGoldBinaryReaderMappedBuffer() : Data(NULL), Size(0) {}
+    ~vtkPEnSightGoldBinaryReaderMappedBuffer()
+    {
+#ifdef VTK_PENSIGHT_USE_MMAP
+      if (this->Data)
+        {
+        munmap(this->Data, this->Size);
+        }
+#endif
+    }
+
+    bool Map(const char* filename)
+    {
+#ifdef VTK_PENSIGHT_USE_MMAP
+      int fd = open(filename, O_RDONLY);
+      if (fd < 0)
+        {
+        return false;
+        }
+      struct stat fs;
+      if (fstat(fd, &fs) != 0 || fs.st_size <= 0)
+        {
+        close(fd);
+        return false;
+        }
+      void* data = mmap(NULL, static_cast<size_t>(fs.st_size), PROT_READ,
+        MAP_PRIVATE, fd, 0);
+      close(fd);
+      if (data == MAP_FAILED)
+        {
+        return false;
+        }
+# ifdef MADV_SEQUENTIAL
+      // Parts are read front to back: let the kernel read ahead large blocks.
+      madvise(data, static_cast<size_t>(fs.st_size), MADV_SEQUENTIAL);
+# endif
+      this->Data = static_cast<char*>(data);
+      this->Size = static_cast<size_t>(fs.st_size);
+      this->setg(this->Data, this->Data, this->Data + this->Size);
+      return true;
+#else
+      (void)filename;
+      return false;
+#endif
+    }
+
+  protected:
+    virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+      std::ios_base::openmode which = std::ios_base::in)
+    {
+      if ((which & std::ios_base::in) == 0 || this->Data == NULL)
+        {
+        return pos_type(off_type(-1));
+        }
+      off_type pos = off;
+      if (dir == std::ios_base::cur)
+        {
+        pos += this->gptr() - this->eback();
+        }
+      else if (dir == std::ios_base::end)
+        {
+        pos += static_cast<off_type>(this->Size);
+        }
+      if (pos < 0 || pos > static_cast<off_type>(this->Size))
+        {
+        return pos_type(off_type(-1));
+        }
+      this->setg(this->Data, this->Data + pos, this->Data + this->Size);
+      return pos_type(pos);
+    }
+
+    virtual pos_type seekpos(pos_type pos,
+      std::ios_base::openmode which = std::ios_base::in)
+    {
+      return this->seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+
+  private:
+    char* Data;
+    size_t Size;
+  };
+
+  // Input stream reading a file mapped in memory.
+  class vtkPEnSightGoldBinaryReaderMappedStream : public istream
+  {
+  public:
+    vtkPEnSightGoldBinaryReaderMappedStream() : istream(NULL)
+    {
+      this->rdbuf(&this->Buffer);
+    }
+    bool Open(const char* filename)
+    {
+      return this->Buffer.Map(filename);
+    }
+
+  private:
+    vtkPEnSightGoldBinaryReaderMappedBuffer Buffer;
+  };
+}
 
 vtkStandardNewMacro(vtkPEnSightGoldBinaryReader);
 
@@ -49,7 +166,6 @@ vtkPEnSightGoldBinaryReader::~vtkPEnSightGoldBinaryReader()
 {
   if (this->IFile)
     {
-    this->IFile->close();
     delete this->IFile;
     this->IFile = NULL;
     }
@@ -71,7 +187,6 @@ int vtkPEnSightGoldBinaryReader::OpenFile(const char* filename)
   // Close file from any previous image
   if (this->IFile)
     {
-    this->IFile->close();
     delete this->IFile;
     this->IFile = NULL;
     }
@@ -84,11 +199,29 @@ int vtkPEnSightGoldBinaryReader::OpenFile(const char* filename)
     // Find out how big the file is.
     this->FileSize = (long)(fs.st_size);
 
+    if (this->UseMemoryMapping)
+      {
+      vtkPEnSightGoldBinaryReaderMappedStream* mapped =
+        new vtkPEnSightGoldBinaryReaderMappedStream;
+      if (mapped->Open(filename))
+        {
+        this->IFile = mapped;
+        }
+      else
+        {
+        vtkDebugMacro("Could not map " << filename << ", reading it instead.");
+        delete mapped;
+        }
+      }
+    if (!this->IFile)
+      {
 #ifdef _WIN32
-    this->IFile = new ifstream(filename, ios::in | ios::binary);
+      this->IFile = new ifstream(filename, ios::in | ios::binary);
 #else
-    this->IFile = new ifstream(filename, ios::in);
+      this->IFile = new ifstream(filename, ios::in);
 #endif
+      }
+    this->OpenedFileName = filename;
     }
   else
     {
@@ -168,6 +301,132 @@ int vtkPEnSightGoldBinaryReader::OpenFile(const char* filename)
 }
 
 
+//----------------------------------------------------------------------------
+int vtkPEnSightGoldBinaryReader::RequestData(
+  vtkInformation* request, vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  int ret = this->Superclass::RequestData(request, inputVector, outputVector);
+  this->SaveFileOffsets();
+  return ret;
+}
+
+//----------------------------------------------------------------------------
+void vtkPEnSightGoldBinaryReader::LoadFileOffsets(const char* fileName)
+{
+  if (!this->UseOffsetIndexFiles ||
+    this->IndexedFiles.find(fileName) != this->IndexedFiles.end())
+    {
+    return;
+    }
+  this->IndexedFiles[fileName] = this->OpenedFileName;
+
+  struct stat fs;
+  if (stat(this->OpenedFileName.c_str(), &fs) != 0)
+    {
+    return;
+    }
+  std::string indexName = this->OpenedFileName + ".pvidx";
+  ifstream index(indexName.c_str(), ios::in);
+  if (!index)
+    {
+    return;
+    }
+
+  std::string magic;
+  int version = 0;
+  long size = -1, mtime = -1;
+  index >> magic >> version >> size >> mtime;
+  if (!index || magic != "vtkPEnSightGoldBinaryReaderIndex" || version != 1 ||
+    size != static_cast<long>(fs.st_size) ||
+    mtime != static_cast<long>(fs.st_mtime))
+    {
+    vtkDebugMacro("Ignoring out of date index file " << indexName.c_str());
+    return;
+    }
+
+  std::map<int, long>& offsets = this->FileOffsets[fileName];
+  int timeStep;
+  long offset;
+  while (index >> timeStep >> offset)
+    {
+    if (offset >= 0 && offset < size)
+      {
+      offsets.insert(std::pair<int, long>(timeStep, offset));
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPEnSightGoldBinaryReader::SetFileOffset(const char* fileName,
+                                                int timeStep)
+{
+  this->FileOffsets[fileName][timeStep] = this->IFile->tellg();
+  if (this->UseOffsetIndexFiles)
+    {
+    this->ModifiedFileOffsets.insert(fileName);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPEnSightGoldBinaryReader::SaveFileOffsets()
+{
+  if (this->ModifiedFileOffsets.empty())
+    {
+    return;
+    }
+  // All the processes find the same offsets.
+  if (this->GetMultiProcessLocalProcessId() > 0)
+    {
+    this->ModifiedFileOffsets.clear();
+    return;
+    }
+
+  std::set<std::string>::iterator iter;
+  for (iter = this->ModifiedFileOffsets.begin();
+    iter != this->ModifiedFileOffsets.end(); ++iter)
+    {
+    std::map<std::string, std::string>::iterator path =
+      this->IndexedFiles.find(*iter);
+    struct stat fs;
+    if (path == this->IndexedFiles.end() ||
+      stat(path->second.c_str(), &fs) != 0)
+      {
+      continue;
+      }
+
+    // Write to a temporary file first so that other processes never read a
+    // partially written index.
+    std::string indexName = path->second + ".pvidx";
+    std::string tmpName = indexName + ".tmp";
+    ofstream index(tmpName.c_str(), ios::out);
+    if (!index)
+      {
+      vtkDebugMacro("Cannot write index file " << indexName.c_str());
+      continue;
+      }
+    index << "vtkPEnSightGoldBinaryReaderIndex 1\n"
+          << static_cast<long>(fs.st_size) << " "
+          << static_cast<long>(fs.st_mtime) << "\n";
+    std::map<int, long>& offsets = this->FileOffsets[*iter];
+    std::map<int, long>::iterator offset;
+    for (offset = offsets.begin(); offset != offsets.end(); ++offset)
+      {
+      index << offset->first << " " << offset->second << "\n";
+      }
+    index.close();
+    if (index.fail() ||
+      (rename(tmpName.c_str(), indexName.c_str()) != 0 &&
+       (remove(indexName.c_str()) != 0 ||
+        rename(tmpName.c_str(), indexName.c_str()) != 0)))
+      {
+      vtkDebugMacro("Cannot write index file " << indexName.c_str());
+      remove(tmpName.c_str());
+      }
+    }
+  this->ModifiedFileOffsets.clear();
+}
+
 //----------------------------------------------------------------------------
 int vtkPEnSightGoldBinaryReader::InitializeFile(const char* fileName)
 {
@@ -254,6 +513,7 @@ int vtkPEnSightGoldBinaryReader::ReadGeometryFile(const char* fileName, int time
     {
     int realTimeStep = timeStep - 1;
     int j = 0;
+    this->LoadFileOffsets(fileName);
     // Try to find the nearest time step for which we know the offset
     for (i = realTimeStep; i >= 0; i--)
       {
@@ -276,12 +536,7 @@ int vtkPEnSightGoldBinaryReader::ReadGeometryFile(const char* fileName, int time
         }
       else
         {
-        if (this->FileOffsets.find(fileName) == this->FileOffsets.end())
-          {
-          std::map<int, long> tsMap;
-          this->FileOffsets[fileName] = tsMap;
-          }
-        this->FileOffsets[fileName][j] = this->IFile->tellg();
+        this->SetFileOffset(fileName, j);
         }
       }
 
@@ -401,7 +656,6 @@ int vtkPEnSightGoldBinaryReader::ReadGeometryFile(const char* fileName, int time
         free(name);
         if (this->IFile)
           {
-          this->IFile->close();
           delete this->IFile;
           this->IFile = NULL;
           }
@@ -413,7 +667,6 @@ int vtkPEnSightGoldBinaryReader::ReadGeometryFile(const char* fileName, int time
 
   if (this->IFile)
     {
-    this->IFile->close();
     delete this->IFile;
     this->IFile = NULL;
     }
@@ -548,7 +801,6 @@ int vtkPEnSightGoldBinaryReader::SkipTimeStep()
     {
     if (this->IFile)
       {
-      this->IFile->close();
       delete this->IFile;
       this->IFile = NULL;
       }
@@ -1181,6 +1433,7 @@ int vtkPEnSightGoldBinaryReader::ReadMeasuredGeometryFile(const char* fileName,
     {
     int realTimeStep = timeStep - 1;
     int k, j = 0;
+    this->LoadFileOffsets(fileName);
     // Try to find the nearest time step for which we know the offset
     for (k = realTimeStep; k >= 0; k--)
       {
@@ -1220,12 +1473,7 @@ int vtkPEnSightGoldBinaryReader::ReadMeasuredGeometryFile(const char* fileName,
                          (sizeof(float)*3 + sizeof(int))*this->NumberOfMeasuredPoints,
                          ios::cur);
       this->ReadLine(line); // END TIME STEP
-      if (this->FileOffsets.find(fileName) == this->FileOffsets.end())
-        {
-        std::map<int, long> tsMap;
-        this->FileOffsets[fileName] = tsMap;
-        }
-      this->FileOffsets[fileName][j] = this->IFile->tellg();
+      this->SetFileOffset(fileName, j);
       }
     while (strncmp(line, "BEGIN TIME STEP", 15) != 0)
       {
@@ -1321,7 +1569,6 @@ int vtkPEnSightGoldBinaryReader::ReadMeasuredGeometryFile(const char* fileName,
 
   if (this->IFile)
     {
-    this->IFile->close();
     delete this->IFile;
     this->IFile = NULL;
     }
@@ -1372,6 +1619,7 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerNode(
   if (this->UseFileSets)
     {
     int realTimeStep = timeStep - 1;
+    this->LoadFileOffsets(fileName);
     // Try to find the nearest time step for which we know the offset
     int j = 0;
     for (i = realTimeStep; i >= 0; i--)
@@ -1426,12 +1674,7 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerNode(
           this->IFile->seekg(sizeof(float)*numPts, ios::cur);
           }
         }
-      if (this->FileOffsets.find(fileName) == this->FileOffsets.end())
-        {
-        std::map<int, long> tsMap;
-        this->FileOffsets[fileName] = tsMap;
-        }
-      this->FileOffsets[fileName][j] = this->IFile->tellg();
+      this->SetFileOffset(fileName, j);
       }
 
     this->ReadLine(line);
@@ -1479,7 +1722,6 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerNode(
       }
     if (this->IFile)
       {
-      this->IFile->close();
       delete this->IFile;
       this->IFile = NULL;
       }
@@ -1546,7 +1788,6 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerNode(
 
   if (this->IFile)
     {
-    this->IFile->close();
     delete this->IFile;
     this->IFile = NULL;
     }
@@ -1598,6 +1839,7 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerNode(
   if (this->UseFileSets)
     {
     int realTimeStep = timeStep - 1;
+    this->LoadFileOffsets(fileName);
     // Try to find the nearest time step for which we know the offset
     int j = 0;
     for (i = realTimeStep; i >= 0; i--)
@@ -1652,12 +1894,7 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerNode(
           this->IFile->seekg(sizeof(float)*3*numPts, ios::cur);
           }
         }
-      if (this->FileOffsets.find(fileName) == this->FileOffsets.end())
-        {
-        std::map<int, long> tsMap;
-        this->FileOffsets[fileName] = tsMap;
-        }
-      this->FileOffsets[fileName][j] = this->IFile->tellg();
+      this->SetFileOffset(fileName, j);
       }
 
     this->ReadLine(line);
@@ -1705,7 +1942,6 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerNode(
       }
     if (this->IFile)
       {
-      this->IFile->close();
       delete this->IFile;
       this->IFile = NULL;
       }
@@ -1762,7 +1998,6 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerNode(
 
   if (this->IFile)
     {
-    this->IFile->close();
     delete this->IFile;
     this->IFile = NULL;
     }
@@ -1815,6 +2050,7 @@ int vtkPEnSightGoldBinaryReader::ReadTensorsPerNode(
     {
     int realTimeStep = timeStep - 1;
     int j = 0;
+    this->LoadFileOffsets(fileName);
     // Try to find the nearest time step for which we know the offset
     for (i = realTimeStep; i >= 0; i--)
       {
@@ -1853,12 +2089,7 @@ int vtkPEnSightGoldBinaryReader::ReadTensorsPerNode(
           this->IFile->seekg(sizeof(float)*6*numPts, ios::cur);
           }
         }
-      if (this->FileOffsets.find(fileName) == this->FileOffsets.end())
-        {
-        std::map<int, long> tsMap;
-        this->FileOffsets[fileName] = tsMap;
-        }
-      this->FileOffsets[fileName][j] = this->IFile->tellg();
+      this->SetFileOffset(fileName, j);
       }
     this->ReadLine(line);
     while (strncmp(line, "BEGIN TIME STEP", 15) != 0)
@@ -1927,7 +2158,6 @@ int vtkPEnSightGoldBinaryReader::ReadTensorsPerNode(
 
   if (this->IFile)
     {
-    this->IFile->close();
     delete this->IFile;
     this->IFile = NULL;
     }
@@ -1981,6 +2211,7 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerElement(
   if (this->UseFileSets)
     {
     int realTimeStep = timeStep - 1;
+    this->LoadFileOffsets(fileName);
     // Try to find the nearest time step for which we know the offset
     int j = 0;
     for (i = realTimeStep; i >= 0; i--)
@@ -2037,7 +2268,6 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerElement(
                 vtkErrorMacro("Unknown element type \"" << line << "\"");
                 if (this->IFile)
                   {
-                  this->IFile->close();
                   delete this->IFile;
                   this->IFile = NULL;
                   }
@@ -2055,12 +2285,7 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerElement(
           lineRead = this->ReadLine(line);
           }
         } // end while
-      if (this->FileOffsets.find(fileName) == this->FileOffsets.end())
-        {
-        std::map<int, long> tsMap;
-        this->FileOffsets[fileName] = tsMap;
-        }
-      this->FileOffsets[fileName][j] = this->IFile->tellg();
+      this->SetFileOffset(fileName, j);
       } // end for
     this->ReadLine(line);
     while (strncmp(line, "BEGIN TIME STEP", 15) != 0)
@@ -2124,7 +2349,6 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerElement(
             vtkErrorMacro("Unknown element type \"" << line << "\"");
             if (this->IFile)
               {
-              this->IFile->close();
               delete this->IFile;
               this->IFile = NULL;
               }
@@ -2185,7 +2409,6 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerElement(
 
   if (this->IFile)
     {
-    this->IFile->close();
     delete this->IFile;
     this->IFile = NULL;
     }
@@ -2238,6 +2461,7 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerElement(
   if (this->UseFileSets)
     {
     int realTimeStep = timeStep - 1;
+    this->LoadFileOffsets(fileName);
     // Try to find the nearest time step for which we know the offset
     int j = 0;
     for (i = realTimeStep; i >= 0; i--)
@@ -2309,12 +2533,7 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerElement(
           lineRead = this->ReadLine(line);
           }
         }
-      if (this->FileOffsets.find(fileName) == this->FileOffsets.end())
-        {
-        std::map<int, long> tsMap;
-        this->FileOffsets[fileName] = tsMap;
-        }
-      this->FileOffsets[fileName][j] = this->IFile->tellg();
+      this->SetFileOffset(fileName, j);
       }
     this->ReadLine(line);
     while (strncmp(line, "BEGIN TIME STEP", 15) != 0)
@@ -2437,7 +2656,6 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerElement(
 
   if (this->IFile)
     {
-    this->IFile->close();
     delete this->IFile;
     this->IFile = NULL;
     }
@@ -2490,6 +2708,7 @@ int vtkPEnSightGoldBinaryReader::ReadTensorsPerElement(
   if (this->UseFileSets)
     {
     int realTimeStep = timeStep - 1;
+    this->LoadFileOffsets(fileName);
     // Try to find the nearest time step for which we know the offset
     int j = 0;
     for (i = realTimeStep; i >= 0; i--)
@@ -2562,12 +2781,7 @@ int vtkPEnSightGoldBinaryReader::ReadTensorsPerElement(
           lineRead = this->ReadLine(line);
           }
         }
-      if (this->FileOffsets.find(fileName) == this->FileOffsets.end())
-        {
-        std::map<int, long> tsMap;
-        this->FileOffsets[fileName] = tsMap;
-        }
-      this->FileOffsets[fileName][j] = this->IFile->tellg();
+      this->SetFileOffset(fileName, j);
       }
     this->ReadLine(line);
     while (strncmp(line, "BEGIN TIME STEP", 15) != 0)
@@ -2711,7 +2925,6 @@ int vtkPEnSightGoldBinaryReader::ReadTensorsPerElement(
 
   if (this->IFile)
     {
-    this->IFile->close();
     delete this->IFile;
     this->IFile = NULL;
     }
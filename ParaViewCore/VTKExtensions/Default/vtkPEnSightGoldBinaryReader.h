@@ -15,6 +15,13 @@
 // .NAME vtkPEnSightGoldBinaryReader
 // .SECTION Description
 // Parallel vtkEnSightGoldBinaryReader.
+//
+// Files are memory mapped when possible (see UseMemoryMapping) so that the
+// numerous seeks done to skip over the parts and the pieces assigned to other
+// processes don't result in any I/O. When files contain several time steps,
+// the offsets of the time steps found are kept and can be saved in an index
+// file next to each data file (see UseOffsetIndexFiles) to be reused by later
+// sessions. These options are set on vtkPGenericEnSightReader.
 // .SECTION Thanks
 // <verbatim>
 //
@@ -35,6 +42,9 @@
 #include "vtkPVVTKExtensionsDefaultModule.h" //needed for exports
 #include "vtkPEnSightReader.h"
 
+#include <set> // for std::set
+#include <string> // for std::string
+
 class vtkMultiBlockDataSet;
 class vtkUnstructuredGrid;
 class vtkPoints;
@@ -50,9 +60,27 @@ class VTKPVVTKEXTENSIONSDEFAULT_EXPORT vtkPEnSightGoldBinaryReader : public vtkP
   vtkPEnSightGoldBinaryReader();
   ~vtkPEnSightGoldBinaryReader();
 
+  virtual int RequestData(vtkInformation*,
+                          vtkInformationVector**,
+                          vtkInformationVector*);
+
   // Returns 1 if successful.  Sets file size as a side action.
   int OpenFile(const char* filename);
 
+  // Description:
+  // Load the time step offsets of the file last opened from its index file,
+  // if any, unless they have already been loaded.
+  void LoadFileOffsets(const char* fileName);
+
+  // Description:
+  // Record the current position in the file as the offset of the given time
+  // step.
+  void SetFileOffset(const char* fileName, int timeStep);
+
+  // Description:
+  // Write the index files of the files for which new offsets were found.
+  void SaveFileOffsets();
+
 
   // Returns 1 if successful.  Handles constructing the filename, opening the file and checking
   // if it's binary
@@ -190,9 +218,18 @@ class VTKPVVTKEXTENSIONSDEFAULT_EXPORT vtkPEnSightGoldBinaryReader : public vtkP
   int ElementIdsListed;
   int Fortran;
 
-  ifstream *IFile;
+  istream *IFile;
   // The size of the file could be used to choose byte order.
   long FileSize;
+  // Full path of the file last opened.
+  std::string OpenedFileName;
+
+//BTX
+  // Full paths of the files whose offsets have been loaded, and names of the
+  // files whose index needs to be written.
+  std::map<std::string, std::string> IndexedFiles;
+  std::set<std::string> ModifiedFileOffsets;
+//ETX
 
   // Float Vector Buffer utils
   void GetVectorFromFloatBuffer(int i, float *vector);
@@ -14,17 +14,364 @@
 =========================================================================*/
 #include "vtkPEquivalenceSet.h"
 #include "vtkObjectFactory.h"
+#include "vtkBitArray.h"
 #include "vtkIntArray.h"
 #include "vtkMultiProcessController.h"
 
+#include "vtkPVConfig.h"
+#ifdef PARAVIEW_USE_MPI
+#include "vtkMPIController.h"
+#endif
+
+#include <vector>
+
+namespace
+{
+// Union-find over the global ids [0, NumberOfIds) where each process owns
+// the parents of a contiguous block of ids. Parents always point to smaller
+// ids, hence the root of a set is its smallest member.
+class vtkDistributedUnionFind
+{
+public:
+  typedef std::vector<std::vector<int> > MessagesType;
+
+  vtkDistributedUnionFind (vtkMultiProcessController* controller, int numIds)
+    {
+    this->Controller = controller;
+    this->MyProc = controller->GetLocalProcessId ();
+    this->NumProcs = controller->GetNumberOfProcesses ();
+    this->BlockSize = (numIds + this->NumProcs - 1) / this->NumProcs;
+    if (this->BlockSize < 1)
+      {
+      this->BlockSize = 1;
+      }
+    this->First = this->MyProc * this->BlockSize;
+    int last = this->First + this->BlockSize;
+    last = last < numIds ? last : numIds;
+    int numOwned = last > this->First ? last - this->First : 0;
+    this->Parents.resize (numOwned);
+    for (int i = 0; i < numOwned; i ++)
+      {
+      this->Parents[i] = this->First + i;
+      }
+    }
+
+  int GetOwner (int id)
+    {
+    return id / this->BlockSize;
+    }
+
+  // Sends messages[p] to process p and returns what each process sent in
+  // received. With MPI, only the non-empty messages are sent, without
+  // blocking. The number of messages each process receives is summed over
+  // all processes first, unless the caller knows it (numIncoming >= 0).
+  // Otherwise, processes are paired by xor-ing their ranks so that the
+  // blocking sends cannot deadlock. Consecutive exchanges that are not
+  // separated by a collective must use different tags.
+  void Exchange (MessagesType& messages, MessagesType& received, int tag,
+    int numIncoming = -1)
+    {
+    received.assign (this->NumProcs, std::vector<int> ());
+    received[this->MyProc].swap (messages[this->MyProc]);
+#ifdef PARAVIEW_USE_MPI
+    vtkMPIController* mpiController =
+      vtkMPIController::SafeDownCast (this->Controller);
+    if (mpiController)
+      {
+      std::vector<int> sending (this->NumProcs, 0);
+      for (int p = 0; p < this->NumProcs; p ++)
+        {
+        sending[p] = (p != this->MyProc && !messages[p].empty ()) ? 1 : 0;
+        }
+      if (numIncoming < 0)
+        {
+        std::vector<int> incoming (this->NumProcs, 0);
+        this->Controller->AllReduce (&sending[0], &incoming[0],
+          this->NumProcs, vtkCommunicator::SUM_OP);
+        numIncoming = incoming[this->MyProc];
+        }
+
+      // Each message is preceded by the sender and its size, so that the
+      // messages can be received in any order.
+      std::vector<int> headers (2 * this->NumProcs);
+      std::vector<vtkMPICommunicator::Request> requests (2 * this->NumProcs);
+      int numRequests = 0;
+      for (int p = 0; p < this->NumProcs; p ++)
+        {
+        if (sending[p])
+          {
+          int size = static_cast<int> (messages[p].size ());
+          headers[2 * p] = this->MyProc;
+          headers[2 * p + 1] = size;
+          mpiController->NoBlockSend (&headers[2 * p], 2, p, tag,
+            requests[numRequests ++]);
+          mpiController->NoBlockSend (&messages[p][0], size, p, tag + 1,
+            requests[numRequests ++]);
+          }
+        }
+      for (int i = 0; i < numIncoming; i ++)
+        {
+        int header[2];
+        mpiController->Receive (header, 2,
+          vtkMultiProcessController::ANY_SOURCE, tag);
+        std::vector<int>& message = received[header[0]];
+        message.resize (header[1]);
+        mpiController->Receive (&message[0], header[1], header[0], tag + 1);
+        }
+      for (int i = 0; i < numRequests; i ++)
+        {
+        requests[i].Wait ();
+        }
+      return;
+      }
+#endif
+    (void)numIncoming;
+    int pow2 = 1;
+    while (pow2 < this->NumProcs)
+      {
+      pow2 *= 2;
+      }
+    for (int k = 1; k < pow2; k ++)
+      {
+      int other = this->MyProc ^ k;
+      if (other >= this->NumProcs)
+        {
+        continue;
+        }
+      if (this->MyProc < other)
+        {
+        this->Send (messages[other], other, tag);
+        this->Receive (received[other], other, tag);
+        }
+      else
+        {
+        this->Receive (received[other], other, tag);
+        this->Send (messages[other], other, tag);
+        }
+      }
+    }
+
+  // Looks up table[id] on the owner of each id. table is indexed by the ids
+  // owned by the process, offset by First.
+  void Lookup (const std::vector<int>& ids, const std::vector<int>& table,
+    std::vector<int>& values)
+    {
+    MessagesType requests (this->NumProcs);
+    for (size_t i = 0; i < ids.size (); i ++)
+      {
+      requests[this->GetOwner (ids[i])].push_back (ids[i]);
+      }
+    // A reply comes back from each process a request was sent to.
+    int numReplies = 0;
+    for (int p = 0; p < this->NumProcs; p ++)
+      {
+      numReplies += (p != this->MyProc && !requests[p].empty ()) ? 1 : 0;
+      }
+    MessagesType received;
+    this->Exchange (requests, received, 475893745);
+    for (int p = 0; p < this->NumProcs; p ++)
+      {
+      std::vector<int>& message = received[p];
+      for (size_t i = 0; i < message.size (); i ++)
+        {
+        message[i] = table[message[i] - this->First];
+        }
+      }
+    MessagesType replies;
+    this->Exchange (received, replies, 475893747, numReplies);
+
+    // Replies come back in the order of the requests.
+    std::vector<size_t> next (this->NumProcs, 0);
+    values.resize (ids.size ());
+    for (size_t i = 0; i < ids.size (); i ++)
+      {
+      int owner = this->GetOwner (ids[i]);
+      values[i] = replies[owner][next[owner] ++];
+      }
+    }
+
+  // Makes every owned id point directly to the root of its set.
+  void CompressPaths ()
+    {
+    int changed = 1;
+    while (changed)
+      {
+      std::vector<int> ids;
+      std::vector<int> positions;
+      for (size_t i = 0; i < this->Parents.size (); i ++)
+        {
+        if (this->Parents[i] != this->First + static_cast<int> (i))
+          {
+          ids.push_back (this->Parents[i]);
+          positions.push_back (static_cast<int> (i));
+          }
+        }
+      std::vector<int> grandParents;
+      this->Lookup (ids, this->Parents, grandParents);
+      int localChanged = 0;
+      for (size_t i = 0; i < ids.size (); i ++)
+        {
+        if (grandParents[i] != ids[i])
+          {
+          this->Parents[positions[i]] = grandParents[i];
+          localChanged = 1;
+          }
+        }
+      this->Controller->AllReduce (&localChanged, &changed, 1,
+        vtkCommunicator::MAX_OP);
+      }
+    }
+
+  // Merges the sets of both ids of each pair.
+  void Union (std::vector<int>& pairs)
+    {
+    for (;;)
+      {
+      int localPairs = static_cast<int> (pairs.size () / 2);
+      int globalPairs = 0;
+      this->Controller->AllReduce (&localPairs, &globalPairs, 1,
+        vtkCommunicator::SUM_OP);
+      if (globalPairs == 0)
+        {
+        break;
+        }
+
+      this->CompressPaths ();
+      std::vector<int> roots;
+      this->Lookup (pairs, this->Parents, roots);
+
+      // Hook the larger root under the smaller one, on the owner of the
+      // larger root.
+      MessagesType hooks (this->NumProcs);
+      for (size_t i = 0; i < roots.size (); i += 2)
+        {
+        int low = roots[i] < roots[i + 1] ? roots[i] : roots[i + 1];
+        int high = roots[i] < roots[i + 1] ? roots[i + 1] : roots[i];
+        if (low != high)
+          {
+          std::vector<int>& hook = hooks[this->GetOwner (high)];
+          hook.push_back (high);
+          hook.push_back (low);
+          }
+        }
+      MessagesType received;
+      this->Exchange (hooks, received, 475893749);
+
+      // A root hooked under several sets keeps one of them as its parent,
+      // the others are left as pairs to merge in the next round.
+      pairs.clear ();
+      for (int p = 0; p < this->NumProcs; p ++)
+        {
+        const std::vector<int>& message = received[p];
+        for (size_t i = 0; i < message.size (); i += 2)
+          {
+          int& parent = this->Parents[message[i] - this->First];
+          int low = message[i + 1];
+          if (parent == message[i])
+            {
+            parent = low;
+            }
+          else if (parent != low)
+            {
+            pairs.push_back (parent < low ? parent : low);
+            pairs.push_back (parent < low ? low : parent);
+            parent = parent < low ? parent : low;
+            }
+          }
+        }
+      }
+    this->CompressPaths ();
+    }
+
+  // Numbers the sets sequentially in the order of their roots and replaces
+  // the parent of each owned id by the number of its set. Returns the number
+  // of sets.
+  int NumberSets ()
+    {
+    int numRoots = 0;
+    for (size_t i = 0; i < this->Parents.size (); i ++)
+      {
+      if (this->Parents[i] == this->First + static_cast<int> (i))
+        {
+        numRoots ++;
+        }
+      }
+    std::vector<int> rootCounts (this->NumProcs, 0);
+    this->Controller->AllGather (&numRoots, &rootCounts[0], 1);
+    int setId = 0;
+    int numSets = 0;
+    for (int p = 0; p < this->NumProcs; p ++)
+      {
+      setId += p < this->MyProc ? rootCounts[p] : 0;
+      numSets += rootCounts[p];
+      }
+
+    std::vector<int> setIds (this->Parents.size (), -1);
+    std::vector<int> ids;
+    std::vector<int> positions;
+    for (size_t i = 0; i < this->Parents.size (); i ++)
+      {
+      if (this->Parents[i] == this->First + static_cast<int> (i))
+        {
+        setIds[i] = setId ++;
+        }
+      else
+        {
+        ids.push_back (this->Parents[i]);
+        positions.push_back (static_cast<int> (i));
+        }
+      }
+    std::vector<int> rootSetIds;
+    this->Lookup (ids, setIds, rootSetIds);
+    for (size_t i = 0; i < ids.size (); i ++)
+      {
+      setIds[positions[i]] = rootSetIds[i];
+      }
+    this->Parents.swap (setIds);
+    return numSets;
+    }
+
+  vtkMultiProcessController* Controller;
+  int MyProc;
+  int NumProcs;
+  int BlockSize;
+  int First;
+  std::vector<int> Parents;
+
+private:
+  void Send (std::vector<int>& message, int other, int tag)
+    {
+    int size = static_cast<int> (message.size ());
+    this->Controller->Send (&size, 1, other, tag);
+    if (size > 0)
+      {
+      this->Controller->Send (&message[0], size, other, tag + 1);
+      }
+    }
+
+  void Receive (std::vector<int>& message, int other, int tag)
+    {
+    int size = 0;
+    this->Controller->Receive (&size, 1, other, tag);
+    message.resize (size);
+    if (size > 0)
+      {
+      this->Controller->Receive (&message[0], size, other, tag + 1);
+      }
+    }
+};
+}
+
 vtkStandardNewMacro (vtkPEquivalenceSet);
 
 vtkPEquivalenceSet::vtkPEquivalenceSet ()
 {
+  this->ReferencedMembers = vtkBitArray::New ();
 }
 
 vtkPEquivalenceSet::~vtkPEquivalenceSet ()
 {
+  this->ReferencedMembers->Delete ();
 }
 
 void vtkPEquivalenceSet::PrintSelf (ostream& os, vtkIndent indent)
@@ -32,54 +379,99 @@ void vtkPEquivalenceSet::PrintSelf (ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf (os, indent);
 }
 
+void vtkPEquivalenceSet::Initialize ()
+{
+  this->Superclass::Initialize ();
+  this->ReferencedMembers->Initialize ();
+}
+
+void vtkPEquivalenceSet::AddEquivalence (int id1, int id2)
+{
+  this->Superclass::AddEquivalence (id1, id2);
+  if (this->Resolved)
+    {
+    return;
+    }
+  int num = this->ReferencedMembers->GetNumberOfTuples ();
+  while (num <= id1 || num <= id2)
+    {
+    this->ReferencedMembers->InsertNextValue (0);
+    ++num;
+    }
+  this->ReferencedMembers->SetValue (id1, 1);
+  this->ReferencedMembers->SetValue (id2, 1);
+}
+
+void vtkPEquivalenceSet::DeepCopy (vtkEquivalenceSet* in)
+{
+  this->Superclass::DeepCopy (in);
+  vtkPEquivalenceSet* pin = vtkPEquivalenceSet::SafeDownCast (in);
+  if (pin)
+    {
+    this->ReferencedMembers->DeepCopy (pin->ReferencedMembers);
+    }
+  else
+    {
+    // Without more information, all the members are referenced.
+    int numMembers = this->GetNumberOfMembers ();
+    this->ReferencedMembers->SetNumberOfTuples (numMembers);
+    for (int i = 0; i < numMembers; i ++)
+      {
+      this->ReferencedMembers->SetValue (i, 1);
+      }
+    }
+}
+
 int vtkPEquivalenceSet::ResolveEquivalences ()
 {
   vtkMultiProcessController* controller = vtkMultiProcessController::GetGlobalController ();
-  int myProc = controller->GetLocalProcessId ();
-  int numProcs = controller->GetNumberOfProcesses ();
+  if (controller == NULL || controller->GetNumberOfProcesses () < 2)
+    {
+    return this->Superclass::ResolveEquivalences ();
+    }
 
-  vtkIntArray* workingSet = vtkIntArray::New ();
-  workingSet->SetNumberOfComponents (1); 
+  int numMembers = this->EquivalenceArray->GetNumberOfTuples ();
+  int numIds = 0;
+  controller->AllReduce (&numMembers, &numIds, 1, vtkCommunicator::MAX_OP);
+  vtkDistributedUnionFind unionFind (controller, numIds);
 
-  int tag = 475893745;
-  int pivot = (numProcs + 1) / 2;
-  while (pivot > 0 && myProc < (pivot * 2))
+  // Only the members equivalent to a smaller id on this process are sent, as
+  // pairs with the smallest member of their local set.
+  std::vector<int> pairs;
+  for (int i = 0; i < numMembers; i ++)
     {
-    int tuples;
-    if (myProc >= pivot)
+    int ref = this->GetEquivalentSetId (i);
+    if (ref != i)
       {
-      tuples = this->EquivalenceArray->GetNumberOfTuples ();
-      controller->Send (&tuples, 1, myProc - pivot, tag + pivot + 0);
-      controller->Send (this->EquivalenceArray, myProc - pivot, tag + pivot + 1);
+      pairs.push_back (ref);
+      pairs.push_back (i);
       }
-    else if ((myProc + pivot) < numProcs)
-      {
-      controller->Receive (&tuples, 1, myProc + pivot, tag + pivot + 0);
-      workingSet->SetNumberOfTuples (tuples);
+    }
+  unionFind.Union (pairs);
+  this->NumberOfResolvedSets = unionFind.NumberSets ();
 
-      controller->Receive (workingSet, myProc + pivot, tag + pivot + 1);
-      while (workingSet->GetNumberOfTuples () > this->EquivalenceArray->GetNumberOfTuples ())
-        {
-        this->EquivalenceArray->InsertNextTuple1 (0);
-        }
-      for (int i = 0; i < workingSet->GetNumberOfTuples (); i ++)
-        {
-        int workingVal = workingSet->GetValue (i);
-        if (workingVal == 0) {
-          continue;
-        }
-        int existingVal = this->EquivalenceArray->GetValue (i); 
-        this->EquivalenceArray->SetValue (i, workingVal);
-        if (existingVal != 0 && existingVal < workingVal)
-          {
-          this->EquateInternal (existingVal, workingVal);
-          }
-        }
+  // Get the sequential set ids of the members referenced on this process
+  // from their owners, the others are unknown here.
+  std::vector<int> members;
+  int numReferenced = this->ReferencedMembers->GetNumberOfTuples ();
+  for (int i = 0; i < numMembers; i ++)
+    {
+    if (i < numReferenced && this->ReferencedMembers->GetValue (i))
+      {
+      members.push_back (i);
       }
-    pivot /= 2;
     }
-  controller->Broadcast (this->EquivalenceArray, 0);
+  std::vector<int> setIds;
+  unionFind.Lookup (members, unionFind.Parents, setIds);
+  for (int i = 0; i < numMembers; i ++)
+    {
+    this->EquivalenceArray->SetValue (i, -1);
+    }
+  for (size_t i = 0; i < members.size (); i ++)
+    {
+    this->EquivalenceArray->SetValue (members[i], setIds[i]);
+    }
+  this->Resolved = 1;
 
-  this->Superclass::ResolveEquivalences ();
-  return 1;
+  return this->NumberOfResolvedSets;
 }
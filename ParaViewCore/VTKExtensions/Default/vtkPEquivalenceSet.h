@@ -15,6 +15,12 @@
 // .NAME vtkPEquivalenceSet - distributed method of Equivalence
 // .SECTION Description
 // Same as EquivalenceSet, but resolving is a global operation.
+// Equivalences are resolved with a distributed union-find: each process owns
+// the parents of a contiguous range of ids, only the members that are
+// equivalent to another id on a process are sent, and sets are merged in
+// rounds of hooking and path compression. No process holds the equivalences
+// of all ids. After resolving, each process knows the global set ids of the
+// members it passed to AddEquivalence() only, the other members get -1.
 // .SEE vtkEquivalenceSet
 
 #ifndef __vtkPEquivalenceSet_h
@@ -22,6 +28,7 @@
 
 #include "vtkPVVTKExtensionsDefaultModule.h" //needed for exports
 #include "vtkEquivalenceSet.h"
+class vtkBitArray;
 
 class VTKPVVTKEXTENSIONSDEFAULT_EXPORT vtkPEquivalenceSet : public vtkEquivalenceSet
 {
@@ -30,13 +37,22 @@ public:
   void PrintSelf(ostream& os, vtkIndent indent);
   static vtkPEquivalenceSet *New();
 
+  virtual void Initialize();
+  virtual void AddEquivalence(int id1, int id2);
+  virtual void DeepCopy(vtkEquivalenceSet* in);
+
   // Globally equivalent set IDs are reassigned to be sequential.
+  // This must be called on all processes. Returns the global number of sets.
   virtual int ResolveEquivalences ();
 
 protected:
   vtkPEquivalenceSet();
   ~vtkPEquivalenceSet();
 
+  // Members passed to AddEquivalence(), the only ones whose global set ids
+  // are looked up when resolving.
+  vtkBitArray *ReferencedMembers;
+
 private:
   vtkPEquivalenceSet(const vtkPEquivalenceSet&);  // Not implemented.
   void operator=(const vtkPEquivalenceSet&);  // Not implemented.
@@ -29,7 +29,9 @@
 #include "vtkTable.h"
 
 
+#include <algorithm>
 #include <string>
+#include <vector>
 #include <vtksys/RegularExpression.hxx>
 
 vtkStandardNewMacro(vtkPExtractHistogram);
@@ -98,12 +100,37 @@ int vtkPExtractHistogram::RequestData(vtkInformation *request,
     // Nothing to do if there is no data
     return 1;
     }
+  bool isRoot = (this->Controller->GetLocalProcessId() ==0);
+  if (!this->CalculateAverages)
+    {
+    // Only the counts differ between processes, sum them on the root
+    // directly instead of gathering the tables.
+    vtkIntArray* bin_values = vtkIntArray::SafeDownCast(
+      output->GetRowData()->GetArray("bin_values"));
+    std::vector<int> counts(this->BinCount, 0);
+    if (!bin_values ||
+      !this->Controller->Reduce(bin_values->GetPointer(0), &counts[0],
+        this->BinCount, vtkCommunicator::SUM_OP, 0))
+      {
+      vtkErrorMacro("Parallel communication error. Could not reduce bins.");
+      return 0;
+      }
+    if (isRoot)
+      {
+      std::copy(counts.begin(), counts.end(), bin_values->GetPointer(0));
+      }
+    else
+      {
+      output->Initialize();
+      }
+    return 1;
+    }
+
   // Now we need to collect and reduce data from all nodes on the root.
   vtkSmartPointer<vtkReductionFilter> reduceFilter = 
     vtkSmartPointer<vtkReductionFilter>::New();
   reduceFilter->SetController(this->Controller);
 
-  bool isRoot = (this->Controller->GetLocalProcessId() ==0);
   if (isRoot)
     {
     // PostGatherHelper needs to be set only on the root node.
@@ -44,6 +44,8 @@ vtkPGenericEnSightReader::vtkPGenericEnSightReader()
   // -2 is the default starting value
   this->MultiProcessLocalProcessId = -2;
   this->MultiProcessNumberOfProcesses = -2;
+  this->UseMemoryMapping = 1;
+  this->UseOffsetIndexFiles = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -142,6 +144,8 @@ int vtkPGenericEnSightReader::RequestInformation(
   vtkPGenericEnSightReader* reader = dynamic_cast<vtkPGenericEnSightReader*>(this->Reader);
   if ( reader )
     {
+    reader->SetUseMemoryMapping(this->UseMemoryMapping);
+    reader->SetUseOffsetIndexFiles(this->UseOffsetIndexFiles);
     //this dynamic cast never should fail
     reader->RequestInformation(request, inputVector, outputVector);
     }
@@ -205,4 +209,6 @@ void vtkPGenericEnSightReader::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
   os << indent << "MultiProcessLocalProcessId: " << this->MultiProcessLocalProcessId << endl;
   os << indent << "MultiProcessNumberOfProcesses: " << this->MultiProcessNumberOfProcesses << endl;
+  os << indent << "UseMemoryMapping: " << this->UseMemoryMapping << endl;
+  os << indent << "UseOffsetIndexFiles: " << this->UseOffsetIndexFiles << endl;
 }
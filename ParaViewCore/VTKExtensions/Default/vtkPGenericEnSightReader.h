@@ -35,6 +35,24 @@ public:
   vtkTypeMacro(vtkPGenericEnSightReader, vtkGenericEnSightReader);
   void PrintSelf(ostream& os, vtkIndent indent);
 
+  // Description:
+  // When on, EnSight Gold binary files are mapped in memory instead of being
+  // read through a file stream. Files are read through a stream when mapping
+  // is not supported or fails. On by default.
+  vtkSetMacro(UseMemoryMapping, int);
+  vtkGetMacro(UseMemoryMapping, int);
+  vtkBooleanMacro(UseMemoryMapping, int);
+
+  // Description:
+  // When on, the offsets of the time steps of EnSight Gold binary files
+  // containing several time steps are loaded from and saved to an index file
+  // named after the data file with the ".pvidx" extension appended. Index
+  // files are ignored when the size or modification time of the data file
+  // changed. Only the first process writes index files. Off by default.
+  vtkSetMacro(UseOffsetIndexFiles, int);
+  vtkGetMacro(UseOffsetIndexFiles, int);
+  vtkBooleanMacro(UseOffsetIndexFiles, int);
+
 protected:
   vtkPGenericEnSightReader();
   ~vtkPGenericEnSightReader();
@@ -53,6 +71,9 @@ protected:
   int MultiProcessLocalProcessId;
   int MultiProcessNumberOfProcesses;
 
+  int UseMemoryMapping;
+  int UseOffsetIndexFiles;
+
 private:
   vtkPGenericEnSightReader(const vtkPGenericEnSightReader&);  // Not implemented.
   void operator=(const vtkPGenericEnSightReader&);  // Not implemented.
@@ -0,0 +1,284 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVLZDataCompressor.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVLZDataCompressor.h"
+
+#include "vtkObjectFactory.h"
+
+#include <string.h>
+#include <vector>
+
+// The compressed stream is a list of sequences:
+//   token | [literal length bytes] | literals | offset (2 bytes) | [match length bytes]
+// The high nibble of the token is the literal length, the low nibble the
+// match length minus VTK_PV_LZ_MIN_MATCH. A nibble of 15 means the length
+// continues in the following bytes, each byte being added until one is less
+// than 255. The last sequence only has literals and no offset.
+#define VTK_PV_LZ_MIN_MATCH 4
+#define VTK_PV_LZ_HASH_LOG 14
+#define VTK_PV_LZ_MAX_OFFSET 65535
+// Number of bytes at the end of the input that are always emitted as
+// literals, so that the match finder can read 4 bytes without checks.
+#define VTK_PV_LZ_LAST_LITERALS 12
+
+namespace
+{
+  inline unsigned int vtkPVLZRead32(const unsigned char* ptr)
+    {
+    unsigned int value;
+    memcpy(&value, ptr, sizeof(value));
+    return value;
+    }
+
+  inline unsigned int vtkPVLZHash(unsigned int sequence)
+    {
+    return (sequence * 2654435761U) >> (32 - VTK_PV_LZ_HASH_LOG);
+    }
+
+  // Writes a length continuation, returns false on overflow.
+  inline bool vtkPVLZWriteLength(size_t length, unsigned char*& op,
+    const unsigned char* oend)
+    {
+    for (; length >= 255; length -= 255)
+      {
+      if (op >= oend)
+        {
+        return false;
+        }
+      *op++ = 255;
+      }
+    if (op >= oend)
+      {
+      return false;
+      }
+    *op++ = static_cast<unsigned char>(length);
+    return true;
+    }
+
+  // Reads a length continuation, returns false on truncated input.
+  inline bool vtkPVLZReadLength(size_t& length, const unsigned char*& ip,
+    const unsigned char* iend)
+    {
+    unsigned char byte;
+    do
+      {
+      if (ip >= iend)
+        {
+        return false;
+        }
+      byte = *ip++;
+      length += byte;
+      }
+    while (byte == 255);
+    return true;
+    }
+
+  // Emits one sequence. match_length is 0 for the last sequence.
+  inline bool vtkPVLZWriteSequence(const unsigned char* literals,
+    size_t literal_length, size_t offset, size_t match_length,
+    unsigned char*& op, const unsigned char* oend)
+    {
+    if (op >= oend)
+      {
+      return false;
+      }
+    unsigned char* token = op++;
+    *token = static_cast<unsigned char>(
+      (literal_length >= 15? 15 : literal_length) << 4);
+    if (literal_length >= 15 &&
+      !vtkPVLZWriteLength(literal_length - 15, op, oend))
+      {
+      return false;
+      }
+    if (static_cast<size_t>(oend - op) < literal_length)
+      {
+      return false;
+      }
+    memcpy(op, literals, literal_length);
+    op += literal_length;
+
+    if (match_length == 0)
+      {
+      return true;
+      }
+
+    if (oend - op < 2)
+      {
+      return false;
+      }
+    *op++ = static_cast<unsigned char>(offset & 0xff);
+    *op++ = static_cast<unsigned char>((offset >> 8) & 0xff);
+    size_t ml = match_length - VTK_PV_LZ_MIN_MATCH;
+    *token |= static_cast<unsigned char>(ml >= 15? 15 : ml);
+    if (ml >= 15 && !vtkPVLZWriteLength(ml - 15, op, oend))
+      {
+      return false;
+      }
+    return true;
+    }
+}
+
+vtkStandardNewMacro(vtkPVLZDataCompressor);
+//----------------------------------------------------------------------------
+vtkPVLZDataCompressor::vtkPVLZDataCompressor()
+{
+}
+
+//----------------------------------------------------------------------------
+vtkPVLZDataCompressor::~vtkPVLZDataCompressor()
+{
+}
+
+//----------------------------------------------------------------------------
+size_t vtkPVLZDataCompressor::GetMaximumCompressionSpace(size_t size)
+{
+  // Incompressible data is emitted as a single literal run.
+  return size + size / 255 + 16;
+}
+
+//----------------------------------------------------------------------------
+size_t vtkPVLZDataCompressor::CompressBuffer(
+  unsigned char const* uncompressedData, size_t uncompressedSize,
+  unsigned char* compressedData, size_t compressionSpace)
+{
+  const unsigned char* const ibase = uncompressedData;
+  const unsigned char* const iend = ibase + uncompressedSize;
+  const unsigned char* anchor = ibase;
+  unsigned char* op = compressedData;
+  const unsigned char* const oend = compressedData + compressionSpace;
+
+  if (uncompressedSize > VTK_PV_LZ_LAST_LITERALS)
+    {
+    const unsigned char* const mflimit = iend - VTK_PV_LZ_LAST_LITERALS;
+    std::vector<size_t> table(static_cast<size_t>(1) << VTK_PV_LZ_HASH_LOG,
+      static_cast<size_t>(-1));
+
+    const unsigned char* ip = ibase;
+    while (ip < mflimit)
+      {
+      unsigned int sequence = vtkPVLZRead32(ip);
+      unsigned int hash = vtkPVLZHash(sequence);
+      size_t candidate = table[hash];
+      size_t position = static_cast<size_t>(ip - ibase);
+      table[hash] = position;
+
+      if (candidate == static_cast<size_t>(-1) ||
+        position - candidate > VTK_PV_LZ_MAX_OFFSET ||
+        vtkPVLZRead32(ibase + candidate) != sequence)
+        {
+        // Skip faster over data that does not compress.
+        ip += 1 + (static_cast<size_t>(ip - anchor) >> 6);
+        continue;
+        }
+
+      const unsigned char* match = ibase + candidate;
+      size_t length = VTK_PV_LZ_MIN_MATCH;
+      while (ip + length < mflimit && match[length] == ip[length])
+        {
+        ++length;
+        }
+
+      if (!vtkPVLZWriteSequence(anchor, static_cast<size_t>(ip - anchor),
+          position - candidate, length, op, oend))
+        {
+        return 0;
+        }
+      ip += length;
+      anchor = ip;
+      }
+    }
+
+  if (!vtkPVLZWriteSequence(anchor, static_cast<size_t>(iend - anchor), 0, 0,
+      op, oend))
+    {
+    return 0;
+    }
+  return static_cast<size_t>(op - compressedData);
+}
+
+//----------------------------------------------------------------------------
+size_t vtkPVLZDataCompressor::UncompressBuffer(
+  unsigned char const* compressedData, size_t compressedSize,
+  unsigned char* uncompressedData, size_t uncompressedSize)
+{
+  const unsigned char* ip = compressedData;
+  const unsigned char* const iend = compressedData + compressedSize;
+  unsigned char* op = uncompressedData;
+  unsigned char* const obase = uncompressedData;
+  unsigned char* const oend = uncompressedData + uncompressedSize;
+
+  while (ip < iend)
+    {
+    unsigned char token = *ip++;
+    size_t literal_length = token >> 4;
+    if (literal_length == 15 && !vtkPVLZReadLength(literal_length, ip, iend))
+      {
+      vtkErrorMacro("Truncated compressed data.");
+      return 0;
+      }
+    if (static_cast<size_t>(iend - ip) < literal_length ||
+      static_cast<size_t>(oend - op) < literal_length)
+      {
+      vtkErrorMacro("Corrupted compressed data.");
+      return 0;
+      }
+    memcpy(op, ip, literal_length);
+    ip += literal_length;
+    op += literal_length;
+
+    if (ip == iend)
+      {
+      // last sequence.
+      break;
+      }
+
+    if (iend - ip < 2)
+      {
+      vtkErrorMacro("Truncated compressed data.");
+      return 0;
+      }
+    size_t offset = static_cast<size_t>(ip[0]) |
+      (static_cast<size_t>(ip[1]) << 8);
+    ip += 2;
+    size_t match_length = token & 0x0f;
+    if (match_length == 15 && !vtkPVLZReadLength(match_length, ip, iend))
+      {
+      vtkErrorMacro("Truncated compressed data.");
+      return 0;
+      }
+    match_length += VTK_PV_LZ_MIN_MATCH;
+    if (offset == 0 || offset > static_cast<size_t>(op - obase) ||
+      static_cast<size_t>(oend - op) < match_length)
+      {
+      vtkErrorMacro("Corrupted compressed data.");
+      return 0;
+      }
+
+    // Matches may overlap the bytes being written, copy byte by byte.
+    const unsigned char* match = op - offset;
+    for (size_t cc=0; cc < match_length; cc++)
+      {
+      op[cc] = match[cc];
+      }
+    op += match_length;
+    }
+
+  return static_cast<size_t>(op - uncompressedData);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVLZDataCompressor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+}
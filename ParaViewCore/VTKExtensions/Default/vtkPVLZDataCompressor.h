@@ -0,0 +1,64 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVLZDataCompressor.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVLZDataCompressor - fast LZ77 data compressor.
+// .SECTION Description
+// vtkPVLZDataCompressor is a byte-oriented LZ77 compressor in the spirit of
+// LZ4: matches are found through a single-entry hash table and encoded as
+// (literal length, match length, offset) sequences without any entropy
+// coding. It compresses less than vtkZLibDataCompressor but is an order of
+// magnitude faster, which makes it suitable for compressing data sent over
+// fast networks. The compressed stream is not compatible with LZ4.
+
+#ifndef __vtkPVLZDataCompressor_h
+#define __vtkPVLZDataCompressor_h
+
+#include "vtkPVVTKExtensionsDefaultModule.h" //needed for exports
+#include "vtkDataCompressor.h"
+
+class VTKPVVTKEXTENSIONSDEFAULT_EXPORT vtkPVLZDataCompressor : public vtkDataCompressor
+{
+public:
+  static vtkPVLZDataCompressor* New();
+  vtkTypeMacro(vtkPVLZDataCompressor, vtkDataCompressor);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Get the maximum space that may be needed to store data of the
+  // given uncompressed size after compression.
+  size_t GetMaximumCompressionSpace(size_t size);
+
+//BTX
+protected:
+  vtkPVLZDataCompressor();
+  ~vtkPVLZDataCompressor();
+
+  // Compression method required by vtkDataCompressor.
+  size_t CompressBuffer(unsigned char const* uncompressedData,
+                        size_t uncompressedSize,
+                        unsigned char* compressedData,
+                        size_t compressionSpace);
+  // Decompression method required by vtkDataCompressor.
+  size_t UncompressBuffer(unsigned char const* compressedData,
+                          size_t compressedSize,
+                          unsigned char* uncompressedData,
+                          size_t uncompressedSize);
+
+private:
+  vtkPVLZDataCompressor(const vtkPVLZDataCompressor&); // Not implemented
+  void operator=(const vtkPVLZDataCompressor&); // Not implemented
+//ETX
+};
+
+#endif
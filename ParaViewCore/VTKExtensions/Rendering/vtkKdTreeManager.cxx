@@ -28,6 +28,8 @@
 #include "vtkSphereSource.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <cmath>
+#include <cstring>
 #include <set>
 #include <vector>
 
@@ -61,6 +63,15 @@ vtkKdTreeManager::vtkKdTreeManager()
   this->Spacing[0] = this->Spacing[1] = this->Spacing[2] = 1.0;
   this->WholeExtent[0] = this->WholeExtent[2] = this->WholeExtent[4] = 0;
   this->WholeExtent[1] = this->WholeExtent[3] = this->WholeExtent[5] = 1;
+
+  this->ReuseTolerance = 0.0;
+  this->KdTreeReused = false;
+  this->KdTreeBuiltForUnstructuredData = false;
+  for (int cc=0; cc < 6; cc++)
+    {
+    this->BuiltBounds[cc] = 0.0;
+    }
+  this->BuiltNumberOfCells = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -92,6 +103,7 @@ void vtkKdTreeManager::SetKdTree(vtkPKdTree* tree)
     {
     vtkSetObjectBodyMacro(KdTree, vtkPKdTree, tree);
     this->KdTreeInitialized = false;
+    this->KdTreeBuiltForUnstructuredData = false;
     }
 }
 
@@ -111,6 +123,23 @@ void vtkKdTreeManager::SetStructuredDataInformation(
 //----------------------------------------------------------------------------
 void vtkKdTreeManager::GenerateKdTree()
 {
+  this->KdTreeReused = false;
+
+  // All processes agree on the global bounds, hence on whether the KdTree is
+  // reused, since building it is a collective operation.
+  double bounds[6];
+  vtkIdType numberOfCells = 0;
+  bool validBounds = false;
+  if (this->ReuseTolerance > 0.0 && !this->ExtentTranslator)
+    {
+    validBounds = this->ComputeGlobalBounds(bounds, numberOfCells);
+    if (validBounds && this->CanReuseKdTree(bounds, numberOfCells))
+      {
+      this->KdTreeReused = true;
+      return;
+      }
+    }
+
   this->KdTree->RemoveAllDataSets();
   if (!this->KdTreeInitialized)
     {
@@ -171,6 +200,121 @@ void vtkKdTreeManager::GenerateKdTree()
 
   this->KdTree->BuildLocator();
   //this->KdTree->PrintTree();
+
+  this->KdTreeBuiltForUnstructuredData = validBounds;
+  if (validBounds)
+    {
+    memcpy(this->BuiltBounds, bounds, 6*sizeof(double));
+    this->BuiltNumberOfCells = numberOfCells;
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool vtkKdTreeManager::ComputeGlobalBounds(
+  double bounds[6], vtkIdType& numberOfCells)
+{
+  vtkBoundingBox bbox;
+  vtkIdType localNumberOfCells = 0;
+  for (vtkDataObjectSet::iterator iter = this->DataObjects->begin();
+    iter != this->DataObjects->end(); ++iter)
+    {
+    vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(*iter);
+    if (cd)
+      {
+      vtkCompositeDataIterator* cdIter = cd->NewIterator();
+      for (cdIter->InitTraversal(); !cdIter->IsDoneWithTraversal();
+        cdIter->GoToNextItem())
+        {
+        vtkDataSet* ds =
+          vtkDataSet::SafeDownCast(cdIter->GetCurrentDataObject());
+        if (ds && ds->GetNumberOfCells() > 0)
+          {
+          bbox.AddBounds(ds->GetBounds());
+          localNumberOfCells += ds->GetNumberOfCells();
+          }
+        }
+      cdIter->Delete();
+      }
+    vtkDataSet* ds = vtkDataSet::SafeDownCast(*iter);
+    if (ds && ds->GetNumberOfCells() > 0)
+      {
+      bbox.AddBounds(ds->GetBounds());
+      localNumberOfCells += ds->GetNumberOfCells();
+      }
+    }
+
+  // Reduce the minima and the negated maxima in a single call.
+  double localBounds[6] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, VTK_DOUBLE_MAX,
+    VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, VTK_DOUBLE_MAX };
+  if (bbox.IsValid())
+    {
+    for (int cc=0; cc < 3; cc++)
+      {
+      localBounds[cc] = bbox.GetMinPoint()[cc];
+      localBounds[cc+3] = -bbox.GetMaxPoint()[cc];
+      }
+    }
+  double globalBounds[6];
+  vtkMultiProcessController* controller = this->KdTree->GetController();
+  if (controller)
+    {
+    controller->AllReduce(localBounds, globalBounds, 6,
+      vtkCommunicator::MIN_OP);
+    controller->AllReduce(&localNumberOfCells, &numberOfCells, 1,
+      vtkCommunicator::SUM_OP);
+    }
+  else
+    {
+    memcpy(globalBounds, localBounds, 6*sizeof(double));
+    numberOfCells = localNumberOfCells;
+    }
+  if (numberOfCells == 0)
+    {
+    return false;
+    }
+  for (int cc=0; cc < 3; cc++)
+    {
+    bounds[2*cc] = globalBounds[cc];
+    bounds[2*cc+1] = -globalBounds[cc+3];
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkKdTreeManager::CanReuseKdTree(
+  const double bounds[6], vtkIdType numberOfCells)
+{
+  if (!this->KdTreeBuiltForUnstructuredData ||
+    this->KdTree->GetNumberOfRegions() == 0)
+    {
+    return false;
+    }
+
+  double tolerance = this->ReuseTolerance;
+  vtkIdType cellsDelta = numberOfCells - this->BuiltNumberOfCells;
+  if (static_cast<double>(cellsDelta < 0? -cellsDelta : cellsDelta) >
+    tolerance * this->BuiltNumberOfCells)
+    {
+    return false;
+    }
+
+  // Data outside of the space partitioned by the KdTree would not be assigned
+  // to any region.
+  double treeBounds[6];
+  this->KdTree->GetBounds(treeBounds);
+  vtkBoundingBox builtBox(this->BuiltBounds);
+  double diagonal = builtBox.GetDiagonalLength();
+  for (int cc=0; cc < 3; cc++)
+    {
+    if (bounds[2*cc] < treeBounds[2*cc] ||
+      bounds[2*cc+1] > treeBounds[2*cc+1] ||
+      fabs(bounds[2*cc] - this->BuiltBounds[2*cc]) > tolerance * diagonal ||
+      fabs(bounds[2*cc+1] - this->BuiltBounds[2*cc+1]) > tolerance * diagonal)
+      {
+      return false;
+      }
+    }
+  return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -289,6 +433,8 @@ void vtkKdTreeManager::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
   os << indent << "KdTree: " << this->KdTree << endl;
   os << indent << "NumberOfPieces: " << this->NumberOfPieces << endl;
+  os << indent << "ReuseTolerance: " << this->ReuseTolerance << endl;
+  os << indent << "KdTreeReused: " << this->KdTreeReused << endl;
 }
 
 
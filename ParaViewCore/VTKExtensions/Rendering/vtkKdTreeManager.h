@@ -21,6 +21,11 @@
 // translator. This class manages this logic. When structure data's extent
 // translator is to be used, it simply uses vtkKdTreeGenerator. Otherwise, it
 // lets the vtkPKdTree build the optimal partitioning for the data.
+//
+// When ReuseTolerance is positive, the partitioning built for unstructured data
+// is kept as long as the global bounds and number of cells of the data stay
+// within that tolerance of the ones the KdTree was built with, so that the data
+// need not be redistributed again when it barely changes.
 
 #ifndef __vtkKdTreeManager_h
 #define __vtkKdTreeManager_h
@@ -68,9 +73,24 @@ public:
   vtkGetMacro(NumberOfPieces, int);
 
   // Description:
-  // Rebuilds the KdTree.
+  // Get/Set the relative tolerance used to decide whether the KdTree built for
+  // unstructured data can be reused. The KdTree is kept when the data is
+  // contained in it, its global bounds moved by at most ReuseTolerance times
+  // the length of the diagonal and its global number of cells changed by at
+  // most ReuseTolerance times the number of cells the KdTree was built with.
+  // 0 (default) rebuilds the KdTree on every call to GenerateKdTree().
+  vtkSetClampMacro(ReuseTolerance, double, 0.0, 1.0);
+  vtkGetMacro(ReuseTolerance, double);
+
+  // Description:
+  // Rebuilds the KdTree, unless it can be reused (see ReuseTolerance). This
+  // must be called on all processes.
   void GenerateKdTree();
 
+  // Description:
+  // Returns true if the last call to GenerateKdTree() kept the KdTree as is.
+  vtkGetMacro(KdTreeReused, bool);
+
 //BTX
 protected:
   vtkKdTreeManager();
@@ -79,10 +99,28 @@ protected:
   void AddDataObjectToKdTree(vtkDataObject *data);
   void AddDataSetToKdTree(vtkDataSet *data);
 
+  // Description:
+  // Computes the bounds and the number of cells of the data objects over all
+  // processes. Returns false if there is no data.
+  bool ComputeGlobalBounds(double bounds[6], vtkIdType& numberOfCells);
+
+  // Description:
+  // Returns true if the KdTree built for bounds and numberOfCells can be used
+  // for data with the given bounds and number of cells.
+  bool CanReuseKdTree(const double bounds[6], vtkIdType numberOfCells);
+
   bool KdTreeInitialized;
   vtkPKdTree* KdTree;
   int NumberOfPieces;
 
+  double ReuseTolerance;
+  bool KdTreeReused;
+  // Global bounds and number of cells the KdTree was last built with, when
+  // it was built for unstructured data.
+  bool KdTreeBuiltForUnstructuredData;
+  double BuiltBounds[6];
+  vtkIdType BuiltNumberOfCells;
+
   vtkSmartPointer<vtkExtentTranslator> ExtentTranslator;
   double Origin[3];
   double Spacing[3];
@@ -25,9 +25,14 @@
 #include "vtkOrderedCompositeDistributor.h"
 #include "vtkPVConfig.h" // needed for PARAVIEW_USE_MPI 
 
+#include "vtkAppendFilter.h"
 #include "vtkBSPCuts.h"
 #include "vtkCallbackCommand.h"
+#include "vtkCellArray.h"
 #include "vtkDataObjectTypes.h"
+#include "vtkExtractCells.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
@@ -35,14 +40,123 @@
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPKdTree.h"
+#include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkDataSetSurfaceFilter.h"
+#include "vtkSmartPointer.h"
+#include "vtkSMPTools.h"
+#include "vtkTimerLog.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
 #ifdef PARAVIEW_USE_MPI
 # include "vtkDistributedDataFilter.h"
 #endif
 
+#include <utility>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+class vtkOrderedCompositeDistributor::vtkInternals
+{
+public:
+  typedef std::vector<std::pair<vtkObject*, unsigned long> > KeyType;
+
+  // Objects (and their modification times) the cached regions were computed
+  // from.
+  KeyType CellRegionsKey;
+  std::vector<int> CellRegions;
+
+  void AddToKey(KeyType& key, vtkObject* object)
+    {
+    key.push_back(std::pair<vtkObject*, unsigned long>(
+        object, object? object->GetMTime() : 0));
+    }
+
+  // Identifies the points and cells of input and the regions of tree.
+  KeyType ComputeKey(vtkDataSet* input, vtkPKdTree* tree)
+    {
+    KeyType key;
+    this->AddToKey(key, tree);
+    this->AddToKey(key, tree->GetCuts());
+    vtkPolyData* pd = vtkPolyData::SafeDownCast(input);
+    vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(input);
+    vtkPointSet* ps = vtkPointSet::SafeDownCast(input);
+    if (pd && pd->GetPoints())
+      {
+      this->AddToKey(key, pd->GetPoints()->GetData());
+      this->AddToKey(key, pd->GetVerts()->GetData());
+      this->AddToKey(key, pd->GetLines()->GetData());
+      this->AddToKey(key, pd->GetPolys()->GetData());
+      this->AddToKey(key, pd->GetStrips()->GetData());
+      }
+    else if (ug && ug->GetPoints())
+      {
+      this->AddToKey(key, ug->GetPoints()->GetData());
+      this->AddToKey(key, ug->GetCells()? ug->GetCells()->GetData() : NULL);
+      this->AddToKey(key, ug->GetCellTypesArray());
+      }
+    else
+      {
+      // Any change of other datasets invalidates the regions.
+      this->AddToKey(key, input);
+      this->AddToKey(key, ps? ps->GetPoints() : NULL);
+      }
+    return key;
+    }
+};
+
+namespace
+{
+  // Locates points in the regions of a vtkPKdTree.
+  class vtkPointRegionsFunctor
+    {
+  public:
+    vtkPKdTree* Tree;
+    vtkPoints* Points;
+    int* Regions;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      double x[3];
+      for (vtkIdType cc=begin; cc < end; cc++)
+        {
+        this->Points->GetPoint(cc, x);
+        this->Regions[cc] = this->Tree->GetRegionContainingPoint(x[0], x[1], x[2]);
+        }
+      }
+    };
+
+  // Assigns to each cell the region containing all its points, or -1 for
+  // cells that straddle several regions.
+  class vtkCellRegionsFunctor
+    {
+  public:
+    vtkDataSet* Input;
+    const int* PointRegions;
+    int* CellRegions;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      vtkNew<vtkIdList> ptIds;
+      for (vtkIdType cc=begin; cc < end; cc++)
+        {
+        this->Input->GetCellPoints(cc, ptIds.GetPointer());
+        vtkIdType numPts = ptIds->GetNumberOfIds();
+        int region = numPts > 0? this->PointRegions[ptIds->GetId(0)] : -1;
+        for (vtkIdType kk=1; kk < numPts && region >= 0; kk++)
+          {
+          if (this->PointRegions[ptIds->GetId(kk)] != region)
+            {
+            region = -1;
+            }
+          }
+        this->CellRegions[cc] = region;
+        }
+      }
+    };
+}
+
 //-----------------------------------------------------------------------------
 #ifdef PARAVIEW_USE_MPI
 static void D3UpdateProgress(vtkObject *_D3, unsigned long,
@@ -70,6 +184,14 @@ vtkOrderedCompositeDistributor::vtkOrderedCompositeDistributor()
   this->Controller = NULL;
   this->PassThrough = false;
   this->OutputType = NULL;
+  this->KeepLocalCells = true;
+  this->AssignmentTime = 0.0;
+  this->ExchangeTime = 0.0;
+  this->MergeTime = 0.0;
+  this->NumberOfKeptCells = 0;
+  this->NumberOfExchangedCells = 0;
+  this->CellRegionsReused = false;
+  this->Internals = new vtkInternals();
   this->SetController(vtkMultiProcessController::GetGlobalController());
 }
 
@@ -79,6 +201,7 @@ vtkOrderedCompositeDistributor::~vtkOrderedCompositeDistributor()
   this->SetPKdTree(NULL);
   this->SetController(NULL);
   this->SetOutputType(NULL);
+  delete this->Internals;
 }
 
 //-----------------------------------------------------------------------------
@@ -90,6 +213,14 @@ void vtkOrderedCompositeDistributor::PrintSelf(ostream &os, vtkIndent indent)
   os << indent << "PassThrough: " << this->PassThrough << endl;
   os << indent << "OutputType: " << 
     (this->OutputType? this->OutputType : "(none)") << endl;
+  os << indent << "KeepLocalCells: " << this->KeepLocalCells << endl;
+  os << indent << "AssignmentTime: " << this->AssignmentTime << endl;
+  os << indent << "ExchangeTime: " << this->ExchangeTime << endl;
+  os << indent << "MergeTime: " << this->MergeTime << endl;
+  os << indent << "NumberOfKeptCells: " << this->NumberOfKeptCells << endl;
+  os << indent << "NumberOfExchangedCells: "
+     << this->NumberOfExchangedCells << endl;
+  os << indent << "CellRegionsReused: " << this->CellRegionsReused << endl;
 }
 
 //-----------------------------------------------------------------------------
@@ -204,54 +335,215 @@ int vtkOrderedCompositeDistributor::RequestData(
 
   this->UpdateProgress(0.01);
 
-  vtkNew<vtkDistributedDataFilter> d3;
-
-  // add progress observer.
-  vtkNew<vtkCallbackCommand> cbc;
-  cbc->SetClientData(this);
-  cbc->SetCallback(D3UpdateProgress);
-  d3->AddObserver(vtkCommand::ProgressEvent, cbc.GetPointer());
-
-  d3->SetBoundaryModeToSplitBoundaryCells();
-  d3->SetInputData(input);
-  d3->SetCuts(cuts);
-
-  // We need to pass the region assignments from PKdTree to D3
-  // (Refer to BUG #10828).
-  d3->SetUserRegionAssignments(
-    this->PKdTree->GetRegionAssignmentMap(),
-    this->PKdTree->GetRegionAssignmentMapLength());
-  d3->SetController(this->Controller);
-  //d3->SetClipAlgorithmType(vtkDistributedDataFilter::USE_TABLEBASEDCLIPDATASET);
-  d3->Update();
-
-  vtkDataSet* distributedData =
-    vtkDataSet::SafeDownCast(d3->GetOutputDataObject(0));
+  // Split the input into the cells that stay on this process and the cells
+  // that have to be exchanged.
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  vtkTimerLog::MarkStartEvent("Assign Cells to Regions");
+  vtkIdType numCells = input->GetNumberOfCells();
+  vtkSmartPointer<vtkDataSet> keptCells;
+  vtkSmartPointer<vtkDataSet> exchangedCells = input;
+  this->NumberOfKeptCells = 0;
+  this->NumberOfExchangedCells = numCells;
+  this->CellRegionsReused = false;
+  if (this->KeepLocalCells && this->PKdTree->GetNumberOfRegions() > 0 &&
+    numCells > 0)
+    {
+    this->UpdateCellRegions(input);
+
+    int myId = this->Controller->GetLocalProcessId();
+    const int* cellRegions = &this->Internals->CellRegions[0];
+    vtkNew<vtkIdList> keptIds;
+    vtkNew<vtkIdList> exchangedIds;
+    for (vtkIdType cc=0; cc < numCells; cc++)
+      {
+      int region = cellRegions[cc];
+      if (region >= 0 &&
+        this->PKdTree->GetProcessAssignedToRegion(region) == myId)
+        {
+        keptIds->InsertNextId(cc);
+        }
+      else
+        {
+        exchangedIds->InsertNextId(cc);
+        }
+      }
+    this->NumberOfKeptCells = keptIds->GetNumberOfIds();
+    this->NumberOfExchangedCells = exchangedIds->GetNumberOfIds();
+
+    if (this->NumberOfExchangedCells == 0)
+      {
+      keptCells = input;
+      exchangedCells = vtkSmartPointer<vtkUnstructuredGrid>::New();
+      }
+    else if (this->NumberOfKeptCells > 0)
+      {
+      vtkNew<vtkExtractCells> keptExtractor;
+      keptExtractor->SetInputData(input);
+      keptExtractor->SetCellList(keptIds.GetPointer());
+      keptExtractor->Update();
+      keptCells = keptExtractor->GetOutput();
+
+      vtkNew<vtkExtractCells> exchangedExtractor;
+      exchangedExtractor->SetInputData(input);
+      exchangedExtractor->SetCellList(exchangedIds.GetPointer());
+      exchangedExtractor->Update();
+      exchangedCells = exchangedExtractor->GetOutput();
+      }
+    }
+  vtkTimerLog::MarkEndEvent("Assign Cells to Regions");
+  timer->StopTimer();
+  this->AssignmentTime = timer->GetElapsedTime();
+
+  // vtkDistributedDataFilter is collective, skip it only if no process has
+  // cells to exchange.
+  timer->StartTimer();
+  vtkTimerLog::MarkStartEvent("Exchange Cells");
+  vtkIdType numExchangedCells = this->NumberOfExchangedCells;
+  vtkIdType totalExchangedCells = 0;
+  this->Controller->AllReduce(&numExchangedCells, &totalExchangedCells, 1,
+    vtkCommunicator::SUM_OP);
+  vtkSmartPointer<vtkDataSet> receivedCells;
+  if (totalExchangedCells > 0)
+    {
+    vtkNew<vtkDistributedDataFilter> d3;
+
+    // add progress observer.
+    vtkNew<vtkCallbackCommand> cbc;
+    cbc->SetClientData(this);
+    cbc->SetCallback(D3UpdateProgress);
+    d3->AddObserver(vtkCommand::ProgressEvent, cbc.GetPointer());
+
+    d3->SetBoundaryModeToSplitBoundaryCells();
+    d3->SetInputData(exchangedCells);
+    d3->SetCuts(cuts);
+
+    // We need to pass the region assignments from PKdTree to D3
+    // (Refer to BUG #10828).
+    d3->SetUserRegionAssignments(
+      this->PKdTree->GetRegionAssignmentMap(),
+      this->PKdTree->GetRegionAssignmentMapLength());
+    d3->SetController(this->Controller);
+    //d3->SetClipAlgorithmType(vtkDistributedDataFilter::USE_TABLEBASEDCLIPDATASET);
+    d3->Update();
+    receivedCells = vtkDataSet::SafeDownCast(d3->GetOutputDataObject(0));
+    }
+  vtkTimerLog::MarkEndEvent("Exchange Cells");
+  timer->StopTimer();
+  this->ExchangeTime = timer->GetElapsedTime();
+
+  timer->StartTimer();
+  vtkTimerLog::MarkStartEvent("Merge Cells");
+  vtkSmartPointer<vtkDataSet> distributedData = receivedCells;
+  if (keptCells && keptCells->GetNumberOfCells() > 0)
+    {
+    distributedData = keptCells;
+    if (receivedCells && receivedCells->GetNumberOfCells() > 0)
+      {
+      vtkNew<vtkAppendFilter> appender;
+      appender->AddInputData(keptCells);
+      appender->AddInputData(receivedCells);
+      appender->Update();
+      distributedData = appender->GetOutput();
+      }
+    }
+  int retVal = this->CopyToOutput(distributedData, output);
+  vtkTimerLog::MarkEndEvent("Merge Cells");
+  timer->StopTimer();
+  this->MergeTime = timer->GetElapsedTime();
+  return retVal;
+#endif
+
+  return 1;
+}
+
+//-----------------------------------------------------------------------------
+void vtkOrderedCompositeDistributor::UpdateCellRegions(vtkDataSet* input)
+{
+  vtkInternals::KeyType key =
+    this->Internals->ComputeKey(input, this->PKdTree);
+  vtkIdType numCells = input->GetNumberOfCells();
+  if (key == this->Internals->CellRegionsKey &&
+    static_cast<vtkIdType>(this->Internals->CellRegions.size()) == numCells)
+    {
+    this->CellRegionsReused = true;
+    return;
+    }
+
+  vtkPointSet* ps = vtkPointSet::SafeDownCast(input);
+  vtkIdType numPts = input->GetNumberOfPoints();
+  std::vector<int> pointRegions(numPts, -1);
+  if (ps && ps->GetPoints() && numPts > 0)
+    {
+    vtkPointRegionsFunctor pointFunctor;
+    pointFunctor.Tree = this->PKdTree;
+    pointFunctor.Points = ps->GetPoints();
+    pointFunctor.Regions = &pointRegions[0];
+    vtkSMPTools::For(0, numPts, pointFunctor);
+    }
+
+  // Make sure the cells of polydata are built before looking them up from
+  // several threads.
+  vtkPolyData* pd = vtkPolyData::SafeDownCast(input);
+  if (pd && numCells > 0)
+    {
+    pd->GetCellType(0);
+    }
+
+  this->Internals->CellRegions.resize(numCells);
+  vtkCellRegionsFunctor cellFunctor;
+  cellFunctor.Input = input;
+  cellFunctor.PointRegions = numPts > 0? &pointRegions[0] : NULL;
+  cellFunctor.CellRegions = &this->Internals->CellRegions[0];
+  vtkSMPTools::For(0, numCells, cellFunctor);
+
+  this->Internals->CellRegionsKey = key;
+}
+
+//-----------------------------------------------------------------------------
+int vtkOrderedCompositeDistributor::CopyToOutput(
+  vtkDataSet* data, vtkDataSet* output)
+{
   // D3 can result in certain processes having empty datasets. Since we use
   // internal methods on vtkDataSetSurfaceFilter, they are not empty-data safe
   // and hence can segfault. This check avoids such segfaults.
-  if (distributedData &&
-      distributedData->GetNumberOfPoints() > 0 &&
-      distributedData->GetNumberOfCells() > 0)
+  if (!data || data->GetNumberOfPoints() == 0 ||
+    data->GetNumberOfCells() == 0)
     {
-    if (output->IsA("vtkUnstructuredGrid"))
-      {
-      output->ShallowCopy(distributedData);
-      }
-    else if (output->IsA("vtkPolyData"))
+    return 1;
+    }
+
+  if (data->IsA(output->GetClassName()))
+    {
+    output->ShallowCopy(data);
+    }
+  else if (output->IsA("vtkUnstructuredGrid"))
+    {
+    vtkNew<vtkAppendFilter> converter;
+    converter->AddInputData(data);
+    converter->Update();
+    output->ShallowCopy(converter->GetOutput());
+    }
+  else if (output->IsA("vtkPolyData"))
+    {
+    vtkNew<vtkDataSetSurfaceFilter> converter;
+    if (data->IsA("vtkUnstructuredGrid"))
       {
-      vtkNew<vtkDataSetSurfaceFilter> converter;
       converter->UnstructuredGridExecute(
-        distributedData, vtkPolyData::SafeDownCast(output));
+        data, vtkPolyData::SafeDownCast(output));
       }
     else
       {
-      vtkErrorMacro(<< "vtkOrderedCompositeDistributor used with unsupported "
-        << "type.");
-      return 0;
+      converter->SetInputData(data);
+      converter->Update();
+      output->ShallowCopy(converter->GetOutput());
       }
     }
-#endif
-
+  else
+    {
+    vtkErrorMacro(<< "vtkOrderedCompositeDistributor used with unsupported "
+      << "type.");
+    return 0;
+    }
   return 1;
 }
@@ -35,6 +35,12 @@
 // This class also has an optional pass through mode to make it easy to
 // turn ordered compositing on and off.
 //
+// With KeepLocalCells on, only the cells that do not lie entirely in a region
+// assigned to the local process go through vtkDistributedDataFilter. The
+// regions of the cells are cached, so that executing again with the same
+// geometry and vtkPKdTree (e.g. when only attributes change) does not locate
+// the points in the tree again.
+//
 
 #ifndef __vtkOrderedCompositeDistributor_h
 #define __vtkOrderedCompositeDistributor_h
@@ -77,6 +83,27 @@ public:
   vtkSetStringMacro(OutputType);
   vtkGetStringMacro(OutputType);
 
+  // Description:
+  // When on (default), cells whose points all lie in a region assigned to the
+  // local process are kept as is and only the other cells are exchanged with
+  // the other processes.
+  vtkSetMacro(KeepLocalCells, bool);
+  vtkGetMacro(KeepLocalCells, bool);
+  vtkBooleanMacro(KeepLocalCells, bool);
+
+  // Description:
+  // Statistics of the last execution on this process: the time (in seconds)
+  // spent assigning cells to regions, exchanging cells with the other
+  // processes and merging the kept cells with the received ones, the number
+  // of cells kept and sent to vtkDistributedDataFilter, and whether the
+  // cached regions of the cells were used.
+  vtkGetMacro(AssignmentTime, double);
+  vtkGetMacro(ExchangeTime, double);
+  vtkGetMacro(MergeTime, double);
+  vtkGetMacro(NumberOfKeptCells, vtkIdType);
+  vtkGetMacro(NumberOfExchangedCells, vtkIdType);
+  vtkGetMacro(CellRegionsReused, bool);
+
 protected:
   vtkOrderedCompositeDistributor();
   ~vtkOrderedCompositeDistributor();
@@ -85,6 +112,23 @@ protected:
   bool PassThrough;
   vtkPKdTree *PKdTree;
   vtkMultiProcessController *Controller;
+  bool KeepLocalCells;
+
+  double AssignmentTime;
+  double ExchangeTime;
+  double MergeTime;
+  vtkIdType NumberOfKeptCells;
+  vtkIdType NumberOfExchangedCells;
+  bool CellRegionsReused;
+
+  // Description:
+  // Updates the cached regions of the cells of input: the region containing
+  // all the points of each cell, or -1.
+  void UpdateCellRegions(vtkDataSet* input);
+
+  // Description:
+  // Copies data, converted if needed, to output.
+  int CopyToOutput(vtkDataSet* data, vtkDataSet* output);
  
   int FillInputPortInformation(int port, vtkInformation *info);
   int RequestDataObject(
@@ -95,6 +139,11 @@ protected:
 private:
   vtkOrderedCompositeDistributor(const vtkOrderedCompositeDistributor &);  // Not implemented.
   void operator=(const vtkOrderedCompositeDistributor &);  // Not implemented.
+
+//BTX
+  class vtkInternals;
+  vtkInternals* Internals;
+//ETX
 };
 
 #endif //__vtkOrderedCompositeDistributor_h
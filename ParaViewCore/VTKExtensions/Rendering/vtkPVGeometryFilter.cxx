@@ -40,7 +40,9 @@
 #include "vtkHyperTreeGrid.h"
 #include "vtkHyperTreeGridGeometry.h"
 #include "vtkImageData.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
+#include "vtkInformationIntegerKey.h"
 #include "vtkInformationIntegerVectorKey.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
@@ -59,6 +61,7 @@
 #include "vtkRectilinearGridOutlineFilter.h"
 #include "vtkSelectionNode.h"
 #include "vtkSmartPointer.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStripper.h"
 #include "vtkStructuredGrid.h"
@@ -78,6 +81,7 @@
 #include <math.h>
 #include <set>
 #include <algorithm>
+#include <cstring>
 
 
 vtkStandardNewMacro(vtkPVGeometryFilter);
@@ -87,6 +91,7 @@ vtkInformationKeyMacro(vtkPVGeometryFilter, VERTS_OFFSETS, IntegerVector);
 vtkInformationKeyMacro(vtkPVGeometryFilter, LINES_OFFSETS, IntegerVector);
 vtkInformationKeyMacro(vtkPVGeometryFilter, POLYS_OFFSETS, IntegerVector);
 vtkInformationKeyMacro(vtkPVGeometryFilter, STRIPS_OFFSETS, IntegerVector);
+vtkInformationKeyMacro(vtkPVGeometryFilter, MESH_TOPOLOGY, Integer);
 class vtkPVGeometryFilter::BoundsReductionOperation : public vtkCommunicator::Operation
 {
 public:
@@ -141,6 +146,311 @@ public:
     }
 };
 
+//----------------------------------------------------------------------------
+namespace
+{
+// Cells of an unstructured grid are extracted in chunks of at least this
+// number of cells, and in at most vtkPVGeometryFilterMaxChunks chunks.
+const vtkIdType vtkPVGeometryFilterChunkSize = 65536;
+const vtkIdType vtkPVGeometryFilterMaxChunks = 64;
+
+// Returns true if the surface of cells of this type can be extracted by the
+// static mesh code path, i.e. linear cells with no point added by the
+// extraction and whose faces are found from their connectivity.
+bool vtkPVGeometryFilterIsStaticMeshCell(int cellType, bool& is3D)
+{
+  is3D = false;
+  switch (cellType)
+    {
+    case VTK_EMPTY_CELL:
+    case VTK_VERTEX:
+    case VTK_POLY_VERTEX:
+    case VTK_LINE:
+    case VTK_POLY_LINE:
+    case VTK_TRIANGLE:
+    case VTK_TRIANGLE_STRIP:
+    case VTK_POLYGON:
+    case VTK_PIXEL:
+    case VTK_QUAD:
+      return true;
+    case VTK_TETRA:
+    case VTK_VOXEL:
+    case VTK_HEXAHEDRON:
+    case VTK_WEDGE:
+    case VTK_PYRAMID:
+    case VTK_PENTAGONAL_PRISM:
+    case VTK_HEXAGONAL_PRISM:
+      is3D = true;
+      return true;
+    default:
+      return false;
+    }
+}
+
+// FNV-1a hash of chunks of an array, the chunks are combined in order so the
+// hash does not depend on the number of threads.
+template <class T>
+class vtkPVGeometryFilterHash
+{
+public:
+  const T* Values;
+  vtkIdType NumberOfValues;
+  vtkIdType ChunkSize;
+  vtkTypeUInt64* ChunkHashes;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
+      {
+      vtkIdType first = chunk * this->ChunkSize;
+      vtkIdType last = std::min(first + this->ChunkSize, this->NumberOfValues);
+      vtkTypeUInt64 hash = 14695981039346656037ULL;
+      for (vtkIdType i = first; i < last; ++i)
+        {
+        hash ^= static_cast<vtkTypeUInt64>(this->Values[i]);
+        hash *= 1099511628211ULL;
+        }
+      this->ChunkHashes[chunk] = hash;
+      }
+    }
+};
+
+template <class T>
+vtkTypeUInt64 vtkPVGeometryFilterHashValues(const T* values,
+  vtkIdType numValues, vtkTypeUInt64 hash)
+{
+  vtkPVGeometryFilterHash<T> functor;
+  functor.Values = values;
+  functor.NumberOfValues = numValues;
+  functor.ChunkSize = 1 << 20;
+  vtkIdType numChunks = (numValues + functor.ChunkSize - 1) / functor.ChunkSize;
+  std::vector<vtkTypeUInt64> chunkHashes(numChunks + 1);
+  functor.ChunkHashes = &chunkHashes[0];
+  vtkSMPTools::For(0, numChunks, 1, functor);
+  for (vtkIdType chunk = 0; chunk < numChunks; ++chunk)
+    {
+    hash = (hash ^ chunkHashes[chunk]) * 1099511628211ULL;
+    }
+  return hash;
+}
+
+// Extracts the surface of chunks of cells of an unstructured grid. Each chunk
+// is copied in its own grid, with the points it uses only, and its surface is
+// extracted with its own vtkDataSetSurfaceFilter. The faces shared by two
+// chunks are removed when the chunks are merged.
+class vtkPVGeometryFilterExtractChunks
+{
+public:
+  vtkUnstructuredGrid* Input;
+  vtkIdType ChunkSize;
+  // For each chunk, the ids of the input points used by the chunk, sorted.
+  std::vector<std::vector<vtkIdType> >* PointIds;
+  vtkUnstructuredGrid** Grids;
+  vtkDataSetSurfaceFilter** Filters;
+  vtkPolyData** Surfaces;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    vtkIdType numCells = this->Input->GetNumberOfCells();
+    vtkPoints* inPoints = this->Input->GetPoints();
+    std::vector<vtkIdType> localIds;
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
+      {
+      vtkIdType first = chunk * this->ChunkSize;
+      vtkIdType last = std::min(first + this->ChunkSize, numCells);
+
+      std::vector<vtkIdType>& pointIds = (*this->PointIds)[chunk];
+      vtkIdType npts, *pts;
+      for (vtkIdType cellId = first; cellId < last; ++cellId)
+        {
+        this->Input->GetCellPoints(cellId, npts, pts);
+        pointIds.insert(pointIds.end(), pts, pts + npts);
+        }
+      std::sort(pointIds.begin(), pointIds.end());
+      pointIds.erase(std::unique(pointIds.begin(), pointIds.end()),
+        pointIds.end());
+
+      vtkUnstructuredGrid* grid = this->Grids[chunk];
+      vtkPoints* points = grid->GetPoints();
+      vtkIdType numPoints = static_cast<vtkIdType>(pointIds.size());
+      points->SetNumberOfPoints(numPoints);
+      double x[3];
+      for (vtkIdType i = 0; i < numPoints; ++i)
+        {
+        inPoints->GetPoint(pointIds[i], x);
+        points->SetPoint(i, x);
+        }
+      grid->Allocate(last - first);
+      for (vtkIdType cellId = first; cellId < last; ++cellId)
+        {
+        this->Input->GetCellPoints(cellId, npts, pts);
+        localIds.resize(npts);
+        for (vtkIdType i = 0; i < npts; ++i)
+          {
+          localIds[i] = std::lower_bound(pointIds.begin(), pointIds.end(),
+            pts[i]) - pointIds.begin();
+          }
+        grid->InsertNextCell(this->Input->GetCellType(cellId), npts,
+          npts > 0? &localIds[0] : NULL);
+        }
+
+      this->Filters[chunk]->UnstructuredGridExecute(grid, this->Surfaces[chunk]);
+      // The copy of the chunk is not needed anymore.
+      grid->Initialize();
+      }
+    }
+};
+
+// Copies the tuples of the source arrays to the target arrays, the tuple i of
+// a target array is the tuple Ids[i] of its source array.
+class vtkPVGeometryFilterGatherTuples
+{
+public:
+  const vtkIdType* Ids;
+  std::vector<std::pair<vtkAbstractArray*, vtkAbstractArray*> > Arrays;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    for (size_t cc = 0; cc < this->Arrays.size(); ++cc)
+      {
+      vtkAbstractArray* source = this->Arrays[cc].first;
+      vtkAbstractArray* target = this->Arrays[cc].second;
+      if (source->GetDataType() == VTK_BIT)
+        {
+        // Tuples share bytes, see GatherBits().
+        continue;
+        }
+      if (vtkDataArray::SafeDownCast(source))
+        {
+        size_t tupleSize = static_cast<size_t>(
+          source->GetNumberOfComponents() * source->GetDataTypeSize());
+        const char* from = static_cast<const char*>(source->GetVoidPointer(0));
+        char* to = static_cast<char*>(target->GetVoidPointer(0));
+        for (vtkIdType i = begin; i < end; ++i)
+          {
+          memcpy(to + i * tupleSize, from + this->Ids[i] * tupleSize,
+            tupleSize);
+          }
+        }
+      else
+        {
+        for (vtkIdType i = begin; i < end; ++i)
+          {
+          target->SetTuple(i, this->Ids[i], source);
+          }
+        }
+      }
+    }
+
+  // Copies the tuples of the bit arrays, which cannot be done concurrently.
+  void GatherBits(vtkIdType numIds)
+    {
+    for (size_t cc = 0; cc < this->Arrays.size(); ++cc)
+      {
+      if (this->Arrays[cc].first->GetDataType() == VTK_BIT)
+        {
+        for (vtkIdType i = 0; i < numIds; ++i)
+          {
+          this->Arrays[cc].second->SetTuple(i, this->Ids[i],
+            this->Arrays[cc].first);
+          }
+        }
+      }
+    }
+
+  // Adds a copy of the arrays of source to target, with one tuple per id.
+  void AddArrays(vtkDataSetAttributes* source, vtkDataSetAttributes* target,
+    vtkIdType numIds)
+    {
+    for (int cc = 0; cc < source->GetNumberOfArrays(); ++cc)
+      {
+      vtkAbstractArray* sourceArray = source->GetAbstractArray(cc);
+      vtkAbstractArray* targetArray = sourceArray->NewInstance();
+      targetArray->SetName(sourceArray->GetName());
+      targetArray->SetNumberOfComponents(
+        sourceArray->GetNumberOfComponents());
+      targetArray->SetNumberOfTuples(numIds);
+      int index = target->AddArray(targetArray);
+      targetArray->Delete();
+      int attribute = source->IsArrayAnAttribute(cc);
+      if (attribute >= 0)
+        {
+        target->SetActiveAttribute(index, attribute);
+        }
+      this->Arrays.push_back(std::make_pair(sourceArray, targetArray));
+      }
+    }
+};
+}
+
+//----------------------------------------------------------------------------
+class vtkPVGeometryFilter::vtkInternals
+{
+public:
+  // Surface of a block of an unstructured grid whose connectivity does not
+  // change, the points and cells of the surface are identified by the ids of
+  // the input points and cells they come from.
+  struct StaticMeshSurface
+    {
+    StaticMeshSurface() : Supported(false), NumberOfPoints(-1),
+      NumberOfCells(-1), HasMeshTopology(false), MeshTopology(0),
+      Connectivity(NULL), CellTypes(NULL), ConnectivityMTime(0), Hash(0),
+      LastExecution(0) {}
+
+    // False when the input has cells that the static mesh code path cannot
+    // handle.
+    bool Supported;
+    vtkSmartPointer<vtkCellArray> Verts;
+    vtkSmartPointer<vtkCellArray> Lines;
+    vtkSmartPointer<vtkCellArray> Polys;
+    vtkSmartPointer<vtkCellArray> Strips;
+    vtkSmartPointer<vtkIdTypeArray> OriginalPointIds;
+    vtkSmartPointer<vtkIdTypeArray> OriginalCellIds;
+
+    // What identifies the connectivity of the input.
+    vtkIdType NumberOfPoints;
+    vtkIdType NumberOfCells;
+    bool HasMeshTopology;
+    int MeshTopology;
+    void* Connectivity;
+    void* CellTypes;
+    unsigned long ConnectivityMTime;
+    vtkTypeUInt64 Hash;
+
+    // Execution in which the surface was last used.
+    unsigned long LastExecution;
+    };
+
+  vtkInternals() : Execution(0) {}
+
+  std::map<unsigned int, StaticMeshSurface> StaticMeshSurfaces;
+  unsigned long Execution;
+
+  // Extracts the surface of input in surface. Returns false if input has
+  // cells that are not supported.
+  bool ExtractStaticMeshSurface(vtkUnstructuredGrid* input,
+    StaticMeshSurface& surface);
+
+  // Removes the surfaces of the blocks that were not executed in the last
+  // execution.
+  void RemoveUnusedStaticMeshSurfaces()
+    {
+    std::map<unsigned int, StaticMeshSurface>::iterator iter =
+      this->StaticMeshSurfaces.begin();
+    while (iter != this->StaticMeshSurfaces.end())
+      {
+      if (iter->second.LastExecution != this->Execution)
+        {
+        this->StaticMeshSurfaces.erase(iter++);
+        }
+      else
+        {
+        ++iter;
+        }
+      }
+    }
+};
+
 //----------------------------------------------------------------------------
 vtkPVGeometryFilter::vtkPVGeometryFilter ()
 {
@@ -185,6 +495,10 @@ vtkPVGeometryFilter::vtkPVGeometryFilter ()
 
   this->HideInternalAMRFaces = true;
   this->UseNonOverlappingAMRMetaDataForOutlines = true;
+  this->UseStaticMesh = false;
+  this->CurrentBlockIndex = 0;
+
+  this->Internals = new vtkInternals();
 }
 
 //----------------------------------------------------------------------------
@@ -219,6 +533,7 @@ vtkPVGeometryFilter::~vtkPVGeometryFilter ()
   this->OutlineSource->Delete();
   this->InternalProgressObserver->Delete();
   this->SetController(0);
+  delete this->Internals;
 }
 
 //----------------------------------------------------------------------------
@@ -517,6 +832,8 @@ int vtkPVGeometryFilter::RequestData(vtkInformation* request,
                                      vtkInformationVector* outputVector)
 {
   vtkDataObject* input = vtkDataObject::GetData(inputVector[0], 0);
+  this->Internals->Execution++;
+  this->CurrentBlockIndex = 0;
   if (vtkCompositeDataSet::SafeDownCast(input))
     {
     vtkTimerLog::MarkStartEvent("vtkPVGeometryFilter::RequestData");
@@ -533,6 +850,7 @@ int vtkPVGeometryFilter::RequestData(vtkInformation* request,
     vtkGarbageCollector::DeferredCollectionPop();
     vtkTimerLog::MarkEndEvent("vtkPVGeometryFilter::GarbageCollect");
     vtkTimerLog::MarkEndEvent("vtkPVGeometryFilter::RequestData");
+    this->Internals->RemoveUnusedStaticMeshSurfaces();
     return 1;
     }
 
@@ -557,6 +875,7 @@ int vtkPVGeometryFilter::RequestData(vtkInformation* request,
     0,
     wholeExtent);
   this->CleanupOutputData(output, 1);
+  this->Internals->RemoveUnusedStaticMeshSurfaces();
   return 1;
 }
 
@@ -925,6 +1244,7 @@ int vtkPVGeometryFilter::RequestCompositeData(vtkInformation*,
     vtkDataObject* block = iter->GetCurrentDataObject();
 
     vtkPolyData* tmpOut = vtkPolyData::New();
+    this->CurrentBlockIndex = iter->GetCurrentFlatIndex();
     this->ExecuteBlock(block, tmpOut, 0, 0, 1, 0, wholeExtent);
     this->CleanupOutputData(tmpOut, 0);
     //skip empty nodes.
@@ -1380,6 +1700,12 @@ void vtkPVGeometryFilter::UnstructuredGridExecute(
     {
     this->OutlineFlag = 0;
 
+    if (this->UseStaticMesh && !this->Triangulate &&
+      this->StaticMeshExecute(input, output))
+      {
+      return;
+      }
+
     bool handleSubdivision = (this->Triangulate != 0);
     if (!handleSubdivision && (this->NonlinearSubdivisionLevel > 0))
       {
@@ -1556,6 +1882,314 @@ void vtkPVGeometryFilter::UnstructuredGridExecute(
   this->DataSetExecute(input, output, doCommunicate);
 }
 
+//----------------------------------------------------------------------------
+bool vtkPVGeometryFilter::StaticMeshExecute(
+  vtkUnstructuredGridBase* inputBase, vtkPolyData* output)
+{
+  vtkUnstructuredGrid* input = vtkUnstructuredGrid::SafeDownCast(inputBase);
+  if (!input || !input->GetPoints() || input->GetNumberOfCells() == 0)
+    {
+    return false;
+    }
+
+  vtkInternals::StaticMeshSurface& surface =
+    this->Internals->StaticMeshSurfaces[this->CurrentBlockIndex];
+  surface.LastExecution = this->Internals->Execution;
+
+  // Is the connectivity the one of the cached surface?
+  vtkIdTypeArray* connectivity = input->GetCells()->GetData();
+  vtkUnsignedCharArray* types = input->GetCellTypesArray();
+  unsigned long connectivityMTime =
+    std::max(connectivity->GetMTime(), types->GetMTime());
+  vtkInformation* info = input->GetInformation();
+  bool hasMeshTopology = info && info->Has(vtkPVGeometryFilter::MESH_TOPOLOGY());
+  int meshTopology =
+    hasMeshTopology? info->Get(vtkPVGeometryFilter::MESH_TOPOLOGY()) : 0;
+
+  bool valid = surface.NumberOfPoints == input->GetNumberOfPoints() &&
+    surface.NumberOfCells == input->GetNumberOfCells() &&
+    surface.HasMeshTopology == hasMeshTopology;
+  if (hasMeshTopology)
+    {
+    valid = valid && surface.MeshTopology == meshTopology;
+    }
+  else if (surface.Connectivity != connectivity ||
+    surface.CellTypes != types ||
+    surface.ConnectivityMTime != connectivityMTime)
+    {
+    vtkTypeUInt64 hash = vtkPVGeometryFilterHashValues(
+      connectivity->GetPointer(0), connectivity->GetNumberOfTuples(),
+      14695981039346656037ULL);
+    hash = vtkPVGeometryFilterHashValues(types->GetPointer(0),
+      types->GetNumberOfTuples(), hash);
+    valid = valid && surface.Hash == hash;
+    surface.Hash = hash;
+    }
+  surface.NumberOfPoints = input->GetNumberOfPoints();
+  surface.NumberOfCells = input->GetNumberOfCells();
+  surface.HasMeshTopology = hasMeshTopology;
+  surface.MeshTopology = meshTopology;
+  surface.Connectivity = connectivity;
+  surface.CellTypes = types;
+  surface.ConnectivityMTime = connectivityMTime;
+
+  if (!valid)
+    {
+    vtkTimerLog::MarkStartEvent("vtkPVGeometryFilter::ExtractStaticMeshSurface");
+    surface.Supported =
+      this->Internals->ExtractStaticMeshSurface(input, surface);
+    vtkTimerLog::MarkEndEvent("vtkPVGeometryFilter::ExtractStaticMeshSurface");
+    }
+  if (!surface.Supported)
+    {
+    return false;
+    }
+
+  // Copy the points and the attributes of the input to the surface.
+  vtkIdType numPoints = surface.OriginalPointIds->GetNumberOfTuples();
+  vtkIdType numCells = surface.OriginalCellIds->GetNumberOfTuples();
+  output->Initialize();
+
+  vtkPoints* points = vtkPoints::New(input->GetPoints()->GetDataType());
+  points->SetNumberOfPoints(numPoints);
+  vtkPVGeometryFilterGatherTuples pointGather;
+  pointGather.Ids = surface.OriginalPointIds->GetPointer(0);
+  pointGather.Arrays.push_back(
+    std::make_pair(input->GetPoints()->GetData(), points->GetData()));
+  pointGather.AddArrays(input->GetPointData(), output->GetPointData(),
+    numPoints);
+  vtkSMPTools::For(0, numPoints, pointGather);
+  pointGather.GatherBits(numPoints);
+  output->SetPoints(points);
+  points->Delete();
+
+  vtkPVGeometryFilterGatherTuples cellGather;
+  cellGather.Ids = surface.OriginalCellIds->GetPointer(0);
+  cellGather.AddArrays(input->GetCellData(), output->GetCellData(), numCells);
+  vtkSMPTools::For(0, numCells, cellGather);
+  cellGather.GatherBits(numCells);
+
+  output->SetVerts(surface.Verts);
+  output->SetLines(surface.Lines);
+  output->SetPolys(surface.Polys);
+  output->SetStrips(surface.Strips);
+
+  if (this->PassThroughPointIds)
+    {
+    output->GetPointData()->AddArray(surface.OriginalPointIds);
+    }
+  if (this->PassThroughCellIds)
+    {
+    output->GetCellData()->AddArray(surface.OriginalCellIds);
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVGeometryFilter::vtkInternals::ExtractStaticMeshSurface(
+  vtkUnstructuredGrid* input, StaticMeshSurface& surface)
+{
+  surface.Verts = NULL;
+  surface.Lines = NULL;
+  surface.Polys = NULL;
+  surface.Strips = NULL;
+  surface.OriginalPointIds = NULL;
+  surface.OriginalCellIds = NULL;
+
+  vtkIdType numCells = input->GetNumberOfCells();
+  vtkIdType numPoints = input->GetNumberOfPoints();
+  unsigned char* types = input->GetCellTypesArray()->GetPointer(0);
+  bool supported[256];
+  bool is3D[256];
+  for (int type = 0; type < 256; ++type)
+    {
+    supported[type] = vtkPVGeometryFilterIsStaticMeshCell(type, is3D[type]);
+    }
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+    {
+    if (!supported[types[cellId]])
+      {
+      return false;
+      }
+    }
+
+  // Extract the surface of the chunks concurrently.
+  vtkIdType numChunks = std::min(std::max(static_cast<vtkIdType>(1),
+      (numCells + vtkPVGeometryFilterChunkSize - 1) /
+      vtkPVGeometryFilterChunkSize), vtkPVGeometryFilterMaxChunks);
+  vtkIdType chunkSize = (numCells + numChunks - 1) / numChunks;
+  std::vector<std::vector<vtkIdType> > chunkPointIds(numChunks);
+  std::vector<vtkUnstructuredGrid*> grids(numChunks);
+  std::vector<vtkDataSetSurfaceFilter*> filters(numChunks);
+  std::vector<vtkPolyData*> surfaces(numChunks);
+  for (vtkIdType chunk = 0; chunk < numChunks; ++chunk)
+    {
+    grids[chunk] = vtkUnstructuredGrid::New();
+    vtkPoints* points = vtkPoints::New(input->GetPoints()->GetDataType());
+    grids[chunk]->SetPoints(points);
+    points->Delete();
+    filters[chunk] = vtkDataSetSurfaceFilter::New();
+    filters[chunk]->PassThroughPointIdsOn();
+    filters[chunk]->PassThroughCellIdsOn();
+    surfaces[chunk] = vtkPolyData::New();
+    }
+  vtkPVGeometryFilterExtractChunks extractor;
+  extractor.Input = input;
+  extractor.ChunkSize = chunkSize;
+  extractor.PointIds = &chunkPointIds;
+  extractor.Grids = &grids[0];
+  extractor.Filters = &filters[0];
+  extractor.Surfaces = &surfaces[0];
+  vtkSMPTools::For(0, numChunks, 1, extractor);
+
+  bool success = true;
+  std::vector<vtkIdTypeArray*> surfacePointIds(numChunks);
+  std::vector<vtkIdTypeArray*> surfaceCellIds(numChunks);
+  for (vtkIdType chunk = 0; chunk < numChunks; ++chunk)
+    {
+    surfacePointIds[chunk] = vtkIdTypeArray::SafeDownCast(
+      surfaces[chunk]->GetPointData()->GetArray("vtkOriginalPointIds"));
+    surfaceCellIds[chunk] = vtkIdTypeArray::SafeDownCast(
+      surfaces[chunk]->GetCellData()->GetArray("vtkOriginalCellIds"));
+    success = success && surfacePointIds[chunk] && surfaceCellIds[chunk];
+    }
+
+  // Faces of 3D cells found in two chunks are internal faces, all their
+  // points are used by both chunks.
+  std::vector<std::vector<unsigned char> > removedPolys(numChunks);
+  if (success && numChunks > 1)
+    {
+    std::vector<vtkIdType> firstChunk(numPoints, -1);
+    std::vector<unsigned char> shared(numPoints, 0);
+    for (vtkIdType chunk = 0; chunk < numChunks; ++chunk)
+      {
+      const std::vector<vtkIdType>& pointIds = chunkPointIds[chunk];
+      for (size_t i = 0; i < pointIds.size(); ++i)
+        {
+        if (firstChunk[pointIds[i]] < 0)
+          {
+          firstChunk[pointIds[i]] = chunk;
+          }
+        else if (firstChunk[pointIds[i]] != chunk)
+          {
+          shared[pointIds[i]] = 1;
+          }
+        }
+      }
+
+    typedef std::pair<std::vector<vtkIdType>, std::pair<vtkIdType, vtkIdType> >
+      FaceType;
+    std::vector<FaceType> faces;
+    for (vtkIdType chunk = 0; chunk < numChunks; ++chunk)
+      {
+      vtkPolyData* chunkSurface = surfaces[chunk];
+      vtkIdType firstPoly =
+        chunkSurface->GetNumberOfVerts() + chunkSurface->GetNumberOfLines();
+      vtkCellArray* polys = chunkSurface->GetPolys();
+      removedPolys[chunk].resize(chunkSurface->GetNumberOfPolys(), 0);
+      vtkIdType npts, *pts;
+      vtkIdType polyId = 0;
+      for (polys->InitTraversal(); polys->GetNextCell(npts, pts); ++polyId)
+        {
+        vtkIdType cellId = chunk * chunkSize +
+          surfaceCellIds[chunk]->GetValue(firstPoly + polyId);
+        if (!is3D[types[cellId]])
+          {
+          continue;
+          }
+        FaceType face;
+        face.first.resize(npts);
+        bool candidate = true;
+        for (vtkIdType i = 0; i < npts && candidate; ++i)
+          {
+          face.first[i] = chunkPointIds[chunk][
+            surfacePointIds[chunk]->GetValue(pts[i])];
+          candidate = shared[face.first[i]] != 0;
+          }
+        if (candidate)
+          {
+          std::sort(face.first.begin(), face.first.end());
+          face.second = std::make_pair(chunk, polyId);
+          faces.push_back(face);
+          }
+        }
+      }
+    std::sort(faces.begin(), faces.end());
+    for (size_t i = 0; i < faces.size(); ++i)
+      {
+      if ((i > 0 && faces[i].first == faces[i-1].first) ||
+        (i + 1 < faces.size() && faces[i].first == faces[i+1].first))
+        {
+        removedPolys[faces[i].second.first][faces[i].second.second] = 1;
+        }
+      }
+    }
+
+  // Merge the surfaces of the chunks, in the order of the input cells.
+  if (success)
+    {
+    std::vector<vtkIdType> outputIds(numPoints, -1);
+    surface.OriginalPointIds = vtkSmartPointer<vtkIdTypeArray>::New();
+    surface.OriginalPointIds->SetName("vtkOriginalPointIds");
+    surface.OriginalCellIds = vtkSmartPointer<vtkIdTypeArray>::New();
+    surface.OriginalCellIds->SetName("vtkOriginalCellIds");
+    vtkSmartPointer<vtkCellArray> cellArrays[4];
+    for (int type = 0; type < 4; ++type)
+      {
+      cellArrays[type] = vtkSmartPointer<vtkCellArray>::New();
+      for (vtkIdType chunk = 0; chunk < numChunks; ++chunk)
+        {
+        vtkPolyData* chunkSurface = surfaces[chunk];
+        vtkCellArray* chunkCells[4] = { chunkSurface->GetVerts(),
+          chunkSurface->GetLines(), chunkSurface->GetPolys(),
+          chunkSurface->GetStrips() };
+        vtkIdType firstCell = 0;
+        for (int previous = 0; previous < type; ++previous)
+          {
+          firstCell += chunkCells[previous]->GetNumberOfCells();
+          }
+        vtkIdType npts, *pts;
+        vtkIdType cellId = 0;
+        vtkCellArray* cells = chunkCells[type];
+        for (cells->InitTraversal(); cells->GetNextCell(npts, pts); ++cellId)
+          {
+          if (type == 2 && !removedPolys[chunk].empty() &&
+            removedPolys[chunk][cellId])
+            {
+            continue;
+            }
+          cellArrays[type]->InsertNextCell(npts);
+          for (vtkIdType i = 0; i < npts; ++i)
+            {
+            vtkIdType pointId = chunkPointIds[chunk][
+              surfacePointIds[chunk]->GetValue(pts[i])];
+            if (outputIds[pointId] < 0)
+              {
+              outputIds[pointId] =
+                surface.OriginalPointIds->InsertNextValue(pointId);
+              }
+            cellArrays[type]->InsertCellPoint(outputIds[pointId]);
+            }
+          surface.OriginalCellIds->InsertNextValue(chunk * chunkSize +
+            surfaceCellIds[chunk]->GetValue(firstCell + cellId));
+          }
+        }
+      }
+    surface.Verts = cellArrays[0];
+    surface.Lines = cellArrays[1];
+    surface.Polys = cellArrays[2];
+    surface.Strips = cellArrays[3];
+    }
+
+  for (vtkIdType chunk = 0; chunk < numChunks; ++chunk)
+    {
+    grids[chunk]->Delete();
+    filters[chunk]->Delete();
+    surfaces[chunk]->Delete();
+    }
+  return success;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVGeometryFilter::PolyDataExecute(
   vtkPolyData* input, vtkPolyData* output, int doCommunicate)
@@ -1765,6 +2399,8 @@ void vtkPVGeometryFilter::PrintSelf(ostream& os, vtkIndent indent)
      << (this->PassThroughCellIds ? "On\n" : "Off\n");
   os << indent << "PassThroughPointIds: "
      << (this->PassThroughPointIds ? "On\n" : "Off\n");
+  os << indent << "UseStaticMesh: "
+     << (this->UseStaticMesh ? "On\n" : "Off\n");
 }
 
 //----------------------------------------------------------------------------
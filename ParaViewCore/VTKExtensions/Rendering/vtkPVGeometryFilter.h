@@ -31,6 +31,7 @@ class vtkHyperOctree;
 class vtkHyperTreeGrid;
 class vtkImageData;
 class vtkUniformGrid;
+class vtkInformationIntegerKey;
 class vtkInformationIntegerVectorKey;
 class vtkInformationVector;
 class vtkMultiProcessController;
@@ -153,6 +154,25 @@ public:
   vtkGetMacro(UseNonOverlappingAMRMetaDataForOutlines, bool);
   vtkBooleanMacro(UseNonOverlappingAMRMetaDataForOutlines, bool);
 
+  // Description:
+  // When set to true, the surface extracted from unstructured grids made of
+  // linear cells is cached for each block, and reused as long as the
+  // connectivity of the block does not change: only the points and the
+  // attributes are copied from the input through the original point and cell
+  // ids of the surface. The surface itself is extracted concurrently on
+  // chunks of cells. The connectivity is identified by the MESH_TOPOLOGY() key
+  // when the producer sets it, by a hash of the cell arrays otherwise. This
+  // has no effect when Triangulate is on. Off by default.
+  vtkSetMacro(UseStaticMesh, bool);
+  vtkGetMacro(UseStaticMesh, bool);
+  vtkBooleanMacro(UseStaticMesh, bool);
+
+  // Description:
+  // Producers can set this key in the information of their output data
+  // object, with a value that changes only when the connectivity of the
+  // output changes, to avoid hashing the cells when UseStaticMesh is on.
+  static vtkInformationIntegerKey* MESH_TOPOLOGY();
+
   // These keys are put in the output composite-data metadata for multipieces
   // since this filter merges multipieces together.
   static vtkInformationIntegerVectorKey* POINT_OFFSETS();
@@ -237,6 +257,11 @@ protected:
   void UnstructuredGridExecute(
     vtkUnstructuredGridBase* input, vtkPolyData* output, int doCommunicate);
 
+  // Description:
+  // Used by UnstructuredGridExecute() when UseStaticMesh is true. Returns
+  // false if the input has cells that the static mesh cache cannot handle.
+  bool StaticMeshExecute(vtkUnstructuredGridBase* input, vtkPolyData* output);
+
   void PolyDataExecute(
     vtkPolyData* input, vtkPolyData* output, int doCommunicate);
 
@@ -306,6 +331,11 @@ protected:
 
   bool HideInternalAMRFaces;
   bool UseNonOverlappingAMRMetaDataForOutlines;
+  bool UseStaticMesh;
+
+  // Flat index of the block being executed, it identifies the static mesh
+  // cache of the block.
+  unsigned int CurrentBlockIndex;
 
 private:
   vtkPVGeometryFilter(const vtkPVGeometryFilter&); // Not implemented
@@ -320,6 +350,9 @@ private:
   void AddBlockColors(vtkPolyData* pd, unsigned int index);
   void AddHierarchicalIndex(vtkPolyData* pd, unsigned int level, unsigned int index);
   class BoundsReductionOperation;
+
+  class vtkInternals;
+  vtkInternals* Internals;
 //ETX
 };
 
@@ -29,6 +29,7 @@
 #include "vtkPoints.h"
 #include "vtkSelection.h"
 #include "vtkSelectionNode.h"
+#include "vtkSMPTools.h"
 #include "vtkSignedCharArray.h"
 #include "vtkSmartPointer.h"
 #include "vtkStringArray.h"
@@ -48,6 +49,7 @@
 #include "vtkDoubleArray.h"
 
 #include <algorithm>
+#include <list>
 #include <vtksys/stl/map>
 #include <vector>
 #include <set>
@@ -69,6 +71,7 @@ public:
 
   virtual void SetSelectedComponent(int newValue) = 0;
   virtual void InvalidateCache() = 0;
+  virtual void SetPartialSortThreshold(vtkIdType newValue) = 0;
   virtual int  Extract( vtkTable* input, vtkTable* output,
                         vtkIdType block, vtkIdType blockSize,
                         bool revertOrder) = 0;
@@ -434,6 +437,132 @@ public:
       return *this;      // Return ref for multiple assignment
       }
   };
+  // Fills the sortable items from the data array (component or normalized
+  // magnitude), used with vtkSMPTools::For().
+  class KeyExtractor
+  {
+  public:
+    SortableArrayItem* Array;
+    const T* Data;
+    int NumberOfComponents;
+    int SelectedComponent;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      const double norm = sqrt(static_cast<double>(this->NumberOfComponents));
+      for(vtkIdType i=begin; i < end; ++i)
+        {
+        this->Array[i].OriginalIndex = i;
+        const T* tuple = this->Data + i*this->NumberOfComponents;
+        if(this->SelectedComponent < 0)
+          {
+          double value = 0;
+          for(int k=0; k < this->NumberOfComponents; k++)
+            {
+            double tmp = static_cast<double>(tuple[k]);
+            value += tmp*tmp;
+            }
+          this->Array[i].Value = static_cast<T>(sqrt(value) / norm);
+          }
+        else
+          {
+          this->Array[i].Value = tuple[this->SelectedComponent];
+          }
+        }
+      }
+  };
+  // Sorts independent chunks of the items, used with vtkSMPTools::For().
+  class ChunkSorter
+  {
+  public:
+    SortableArrayItem* Array;
+    vtkIdType ArraySize;
+    vtkIdType ChunkSize;
+    bool (*Compare)(const SortableArrayItem&, const SortableArrayItem&);
+
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      for(vtkIdType chunk=begin; chunk < end; ++chunk)
+        {
+        vtkIdType first = chunk * this->ChunkSize;
+        vtkIdType last = MIN(first + this->ChunkSize, this->ArraySize);
+        std::sort(this->Array + first, this->Array + last, this->Compare);
+        }
+      }
+  };
+  // Merges pairs of consecutive sorted runs of RunSize items, used with
+  // vtkSMPTools::For().
+  class RunMerger
+  {
+  public:
+    SortableArrayItem* Array;
+    vtkIdType ArraySize;
+    vtkIdType RunSize;
+    bool (*Compare)(const SortableArrayItem&, const SortableArrayItem&);
+
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      for(vtkIdType pair=begin; pair < end; ++pair)
+        {
+        vtkIdType first = 2 * pair * this->RunSize;
+        vtkIdType middle = first + this->RunSize;
+        vtkIdType last = MIN(middle + this->RunSize, this->ArraySize);
+        if(middle < last)
+          {
+          std::inplace_merge(this->Array + first, this->Array + middle,
+                             this->Array + last, this->Compare);
+          }
+        }
+      }
+  };
+  // Sorts the items concurrently: chunks are sorted independently and then
+  // merged two by two. Small arrays are simply sorted in place.
+  static void SortItems(SortableArrayItem* array, vtkIdType size,
+                        bool reverseOrder)
+    {
+    // Descendent is the ascending order, the naming comes from the histogram
+    bool (*compare)(const SortableArrayItem&, const SortableArrayItem&) =
+        reverseOrder ? SortableArrayItem::Ascendent
+                     : SortableArrayItem::Descendent;
+    if(size <= SORT_CHUNK_SIZE)
+      {
+      std::sort(array, array + size, compare);
+      return;
+      }
+
+    ChunkSorter sorter;
+    sorter.Array = array;
+    sorter.ArraySize = size;
+    sorter.ChunkSize = SORT_CHUNK_SIZE;
+    sorter.Compare = compare;
+    vtkSMPTools::For(0, (size + SORT_CHUNK_SIZE - 1) / SORT_CHUNK_SIZE,
+                     1, sorter);
+
+    RunMerger merger;
+    merger.Array = array;
+    merger.ArraySize = size;
+    merger.Compare = compare;
+    for(vtkIdType runSize = SORT_CHUNK_SIZE; runSize < size; runSize *= 2)
+      {
+      merger.RunSize = runSize;
+      vtkSMPTools::For(0, (size + 2*runSize - 1) / (2*runSize), 1, merger);
+      }
+    }
+  // Extracts the sortable items of the given array in parallel.
+  static SortableArrayItem* NewSortableItems(const T* dataPtr,
+                                             vtkIdType numTuples,
+                                             int numComponents,
+                                             int selectedComponent)
+    {
+    SortableArrayItem* array = new SortableArrayItem[numTuples];
+    KeyExtractor extractor;
+    extractor.Array = array;
+    extractor.Data = dataPtr;
+    extractor.NumberOfComponents = numComponents;
+    extractor.SelectedComponent = selectedComponent;
+    vtkSMPTools::For(0, numTuples, extractor);
+    return array;
+    }
   class ArraySorter
   {
   public:
@@ -444,6 +573,7 @@ public:
     ArraySorter()
       {
       this->Array = 0;
+      this->ArraySize = 0;
       this->Histo = 0;
       }
 
@@ -499,42 +629,65 @@ public:
       this->Histo->Inverted = reverseOrder;
       this->Histo->SetScalarRange(scalarRange);
       this->ArraySize = numTuples;
-      this->Array = new SortableArrayItem[this->ArraySize];
+      this->Array = NewSortableItems(dataPtr, numTuples, numComponents,
+                                     selectedComponent);
 
-      // Fill the sortable array
+      // Build the histogram
       for(vtkIdType i=0; i < this->ArraySize; ++i)
         {
-        this->Array[i].OriginalIndex = i;
-        double value = 0;
-        double tmp;
-        if(selectedComponent < 0)
-          {
-          // Compute magnitude
-          for(int k=0;k<numComponents;k++)
-            {
-            tmp = static_cast<double>(dataPtr[k + i*numComponents]);
-            value +=  tmp*tmp;
-            }
-          value = sqrt(value) / sqrt(static_cast<double>(numComponents));
-          this->Array[i].Value = static_cast<T>(value);
-          }
-        else
-          {
-          this->Array[i].Value = dataPtr[selectedComponent + i*numComponents];
-          value = static_cast<double>(this->Array[i].Value);
-          }
-        this->Histo->AddValue(value);
+        this->Histo->AddValue(static_cast<double>(this->Array[i].Value));
         }
 
       // Sort it
-      if(reverseOrder)
+      SortItems(this->Array, this->ArraySize, reverseOrder);
+      }
+
+    // Description:
+    // Only keep the first nbItems items of the sorted array without sorting
+    // the whole array. No histogram is built.
+    void PartialUpdate(T* dataPtr, vtkIdType numTuples, int numComponents,
+                       int selectedComponent, vtkIdType nbItems,
+                       bool reverseOrder)
+      {
+      // Clear memory if needed
+      this->Clear();
+
+      if(numComponents == 1 && selectedComponent < 0)
         {
-        std::sort(this->Array, this->Array + this->ArraySize, SortableArrayItem::Ascendent);
+        selectedComponent = 0; // We can not compute magnitude on scalar value
         }
-      else
+
+      this->ArraySize = numTuples;
+      this->Array = NewSortableItems(dataPtr, numTuples, numComponents,
+                                     selectedComponent);
+      if(nbItems >= numTuples)
         {
-        std::sort(this->Array, this->Array + this->ArraySize, SortableArrayItem::Descendent);
+        SortItems(this->Array, this->ArraySize, reverseOrder);
+        return;
         }
+
+      bool (*compare)(const SortableArrayItem&, const SortableArrayItem&) =
+          reverseOrder ? SortableArrayItem::Ascendent
+                       : SortableArrayItem::Descendent;
+      std::nth_element(this->Array, this->Array + nbItems,
+                       this->Array + numTuples, compare);
+      std::sort(this->Array, this->Array + nbItems, compare);
+
+      // Release the tail
+      SortableArrayItem* head = new SortableArrayItem[nbItems];
+      std::copy(this->Array, this->Array + nbItems, head);
+      delete[] this->Array;
+      this->Array = head;
+      this->ArraySize = nbItems;
+      }
+
+    // Description:
+    // Sort the whole array without building a histogram.
+    void Sort(T* dataPtr, vtkIdType numTuples, int numComponents,
+              int selectedComponent, bool reverseOrder)
+      {
+      this->PartialUpdate(dataPtr, numTuples, numComponents,
+                          selectedComponent, numTuples, reverseOrder);
       }
 
     void SortProcessId(vtkIdType* dataPtr, vtkIdType numTuples,
@@ -561,14 +714,7 @@ public:
         }
 
       // Sort it
-      if(reverseOrder)
-        {
-        std::sort(this->Array, this->Array + this->ArraySize, SortableArrayItem::Ascendent);
-        }
-      else
-        {
-        std::sort(this->Array, this->Array + this->ArraySize, SortableArrayItem::Descendent);
-        }
+      SortItems(this->Array, this->ArraySize, reverseOrder);
       }
   };
 
@@ -578,7 +724,10 @@ public:
     {
     // Only used for testing
     this->LocalSorter = 0;
+    this->PartialSorter = 0;
     this->GlobalHistogram = 0;
+    this->CommonRange[0] = 0;
+    this->CommonRange[1] = 1;
     this->Debug = false;
     }
 
@@ -589,6 +738,10 @@ public:
     this->SelectedComponent = 0;
     this->NeedToBuildCache = true;
     this->DataToSort = dataToSort;
+    this->PartialSortSize = 0;
+    this->PartialSortThreshold = 0;
+    this->CommonRange[0] = 0;
+    this->CommonRange[1] = 1;
 
     this->InputMTime = input->GetMTime();
 
@@ -604,12 +757,14 @@ public:
 
     // Create internal objects
     this->LocalSorter = new ArraySorter();
+    this->PartialSorter = new ArraySorter();
     this->GlobalHistogram = new Histogram(HISTOGRAM_SIZE);
     }
 
   virtual ~Internals()
     {
     if (this->LocalSorter)     delete this->LocalSorter;
+    if (this->PartialSorter)   delete this->PartialSorter;
     if (this->GlobalHistogram) delete this->GlobalHistogram;
     }
 
@@ -893,59 +1048,93 @@ public:
               vtkIdType block, vtkIdType blockSize, bool revertOrder)
     {
     // ------------------------------------------------------------------------
-    // Make sure that the Cache is builded
-    //    This will sort the local array, that's why we don't want to do it
-    //    at each execution. Specialy when we only change the requested block.
-    // ------------------------------------------------------------------------
-    if(this->NeedToBuildCache)
-      {
-      this->BuildCache(true, revertOrder);
-      }
-
-    // ------------------------------------------------------------------------
-    // Search for lower bound
+    // The first blocks are extracted from the head of a partial sort: each
+    // process provides its (block+1)*blockSize first elements and the merging
+    // process keeps the requested block. The whole array is only sorted once
+    // deeper blocks are requested.
     // ------------------------------------------------------------------------
     vtkIdType nbElementsToRemoveFromHead = 0;
-    vtkIdType localOffset = 0;
-    vtkIdType nbElementsInBar = 0;
-    this->SearchGlobalIndexLocation( (block * blockSize),
-                                     this->LocalSorter->Histo,
-                                     this->GlobalHistogram,
-                                     nbElementsToRemoveFromHead,
-                                     localOffset,
-                                     nbElementsInBar);
-
-
-
-    // ------------------------------------------------------------------------
-    // Search for upper bound
-    // ------------------------------------------------------------------------
-    vtkIdType upperOffset = 0;
-    vtkIdType globalUpperOffset = 0;
-    vtkIdType searchIdx =
-        (this->GlobalHistogram->TotalValues < (block + 1) * blockSize) ?
-        this->GlobalHistogram->TotalValues : ((block + 1) * blockSize);
-    searchIdx--; // It is not a size it is an index (so -1)
-
-    this->SearchGlobalIndexLocation( searchIdx,
-                                     this->LocalSorter->Histo,
-                                     this->GlobalHistogram,
-                                     globalUpperOffset,
-                                     upperOffset,
-                                     nbElementsInBar );
-
-
-    // We have to include our searched index (so +1)
-    vtkIdType localSize = (upperOffset + nbElementsInBar) - localOffset + 1;
-
-    // ------------------------------------------------------------------------
-    // Build local subset table
-    // ------------------------------------------------------------------------
+    vtkIdType localSize = 0;
     vtkSmartPointer<vtkTable> localSubset;
-    localSubset.TakeReference( this->NewSubsetTable( input,
-                                                     this->LocalSorter,
-                                                     localOffset,
-                                                     localSize));
+    vtkIdType topSize = (block + 1) * blockSize;
+    if(this->NeedToBuildCache && topSize <= this->PartialSortThreshold)
+      {
+      if(this->DataToSort && this->PartialSortSize < topSize)
+        {
+        // Sort enough elements to serve every block below the threshold
+        this->PartialSortSize = this->PartialSortThreshold;
+        this->PartialSorter->PartialUpdate(
+            static_cast<T*>(this->DataToSort->GetVoidPointer(0)),
+            this->DataToSort->GetNumberOfTuples(),
+            this->DataToSort->GetNumberOfComponents(),
+            this->SelectedComponent,
+            this->PartialSortSize,
+            revertOrder);
+        }
+
+      nbElementsToRemoveFromHead = block * blockSize;
+      localSize = this->DataToSort ? topSize : 0;
+      localSubset.TakeReference( this->NewSubsetTable( input,
+                                                       this->PartialSorter,
+                                                       0,
+                                                       localSize));
+      }
+    else
+      {
+      // ----------------------------------------------------------------------
+      // Make sure that the Cache is builded
+      //    This will sort the local array, that's why we don't want to do it
+      //    at each execution. Specialy when we only change the requested block.
+      // ----------------------------------------------------------------------
+      if(this->NeedToBuildCache)
+        {
+        this->BuildCache(true, revertOrder);
+
+        // The partial sort is not needed anymore
+        this->PartialSorter->Clear();
+        this->PartialSortSize = 0;
+        }
+
+      // ----------------------------------------------------------------------
+      // Search for lower bound
+      // ----------------------------------------------------------------------
+      vtkIdType localOffset = 0;
+      vtkIdType nbElementsInBar = 0;
+      this->SearchGlobalIndexLocation( (block * blockSize),
+                                       this->LocalSorter->Histo,
+                                       this->GlobalHistogram,
+                                       nbElementsToRemoveFromHead,
+                                       localOffset,
+                                       nbElementsInBar);
+
+      // ----------------------------------------------------------------------
+      // Search for upper bound
+      // ----------------------------------------------------------------------
+      vtkIdType upperOffset = 0;
+      vtkIdType globalUpperOffset = 0;
+      vtkIdType searchIdx =
+          (this->GlobalHistogram->TotalValues < (block + 1) * blockSize) ?
+          this->GlobalHistogram->TotalValues : ((block + 1) * blockSize);
+      searchIdx--; // It is not a size it is an index (so -1)
+
+      this->SearchGlobalIndexLocation( searchIdx,
+                                       this->LocalSorter->Histo,
+                                       this->GlobalHistogram,
+                                       globalUpperOffset,
+                                       upperOffset,
+                                       nbElementsInBar );
+
+      // We have to include our searched index (so +1)
+      localSize = (upperOffset + nbElementsInBar) - localOffset + 1;
+
+      // ----------------------------------------------------------------------
+      // Build local subset table
+      // ----------------------------------------------------------------------
+      localSubset.TakeReference( this->NewSubsetTable( input,
+                                                       this->LocalSorter,
+                                                       localOffset,
+                                                       localSize));
+      }
 
     // ------------------------------------------------------------------------
     // Find the process that will merge all subset table
@@ -1006,14 +1195,13 @@ public:
         vtkSortedTableStreamer::PrintInfo(localSubset.GetPointer());
         }
 
+      // No histogram is needed to trim the merged rows
       ArraySorter sorter;
-      sorter.Update(static_cast<T*>(subsetArray->GetVoidPointer(0)),
-                    subsetArray->GetNumberOfTuples(),
-                    subsetArray->GetNumberOfComponents(),
-                    this->SelectedComponent,
-                    HISTOGRAM_SIZE,
-                    this->CommonRange,
-                    revertOrder);
+      sorter.Sort(static_cast<T*>(subsetArray->GetVoidPointer(0)),
+                  subsetArray->GetNumberOfTuples(),
+                  subsetArray->GetNumberOfComponents(),
+                  this->SelectedComponent,
+                  revertOrder);
 
       // trim it (remove head and tail that don't belong to the result)
       localSubset.TakeReference(
@@ -1176,13 +1364,22 @@ public:
   void InvalidateCache()
     {
     this->NeedToBuildCache = true;
+    this->PartialSorter->Clear();
+    this->PartialSortSize = 0;
+    }
+
+  // --------------------------------------------------------------------------
+  void SetPartialSortThreshold(vtkIdType newValue)
+    {
+    this->PartialSortThreshold = newValue;
     }
 
   // --------------------------------------------------------------------------
   bool IsInvalid(vtkTable* input, vtkDataArray* dataToProcess)
     {
-    return !dataToProcess || input->GetMTime() != this->InputMTime
-           || dataToProcess->GetMTime() != this->DataMTime;
+    return dataToProcess != this->DataToSort
+           || input->GetMTime() != this->InputMTime
+           || (dataToProcess && dataToProcess->GetMTime() != this->DataMTime);
     }
 
   // --------------------------------------------------------------------------
@@ -1398,6 +1595,9 @@ private:
   unsigned long int DataMTime;  // Keep the original data MTime
   vtkDataArray* DataToSort;   // DataArray to sort
   ArraySorter* LocalSorter;   // Local ArraySorter based on global range
+  ArraySorter* PartialSorter; // Local head of the sorted array (first blocks)
+  vtkIdType PartialSortSize;  // Number of elements sorted by PartialSorter
+  vtkIdType PartialSortThreshold; // Blocks ending below use PartialSorter
   Histogram* GlobalHistogram; // Globaly merged Histogram based on global range
   double CommonRange[2];      // Scalar range used across processes
   int Me;                     // Current process ID
@@ -1415,6 +1615,83 @@ private:
   // Maybe make some test on huge cluster to see which histogram size is
   // the best.
   const static int HISTOGRAM_SIZE = 256;
+  // Number of elements sorted sequentially before merging sorted chunks
+  const static int SORT_CHUNK_SIZE = 1048576;
+};
+//****************************************************************************
+// Keeps the internals of the recently sorted columns, most recently used
+// first, as well as the table merged from a composite input so that the rows
+// indexed by the internals stay the same.
+class vtkSortedTableStreamer::InternalsCache
+{
+public:
+  struct Entry
+    {
+    std::string ColumnName;
+    int SelectedComponent;
+    bool InvertOrder;
+    InternalsBase* Internal;
+    };
+  typedef std::list<Entry> EntriesType;
+
+  EntriesType Entries;
+  unsigned long InputMTime;
+
+  vtkSmartPointer<vtkTable> MergedInput;
+  vtkDataObject* MergedInputSource; // Only used for comparison
+  unsigned long MergedInputMTime;
+
+  InternalsCache()
+    {
+    this->InputMTime = 0;
+    this->MergedInputSource = 0;
+    this->MergedInputMTime = 0;
+    }
+
+  ~InternalsCache()
+    {
+    this->Clear();
+    }
+
+  void Clear()
+    {
+    for(EntriesType::iterator iter = this->Entries.begin();
+        iter != this->Entries.end(); ++iter)
+      {
+      delete iter->Internal;
+      }
+    this->Entries.clear();
+    }
+
+  EntriesType::iterator Find(const std::string& columnName,
+                             int selectedComponent, bool invertOrder)
+    {
+    EntriesType::iterator iter = this->Entries.begin();
+    for(; iter != this->Entries.end(); ++iter)
+      {
+      if(iter->ColumnName == columnName &&
+         iter->SelectedComponent == selectedComponent &&
+         iter->InvertOrder == invertOrder)
+        {
+        break;
+        }
+      }
+    return iter;
+    }
+
+  void Erase(EntriesType::iterator iter)
+    {
+    delete iter->Internal;
+    this->Entries.erase(iter);
+    }
+
+  void Shrink(int maximumSize)
+    {
+    while(static_cast<int>(this->Entries.size()) > maximumSize)
+      {
+      this->Erase(--this->Entries.end());
+      }
+    }
 };
 //****************************************************************************
 vtkStandardNewMacro(vtkSortedTableStreamer);
@@ -1429,7 +1706,10 @@ vtkSortedTableStreamer::vtkSortedTableStreamer()
   this->Block = 0;
   this->BlockSize = 1024;
   this->Internal = 0;
+  this->Cache = new InternalsCache();
   this->SelectedComponent = 0;
+  this->MaximumNumberOfCachedSorts = 2;
+  this->PartialSortThreshold = 4096;
   this->SetController(vtkMultiProcessController::GetGlobalController());
 }
 
@@ -1438,11 +1718,10 @@ vtkSortedTableStreamer::~vtkSortedTableStreamer()
 {
   this->SetColumnToSort(0);
   this->SetController(0);
-  if(this->Internal)
-    {
-    delete this->Internal;
-    this->Internal = 0;
-    }
+  // The internals are owned by the cache
+  this->Internal = 0;
+  delete this->Cache;
+  this->Cache = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -1468,6 +1747,14 @@ int vtkSortedTableStreamer::RequestData( vtkInformation* vtkNotUsed(request),
 
   bool orderInverted = this->InvertOrder > 0;
 
+  // Reuse the table merged from the same composite input
+  if(!input && this->Cache->MergedInput &&
+     this->Cache->MergedInputSource == inputDO &&
+     this->Cache->MergedInputMTime == inputDO->GetMTime())
+    {
+    input = this->Cache->MergedInput;
+    }
+
   // Convert a composite dataset into a vtkTable input.
   if(!input)
     {
@@ -1555,6 +1842,15 @@ int vtkSortedTableStreamer::RequestData( vtkInformation* vtkNotUsed(request),
         }
       }
     iter->Delete();
+
+    this->Cache->MergedInput = input;
+    this->Cache->MergedInputSource = inputDO;
+    this->Cache->MergedInputMTime = inputDO->GetMTime();
+    }
+  else if(input != this->Cache->MergedInput)
+    {
+    this->Cache->MergedInput = 0;
+    this->Cache->MergedInputSource = 0;
     }
 
   // Get input data
@@ -1570,18 +1866,64 @@ int vtkSortedTableStreamer::RequestData( vtkInformation* vtkNotUsed(request),
   // single point/cell.
   // --------------------------------------------------------------------------
 
-  // Delete internal object if the input has change (table or array to sort)
-  if(this->Internal && this->Internal->IsInvalid(input, arrayToProcess))
+  // Look for the internal object of the requested column. The requested
+  // component is used as key since the real one depends on local data.
+  std::string columnName = this->GetColumnToSort() ? this->GetColumnToSort() : "";
+  InternalsCache::EntriesType::iterator entry =
+      this->Cache->Find(columnName, this->SelectedComponent, orderInverted);
+
+  // Delete all internal objects if the input has changed, or the requested
+  // one if the array to sort has changed. Every process must take the same
+  // decision as building the internal object involves collective operations.
+  int localStatus[2] = {0, 0};
+  int globalStatus[2] = {0, 0};
+  localStatus[0] = (input->GetMTime() != this->Cache->InputMTime) ? 1 : 0;
+  localStatus[1] = (entry != this->Cache->Entries.end() &&
+                    entry->Internal->IsInvalid(input, arrayToProcess)) ? 1 : 0;
+  this->Controller->GetCommunicator()->AllReduce(localStatus, globalStatus, 2,
+                                                 vtkCommunicator::MAX_OP);
+  if(globalStatus[0])
+    {
+    this->Cache->Clear();
+    this->Cache->InputMTime = input->GetMTime();
+    entry = this->Cache->Entries.end();
+    }
+  else if(globalStatus[1])
     {
-    delete this->Internal;
-    this->Internal = 0;
+    this->Cache->Erase(entry);
+    entry = this->Cache->Entries.end();
     }
 
   // Make sure that an internal object is available
-  this->CreateInternalIfNeeded(input, arrayToProcess);
+  this->Internal = 0;
+  if(entry != this->Cache->Entries.end())
+    {
+    // Move it in front of the most recently used
+    this->Cache->Entries.splice(this->Cache->Entries.begin(),
+                                this->Cache->Entries, entry);
+    this->Internal = entry->Internal;
+    }
+  else
+    {
+    this->CreateInternalIfNeeded(input, arrayToProcess);
+    if(!this->Internal)
+      {
+      return 0;
+      }
+
+    InternalsCache::Entry newEntry;
+    newEntry.ColumnName = columnName;
+    newEntry.SelectedComponent = this->SelectedComponent;
+    newEntry.InvertOrder = orderInverted;
+    newEntry.Internal = this->Internal;
+    this->Cache->Entries.push_front(newEntry);
+    this->Cache->Shrink(this->MaximumNumberOfCachedSorts);
+    }
+
   int realComponent = (!arrayToProcess) ?  0 :
                       this->GetSelectedComponent() % arrayToProcess->GetNumberOfComponents();
   this->Internal->SetSelectedComponent(realComponent);
+  this->Internal->SetPartialSortThreshold(this->PartialSortThreshold);
 
 
   // Manage custom case where sorting occur on a virtual array (process id)
@@ -1606,6 +1948,11 @@ void vtkSortedTableStreamer::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
   os << indent << "Sorting column: "
      << (this->ColumnToSort?this->ColumnToSort:"(none)") << endl;
+  os << indent << "MaximumNumberOfCachedSorts: "
+     << this->MaximumNumberOfCachedSorts << endl;
+  os << indent << "PartialSortThreshold: " << this->PartialSortThreshold << endl;
+  os << indent << "Number of cached sorts: "
+     << this->Cache->Entries.size() << endl;
 }
 
 //----------------------------------------------------------------------------
@@ -1616,30 +1963,15 @@ const char* vtkSortedTableStreamer::GetColumnNameToSort()
 //----------------------------------------------------------------------------
 void vtkSortedTableStreamer::SetColumnNameToSort(const char* columnName)
 {
+  // The internal objects of the previously sorted columns are kept in the
+  // cache and reused if the column is sorted again.
   this->SetColumnToSort(columnName);
-  if(strcmp("vtkOriginalProcessIds", this->GetColumnToSort()) != 0)
-    {
-    if(this->Internal)
-      {
-      delete this->Internal;
-      this->Internal = 0;
-      }
-    }
 }
 //----------------------------------------------------------------------------
 void vtkSortedTableStreamer::SetInvertOrder(int newValue)
 {
-  bool changed = this->InvertOrder != newValue;
-  bool removeInternal = changed &&
-                        strcmp("vtkOriginalProcessIds", this->GetColumnToSort()) != 0;
-
-  if(removeInternal && this->Internal)
-    {
-    delete this->Internal;
-    this->Internal = 0;
-    }
-
-  if(changed)
+  // Each order has its own internal object in the cache
+  if(this->InvertOrder != newValue)
     {
     this->InvertOrder = newValue;
     this->Modified();
@@ -18,6 +18,11 @@
 // This filter is used quickly get a sorted subset of a given vtkTable.
 // By sorted we mean a subset build from a global sort even if some optimisation
 // allow us to skip a global table sorting.
+//
+// The sort of a column is kept and reused for the following block requests,
+// and for the recently sorted columns, until the input is modified. The first
+// blocks are extracted from a partial sort of the rows of each process so
+// that they are available without sorting the whole column.
 
 #ifndef __vtkSortedTableStreamer_h
 #define __vtkSortedTableStreamer_h
@@ -33,7 +38,9 @@ class VTKPVVTKEXTENSIONSRENDERING_EXPORT vtkSortedTableStreamer : public vtkTabl
 private:
   class InternalsBase;
   template<class T> class Internals;
+  class InternalsCache;
   InternalsBase* Internal;
+  InternalsCache* Cache;
 
 public:
   static void PrintInfo(vtkTable* input);
@@ -80,6 +87,22 @@ public:
   void SetInvertOrder(int newValue);
   vtkGetMacro(InvertOrder, int);
 
+  // Description:
+  // Maximum number of sorted columns (for a given component and order) kept
+  // in memory so that sorting again on a recently sorted column does not
+  // require to sort it again. Default is 2.
+  vtkSetClampMacro(MaximumNumberOfCachedSorts, int, 1, VTK_INT_MAX);
+  vtkGetMacro(MaximumNumberOfCachedSorts, int);
+
+  // Description:
+  // Blocks ending before this number of rows are extracted from the first
+  // rows of a partial sort on each process. The whole column is only sorted
+  // once a block further away is requested. Each process sends up to
+  // (Block+1)*BlockSize rows to the merging process in that case.
+  // 0 disables the partial sort. Default is 4096.
+  vtkSetMacro(PartialSortThreshold, vtkIdType);
+  vtkGetMacro(PartialSortThreshold, vtkIdType);
+
 protected:
   vtkSortedTableStreamer();
   ~vtkSortedTableStreamer();
@@ -104,6 +127,8 @@ protected:
   char* ColumnToSort;
   int SelectedComponent;
   int InvertOrder;
+  int MaximumNumberOfCachedSorts;
+  vtkIdType PartialSortThreshold;
 private:
   vtkSortedTableStreamer(const vtkSortedTableStreamer&); // Not implemented
   void operator=(const vtkSortedTableStreamer&);   // Not implemented
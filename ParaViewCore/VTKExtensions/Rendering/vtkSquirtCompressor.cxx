@@ -20,20 +20,296 @@
 #include "vtkObjectFactory.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkMultiProcessStream.h"
+#include "vtkSMPTools.h"
+#include "vtkType.h"
 #include <vtksys/ios/sstream>
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+// Number of pixels of the blocks that are compressed concurrently. Runs
+// never span two blocks, blocks are also the units compared to the previous
+// image in InterFrameMode.
+const vtkIdType SQUIRT_BLOCK_SIZE = 4096;
+
+// First word of the images compressed in InterFrameMode.
+const unsigned int SQUIRT_INTER_FRAME_MAGIC = 0x46495153;
+
+// Number of words of the InterFrameMode header: magic, block size, number of
+// pixels, image index, key image flag and number of blocks sent. The header
+// is followed by the indices of the blocks sent, their number of runs and
+// then the runs themselves.
+const vtkIdType SQUIRT_INTER_FRAME_HEADER_SIZE = 6;
+
+// A complete image is sent at this interval in InterFrameMode, so that a
+// decompressor that missed an image eventually recovers.
+const unsigned int SQUIRT_KEY_FRAME_INTERVAL = 64;
+
+//-----------------------------------------------------------------------------
+// Run length encodes the RGBA pixels [first, last) into out, returns the
+// number of runs written.
+vtkIdType SquirtEncodeRGBA(const unsigned int* in, vtkIdType first,
+  vtkIdType last, unsigned int mask, unsigned int* out)
+{
+  const vtkTypeUInt64 mask2 =
+    (static_cast<vtkTypeUInt64>(mask) << 32) | mask;
+  vtkIdType comp_index = 0;
+  vtkIdType index = first;
+  while (index < last)
+    {
+    unsigned int current_color = in[index++];
+    const unsigned int masked_color = current_color & mask;
+    const vtkTypeUInt64 masked_color2 =
+      (static_cast<vtkTypeUInt64>(masked_color) << 32) | masked_color;
+    unsigned int count = 0;
+
+    // Compute run, comparing two pixels at once while possible.
+    while ((index + 1 < last) && (count + 2 <= 0x7F))
+      {
+      vtkTypeUInt64 pair;
+      memcpy(&pair, in + index, sizeof(pair));
+      if ((pair & mask2) != masked_color2)
+        {
+        break;
+        }
+      index += 2; count += 2;
+      }
+    while ((index < last) && (count < 0x7F) &&
+      ((in[index] & mask) == masked_color))
+      {
+      index++; count++;
+      }
+    if (*(((unsigned char*)&current_color)+3) > 0)
+      {
+      count |= 0x80;
+      }
+
+    // Record color and run length
+    out[comp_index] = current_color;
+    *((unsigned char*)(out + comp_index) + 3) = (unsigned char)count;
+    comp_index++;
+    }
+  return comp_index;
+}
+
+//-----------------------------------------------------------------------------
+inline unsigned int SquirtLoadRGB(const unsigned char* in)
+{
+  unsigned int color = 0;
+  unsigned char* p = (unsigned char*)&color;
+  p[0] = in[0];
+  p[1] = in[1];
+  p[2] = in[2];
+  return color;
+}
+
+//-----------------------------------------------------------------------------
+// Run length encodes the RGB pixels [first, last) into out, returns the
+// number of runs written.
+vtkIdType SquirtEncodeRGB(const unsigned char* in, vtkIdType first,
+  vtkIdType last, unsigned int mask, unsigned int* out)
+{
+  vtkIdType comp_index = 0;
+  vtkIdType index = first;
+  while (index < last)
+    {
+    unsigned int current_color = SquirtLoadRGB(in + 3*index);
+    const unsigned int masked_color = current_color & mask;
+    index++;
+
+    // Compute Run
+    unsigned int count = 0;
+    while ((index < last) && (count < 255) &&
+      ((SquirtLoadRGB(in + 3*index) & mask) == masked_color))
+      {
+      index++; count++;
+      }
+
+    // Record color and run length
+    out[comp_index] = current_color;
+    *((unsigned char*)(out + comp_index) + 3) = (unsigned char)count;
+    comp_index++;
+    }
+  return comp_index;
+}
+
+//-----------------------------------------------------------------------------
+// Expands numRuns runs into out, without writing past out + size. Returns
+// the number of pixels written.
+vtkIdType SquirtDecode(const unsigned int* runs, vtkIdType numRuns,
+  bool rgba, unsigned int* out, vtkIdType size)
+{
+  vtkIdType index = 0;
+  for (vtkIdType i = 0; i < numRuns && index < size; i++)
+    {
+    // Get color and run length count
+    unsigned int current_color = runs[i];
+    int count = *((unsigned char*)&current_color+3);
+
+    if (rgba)
+      {
+      *((unsigned char*)&current_color+3) = (count & 0x80) != 0? 0xff : 0;
+      count &= 0x7f;
+      }
+    else
+      {
+      *((unsigned char*)&current_color+3) = 0xff;
+      }
+
+    // Blast color into color buffer
+    vtkIdType end = std::min(index + count + 1, size);
+    std::fill(out + index, out + end, current_color);
+    index = end;
+    }
+  return index;
+}
+}
+
+//-----------------------------------------------------------------------------
+class vtkSquirtCompressor::vtkInternals
+{
+public:
+  vtkInternals()
+    : HasPreviousInput(false),
+      PreviousNumberOfComponents(0),
+      PreviousLevel(0),
+      FrameIndex(0),
+      HasPreviousOutput(false),
+      PreviousOutputIndex(0)
+    {
+    }
+
+  // Compresses the blocks [begin, end) into their slot of Runs. When
+  // Previous is set, it is updated with the input, and the blocks that did
+  // not change are skipped if Compare is set.
+  class BlockEncoder
+  {
+  public:
+    const unsigned char* Input;
+    int NumberOfComponents;
+    vtkIdType NumberOfPixels;
+    unsigned int Mask;
+    unsigned int* Runs;
+    vtkIdType* RunCounts;
+    unsigned char* Previous;
+    bool Compare;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      for (vtkIdType block = begin; block < end; ++block)
+        {
+        vtkIdType first = block * SQUIRT_BLOCK_SIZE;
+        vtkIdType last = std::min(first + SQUIRT_BLOCK_SIZE,
+          this->NumberOfPixels);
+        if (this->Previous)
+          {
+          size_t offset = static_cast<size_t>(first) * this->NumberOfComponents;
+          size_t length =
+            static_cast<size_t>(last - first) * this->NumberOfComponents;
+          if (this->Compare &&
+            memcmp(this->Previous + offset, this->Input + offset, length) == 0)
+            {
+            this->RunCounts[block] = 0;
+            continue;
+            }
+          memcpy(this->Previous + offset, this->Input + offset, length);
+          }
+        this->RunCounts[block] = this->NumberOfComponents == 4?
+          SquirtEncodeRGBA(reinterpret_cast<const unsigned int*>(this->Input),
+            first, last, this->Mask, this->Runs + first) :
+          SquirtEncodeRGB(this->Input, first, last, this->Mask,
+            this->Runs + first);
+        }
+      }
+  };
+
+  // Copies the runs of the blocks sent to their place in the output.
+  class BlockCopier
+  {
+  public:
+    const unsigned int* Runs;
+    const vtkIdType* RunCounts;
+    const unsigned int* Blocks;
+    const vtkIdType* Offsets;
+    unsigned int* Output;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      for (vtkIdType i = begin; i < end; ++i)
+        {
+        vtkIdType block = this->Blocks[i];
+        memcpy(this->Output + this->Offsets[i],
+          this->Runs + block * SQUIRT_BLOCK_SIZE,
+          this->RunCounts[block] * sizeof(unsigned int));
+        }
+      }
+  };
+
+  // Expands the runs of the blocks received into Output.
+  class BlockDecoder
+  {
+  public:
+    const unsigned int* Runs;
+    const unsigned int* Blocks;
+    const unsigned int* RunCounts;
+    const vtkIdType* Offsets;
+    bool RGBA;
+    unsigned int* Output;
+    vtkIdType NumberOfPixels;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      for (vtkIdType i = begin; i < end; ++i)
+        {
+        vtkIdType first = this->Blocks[i] * SQUIRT_BLOCK_SIZE;
+        vtkIdType size = std::min(SQUIRT_BLOCK_SIZE,
+          this->NumberOfPixels - first);
+        SquirtDecode(this->Runs + this->Offsets[i], this->RunCounts[i],
+          this->RGBA, this->Output + first, size);
+        }
+      }
+  };
+
+  // Compression scratch space, holds the runs of each block at the offset
+  // of its first pixel.
+  std::vector<unsigned int> Runs;
+  std::vector<vtkIdType> RunCounts;
+  std::vector<unsigned int> Blocks;
+  std::vector<vtkIdType> Offsets;
+
+  // Last image compressed in InterFrameMode.
+  std::vector<unsigned char> PreviousInput;
+  bool HasPreviousInput;
+  int PreviousNumberOfComponents;
+  int PreviousLevel;
+  unsigned int FrameIndex;
+
+  // Last image decompressed in InterFrameMode.
+  std::vector<unsigned int> PreviousOutput;
+  bool HasPreviousOutput;
+  unsigned int PreviousOutputIndex;
+};
+
 vtkStandardNewMacro(vtkSquirtCompressor);
 
 
 //-----------------------------------------------------------------------------
 vtkSquirtCompressor::vtkSquirtCompressor()
     :
-  SquirtLevel(3)
-{}
+  SquirtLevel(3),
+  InterFrameMode(0)
+{
+  this->Internals = new vtkInternals;
+}
 
 //-----------------------------------------------------------------------------
 vtkSquirtCompressor::~vtkSquirtCompressor()
-{}
+{
+  delete this->Internals;
+}
 
 //-----------------------------------------------------------------------------
 int vtkSquirtCompressor::Compress()
@@ -52,12 +328,7 @@ int vtkSquirtCompressor::Compress()
     return VTK_ERROR;
     }
 
-  int count=0;
-  int index=0;
-  int comp_index=0;
-  int end_index;
   int compress_level = this->LossLessMode?0:this->SquirtLevel;
-  unsigned int current_color;
   unsigned char compress_masks[6][4] = {  {0xFF, 0xFF, 0xFF, 0xFF},
       {0xFE, 0xFF, 0xFE, 0xFF},
       {0xFC, 0xFE, 0xFC, 0xFF},
@@ -77,96 +348,112 @@ int vtkSquirtCompressor::Compress()
   // I shifted the level by one so that 0 means no compression.
   memcpy(&compress_mask, &compress_masks[compress_level], 4);
 
-  // Access raw arrays directly
-  if (input->GetNumberOfComponents() == 4)
-    {
-    unsigned int* _rawColorBuffer;
-    unsigned int* _rawCompressedBuffer;
-    int numPixels = input->GetNumberOfTuples();
-    _rawColorBuffer = (unsigned int*)input->GetPointer(0);
-    _rawCompressedBuffer = (unsigned int*)this->Output->WritePointer(0,numPixels*4);
-    end_index = numPixels;
-
-    // Go through color buffer and put RLE format into compressed buffer
-    while((index < end_index) && (comp_index < end_index)) 
-      {
+  vtkInternals* internals = this->Internals;
+  int numComponents = input->GetNumberOfComponents();
+  vtkIdType numPixels = input->GetNumberOfTuples();
+  vtkIdType numBlocks = (numPixels + SQUIRT_BLOCK_SIZE - 1)/SQUIRT_BLOCK_SIZE;
 
-      // Record color
-      current_color = _rawCompressedBuffer[comp_index] =_rawColorBuffer[index];
-      index++;
+  // A key image is sent when the decompressor can't have the previous one
+  // or when the runs would differ from the ones of the previous image.
+  bool keyFrame = true;
+  if (this->InterFrameMode)
+    {
+    keyFrame = !internals->HasPreviousInput
+      || internals->PreviousInput.size()
+        != static_cast<size_t>(numPixels * numComponents)
+      || internals->PreviousNumberOfComponents != numComponents
+      || internals->PreviousLevel != compress_level
+      || internals->FrameIndex % SQUIRT_KEY_FRAME_INTERVAL == 0;
+    internals->PreviousInput.resize(numPixels * numComponents);
+    }
+  else
+    {
+    internals->HasPreviousInput = false;
+    }
 
-      // Compute Run
-      while((index<end_index) && (count<0x7F) &&
-        ((current_color&compress_mask) == (_rawColorBuffer[index]&compress_mask)))
-        { 
-        index++; count++;   
-        }
-      if (*(((unsigned char*)&current_color)+3) > 0)
+  // Compress the blocks concurrently, each one into its own slot, a block
+  // never has more runs than pixels.
+  internals->Runs.resize(numPixels);
+  internals->RunCounts.resize(numBlocks);
+  vtkInternals::BlockEncoder encoder;
+  encoder.Input = input->GetPointer(0);
+  encoder.NumberOfComponents = numComponents;
+  encoder.NumberOfPixels = numPixels;
+  encoder.Mask = compress_mask;
+  encoder.Runs = numPixels? &internals->Runs[0] : NULL;
+  encoder.RunCounts = numBlocks? &internals->RunCounts[0] : NULL;
+  encoder.Previous = (this->InterFrameMode && numPixels)?
+    &internals->PreviousInput[0] : NULL;
+  encoder.Compare = !keyFrame;
+  vtkSMPTools::For(0, numBlocks, 1, encoder);
+
+  // Lay out the blocks to send, unchanged blocks have no runs.
+  internals->Blocks.clear();
+  internals->Offsets.clear();
+  vtkIdType headerSize = 0;
+  if (this->InterFrameMode)
+    {
+    for (vtkIdType block = 0; block < numBlocks; ++block)
+      {
+      if (internals->RunCounts[block] > 0)
         {
-        count |= 0x80;
+        internals->Blocks.push_back(static_cast<unsigned int>(block));
         }
-
-      // Record Run length
-      *((unsigned char*)_rawCompressedBuffer+comp_index*4+3) =(unsigned char)count;
-      comp_index++;
-
-      count = 0;
-
       }
+    headerSize = SQUIRT_INTER_FRAME_HEADER_SIZE
+      + 2 * static_cast<vtkIdType>(internals->Blocks.size());
     }
-  else if (input->GetNumberOfComponents() == 3)
+  else
     {
-    unsigned char* _rawColorBuffer;
-    unsigned int* _rawCompressedBuffer;
-    int numPixels = input->GetNumberOfTuples();
-    _rawColorBuffer = (unsigned char*)input->GetPointer(0);
-    _rawCompressedBuffer = (unsigned int*)this->Output->WritePointer(0,numPixels*4);
-    end_index = numPixels;
-
-    // Go through color buffer and put RLE format into compressed buffer
-    while((index < 3*numPixels) && (comp_index < end_index)) 
+    internals->Blocks.resize(numBlocks);
+    for (vtkIdType block = 0; block < numBlocks; ++block)
       {
+      internals->Blocks[block] = static_cast<unsigned int>(block);
+      }
+    }
+  vtkIdType numBlocksSent = static_cast<vtkIdType>(internals->Blocks.size());
+  vtkIdType comp_index = headerSize;
+  internals->Offsets.resize(numBlocksSent);
+  for (vtkIdType i = 0; i < numBlocksSent; ++i)
+    {
+    internals->Offsets[i] = comp_index;
+    comp_index += internals->RunCounts[internals->Blocks[i]];
+    }
 
-      int next_color = 0;
-      // Record color
-      unsigned char* p = (unsigned char*)&current_color;
-      *p++ = _rawColorBuffer[index];
-      *p++ = _rawColorBuffer[index+1];
-      *p++ = _rawColorBuffer[index+2];
-      *p = 0x0;
-      
-      _rawCompressedBuffer[comp_index] = current_color;
-      index+=3;
-      
-      p = (unsigned char*)&next_color;
-      *p++ = _rawColorBuffer[index];
-      *p++ = _rawColorBuffer[index+1];
-      *p++ = _rawColorBuffer[index+2];
-      *p = 0x0;
-    
-      // Compute Run
-      while(((current_color&compress_mask) == (next_color&compress_mask)) &&
-        (index < 3*numPixels) && (count<255))
-        { 
-        index+=3; count++;   
-        if (index < 3*numPixels)
-          {
-          p = (unsigned char*)&next_color;
-          *p++ = _rawColorBuffer[index];
-          *p++ = _rawColorBuffer[index+1];
-          *p++ = _rawColorBuffer[index+2];
-          *p = 0x0;
-          }
-        }
-
-      // Record Run length
-      *((unsigned char*)_rawCompressedBuffer+comp_index*4+3) =(unsigned char)count;
-      comp_index++;
-
-      count = 0;
+  unsigned int* _rawCompressedBuffer =
+    (unsigned int*)this->Output->WritePointer(0, 4*std::max(comp_index,
+        static_cast<vtkIdType>(1)));
+  if (this->InterFrameMode)
+    {
+    _rawCompressedBuffer[0] = SQUIRT_INTER_FRAME_MAGIC;
+    _rawCompressedBuffer[1] = static_cast<unsigned int>(SQUIRT_BLOCK_SIZE);
+    _rawCompressedBuffer[2] = static_cast<unsigned int>(numPixels);
+    _rawCompressedBuffer[3] = internals->FrameIndex;
+    _rawCompressedBuffer[4] = keyFrame? 1 : 0;
+    _rawCompressedBuffer[5] = static_cast<unsigned int>(numBlocksSent);
+    unsigned int* blocks = _rawCompressedBuffer + SQUIRT_INTER_FRAME_HEADER_SIZE;
+    unsigned int* counts = blocks + numBlocksSent;
+    for (vtkIdType i = 0; i < numBlocksSent; ++i)
+      {
+      blocks[i] = internals->Blocks[i];
+      counts[i] =
+        static_cast<unsigned int>(internals->RunCounts[internals->Blocks[i]]);
       }
+
+    internals->HasPreviousInput = true;
+    internals->PreviousNumberOfComponents = numComponents;
+    internals->PreviousLevel = compress_level;
+    internals->FrameIndex++;
     }
 
+  vtkInternals::BlockCopier copier;
+  copier.Runs = encoder.Runs;
+  copier.RunCounts = encoder.RunCounts;
+  copier.Blocks = numBlocksSent? &internals->Blocks[0] : NULL;
+  copier.Offsets = numBlocksSent? &internals->Offsets[0] : NULL;
+  copier.Output = _rawCompressedBuffer;
+  vtkSMPTools::For(0, numBlocksSent, 16, copier);
+
   // Back to vtk arrays :)
   this->Output->SetNumberOfComponents(1);
   this->Output->SetNumberOfTuples(4*comp_index);
@@ -185,45 +472,100 @@ int vtkSquirtCompressor::Decompress()
 
   vtkUnsignedCharArray* in = this->GetInput();
   vtkUnsignedCharArray* out = this->GetOutput();
-  int count=0;
-  int index=0;
-  unsigned int current_color;
-  unsigned int* _rawColorBuffer;
-  unsigned int* _rawCompressedBuffer;
+  bool rgba = out->GetNumberOfComponents() == 4;
 
-  // Get compressed buffer size
-  int CompSize = in->GetNumberOfTuples()/4; /// NOTE 1->4
+  // Get compressed and color buffer sizes
+  vtkIdType CompSize = in->GetNumberOfTuples()/4; /// NOTE 1->4
+  vtkIdType ColorSize =
+    out->GetNumberOfTuples()*out->GetNumberOfComponents()/4;
 
   // Access raw arrays directly
-  _rawColorBuffer = (unsigned int*)out->GetPointer(0);
-  _rawCompressedBuffer = (unsigned int*)in->GetPointer(0);
+  unsigned int* _rawColorBuffer = (unsigned int*)out->GetPointer(0);
+  const unsigned int* _rawCompressedBuffer = (unsigned int*)in->GetPointer(0);
 
-  // Go through compress buffer and extract RLE format into color buffer
-  for(int i=0; i<CompSize; i++)
+  if (!this->InterFrameMode)
     {
-    // Get color and count
-    current_color = _rawCompressedBuffer[i];
+    // Go through compress buffer and extract RLE format into color buffer
+    SquirtDecode(_rawCompressedBuffer, CompSize, rgba, _rawColorBuffer,
+      ColorSize);
+    return VTK_OK;
+    }
 
-    // Get run length count;
-    count = *((unsigned char*)&current_color+3);
+  if (CompSize < SQUIRT_INTER_FRAME_HEADER_SIZE
+    || _rawCompressedBuffer[0] != SQUIRT_INTER_FRAME_MAGIC
+    || _rawCompressedBuffer[1] != static_cast<unsigned int>(SQUIRT_BLOCK_SIZE))
+    {
+    vtkErrorMacro("Image was not compressed in InterFrameMode.");
+    return VTK_ERROR;
+    }
 
-    if (out->GetNumberOfComponents() == 4)
+  vtkInternals* internals = this->Internals;
+  vtkIdType numPixels = _rawCompressedBuffer[2];
+  unsigned int frameIndex = _rawCompressedBuffer[3];
+  bool keyFrame = _rawCompressedBuffer[4] != 0;
+  vtkIdType numBlocksSent = _rawCompressedBuffer[5];
+  vtkIdType numBlocks = (numPixels + SQUIRT_BLOCK_SIZE - 1)/SQUIRT_BLOCK_SIZE;
+  if (numPixels > ColorSize || numBlocksSent > numBlocks
+    || (keyFrame && numBlocksSent != numBlocks)
+    || CompSize < SQUIRT_INTER_FRAME_HEADER_SIZE + 2*numBlocksSent)
+    {
+    vtkErrorMacro("Compressed image does not fit the output.");
+    return VTK_ERROR;
+    }
+  if (!keyFrame && (!internals->HasPreviousOutput
+      || internals->PreviousOutput.size() != static_cast<size_t>(numPixels)
+      || internals->PreviousOutputIndex + 1 != frameIndex))
+    {
+    // The blocks that were not sent can't be restored, wait for the next
+    // key image.
+    vtkWarningMacro("Image " << frameIndex
+      << " does not follow the last decompressed image, it is skipped.");
+    internals->HasPreviousOutput = false;
+    return VTK_ERROR;
+    }
+
+  const unsigned int* blocks =
+    _rawCompressedBuffer + SQUIRT_INTER_FRAME_HEADER_SIZE;
+  const unsigned int* counts = blocks + numBlocksSent;
+  vtkIdType comp_index = SQUIRT_INTER_FRAME_HEADER_SIZE + 2*numBlocksSent;
+  internals->Offsets.resize(numBlocksSent);
+  for (vtkIdType i = 0; i < numBlocksSent; ++i)
+    {
+    if (blocks[i] >= static_cast<unsigned int>(numBlocks))
       {
-      *((unsigned char*)&current_color+3) = (count & 0x80) != 0? 0xff : 0;
-      count &= 0x7f;
+      vtkErrorMacro("Invalid block index " << blocks[i] << ".");
+      internals->HasPreviousOutput = false;
+      return VTK_ERROR;
       }
-    else
-      {
-      *((unsigned char*)&current_color+3) = 0xff;
-      }
-
-    // Set color
-    _rawColorBuffer[index++] = current_color;
+    internals->Offsets[i] = comp_index;
+    comp_index += counts[i];
+    }
+  if (comp_index > CompSize)
+    {
+    vtkErrorMacro("Compressed image is truncated.");
+    internals->HasPreviousOutput = false;
+    return VTK_ERROR;
+    }
 
-    // Blast color into color buffer
-    for(int j=0; j< count; j++)
-      _rawColorBuffer[index++] = current_color;
+  // Expand the blocks received over the previous image, concurrently.
+  internals->PreviousOutput.resize(numPixels);
+  vtkInternals::BlockDecoder decoder;
+  decoder.Runs = _rawCompressedBuffer;
+  decoder.Blocks = blocks;
+  decoder.RunCounts = counts;
+  decoder.Offsets = numBlocksSent? &internals->Offsets[0] : NULL;
+  decoder.RGBA = rgba;
+  decoder.Output = numPixels? &internals->PreviousOutput[0] : NULL;
+  decoder.NumberOfPixels = numPixels;
+  vtkSMPTools::For(0, numBlocksSent, 1, decoder);
+
+  if (numPixels)
+    {
+    memcpy(_rawColorBuffer, &internals->PreviousOutput[0],
+      numPixels*sizeof(unsigned int));
     }
+  internals->HasPreviousOutput = true;
+  internals->PreviousOutputIndex = frameIndex;
   return VTK_OK;
 }
 
@@ -232,7 +574,8 @@ void vtkSquirtCompressor::SaveConfiguration(vtkMultiProcessStream *stream)
 {
   vtkImageCompressor::SaveConfiguration(stream);
   *stream
-    << this->SquirtLevel;
+    << this->SquirtLevel
+    << this->InterFrameMode;
 }
 
 //-----------------------------------------------------------------------------
@@ -241,7 +584,8 @@ bool vtkSquirtCompressor::RestoreConfiguration(vtkMultiProcessStream *stream)
   if (vtkImageCompressor::RestoreConfiguration(stream))
     {
     *stream
-      >> this->SquirtLevel;
+      >> this->SquirtLevel
+      >> this->InterFrameMode;
     return true;
     }
   return false;
@@ -255,6 +599,12 @@ const char *vtkSquirtCompressor::SaveConfiguration()
     << vtkImageCompressor::SaveConfiguration()
     << " "
     << this->SquirtLevel;
+  // InterFrameMode is optional so that the default configuration is
+  // unchanged.
+  if (this->InterFrameMode)
+    {
+    oss << " " << this->InterFrameMode;
+    }
 
   this->SetConfiguration(oss.str().c_str());
 
@@ -269,7 +619,18 @@ const char *vtkSquirtCompressor::RestoreConfiguration(const char *stream)
     {
     std::istringstream iss(stream);
     iss >> this->SquirtLevel;
-    return stream+iss.tellg();
+    std::streamoff pos = iss.tellg();
+    int interFrameMode = 0;
+    if (iss >> interFrameMode)
+      {
+      pos = iss.tellg();
+      }
+    else
+      {
+      interFrameMode = 0;
+      }
+    this->InterFrameMode = interFrameMode;
+    return pos < 0? stream+strlen(stream) : stream+pos;
     }
   return 0;
 }
@@ -279,4 +640,5 @@ void vtkSquirtCompressor::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "SquirtLevel: " << this->SquirtLevel << endl;
+  os << indent << "InterFrameMode: " << this->InterFrameMode << endl;
 }
@@ -39,6 +39,11 @@
 // example when a run starts in one actor whose reduced color matches the
 // background the background is colored with the actor color.
 //
+// The image is split in blocks of consecutive pixels that are compressed
+// concurrently, runs never span two blocks. In InterFrameMode the blocks
+// are also compared to the previously compressed image and only the ones
+// that changed are sent.
+//
 // .SECTION Thanks
 // Thanks to Sandia National Laboratories for this compression technique
 
@@ -64,6 +69,17 @@ public:
   vtkSetClampMacro(SquirtLevel, int, 0, 5);
   vtkGetMacro(SquirtLevel, int);
 
+  // Description:
+  // When set, only the blocks of pixels that changed since the previous
+  // image are compressed and sent. The decompressor restores the others from
+  // the previous image it decompressed, hence every compressed image must be
+  // decompressed, in order, by a single decompressor that has this mode set
+  // as well. A complete key image is sent when the size of the image or the
+  // compression level changes, and periodically. Off by default.
+  vtkSetMacro(InterFrameMode, int);
+  vtkGetMacro(InterFrameMode, int);
+  vtkBooleanMacro(InterFrameMode, int);
+
   // Description:
   // Compress/Decompress data array on the objects input with results
   // in the objects output. See also Set/GetInput/Output.
@@ -84,8 +100,14 @@ protected:
   virtual ~vtkSquirtCompressor();
 
   int SquirtLevel;
+  int InterFrameMode;
 
 private:
+  //BTX
+  class vtkInternals;
+  vtkInternals* Internals;
+  //ETX
+
   vtkSquirtCompressor(const vtkSquirtCompressor&); // Not implemented.
   void operator=(const vtkSquirtCompressor&); // Not implemented.
 };
@@ -0,0 +1,102 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    BenchmarkIntegrateAttributes.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Reports the time to integrate the same amount of cells per rank with
+// vtkIntegrateAttributes and checks the global sums. Run with increasing
+// number of ranks to get the time against rank count, it should not grow
+// with the number of ranks.
+
+#include <mpi.h>
+
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkIntegrateAttributes.h"
+#include "vtkMPIController.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkTimerLog.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+#include <cstdlib>
+
+int main(int argc, char* argv[])
+{
+  MPI_Init(&argc, &argv);
+
+  vtkNew<vtkMPIController> controller;
+  controller->Initialize(&argc, &argv, 1);
+  vtkMultiProcessController::SetGlobalController(controller.GetPointer());
+
+  int rank = controller->GetLocalProcessId();
+  int nranks = controller->GetNumberOfProcesses();
+  const int iterations = 5;
+  const int resolution = 64;
+
+  // Each rank has its own block of the same size along x.
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(resolution, resolution, resolution);
+  image->SetOrigin(rank * (resolution - 1), 0, 0);
+  image->SetSpacing(1, 1, 1);
+  vtkNew<vtkDoubleArray> density;
+  density->SetName("Density");
+  density->SetNumberOfTuples(image->GetNumberOfPoints());
+  density->FillComponent(0, 2.0);
+  image->GetPointData()->AddArray(density.GetPointer());
+
+  vtkNew<vtkIntegrateAttributes> integrate;
+  integrate->SetController(controller.GetPointer());
+  integrate->SetInputData(image.GetPointer());
+
+  vtkNew<vtkTimerLog> timer;
+  controller->Barrier();
+  timer->StartTimer();
+  for (int cc=0; cc < iterations; cc++)
+    {
+    integrate->Modified();
+    integrate->Update();
+    }
+  timer->StopTimer();
+
+  double local = timer->GetElapsedTime() / iterations;
+  double global = 0.0;
+  controller->Reduce(&local, &global, 1, vtkCommunicator::MAX_OP, 0);
+
+  int retVal = EXIT_SUCCESS;
+  if (rank == 0)
+    {
+    cout << "Ranks: " << nranks
+         << " Cells per rank: " << image->GetNumberOfCells()
+         << " Integrate: " << global << " s" << endl;
+
+    double volume = static_cast<double>(nranks) *
+      (resolution - 1) * (resolution - 1) * (resolution - 1);
+    vtkUnstructuredGrid* output = integrate->GetOutput();
+    vtkDataArray* volumeArray = output->GetCellData()->GetArray("Volume");
+    vtkDataArray* densityArray = output->GetPointData()->GetArray("Density");
+    if (!volumeArray || !densityArray ||
+      fabs(volumeArray->GetTuple1(0) - volume) > 1e-6 * volume ||
+      fabs(densityArray->GetTuple1(0) - 2.0 * volume) > 1e-6 * volume)
+      {
+      cerr << "ERROR: wrong integrated values, expected a volume of "
+           << volume << "." << endl;
+      retVal = EXIT_FAILURE;
+      }
+    }
+  controller->Broadcast(&retVal, 1, 0);
+
+  controller->Finalize();
+  return retVal;
+}
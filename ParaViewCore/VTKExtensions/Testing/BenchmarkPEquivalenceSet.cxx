@@ -0,0 +1,111 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    BenchmarkPEquivalenceSet.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Reports the time to resolve the same number of fragments per rank with
+// vtkPEquivalenceSet and checks the resolved set ids. Fragments are paired on
+// each rank and the last pair of a rank touches the first pair of the next
+// one. Run with increasing number of ranks, and optionally the number of
+// fragments per rank as argument, to get the time against rank count.
+
+#include <mpi.h>
+
+#include "vtkMPIController.h"
+#include "vtkNew.h"
+#include "vtkPEquivalenceSet.h"
+#include "vtkTimerLog.h"
+
+#include <cstdlib>
+
+int main(int argc, char* argv[])
+{
+  MPI_Init(&argc, &argv);
+
+  vtkNew<vtkMPIController> controller;
+  controller->Initialize(&argc, &argv, 1);
+  vtkMultiProcessController::SetGlobalController(controller.GetPointer());
+
+  int rank = controller->GetLocalProcessId();
+  int nranks = controller->GetNumberOfProcesses();
+  int fragments = 100000;
+  if (argc > 1)
+    {
+    fragments = atoi(argv[1]);
+    }
+  fragments += fragments % 2;
+  const int iterations = 3;
+  int first = rank * fragments;
+
+  vtkNew<vtkPEquivalenceSet> set;
+  double local = 0.0;
+  int numSets = 0;
+  vtkNew<vtkTimerLog> timer;
+  for (int cc=0; cc < iterations; cc++)
+    {
+    set->Initialize();
+    for (int k=0; k < fragments; k += 2)
+      {
+      set->AddEquivalence(first + k, first + k + 1);
+      }
+    if (rank < nranks - 1)
+      {
+      set->AddEquivalence(first + fragments - 1, first + fragments);
+      }
+
+    controller->Barrier();
+    timer->StartTimer();
+    numSets = set->ResolveEquivalences();
+    timer->StopTimer();
+    local += timer->GetElapsedTime() / iterations;
+    }
+
+  // Pair k of this rank is merged with the pairs touching the previous ranks.
+  int errors = 0;
+  int expectedSets = nranks * fragments / 2 - (nranks - 1);
+  if (numSets != expectedSets)
+    {
+    errors++;
+    }
+  for (int k=0; k < fragments; k++)
+    {
+    if (set->GetEquivalentSetId(first + k) !=
+      rank * fragments / 2 + k / 2 - rank)
+      {
+      errors++;
+      }
+    }
+  int totalErrors = 0;
+  controller->Reduce(&errors, &totalErrors, 1, vtkCommunicator::SUM_OP, 0);
+
+  double global = 0.0;
+  controller->Reduce(&local, &global, 1, vtkCommunicator::MAX_OP, 0);
+
+  int retVal = EXIT_SUCCESS;
+  if (rank == 0)
+    {
+    cout << "Ranks: " << nranks
+         << " Fragments per rank: " << fragments
+         << " Sets: " << numSets
+         << " Resolve: " << global << " s" << endl;
+    if (totalErrors > 0)
+      {
+      cerr << "ERROR: " << totalErrors << " wrong set ids, expected "
+           << expectedSets << " sets." << endl;
+      retVal = EXIT_FAILURE;
+      }
+    }
+  controller->Broadcast(&retVal, 1, 0);
+
+  controller->Finalize();
+  return retVal;
+}
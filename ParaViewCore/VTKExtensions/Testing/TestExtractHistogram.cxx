@@ -20,6 +20,37 @@
 #include "vtkSmartPointer.h"
 #include "vtkSphereSource.h"
 #include "vtkIntArray.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+
+// Compares the bin values of an approximate histogram to the exact ones.
+static bool vtkCompareBins(vtkExtractHistogram* approximate,
+  vtkExtractHistogram* exact, int bin_count)
+{
+  approximate->SetBinCount(bin_count);
+  exact->SetBinCount(bin_count);
+  approximate->Update();
+  exact->Update();
+  vtkIntArray* approximate_values = vtkIntArray::SafeDownCast(
+    approximate->GetOutput()->GetRowData()->GetArray("bin_values"));
+  vtkIntArray* exact_values = vtkIntArray::SafeDownCast(
+    exact->GetOutput()->GetRowData()->GetArray("bin_values"));
+  if (!approximate_values || !exact_values ||
+    approximate_values->GetNumberOfTuples() != bin_count)
+    {
+    vtkGenericWarningMacro("bin_values missing.");
+    return false;
+    }
+  for (int i = 0; i < bin_count; i++)
+    {
+    if (approximate_values->GetValue(i) != exact_values->GetValue(i))
+      {
+      vtkGenericWarningMacro("incorrect approximate bin value.");
+      return false;
+      }
+    }
+  return true;
+}
 
 /// Test the output of the vtkExtractHistogram filter in a simple serial case
 int TestExtractHistogram(int, char*[])
@@ -93,5 +124,48 @@ int TestExtractHistogram(int, char*[])
     vtkGenericWarningMacro("incorrect bin value.");
     return 1;
     }
+
+  // Approximate binning is exact when the bin count divides the sketch bin
+  // count, including when the bins are computed again from the sketch.
+  vtkSmartPointer<vtkDoubleArray> values =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  values->SetName("values");
+  values->SetNumberOfTuples(10000);
+  for (vtkIdType i = 0; i < values->GetNumberOfTuples(); i++)
+    {
+    values->SetValue(i, (i * 37) % 100 + 0.25);
+    }
+  vtkSmartPointer<vtkPolyData> points = vtkSmartPointer<vtkPolyData>::New();
+  points->GetPointData()->AddArray(values);
+
+  vtkSmartPointer<vtkExtractHistogram> approximate =
+    vtkSmartPointer<vtkExtractHistogram>::New();
+  vtkSmartPointer<vtkExtractHistogram> exact =
+    vtkSmartPointer<vtkExtractHistogram>::New();
+  vtkExtractHistogram* filters[2] = { approximate, exact };
+  for (int i = 0; i < 2; i++)
+    {
+    filters[i]->SetInputData(points);
+    filters[i]->SetInputArrayToProcess(0, 0, 0,
+      vtkDataObject::FIELD_ASSOCIATION_POINTS, "values");
+    filters[i]->SetUseCustomBinRanges(true);
+    filters[i]->SetCustomBinRanges(0, 100);
+    }
+  approximate->SetUseApproximateBinning(true);
+  approximate->SetSketchBinCount(1000);
+  if (!vtkCompareBins(approximate, exact, 10) ||
+    !vtkCompareBins(approximate, exact, 20) ||
+    !vtkCompareBins(approximate, exact, 100))
+    {
+    return 1;
+    }
+
+  // The sketch is computed again when the array is modified.
+  values->SetValue(0, 99.25);
+  values->Modified();
+  if (!vtkCompareBins(approximate, exact, 10))
+    {
+    return 1;
+    }
   return 0;
 }
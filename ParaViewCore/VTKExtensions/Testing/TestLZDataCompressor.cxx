@@ -0,0 +1,93 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestLZDataCompressor.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVLZDataCompressor.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+static bool vtkTestRoundTrip(vtkPVLZDataCompressor* compressor,
+  const std::vector<unsigned char>& input, const char* name)
+{
+  size_t length = input.size();
+  std::vector<unsigned char> compressed(
+    compressor->GetMaximumCompressionSpace(length));
+  size_t compressed_length = compressor->Compress(
+    length? &input[0] : NULL, length, &compressed[0], compressed.size());
+  if (compressed_length == 0)
+    {
+    cerr << name << ": compression failed." << endl;
+    return false;
+    }
+
+  std::vector<unsigned char> output(length + 1);
+  size_t output_length = compressor->Uncompress(
+    &compressed[0], compressed_length, &output[0], length);
+  cout << name << ": " << length << " -> " << compressed_length << endl;
+  if (output_length != length ||
+    (length > 0 && memcmp(&input[0], &output[0], length) != 0))
+    {
+    cerr << name << ": round trip failed." << endl;
+    return false;
+    }
+  return true;
+}
+
+int TestLZDataCompressor(int, char*[])
+{
+  vtkNew<vtkPVLZDataCompressor> compressor;
+  vtkMath::RandomSeed(1234);
+
+  bool success = vtkTestRoundTrip(compressor.GetPointer(),
+    std::vector<unsigned char>(), "empty");
+
+  std::vector<unsigned char> input(100000);
+  for (size_t cc=0; cc < input.size(); cc++)
+    {
+    input[cc] = static_cast<unsigned char>(vtkMath::Random(0, 256));
+    }
+  success &= vtkTestRoundTrip(compressor.GetPointer(), input, "random");
+
+  for (size_t cc=0; cc < input.size(); cc++)
+    {
+    input[cc] = static_cast<unsigned char>(cc / 100);
+    }
+  success &= vtkTestRoundTrip(compressor.GetPointer(), input, "runs");
+
+  std::vector<float> values(input.size() / sizeof(float));
+  for (size_t cc=0; cc < values.size(); cc++)
+    {
+    values[cc] = static_cast<float>(sin(cc * 0.01));
+    }
+  memcpy(&input[0], &values[0], values.size() * sizeof(float));
+  success &= vtkTestRoundTrip(compressor.GetPointer(), input, "floats");
+
+  // Truncated streams must be rejected.
+  std::vector<unsigned char> compressed(
+    compressor->GetMaximumCompressionSpace(input.size()));
+  size_t compressed_length = compressor->Compress(
+    &input[0], input.size(), &compressed[0], compressed.size());
+  std::vector<unsigned char> output(input.size());
+  if (compressor->Uncompress(&compressed[0], compressed_length / 2,
+      &output[0], output.size()) == input.size())
+    {
+    cerr << "truncated stream was not rejected." << endl;
+    success = false;
+    }
+
+  return success? 0 : 1;
+}
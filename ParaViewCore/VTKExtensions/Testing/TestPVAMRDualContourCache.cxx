@@ -0,0 +1,125 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVAMRDualContourCache.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests that changing only the iso value of the AMR dual contour reuses the
+// blocks cached by its dual grid helper, without exchanging ghost values
+// again, and that a new input rebuilds them.
+
+#include "vtkAMRDualGridHelper.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkDataSet.h"
+#include "vtkDummyController.h"
+#include "vtkPVAMRDualContour.h"
+#include "vtkSmartPointer.h"
+#include "vtkSpyPlotReader.h"
+#include "vtkTestUtilities.h"
+
+namespace
+{
+  vtkIdType GetNumberOfPoints(vtkAlgorithm* algorithm)
+    {
+    vtkCompositeDataSet* output = vtkCompositeDataSet::SafeDownCast(
+      algorithm->GetOutputDataObject(0));
+    if (output == NULL)
+      {
+      return 0;
+      }
+    vtkIdType numPoints = 0;
+    vtkCompositeDataIterator* iter = output->NewIterator();
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+      iter->GoToNextItem())
+      {
+      vtkDataSet* ds = vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
+      numPoints += ds? ds->GetNumberOfPoints() : 0;
+      }
+    iter->Delete();
+    return numPoints;
+    }
+}
+
+#define CHECK(expr) \
+  if (!(expr)) \
+    { \
+    cerr << "ERROR: Failed at line " << __LINE__ << ": " #expr << endl; \
+    status = EXIT_FAILURE; \
+    }
+
+int TestPVAMRDualContourCache(int argc, char* argv[])
+{
+  const char* fname = vtkTestUtilities::ExpandDataFileName(
+    argc, argv, "Data/SPCTH/Dave_Karelitz_Small/spcth.0");
+
+  vtkSmartPointer<vtkDummyController> controller =
+    vtkSmartPointer<vtkDummyController>::New();
+  vtkMultiProcessController::SetGlobalController(controller);
+
+  vtkSmartPointer<vtkSpyPlotReader> reader =
+    vtkSmartPointer<vtkSpyPlotReader>::New();
+  reader->SetFileName(fname);
+  reader->SetGlobalController(controller);
+  reader->MergeXYZComponentsOn();
+  reader->DownConvertVolumeFractionOn();
+  reader->DistributeFilesOn();
+  reader->SetCellArrayStatus("Material volume fraction - 3", 1);
+  delete [] fname;
+
+  vtkSmartPointer<vtkPVAMRDualContour> contour =
+    vtkSmartPointer<vtkPVAMRDualContour>::New();
+  contour->SetInputConnection(reader->GetOutputPort(0));
+  contour->SetVolumeFractionSurfaceValue(0.1);
+  contour->SetEnableMergePoints(1);
+  contour->SetEnableDegenerateCells(1);
+  contour->SetEnableMultiProcessCommunication(1);
+  contour->AddInputCellArrayToProcess("Material volume fraction - 3");
+  contour->Update();
+
+  int status = EXIT_SUCCESS;
+  vtkAMRDualGridHelper* helper = contour->GetHelper();
+  if (helper == NULL)
+    {
+    cerr << "ERROR: No dual grid helper after the first update." << endl;
+    return EXIT_FAILURE;
+    }
+  CHECK(helper->GetNumberOfBlockBuilds() == 1);
+  CHECK(helper->GetNumberOfGhostExchanges() == 1);
+  vtkIdType numPoints = GetNumberOfPoints(contour);
+  CHECK(numPoints > 0);
+
+  // Only the iso value changes: the blocks and the ghost values are reused.
+  contour->SetVolumeFractionSurfaceValue(0.5);
+  contour->Update();
+  CHECK(contour->GetHelper() == helper);
+  CHECK(helper->GetNumberOfBlockBuilds() == 1);
+  CHECK(helper->GetNumberOfGhostExchanges() == 1);
+  CHECK(GetNumberOfPoints(contour) > 0);
+  CHECK(GetNumberOfPoints(contour) != numPoints);
+
+  // Back to the first iso value, the surface is the same as before.
+  contour->SetVolumeFractionSurfaceValue(0.1);
+  contour->Update();
+  CHECK(helper->GetNumberOfGhostExchanges() == 1);
+  CHECK(GetNumberOfPoints(contour) == numPoints);
+
+  // A new input rebuilds the blocks and exchanges the ghost values again.
+  reader->Modified();
+  contour->Update();
+  CHECK(contour->GetHelper() == helper);
+  CHECK(helper->GetNumberOfBlockBuilds() == 2);
+  CHECK(helper->GetNumberOfGhostExchanges() == 2);
+  CHECK(GetNumberOfPoints(contour) == numPoints);
+
+  vtkMultiProcessController::SetGlobalController(NULL);
+  return status;
+}
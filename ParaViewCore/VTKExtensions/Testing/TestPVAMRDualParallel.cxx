@@ -0,0 +1,175 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVAMRDualParallel.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests that the AMR dual contour and clip filters produce the same output
+// whether the blocks are processed serially or in parallel chunks.
+
+#include "vtkCompositeDataIterator.h"
+#include "vtkDataSet.h"
+#include "vtkDummyController.h"
+#include "vtkIdList.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkPVAMRDualClip.h"
+#include "vtkPVAMRDualContour.h"
+#include "vtkSmartPointer.h"
+#include "vtkSpyPlotReader.h"
+#include "vtkTestUtilities.h"
+
+#include <vector>
+
+namespace
+{
+  void GetDataSets(vtkDataObject* dobj, std::vector<vtkDataSet*>& datasets)
+    {
+    vtkMultiBlockDataSet* mb = vtkMultiBlockDataSet::SafeDownCast(dobj);
+    if (mb == NULL)
+      {
+      return;
+      }
+    vtkCompositeDataIterator* iter = mb->NewIterator();
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+      iter->GoToNextItem())
+      {
+      vtkDataSet* ds = vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
+      if (ds)
+        {
+        datasets.push_back(ds);
+        }
+      }
+    iter->Delete();
+    }
+
+  // Returns true when both outputs have the same points, in the same order,
+  // and the same cells.
+  bool AreIdentical(vtkDataObject* serial, vtkDataObject* parallel)
+    {
+    std::vector<vtkDataSet*> serialDataSets, parallelDataSets;
+    GetDataSets(serial, serialDataSets);
+    GetDataSets(parallel, parallelDataSets);
+    if (serialDataSets.empty() ||
+      serialDataSets.size() != parallelDataSets.size())
+      {
+      return false;
+      }
+    vtkSmartPointer<vtkIdList> serialIds = vtkSmartPointer<vtkIdList>::New();
+    vtkSmartPointer<vtkIdList> parallelIds = vtkSmartPointer<vtkIdList>::New();
+    for (size_t cc=0; cc < serialDataSets.size(); cc++)
+      {
+      vtkDataSet* a = serialDataSets[cc];
+      vtkDataSet* b = parallelDataSets[cc];
+      if (a->GetNumberOfPoints() == 0 ||
+        a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+        a->GetNumberOfCells() != b->GetNumberOfCells())
+        {
+        return false;
+        }
+      for (vtkIdType ptId=0; ptId < a->GetNumberOfPoints(); ptId++)
+        {
+        double pa[3], pb[3];
+        a->GetPoint(ptId, pa);
+        b->GetPoint(ptId, pb);
+        if (pa[0] != pb[0] || pa[1] != pb[1] || pa[2] != pb[2])
+          {
+          return false;
+          }
+        }
+      for (vtkIdType cellId=0; cellId < a->GetNumberOfCells(); cellId++)
+        {
+        a->GetCellPoints(cellId, serialIds);
+        b->GetCellPoints(cellId, parallelIds);
+        if (a->GetCellType(cellId) != b->GetCellType(cellId) ||
+          serialIds->GetNumberOfIds() != parallelIds->GetNumberOfIds())
+          {
+          return false;
+          }
+        for (vtkIdType ii=0; ii < serialIds->GetNumberOfIds(); ii++)
+          {
+          if (serialIds->GetId(ii) != parallelIds->GetId(ii))
+            {
+            return false;
+            }
+          }
+        }
+      }
+    return true;
+    }
+}
+
+int TestPVAMRDualParallel(int argc, char* argv[])
+{
+  const char* fname = vtkTestUtilities::ExpandDataFileName(
+    argc, argv, "Data/SPCTH/Dave_Karelitz_Small/spcth.0");
+
+  vtkSmartPointer<vtkDummyController> controller =
+    vtkSmartPointer<vtkDummyController>::New();
+  vtkMultiProcessController::SetGlobalController(controller);
+
+  vtkSmartPointer<vtkSpyPlotReader> reader =
+    vtkSmartPointer<vtkSpyPlotReader>::New();
+  reader->SetFileName(fname);
+  reader->SetGlobalController(controller);
+  reader->MergeXYZComponentsOn();
+  reader->DownConvertVolumeFractionOn();
+  reader->DistributeFilesOn();
+  reader->SetCellArrayStatus("Material volume fraction - 3", 1);
+  reader->Update();
+  delete [] fname;
+
+  int status = EXIT_SUCCESS;
+
+  // Without merging points, the blocks are processed in chunks. A single
+  // chunk processes them serially.
+  vtkSmartPointer<vtkPVAMRDualContour> contour[2];
+  vtkSmartPointer<vtkPVAMRDualClip> clip[2];
+  for (int cc=0; cc < 2; cc++)
+    {
+    contour[cc] = vtkSmartPointer<vtkPVAMRDualContour>::New();
+    contour[cc]->SetInputConnection(reader->GetOutputPort(0));
+    contour[cc]->SetVolumeFractionSurfaceValue(0.1);
+    contour[cc]->SetEnableMergePoints(0);
+    contour[cc]->SetEnableDegenerateCells(1);
+    contour[cc]->SetEnableMultiProcessCommunication(1);
+    contour[cc]->SetMaximumNumberOfChunks(cc == 0? 1 : 64);
+    contour[cc]->AddInputCellArrayToProcess("Material volume fraction - 3");
+    contour[cc]->Update();
+
+    clip[cc] = vtkSmartPointer<vtkPVAMRDualClip>::New();
+    clip[cc]->SetInputConnection(reader->GetOutputPort(0));
+    clip[cc]->SetVolumeFractionSurfaceValue(0.1);
+    clip[cc]->SetEnableMergePoints(0);
+    clip[cc]->SetEnableDegenerateCells(1);
+    clip[cc]->SetEnableMultiProcessCommunication(1);
+    clip[cc]->SetMaximumNumberOfChunks(cc == 0? 1 : 64);
+    clip[cc]->AddInputCellArrayToProcess("Material volume fraction - 3");
+    clip[cc]->Update();
+    }
+
+  if (!AreIdentical(contour[0]->GetOutputDataObject(0),
+      contour[1]->GetOutputDataObject(0)))
+    {
+    cerr << "ERROR: The contour processed in parallel differs from the "
+         << "serial one." << endl;
+    status = EXIT_FAILURE;
+    }
+  if (!AreIdentical(clip[0]->GetOutputDataObject(0),
+      clip[1]->GetOutputDataObject(0)))
+    {
+    cerr << "ERROR: The clip processed in parallel differs from the "
+         << "serial one." << endl;
+    status = EXIT_FAILURE;
+    }
+
+  vtkMultiProcessController::SetGlobalController(NULL);
+  return status;
+}
@@ -0,0 +1,157 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVGeometryFilterStaticMesh.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkPVGeometryFilter extracts the same surface with and without
+// UseStaticMesh, and that the cached surface follows the points and the
+// attributes of the input.
+
+#include "vtkAppendFilter.h"
+#include "vtkCellArray.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPVGeometryFilter.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+
+// Returns true if the points and the "Temperature" array of the surface
+// are the ones of the input points they come from.
+static bool vtkCheckSurface(vtkPolyData* surface, vtkUnstructuredGrid* input)
+{
+  vtkIdTypeArray* ids = vtkIdTypeArray::SafeDownCast(
+    surface->GetPointData()->GetArray("vtkOriginalPointIds"));
+  vtkDataArray* temperature =
+    surface->GetPointData()->GetArray("Temperature");
+  vtkDataArray* inputTemperature =
+    input->GetPointData()->GetArray("Temperature");
+  if (!ids || !temperature)
+    {
+    cerr << "Missing point arrays." << endl;
+    return false;
+    }
+  for (vtkIdType i=0; i < surface->GetNumberOfPoints(); i++)
+    {
+    double x[3], y[3];
+    surface->GetPoint(i, x);
+    input->GetPoint(ids->GetValue(i), y);
+    if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2] ||
+      temperature->GetTuple1(i) != inputTemperature->GetTuple1(ids->GetValue(i)))
+      {
+      cerr << "Wrong point " << i << "." << endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+static vtkUnstructuredGrid* vtkCreateGrid(int resolution)
+{
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(resolution, resolution, resolution);
+  vtkNew<vtkAppendFilter> append;
+  append->AddInputData(image.GetPointer());
+  append->Update();
+  vtkUnstructuredGrid* grid = vtkUnstructuredGrid::New();
+  grid->ShallowCopy(append->GetOutput());
+
+  vtkNew<vtkDoubleArray> temperature;
+  temperature->SetName("Temperature");
+  temperature->SetNumberOfTuples(grid->GetNumberOfPoints());
+  for (vtkIdType i=0; i < grid->GetNumberOfPoints(); i++)
+    {
+    temperature->SetValue(i, grid->GetPoint(i)[0]);
+    }
+  grid->GetPointData()->AddArray(temperature.GetPointer());
+  return grid;
+}
+
+int TestPVGeometryFilterStaticMesh(int, char*[])
+{
+  bool success = true;
+
+  // Enough cells to extract the surface in several chunks.
+  const int resolution = 61;
+  vtkUnstructuredGrid* grid = vtkCreateGrid(resolution);
+
+  vtkNew<vtkPVGeometryFilter> regular;
+  regular->SetUseOutline(0);
+  regular->SetInputData(grid);
+  regular->Update();
+
+  vtkNew<vtkPVGeometryFilter> cached;
+  cached->SetUseOutline(0);
+  cached->SetUseStaticMesh(true);
+  cached->SetInputData(grid);
+  cached->Update();
+
+  vtkPolyData* expected = vtkPolyData::SafeDownCast(regular->GetOutput());
+  vtkPolyData* surface = vtkPolyData::SafeDownCast(cached->GetOutput());
+  vtkIdType numFaces = 6 * (resolution - 1) * (resolution - 1);
+  if (surface->GetNumberOfPolys() != numFaces ||
+    surface->GetNumberOfPolys() != expected->GetNumberOfPolys() ||
+    surface->GetNumberOfPoints() != expected->GetNumberOfPoints())
+    {
+    cerr << "Expected " << numFaces << " faces, got "
+         << surface->GetNumberOfPolys() << "." << endl;
+    success = false;
+    }
+  success &= vtkCheckSurface(surface, grid);
+  vtkCellArray* polys = surface->GetPolys();
+
+  // Move the points and change the attributes, the cached faces are used.
+  vtkPoints* points = grid->GetPoints();
+  vtkDataArray* temperature = grid->GetPointData()->GetArray("Temperature");
+  for (vtkIdType i=0; i < grid->GetNumberOfPoints(); i++)
+    {
+    double x[3];
+    points->GetPoint(i, x);
+    x[2] = 2.0 * x[2] + sin(x[0]);
+    points->SetPoint(i, x);
+    temperature->SetTuple1(i, x[2]);
+    }
+  points->Modified();
+  temperature->Modified();
+  grid->Modified();
+  cached->Update();
+  surface = vtkPolyData::SafeDownCast(cached->GetOutput());
+  if (surface->GetPolys() != polys)
+    {
+    cerr << "The cached surface was not used." << endl;
+    success = false;
+    }
+  success &= vtkCheckSurface(surface, grid);
+
+  // A new connectivity, the surface is extracted again.
+  grid->Delete();
+  grid = vtkCreateGrid(11);
+  cached->SetInputData(grid);
+  cached->Update();
+  surface = vtkPolyData::SafeDownCast(cached->GetOutput());
+  if (surface->GetNumberOfPolys() != 6 * 10 * 10)
+    {
+    cerr << "Expected " << 6 * 10 * 10 << " faces, got "
+         << surface->GetNumberOfPolys() << "." << endl;
+    success = false;
+    }
+  success &= vtkCheckSurface(surface, grid);
+  grid->Delete();
+
+  return success? 0 : 1;
+}
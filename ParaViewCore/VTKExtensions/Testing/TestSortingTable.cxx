@@ -24,6 +24,8 @@
 #include "vtkMultiProcessController.h"
 #include "vtkDummyController.h"
 
+#include <algorithm>
+#include <vector>
 #include <float.h>
 // ----------------------------------------------------------------------------
 void fillArray(vtkDoubleArray* array, double* dataPointer, int dataSize, const char* name)
@@ -156,6 +158,64 @@ int sortMagnitudeOnUnsignedCharVector()
   return EXIT_SUCCESS;
 }
 
+// ----------------------------------------------------------------------------
+// Make sure that the blocks extracted from the partial sort and the ones
+// extracted after sorting the whole column are consistent, including when
+// switching back to a previously sorted column.
+int sortByBlocks(bool debug)
+{
+  const int size = 10000;
+  const int blockSize = 100;
+  std::vector<double> dataA(size);
+  std::vector<double> dataB(size);
+  for(int i=0;i<size;i++)
+    {
+    dataA[i] = (i * 7919) % 1000;
+    dataB[i] = size - i;
+    }
+  std::vector<double> sortedA(dataA);
+  std::sort(sortedA.begin(), sortedA.end());
+  std::vector<double> sortedB(dataB);
+  std::sort(sortedB.begin(), sortedB.end());
+
+  vtkSmartPointer<vtkDoubleArray> arrayA = vtkSmartPointer<vtkDoubleArray>::New();
+  fillArray(arrayA.GetPointer(), &dataA[0], size, "A");
+  vtkSmartPointer<vtkDoubleArray> arrayB = vtkSmartPointer<vtkDoubleArray>::New();
+  fillArray(arrayB.GetPointer(), &dataB[0], size, "B");
+
+  vtkSmartPointer<vtkTable> input = vtkSmartPointer<vtkTable>::New();
+  input->AddColumn(arrayA);
+  input->AddColumn(arrayB);
+  vtkSmartPointer<vtkSortedTableStreamer> sortingfilter = vtkSmartPointer<vtkSortedTableStreamer>::New();
+
+  sortingfilter->SetInputData(input.GetPointer());
+  sortingfilter->SetSelectedComponent(0);
+  sortingfilter->SetBlockSize(blockSize);
+  sortingfilter->SetPartialSortThreshold(10 * blockSize);
+
+  // Blocks below the threshold are extracted from the partial sort, the
+  // whole column is sorted for block 50 and then reused.
+  const int nbSteps = 7;
+  const char* columns[nbSteps] = { "A", "A", "A", "B", "A", "A", "A" };
+  const int blocks[nbSteps] = { 0, 1, 9, 0, 50, 0, 99 };
+  for(int i=0;i<nbSteps;i++)
+    {
+    sortingfilter->SetColumnNameToSort(columns[i]);
+    sortingfilter->SetBlock(blocks[i]);
+    sortingfilter->Update();
+
+    double* expected = (columns[i][0] == 'A') ? &sortedA[0] : &sortedB[0];
+    if(!compareArray(sortingfilter->GetOutput(), columns[i],
+                     expected + blocks[i] * blockSize, blockSize, debug))
+      {
+      cout << "Invalid block " << blocks[i] << " of " << columns[i] << endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
+
 // ----------------------------------------------------------------------------
 int TestSortingTable(int vtkNotUsed(argc), char **vtkNotUsed(argv))
 {
@@ -179,6 +239,9 @@ int TestSortingTable(int vtkNotUsed(argc), char **vtkNotUsed(argv))
            ? "FAILED" :  "SUCCESS")
        << endl;
   // --------------------------------------------------------------------------
+  cout << "Testing sorting by blocks: "
+       << ((result += sortByBlocks(debug)) ? "FAILED" :  "SUCCESS")
+       << endl;
   // --------------------------------------------------------------------------
 
   // Delete Fake MPI controller
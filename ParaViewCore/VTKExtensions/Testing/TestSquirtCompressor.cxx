@@ -0,0 +1,155 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestSquirtCompressor.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkSquirtCompressor.h"
+#include "vtkNew.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <cstring>
+#include <vector>
+
+// Fills an opaque RGBA image with a gradient background and a box whose
+// position depends on frame.
+static void vtkFillImage(vtkUnsignedCharArray* image, int width, int height,
+  int frame)
+{
+  image->SetNumberOfComponents(4);
+  image->SetNumberOfTuples(width * height);
+  unsigned char* pixels = image->GetPointer(0);
+  for (int j=0; j < height; j++)
+    {
+    for (int i=0; i < width; i++)
+      {
+      unsigned char* pixel = pixels + 4 * (j * width + i);
+      bool inBox = i >= 10 + frame && i < 40 + frame && j >= 20 && j < 50;
+      pixel[0] = static_cast<unsigned char>(inBox? 255 : j % 256);
+      pixel[1] = static_cast<unsigned char>(inBox? (i * 7) % 256 : 32);
+      pixel[2] = static_cast<unsigned char>(inBox? 0 : (i / 64) % 256);
+      pixel[3] = 255;
+      }
+    }
+}
+
+// Compresses input with compressor and decompresses it with decompressor
+// into output.
+static bool vtkRoundTrip(vtkSquirtCompressor* compressor,
+  vtkSquirtCompressor* decompressor, vtkUnsignedCharArray* input,
+  vtkUnsignedCharArray* output)
+{
+  vtkNew<vtkUnsignedCharArray> compressed;
+  compressor->SetInput(input);
+  compressor->SetOutput(compressed.GetPointer());
+  if (compressor->Compress() != VTK_OK)
+    {
+    return false;
+    }
+
+  output->SetNumberOfComponents(4);
+  output->SetNumberOfTuples(input->GetNumberOfTuples());
+  decompressor->SetInput(compressed.GetPointer());
+  decompressor->SetOutput(output);
+  return decompressor->Decompress() == VTK_OK;
+}
+
+static bool vtkCheckRoundTrip(vtkSquirtCompressor* compressor,
+  vtkSquirtCompressor* decompressor, vtkUnsignedCharArray* input,
+  const char* name)
+{
+  vtkNew<vtkUnsignedCharArray> output;
+  if (!vtkRoundTrip(compressor, decompressor, input, output.GetPointer()) ||
+    memcmp(input->GetPointer(0), output->GetPointer(0),
+      4 * input->GetNumberOfTuples()) != 0)
+    {
+    cerr << name << ": round trip failed." << endl;
+    return false;
+    }
+  return true;
+}
+
+int TestSquirtCompressor(int, char*[])
+{
+  bool success = true;
+  vtkNew<vtkUnsignedCharArray> image;
+
+  // Lossless, all the pixels are restored.
+  vtkNew<vtkSquirtCompressor> compressor;
+  vtkNew<vtkSquirtCompressor> decompressor;
+  compressor->SetSquirtLevel(0);
+  for (int frame=0; frame < 3; frame++)
+    {
+    vtkFillImage(image.GetPointer(), 300, 200, frame);
+    success &= vtkCheckRoundTrip(compressor.GetPointer(),
+      decompressor.GetPointer(), image.GetPointer(), "lossless");
+    }
+
+  // InterFrameMode, with unchanged images and a change of size that
+  // requires a key image.
+  vtkNew<vtkSquirtCompressor> interCompressor;
+  vtkNew<vtkSquirtCompressor> interDecompressor;
+  interCompressor->RestoreConfiguration("vtkSquirtCompressor 0 0 1");
+  interDecompressor->RestoreConfiguration(
+    interCompressor->SaveConfiguration());
+  if (!interDecompressor->GetInterFrameMode() ||
+    interDecompressor->GetSquirtLevel() != 0)
+    {
+    cerr << "configuration was not restored." << endl;
+    success = false;
+    }
+  int frames[] = { 0, 1, 1, 5, 5 };
+  int widths[] = { 300, 300, 300, 300, 150 };
+  for (int cc=0; cc < 5; cc++)
+    {
+    vtkFillImage(image.GetPointer(), widths[cc], 200, frames[cc]);
+    success &= vtkCheckRoundTrip(interCompressor.GetPointer(),
+      interDecompressor.GetPointer(), image.GetPointer(), "inter-frame");
+    }
+
+  // Lossy InterFrameMode restores the same pixels as the regular mode.
+  compressor->SetSquirtLevel(3);
+  interCompressor->SetSquirtLevel(3);
+  for (int frame=0; frame < 3; frame++)
+    {
+    vtkFillImage(image.GetPointer(), 300, 200, frame);
+    vtkNew<vtkUnsignedCharArray> expected;
+    vtkNew<vtkUnsignedCharArray> output;
+    if (!vtkRoundTrip(compressor.GetPointer(), decompressor.GetPointer(),
+        image.GetPointer(), expected.GetPointer()) ||
+      !vtkRoundTrip(interCompressor.GetPointer(),
+        interDecompressor.GetPointer(), image.GetPointer(),
+        output.GetPointer()) ||
+      memcmp(expected->GetPointer(0), output->GetPointer(0),
+        4 * image->GetNumberOfTuples()) != 0)
+      {
+      cerr << "lossy inter-frame: round trip failed." << endl;
+      success = false;
+      }
+    }
+
+  // A decompressor that missed an image must not restore the next one.
+  vtkNew<vtkUnsignedCharArray> compressed;
+  interCompressor->SetInput(image.GetPointer());
+  interCompressor->SetOutput(compressed.GetPointer());
+  interCompressor->Compress();
+  vtkFillImage(image.GetPointer(), 300, 200, 4);
+  vtkNew<vtkUnsignedCharArray> output;
+  if (vtkRoundTrip(interCompressor.GetPointer(),
+      interDecompressor.GetPointer(), image.GetPointer(),
+      output.GetPointer()))
+    {
+    cerr << "missing image was not detected." << endl;
+    success = false;
+    }
+
+  return success? 0 : 1;
+}
@@ -38,6 +38,32 @@ TerminationCondition::~TerminationCondition()
   this->ClearPeriodicBC();
 }
 
+//-----------------------------------------------------------------------------
+void TerminationCondition::DeepCopy(const TerminationCondition &other)
+{
+  if (&other==this) return;
+
+  // periodic faces are allocated in pairs, one pair for each
+  // periodic direction.
+  int periodic[3];
+  for (int q=0; q<3; ++q)
+    {
+    periodic[q]=(other.PeriodicBCFaces[2*q]!=0);
+    }
+  this->SetProblemDomain(other.ProblemDomain,periodic);
+  this->WorkingDomain=other.WorkingDomain;
+
+  this->ClearTerminationSurfaces();
+  size_t nSurfaces=other.TerminationSurfaces.size();
+  for (size_t i=0; i<nSurfaces; ++i)
+    {
+    vtkPolyData *pd
+      = vtkPolyData::SafeDownCast(other.TerminationSurfaces[i]->GetDataSet());
+
+    this->PushTerminationSurface(pd,other.TerminationSurfaceNames[i].c_str());
+    }
+}
+
 //-----------------------------------------------------------------------------
 void TerminationCondition::ClearTerminationSurfaces()
 {
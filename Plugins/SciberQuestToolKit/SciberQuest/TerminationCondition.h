@@ -26,6 +26,14 @@ public:
   TerminationCondition();
   virtual ~TerminationCondition();
 
+  /**
+  Copy the problem and working domains, periodic BC's and termination
+  surfaces of another instance. The cell locators are rebuilt so that
+  the copy may be used concurrently with the original. The color
+  mapper is not copied.
+  */
+  void DeepCopy(const TerminationCondition &other);
+
   /**
   Determine if the segment p0->p1 intersects a periodic boundary.
   If so the bc is applied and the face id (1-6) is returned.
@@ -143,6 +151,9 @@ private:
   // Helper, to generate a polygonal box from a set of bounds.
   void DomainToLocator(vtkCellLocator *cellLoc, double dom[6]);
 
+  TerminationCondition(const TerminationCondition &); // not implemented
+  void operator=(const TerminationCondition &); // not implemented
+
 private:
   CartesianBounds ProblemDomain;                    // simulation bounds
   vtkCellLocator *PeriodicBCFaces[6];               // periodic faces
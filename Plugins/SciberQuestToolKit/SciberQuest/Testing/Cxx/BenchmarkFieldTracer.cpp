@@ -0,0 +1,143 @@
+/*
+   ____    _ __           ____               __    ____
+  / __/___(_) /  ___ ____/ __ \__ _____ ___ / /_  /  _/__  ____
+ _\ \/ __/ / _ \/ -_) __/ /_/ / // / -_|_-</ __/ _/ // _ \/ __/
+/___/\__/_/_.__/\__/_/  \___\_\_,_/\__/___/\__/ /___/_//_/\__(_)
+
+Copyright 2012 SciberQuest Inc.
+*/
+#include "vtkMultiProcessController.h"
+#include "vtkSQLog.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkSQBOVMetaReader.h"
+#include "vtkSQFieldTracer.h"
+#include "vtkSQPlaneSource.h"
+#include "vtkDataSet.h"
+#include "TestUtils.h"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Times the field tracer with each of its schedulers, static, master-slave
+// and work stealing, using 1, 2 and 4 threads per process. Run with
+// increasing numbers of processes to compare their scaling. The timings
+// are written to the log. Every run must produce the same total number of
+// lines across processes, otherwise the benchmark fails.
+int BenchmarkFieldTracer(int argc, char *argv[])
+{
+  vtkMultiProcessController *controller=Initialize(&argc,&argv);
+  int worldRank=controller->GetLocalProcessId();
+  int worldSize=controller->GetNumberOfProcesses();
+
+  // configure
+  std::string dataRoot;
+  std::string tempDir;
+  std::string baseline;
+  BroadcastConfiguration(controller,argc,argv,dataRoot,tempDir,baseline);
+
+  std::string inputFileName;
+  inputFileName=dataRoot+"/SciberQuestToolKit/MagneticIslands/MagneticIslands.bov";
+
+  std::string logFileName;
+  logFileName=NativePath(tempDir+"/SciberQuestToolKit-BenchmarkFieldTracer.log");
+  vtkSQLog *log=vtkSQLog::GetGlobalInstance();
+  log->SetFileName(logFileName.c_str());
+  log->SetGlobalLevel(1);
+
+  // ooc reader
+  vtkSQBOVMetaReader *mr=vtkSQBOVMetaReader::New();
+  mr->SetFileName(inputFileName.c_str());
+  mr->SetPointArrayStatus("b",1);
+  mr->SetNumberOfGhostCells(2);
+  mr->SetXHasPeriodicBC(1);
+  mr->SetYHasPeriodicBC(1);
+  mr->SetZHasPeriodicBC(1);
+  mr->SetBlockSize(8,8,8);
+  mr->SetBlockCacheSize(8);
+
+  // seed points
+  vtkSQPlaneSource *p=vtkSQPlaneSource::New();
+  p->SetOrigin(-3.0,-3.0,0.0);
+  p->SetPoint1(3.0,-3.0,0.0);
+  p->SetPoint2(-3.0,3.0,0.0);
+  p->SetResolution(24,24);
+
+  // field tracer
+  vtkSQFieldTracer *ft=vtkSQFieldTracer::New();
+  ft->SetMode(vtkSQFieldTracer::MODE_STREAM);
+  ft->SetIntegratorType(vtkSQFieldTracer::INTEGRATOR_RK4);
+  ft->SetMaxStep(0.01);
+  ft->SetMaxLineLength(300);
+  ft->SetNullThreshold(0.001);
+  ft->SetForwardOnly(0);
+  ft->SetWorkerBlockSize(8);
+  ft->SetMasterBlockSize(2);
+  ft->AddInputConnection(0,mr->GetOutputPort(0));
+  ft->AddInputConnection(1,p->GetOutputPort(0));
+  ft->SetInputArrayToProcess(0,0,0,vtkDataObject::FIELD_ASSOCIATION_POINTS,"b");
+  mr->Delete();
+  p->Delete();
+
+  GetParallelExec(worldRank,worldSize,ft,0.0);
+
+  const char *schedulerNames[3]={"static","master-slave","work-stealing"};
+  const int nThreads[3]={1,2,4};
+  vtkIdType nExpected=-1;
+  int code=0;
+  for (int i=0; i<3; ++i)
+    {
+    for (int j=0; j<3; ++j)
+      {
+      std::ostringstream oss;
+      oss
+        << "BenchmarkFieldTracer::"
+        << schedulerNames[i]
+        << "-np" << worldSize
+        << "-nt" << nThreads[j];
+      std::string eventName=oss.str();
+
+      ft->SetUseDynamicScheduler(i>0);
+      ft->SetUseWorkStealing(i>1);
+      ft->SetNumberOfThreads(nThreads[j]);
+      ft->Modified();
+
+      controller->Barrier();
+      log->StartEvent(eventName.c_str());
+      ft->Update();
+      log->EndEventSynch(eventName.c_str());
+
+      // a scheduler that drops or duplicates seeds changes the total
+      vtkIdType nLocal=ft->GetOutput()->GetNumberOfCells();
+      vtkIdType nTotal=0;
+      controller->AllReduce(&nLocal,&nTotal,1,vtkCommunicator::SUM_OP);
+      if (nExpected<0)
+        {
+        nExpected=nTotal;
+        }
+
+      if (worldRank==0)
+        {
+        std::cerr
+          << eventName << " "
+          << nTotal << " lines"
+          << std::endl;
+        if (nTotal!=nExpected)
+          {
+          std::cerr
+            << "Error: " << eventName << " produced " << nTotal
+            << " lines, expected " << nExpected
+            << std::endl;
+          }
+        }
+      if (nTotal!=nExpected)
+        {
+        code=1;
+        }
+      }
+    }
+
+  ft->Delete();
+
+  return Finalize(controller,code);
+}
@@ -13,6 +13,8 @@ Copyright 2012 SciberQuest Inc.
 #include "vtkMultiProcessController.h"
 #if defined(PARAVIEW_USE_MPI) && !defined(WIN32)
 #include "vtkMPIController.h"
+#include "SQMPICHWarningSupression.h"
+#include <mpi.h>
 #else
 #include "vtkDummyController.h"
 #endif
@@ -89,8 +91,12 @@ vtkMultiProcessController *Initialize(int *argc, char ***argv)
   vtkMultiProcessController *controller;
 
   #if defined(PARAVIEW_USE_MPI) && !defined(WIN32)
+  // the field tracers integrate with more than one thread only
+  // when MPI calls may be made from any thread, one at a time.
+  int threadLevel=MPI_THREAD_SINGLE;
+  MPI_Init_thread(argc,argv,MPI_THREAD_SERIALIZED,&threadLevel);
   controller=vtkMPIController::New();
-  controller->Initialize(argc,argv,0);
+  controller->Initialize(argc,argv,1);
   #else
   (void)argc;
   (void)argv;
@@ -23,6 +23,12 @@ public:
     m_end(size)
      { }
 
+  WorkQueue(int first, int end)
+      :
+    m_at(first),
+    m_end(end)
+     { }
+
   int GetBlock(IdBlock &b, int size)
     {
     if (m_at==m_end)
@@ -38,6 +44,40 @@ public:
     return size;
     }
 
+  /**
+  Remove the back half of the remaining indices and return them in b,
+  provided that more than size indices remain. This is used to hand
+  a portion of the queue over to another process.
+  */
+  int SplitBlock(IdBlock &b, int size)
+    {
+    int n=m_end-m_at;
+    if (n<=size)
+      {
+      b.first()=b.size()=0;
+      return 0;
+      }
+    int half=n/2;
+    m_end-=half;
+    b.first()=m_end;
+    b.size()=half;
+    return half;
+    }
+
+  /**
+  Replace the remaining indices with those of b.
+  */
+  void SetBlock(IdBlock &b)
+    {
+    m_at=(int)b.first();
+    m_end=(int)b.last();
+    }
+
+  /**
+  Return the number of indices remaining.
+  */
+  int GetSize() const { return m_end-m_at; }
+
 private:
   int m_at;
   int m_end;
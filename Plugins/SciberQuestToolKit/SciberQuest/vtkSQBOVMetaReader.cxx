@@ -92,6 +92,8 @@ vtkSQBOVMetaReader::vtkSQBOVMetaReader()
   this->DecompDims[1]=
   this->DecompDims[2]=1;
   this->BlockCacheSize=10;
+  this->BlockCacheRam=0;
+  this->PrefetchDepth=1;
   this->ClearCachedBlocks=1;
   this->BlockSize[0]=
   this->BlockSize[1]=
@@ -125,6 +127,8 @@ void vtkSQBOVMetaReader::Clear()
   this->DecompDims[1]=
   this->DecompDims[2]=1;
   this->BlockCacheSize=10;
+  this->BlockCacheRam=0;
+  this->PrefetchDepth=1;
   this->ClearCachedBlocks=1;
   this->BlockSize[0]=
   this->BlockSize[1]=
@@ -186,6 +190,17 @@ int vtkSQBOVMetaReader::Initialize(
     this->SetBlockCacheSize(block_cache_size);
     }
 
+  int block_cache_ram=0;
+  GetOptionalAttribute<int,1>(elem,"block_cache_ram",&block_cache_ram);
+  if (block_cache_ram>0)
+    {
+    this->SetBlockCacheRam(block_cache_ram);
+    }
+
+  int prefetch_depth=1;
+  GetOptionalAttribute<int,1>(elem,"prefetch_depth",&prefetch_depth);
+  this->SetPrefetchDepth(prefetch_depth);
+
   int periodic_bc[3]={0,0,0};
   GetOptionalAttribute<int,3>(elem,"periodic_bc",periodic_bc);
   this->SetPeriodicBC(periodic_bc);
@@ -216,6 +231,8 @@ int vtkSQBOVMetaReader::Initialize(
       << "#   block_cache_ram_factor=" << this->BlockCacheRamFactor << "\n"
       << "#   decomp_dims=" << Tuple<int>(this->DecompDims,3) << "\n"
       << "#   block_cache_size=" << this->BlockCacheSize << "\n"
+      << "#   block_cache_ram=" << this->BlockCacheRam << "\n"
+      << "#   prefetch_depth=" << this->PrefetchDepth << "\n"
       << "#   periodic_bc=" << Tuple<int>(this->PeriodicBC,3) << "\n"
       << "#   n_ghosts=" << this->NGhosts << "\n"
       << "#   clear_cache=" << this->ClearCachedBlocks << "\n";
@@ -443,6 +460,7 @@ void vtkSQBOVMetaReader::EstimateBlockCacheSize()
       << this->WorldRank
       << " vtkSQBOVMetaReader::BlockCacheSettings"
       << " BlockCacheSize=" << this->BlockCacheSize
+      << " BlockCacheRam=" << this->BlockCacheRam
       << " DecompDims=("
       << this->DecompDims[0] << ", "
       << this->DecompDims[1] << ", "
@@ -888,6 +906,8 @@ int vtkSQBOVMetaReader::RequestData(
   OOCReader->SetTimeIndex(stepId);
   OOCReader->SetDomainDecomp(ddecomp);
   OOCReader->SetBlockCacheSize(this->BlockCacheSize);
+  OOCReader->SetBlockCacheRam(1048576ull*this->BlockCacheRam);
+  OOCReader->SetPrefetchDepth(this->PrefetchDepth);
   OOCReader->SetCloseClearsCachedBlocks(this->ClearCachedBlocks);
   OOCReader->InitializeBlockCache();
   OOCReader->SetLogLevel(this->LogLevel);
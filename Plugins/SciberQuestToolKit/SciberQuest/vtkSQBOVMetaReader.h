@@ -76,6 +76,18 @@ public:
   vtkSetMacro(BlockCacheSize,int);
   vtkGetMacro(BlockCacheSize,int);
 
+  // Description:
+  // Set the amount of ram (in MiB) the block cache may use during
+  // out-of-core operation. If 0 the cache holds BlockCacheSize blocks.
+  vtkSetMacro(BlockCacheRam,int);
+  vtkGetMacro(BlockCacheRam,int);
+
+  // Description:
+  // Set the number of blocks to read ahead of the integration
+  // during out-of-core operation. 0 disables prefetching.
+  vtkSetMacro(PrefetchDepth,int);
+  vtkGetMacro(PrefetchDepth,int);
+
   // Description:
   // Sets the size of the blocks to use during out-of-core
   // operation.
@@ -133,6 +145,8 @@ private:
   int NGhosts;             // number of ghosts cells to load (ooc only)
   int DecompDims[3];       // subset split into an LxMxN cartesian decomposition
   int BlockCacheSize;      // number of blocks to cache during ooc oepration
+  int BlockCacheRam;       // MiB of ram the block cache may use
+  int PrefetchDepth;       // number of blocks to read ahead during ooc operation
   int ClearCachedBlocks;   // control persistence of cahce
   int BlockSize[3];        // size of block in the decomp
   double BlockCacheRamFactor; // % of per-core ram to use for the block cache
@@ -45,6 +45,10 @@ Copyright 2012 SciberQuest Inc.
 #include "vtkRungeKutta4.h"
 #include "vtkRungeKutta45.h"
 #include "vtkMultiProcessController.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
+#include "vtkConditionVariable.h"
+#include "vtkMinimalStandardRandomSequence.h"
 #include "vtkMath.h"
 
 #include "vtkPVInformationKeys.h"
@@ -75,6 +79,8 @@ Copyright 2012 SciberQuest Inc.
 #endif
 
 #include <algorithm>
+#include <vector>
+#include <string>
 
 #ifdef SQTK_DEBUG
 #define vtkSQFieldTracerDEBUG 2
@@ -98,6 +104,341 @@ Copyright 2012 SciberQuest Inc.
 
 const double vtkSQFieldTracer::EPSILON = 1.0E-12;
 
+/// Integration state used by a single thread.
+class FieldTraceWorker
+{
+public:
+  FieldTraceWorker(
+        vtkInitialValueProblemSolver *integrator,
+        TerminationCondition *tcon,
+        int ownsTCon);
+  ~FieldTraceWorker();
+
+  vtkInitialValueProblemSolver *Integrator;
+  vtkInterpolatedVelocityField *Interp; // held by the integrator
+  TerminationCondition *TCon;
+  vtkDataSet *Cache;                    // neighborhood being integrated
+  int OwnsTCon;
+
+private:
+  FieldTraceWorker(const FieldTraceWorker &); // not implemented
+  void operator=(const FieldTraceWorker &); // not implemented
+};
+
+//-----------------------------------------------------------------------------
+FieldTraceWorker::FieldTraceWorker(
+      vtkInitialValueProblemSolver *integrator,
+      TerminationCondition *tcon,
+      int ownsTCon)
+      :
+  Integrator(integrator),
+  Interp(0),
+  TCon(tcon),
+  Cache(0),
+  OwnsTCon(ownsTCon)
+{
+  // forces a read before the first integration.
+  this->TCon->ResetWorkingDomain();
+}
+
+//-----------------------------------------------------------------------------
+FieldTraceWorker::~FieldTraceWorker()
+{
+  this->Integrator->Delete();
+  if (this->Cache)
+    {
+    this->Cache->UnRegister(0);
+    }
+  if (this->OwnsTCon)
+    {
+    delete this->TCon;
+    }
+}
+
+/**
+A pool of threads sharing out the field lines of a block. The calling
+thread takes part in the integration as worker 0, the others wait on a
+condition variable in between blocks. Each worker has its own integrator,
+interpolator and copy of the termination condition, as these are not
+thread safe. Neighborhood reads are serialized.
+*/
+class FieldTraceWorkerPool
+{
+public:
+  FieldTraceWorkerPool(
+        vtkSQFieldTracer *tracer,
+        vtkSQOOCReader *reader,
+        const char *fieldName,
+        TerminationCondition *tcon,
+        int nThreads);
+  ~FieldTraceWorkerPool();
+
+  /**
+  Start the threads on the lines of the given trace data. The caller
+  integrates along side them using worker 0 and then waits for
+  them to finish.
+  */
+  void Start(FieldTraceData *traceData, vtkIdType nLines);
+  void Wait();
+
+  /**
+  Get the id of the next line to integrate. Returns 0 when all lines
+  have been handed out.
+  */
+  int NextLine(vtkIdType &id);
+
+  /**
+  Integrate the line with the given id.
+  */
+  void Integrate(FieldTraceWorker *worker, vtkIdType id);
+
+  FieldTraceWorker *GetWorker(int i){ return this->Workers[i]; }
+  int GetNumberOfThreads() const { return (int)this->Workers.size(); }
+
+private:
+  static VTK_THREAD_RETURN_TYPE Run(void *arg);
+
+private:
+  vtkSQFieldTracer *Tracer;
+  vtkSQOOCReader *Reader;
+  vtkMutexLock *ReaderLock;
+  std::string FieldName;
+  std::vector<FieldTraceWorker*> Workers;
+  vtkMultiThreader *Threader;
+  std::vector<int> ThreadIds;
+
+  // Protects all the members below.
+  vtkMutexLock *Lock;
+  vtkConditionVariable *WorkReady;
+  vtkConditionVariable *WorkDone;
+  FieldTraceData *TraceData;
+  vtkIdType NumberOfLines;
+  vtkIdType NextId;
+  int NumberStarted;
+  int NumberBusy;
+  int Generation;
+  bool Exit;
+};
+
+//-----------------------------------------------------------------------------
+FieldTraceWorkerPool::FieldTraceWorkerPool(
+      vtkSQFieldTracer *tracer,
+      vtkSQOOCReader *reader,
+      const char *fieldName,
+      TerminationCondition *tcon,
+      int nThreads)
+      :
+  Tracer(tracer),
+  Reader(reader),
+  ReaderLock(0),
+  FieldName(fieldName),
+  Threader(0),
+  Lock(0),
+  WorkReady(0),
+  WorkDone(0),
+  TraceData(0),
+  NumberOfLines(0),
+  NextId(0),
+  NumberStarted(0),
+  NumberBusy(0),
+  Generation(0),
+  Exit(false)
+{
+  this->ReaderLock=vtkMutexLock::New();
+  this->Lock=vtkMutexLock::New();
+  this->WorkReady=vtkConditionVariable::New();
+  this->WorkDone=vtkConditionVariable::New();
+
+  nThreads=std::max(1,std::min(nThreads,VTK_MAX_THREADS));
+  for (int i=0; i<nThreads; ++i)
+    {
+    // worker 0 runs in the calling thread and uses the trace data's
+    // termination condition, the others get their own copy.
+    TerminationCondition *workerTCon=tcon;
+    if (i>0)
+      {
+      workerTCon=new TerminationCondition;
+      workerTCon->DeepCopy(*tcon);
+      }
+    this->Workers.push_back(
+        new FieldTraceWorker(tracer->Integrator->NewInstance(),workerTCon,i>0));
+    }
+
+  this->Threader=vtkMultiThreader::New();
+  for (int i=1; i<nThreads; ++i)
+    {
+    this->ThreadIds.push_back(
+        this->Threader->SpawnThread(FieldTraceWorkerPool::Run,this));
+    }
+}
+
+//-----------------------------------------------------------------------------
+FieldTraceWorkerPool::~FieldTraceWorkerPool()
+{
+  this->Lock->Lock();
+  this->Exit=true;
+  this->WorkReady->Broadcast();
+  this->Lock->Unlock();
+
+  size_t nThreads=this->ThreadIds.size();
+  for (size_t i=0; i<nThreads; ++i)
+    {
+    this->Threader->TerminateThread(this->ThreadIds[i]);
+    }
+  this->Threader->Delete();
+
+  size_t nWorkers=this->Workers.size();
+  for (size_t i=0; i<nWorkers; ++i)
+    {
+    delete this->Workers[i];
+    }
+
+  this->ReaderLock->Delete();
+  this->Lock->Delete();
+  this->WorkReady->Delete();
+  this->WorkDone->Delete();
+}
+
+//-----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE FieldTraceWorkerPool::Run(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info
+    = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+
+  FieldTraceWorkerPool *self
+    = static_cast<FieldTraceWorkerPool*>(info->UserData);
+
+  self->Lock->Lock();
+  // worker 0 belongs to the calling thread.
+  self->NumberStarted+=1;
+  FieldTraceWorker *worker=self->Workers[self->NumberStarted];
+  int generation=0;
+  for (;;)
+    {
+    while ((self->Generation==generation) && !self->Exit)
+      {
+      self->WorkReady->Wait(self->Lock);
+      }
+    if (self->Exit)
+      {
+      break;
+      }
+    generation=self->Generation;
+    self->Lock->Unlock();
+
+    vtkIdType id=0;
+    while (self->NextLine(id))
+      {
+      self->Integrate(worker,id);
+      }
+
+    self->Lock->Lock();
+    self->NumberBusy-=1;
+    if (self->NumberBusy==0)
+      {
+      self->WorkDone->Signal();
+      }
+    }
+  self->Lock->Unlock();
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//-----------------------------------------------------------------------------
+void FieldTraceWorkerPool::Start(FieldTraceData *traceData, vtkIdType nLines)
+{
+  this->Lock->Lock();
+  this->TraceData=traceData;
+  this->NumberOfLines=nLines;
+  this->NextId=0;
+  this->NumberBusy=(int)this->ThreadIds.size();
+  this->Generation+=1;
+  this->WorkReady->Broadcast();
+  this->Lock->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+void FieldTraceWorkerPool::Wait()
+{
+  this->Lock->Lock();
+  while (this->NumberBusy)
+    {
+    this->WorkDone->Wait(this->Lock);
+    }
+  this->TraceData=0;
+  this->Lock->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+int FieldTraceWorkerPool::NextLine(vtkIdType &id)
+{
+  int more=0;
+  this->Lock->Lock();
+  if (this->NextId<this->NumberOfLines)
+    {
+    id=this->NextId;
+    this->NextId+=1;
+    more=1;
+    }
+  this->Lock->Unlock();
+  return more;
+}
+
+//-----------------------------------------------------------------------------
+void FieldTraceWorkerPool::Integrate(FieldTraceWorker *worker, vtkIdType id)
+{
+  FieldLine *line=this->TraceData->GetFieldLine(id);
+  this->Tracer->IntegrateOne(
+        this->Reader,
+        this->ReaderLock,
+        this->FieldName.c_str(),
+        line,
+        worker);
+}
+
+#ifndef SQTK_WITHOUT_MPI
+//-----------------------------------------------------------------------------
+static
+void ServiceStealRequests(
+      WorkQueue &Q,
+      int blockSize,
+      int reqTag,
+      int repTag,
+      int &nGiven)
+{
+  // answer all pending requests. The back half of the remaining work
+  // is handed over when there is more than a block left, otherwise
+  // a zero sized block is sent.
+  int pendingReq=0;
+  do
+    {
+    MPI_Status stat;
+    MPI_Iprobe(MPI_ANY_SOURCE,reqTag,MPI_COMM_WORLD,&pendingReq,&stat);
+    if (pendingReq)
+      {
+      int buf;
+      int otherProc=stat.MPI_SOURCE;
+      MPI_Recv(&buf,0,MPI_INT,otherProc,reqTag,MPI_COMM_WORLD,&stat);
+
+      IdBlock sourceIds;
+      if (Q.SplitBlock(sourceIds,blockSize))
+        {
+        nGiven+=1;
+        }
+      // the thief has posted the receive before asking.
+      MPI_Send(
+          sourceIds.data(),
+          (int)sourceIds.dataSize(),
+          MPI_UNSIGNED_LONG_LONG,
+          otherProc,
+          repTag,
+          MPI_COMM_WORLD);
+      }
+    }
+  while (pendingReq);
+}
+#endif
+
 //-----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSQFieldTracer);
 
@@ -107,8 +448,10 @@ vtkSQFieldTracer::vtkSQFieldTracer()
   WorldSize(1),
   WorldRank(0),
   UseDynamicScheduler(0),
+  UseWorkStealing(0),
   WorkerBlockSize(16),
   MasterBlockSize(256),
+  NumberOfThreads(1),
   ForwardOnly(0),
   StepUnit(ARC_LENGTH),
   MinStep(1.0E-8),
@@ -255,6 +598,20 @@ int vtkSQFieldTracer::Initialize(vtkPVXMLElement *root)
     this->SetUseDynamicScheduler(dynamicScheduler);
     }
 
+  int workStealing=-1;
+  GetOptionalAttribute<int,1>(elem,"work_stealing",&workStealing);
+  if (workStealing>=0)
+    {
+    this->SetUseWorkStealing(workStealing);
+    }
+
+  int numberOfThreads=-1;
+  GetOptionalAttribute<int,1>(elem,"number_of_threads",&numberOfThreads);
+  if (numberOfThreads>0)
+    {
+    this->SetNumberOfThreads(numberOfThreads);
+    }
+
   int masterBlockSize=-1;
   GetOptionalAttribute<int,1>(elem,"master_block_size",&masterBlockSize);
   if (masterBlockSize>=0)
@@ -294,6 +651,8 @@ int vtkSQFieldTracer::Initialize(vtkPVXMLElement *root)
       << "#   nullThreshold=" << this->GetNullThreshold() << "\n"
       << "#   forwardOnly=" << this->GetForwardOnly() << "\n"
       << "#   dynamicScheduler=" << this->GetUseDynamicScheduler() << "\n"
+      << "#   workStealing=" << this->GetUseWorkStealing() << "\n"
+      << "#   numberOfThreads=" << this->GetNumberOfThreads() << "\n"
       << "#   masterBlockSize=" << this->GetMasterBlockSize() << "\n"
       << "#   workerBlockSize=" << this->GetWorkerBlockSize() << "\n"
       << "#   squeezeColorMap=" << this->GetSqueezeColorMap() << "\n";
@@ -644,6 +1003,12 @@ int vtkSQFieldTracer::RequestData(
   (void)inputVector;
   (void)outputVector;
   #else
+  if (!this->Integrator)
+    {
+    vtkErrorMacro("Integrator type has not been set.");
+    return 1;
+    }
+
   vtkInformation *info;
 
   /// Reader
@@ -674,10 +1039,6 @@ int vtkSQFieldTracer::RequestData(
   oocr->ActivateArray(fieldName);
   oocr->SetCommunicator(this->UseCommWorld?MPI_COMM_WORLD:MPI_COMM_SELF);
   oocr->Open();
-  // We provide the integrator a pointer to a cache. The integrator
-  // uses this as it sees fit to reduce the number of reads. If its
-  // not null after the integrator returns we have to delete.
-  vtkDataSet *oocrCache=0;
 
   // the bounds (problem domain) of the data should be provided by the
   // meta reader.
@@ -858,25 +1219,57 @@ int vtkSQFieldTracer::RequestData(
     }
   tcon->InitializeColorMapper();
 
+  /// Threads
+  // Neighborhoods are read by whichever thread needs them, one at
+  // a time, which requires at least serialized MPI threading.
+  int nThreads=this->NumberOfThreads;
+  if (nThreads>1)
+    {
+    int threadLevel=MPI_THREAD_SINGLE;
+    MPI_Query_thread(&threadLevel);
+    if (threadLevel<MPI_THREAD_SERIALIZED)
+      {
+      vtkWarningMacro(
+        << "Integrating with " << nThreads << " threads requires "
+        << "MPI_THREAD_SERIALIZED. Using 1 thread.");
+      nThreads=1;
+      }
+    }
+  FieldTraceWorkerPool *workers
+    = new FieldTraceWorkerPool(this,oocr.GetPointer(),fieldName,tcon,nThreads);
+
   /// Work loops
   if (this->UseDynamicScheduler)
     {
-    #if vtkSQFieldTracerDEBUG>1
-    pCerr() << "Starting dynamic scheduler." << std::endl;
-    #endif
     // This requires all process to have all the seed source data
     // present.
     vtkIdType nSourceCells
       = (sourceGen!=0?sourceGen->GetNumberOfCells():source->GetNumberOfCells());
 
-    this->IntegrateDynamic(
-          this->WorldRank,
-          this->WorldSize,
-          nSourceCells,
-          fieldName,
-          oocr.GetPointer(),
-          oocrCache,
-          traceData);
+    if (this->UseWorkStealing)
+      {
+      #if vtkSQFieldTracerDEBUG>1
+      pCerr() << "Starting work stealing scheduler." << std::endl;
+      #endif
+      this->IntegrateWorkStealing(
+            this->WorldRank,
+            this->WorldSize,
+            nSourceCells,
+            traceData,
+            workers);
+      }
+    else
+      {
+      #if vtkSQFieldTracerDEBUG>1
+      pCerr() << "Starting dynamic scheduler." << std::endl;
+      #endif
+      this->IntegrateDynamic(
+            this->WorldRank,
+            this->WorldSize,
+            nSourceCells,
+            traceData,
+            workers);
+      }
     }
   else
     {
@@ -887,12 +1280,12 @@ int vtkSQFieldTracer::RequestData(
     // process has a unique portion of the work.
     this->IntegrateStatic(
           source->GetNumberOfCells(),
-          fieldName,
-          oocr.GetPointer(),
-          oocrCache,
-          traceData);
+          traceData,
+          workers);
     }
 
+  delete workers;
+
   /// Remove segments where a periodic bc was applied.
   if ( (this->Mode==MODE_STREAM)
     && this->CullPeriodicTransitions
@@ -925,10 +1318,8 @@ int vtkSQFieldTracer::RequestData(
 inline
 int vtkSQFieldTracer::IntegrateStatic(
       vtkIdType nCells,
-      const char *fieldName,
-      vtkSQOOCReader *oocr,
-      vtkDataSet *&oocrCache,
-      FieldTraceData *traceData)
+      FieldTraceData *traceData,
+      FieldTraceWorkerPool *workers)
 {
   #if defined vtkSQFieldTracerTIME
   vtkSQLog *log=vtkSQLog::GetGlobalInstance();
@@ -943,9 +1334,7 @@ int vtkSQFieldTracer::IntegrateStatic(
   int ok=this->IntegrateBlock(
             &sourceIds,
             traceData,
-            fieldName,
-            oocr,
-            oocrCache);
+            workers);
 
   #if defined vtkSQFieldTracerTIME
   log->EndEvent("vtkSQFieldTracer::IntegrateStatic");
@@ -959,10 +1348,8 @@ int vtkSQFieldTracer::IntegrateDynamic(
       int procId,
       int nProcs,
       vtkIdType nCells,
-      const char *fieldName,
-      vtkSQOOCReader *oocr,
-      vtkDataSet *&oocrCache,
-      FieldTraceData *traceData)
+      FieldTraceData *traceData,
+      FieldTraceWorkerPool *workers)
 {
   #if defined vtkSQFieldTracerTIME
   vtkSQLog *log=vtkSQLog::GetGlobalInstance();
@@ -973,10 +1360,8 @@ int vtkSQFieldTracer::IntegrateDynamic(
   (void)procId;
   (void)nProcs;
   (void)nCells;
-  (void)fieldName;
-  (void)oocr;
-  (void)oocrCache;
   (void)traceData;
+  (void)workers;
   #else
   const int masterProcId=(nProcs>1?1:0); // NOTE: proc 0 is busy with PV overhead.
   const int BLOCK_REQ=12345;
@@ -1057,9 +1442,7 @@ int vtkSQFieldTracer::IntegrateDynamic(
           this->IntegrateBlock(
                   &sourceIds,
                   traceData,
-                  fieldName,
-                  oocr,
-                  oocrCache);
+                  workers);
 
           double prog=(double)sourceIds.last()/(double)nCells;
           this->UpdateProgress(prog);
@@ -1109,9 +1492,7 @@ int vtkSQFieldTracer::IntegrateDynamic(
       this->IntegrateBlock(
                 &sourceIds,
                 traceData,
-                fieldName,
-                oocr,
-                oocrCache);
+                workers);
 
       double prog=(double)sourceIds.last()/(double)nCells;
       this->UpdateProgress(prog);
@@ -1126,14 +1507,213 @@ int vtkSQFieldTracer::IntegrateDynamic(
   return 1;
 }
 
+//-----------------------------------------------------------------------------
+int vtkSQFieldTracer::IntegrateWorkStealing(
+      int procId,
+      int nProcs,
+      vtkIdType nCells,
+      FieldTraceData *traceData,
+      FieldTraceWorkerPool *workers)
+{
+  #if defined vtkSQFieldTracerTIME
+  vtkSQLog *log=vtkSQLog::GetGlobalInstance();
+  log->StartEvent("vtkSQFieldTracer::IntegrateWorkStealing");
+  #endif
+
+  #ifdef SQTK_WITHOUT_MPI
+  (void)procId;
+  (void)nProcs;
+  (void)nCells;
+  (void)traceData;
+  (void)workers;
+  #else
+  const int STEAL_REQ=12346;
+  const int STEAL_REP=12347;
+  const int STEAL_DONE=12348;
+  const int STEAL_TERM=12349;
+
+  int blockSize=std::min(this->WorkerBlockSize,std::max((int)nCells/nProcs,1));
+
+  // Each process starts with an equal share of the seed cells. Work is
+  // taken from the front of the queue and given away from the back.
+  WorkQueue Q(
+        (int)((nCells*procId)/nProcs),
+        (int)((nCells*(procId+1))/nProcs));
+
+  std::vector<int> victims;
+  for (int i=0; i<nProcs; ++i)
+    {
+    if (i!=procId)
+      {
+      victims.push_back(i);
+      }
+    }
+
+  vtkMinimalStandardRandomSequence *rng=vtkMinimalStandardRandomSequence::New();
+  rng->SetSeed(procId+1);
+
+  int nIntegrated=0;
+  int nStealAttempts=0;
+  int nStolen=0;
+  int nGiven=0;
+
+  while (1)
+    {
+    // integrate the local work a block at a time, and answer steal
+    // requests in between.
+    while (1)
+      {
+      ServiceStealRequests(Q,blockSize,STEAL_REQ,STEAL_REP,nGiven);
+
+      IdBlock sourceIds;
+      if (!Q.GetBlock(sourceIds,blockSize))
+        {
+        break;
+        }
+
+      #if vtkSQFieldTracerDEBUG>0
+      pCerr() << procId << " integrating " << sourceIds << std::endl;
+      #endif
+
+      this->IntegrateBlock(
+              &sourceIds,
+              traceData,
+              workers);
+
+      nIntegrated+=(int)sourceIds.size();
+      double prog=std::min(1.0,(double)(nIntegrated*nProcs)/(double)nCells);
+      this->UpdateProgress(prog);
+      }
+
+    // Out of work. Visit the other processes in random order until one
+    // of them hands some over. Requests made of this process are
+    // answered while waiting.
+    for (size_t i=victims.size(); i>1; --i)
+      {
+      size_t j=std::min((size_t)(rng->GetValue()*i),i-1);
+      rng->Next();
+      std::swap(victims[i-1],victims[j]);
+      }
+
+    int stolen=0;
+    size_t nVictims=victims.size();
+    for (size_t i=0; (i<nVictims) && !stolen; ++i)
+      {
+      int victim=victims[i];
+
+      IdBlock sourceIds;
+      MPI_Request req;
+      MPI_Irecv(
+          sourceIds.data(),
+          (int)sourceIds.dataSize(),
+          MPI_UNSIGNED_LONG_LONG,
+          victim,
+          STEAL_REP,
+          MPI_COMM_WORLD,
+          &req);
+
+      MPI_Send(&procId,0,MPI_INT,victim,STEAL_REQ,MPI_COMM_WORLD);
+
+      int replied=0;
+      while (!replied)
+        {
+        ServiceStealRequests(Q,blockSize,STEAL_REQ,STEAL_REP,nGiven);
+        MPI_Test(&req,&replied,MPI_STATUS_IGNORE);
+        }
+      nStealAttempts+=1;
+
+      #if vtkSQFieldTracerDEBUG>0
+      pCerr() << procId << " stole " << sourceIds << " from " << victim << std::endl;
+      #endif
+
+      if (!sourceIds.empty())
+        {
+        Q.SetBlock(sourceIds);
+        nStolen+=1;
+        stolen=1;
+        }
+      }
+
+    // None of the others had work to spare. Work is never created
+    // so there is nothing more to do here.
+    if (!stolen)
+      {
+      break;
+      }
+    }
+  rng->Delete();
+
+  // Process 0 collects a done message from each process, and lets them all
+  // know when all are done. Until then steal requests have to be answered.
+  // All requests have been answered when the last done message arrives,
+  // since a process only sends it after its last request is answered.
+  int nDone=1;
+  if (procId!=0)
+    {
+    MPI_Send(&procId,0,MPI_INT,0,STEAL_DONE,MPI_COMM_WORLD);
+    }
+  int term=0;
+  while (!term)
+    {
+    ServiceStealRequests(Q,blockSize,STEAL_REQ,STEAL_REP,nGiven);
+
+    MPI_Status stat;
+    int buf;
+    if (procId==0)
+      {
+      int pendingDone=0;
+      MPI_Iprobe(MPI_ANY_SOURCE,STEAL_DONE,MPI_COMM_WORLD,&pendingDone,&stat);
+      if (pendingDone)
+        {
+        MPI_Recv(&buf,0,MPI_INT,stat.MPI_SOURCE,STEAL_DONE,MPI_COMM_WORLD,&stat);
+        nDone+=1;
+        }
+      if (nDone==nProcs)
+        {
+        for (int i=1; i<nProcs; ++i)
+          {
+          MPI_Send(&procId,0,MPI_INT,i,STEAL_TERM,MPI_COMM_WORLD);
+          }
+        term=1;
+        }
+      }
+    else
+      {
+      MPI_Iprobe(0,STEAL_TERM,MPI_COMM_WORLD,&term,&stat);
+      if (term)
+        {
+        MPI_Recv(&buf,0,MPI_INT,0,STEAL_TERM,MPI_COMM_WORLD,&stat);
+        }
+      }
+    }
+
+  vtkSQLog *sqlog=vtkSQLog::GetGlobalInstance();
+  if (this->LogLevel || sqlog->GetGlobalLevel())
+    {
+    sqlog->GetBody()
+      << procId
+      << " vtkSQFieldTracer::WorkStealingStats"
+      << " nThreads=" << workers->GetNumberOfThreads()
+      << " nIntegrated=" << nIntegrated
+      << " nStealAttempts=" << nStealAttempts
+      << " nStolen=" << nStolen
+      << " nGiven=" << nGiven
+      << "\n";
+    }
+  #endif
+
+  #if defined vtkSQFieldTracerTIME
+  log->EndEvent("vtkSQFieldTracer::IntegrateWorkStealing");
+  #endif
+
+  return 1;
+}
+
 //-----------------------------------------------------------------------------
 int vtkSQFieldTracer::IntegrateBlock(
       IdBlock *sourceIds,
       FieldTraceData *traceData,
-      const char *fieldName,
-      vtkSQOOCReader *oocr,
-      vtkDataSet *&oocrCache)
-
+      FieldTraceWorkerPool *workers)
 {
   // build the output.
   #if defined vtkSQFieldTracerTIME
@@ -1145,9 +1725,13 @@ int vtkSQFieldTracer::IntegrateBlock(
   log->EndEvent("vtkSQFieldTracer::InsertCells");
   #endif
 
-  TerminationCondition *tcon=traceData->GetTerminationCondition();
+  // the other threads pull lines from the same block while this
+  // thread does, so that progress is only reported from here.
+  workers->Start(traceData,nLines);
+  FieldTraceWorker *worker=workers->GetWorker(0);
 
-  for (vtkIdType i=0; i<nLines; ++i) //, prog+=progInc)
+  vtkIdType i=0;
+  while (workers->NextLine(i))
     {
     // progress report for static load balance. the report
     // for dunamic load balance is done once for each block.
@@ -1158,13 +1742,13 @@ int vtkSQFieldTracer::IntegrateBlock(
       }
 
     // trace a stream line
-    FieldLine *line=traceData->GetFieldLine(i);
-    this->IntegrateOne(oocr,oocrCache,fieldName,line,tcon);
+    workers->Integrate(worker,i);
 
     #if vtkSQFieldTracerDEBUG>=0
     cstd::err << ".";
     #endif
     }
+  workers->Wait();
 
   // sync results to output. free resources in preparation
   // for the next pass.
@@ -1184,11 +1768,13 @@ int vtkSQFieldTracer::IntegrateBlock(
 //-----------------------------------------------------------------------------
 void vtkSQFieldTracer::IntegrateOne(
       vtkSQOOCReader *oocR,
-      vtkDataSet *&oocRCache,
+      vtkMutexLock *oocRLock,
       const char *fieldName,
       FieldLine *line,
-      TerminationCondition *tcon)
+      FieldTraceWorker *worker)
 {
+  TerminationCondition *tcon=worker->TCon;
+
   #if defined vtkSQFieldTracerTIME
   vtkSQLog *log=vtkSQLog::GetGlobalInstance();
   log->StartEvent("vtkSQFieldTracer::Integrate");
@@ -1237,8 +1823,7 @@ void vtkSQFieldTracer::IntegrateOne(
     double p2[3]={0.0};                     // integrated point, non-periodic coordinate space.
     double s0[3]={0.0};                     // segment start point
     int bcSurf=0;                           // set when a periodic boundary condition has been applied.
-    static                                  // interpolator
-    vtkInterpolatedVelocityField *interp=0;
+    vtkInterpolatedVelocityField *interp=worker->Interp; // interpolator
     #if vtkSQFieldTracerDEBUG>1
     double minStepTaken=VTK_DOUBLE_MAX;
     double maxStepTaken=VTK_DOUBLE_MIN;
@@ -1265,17 +1850,31 @@ void vtkSQFieldTracer::IntegrateOne(
         log->EndEvent("vtkSQFieldTracer::Integrate");
         log->StartEvent("vtkSQFieldTracer::LoadBlock");
         #endif
-        oocRCache=oocR->ReadNeighborhood(p0,tcon->GetWorkingDomain());
-        if (!oocRCache)
+        // The reader may release the neighborhood held by another thread
+        // from its cache, so take a reference before letting go of the lock.
+        oocRLock->Lock();
+        vtkDataSet *nhood=oocR->ReadNeighborhood(p0,tcon->GetWorkingDomain());
+        if (nhood)
+          {
+          nhood->Register(0);
+          }
+        if (worker->Cache)
+          {
+          worker->Cache->UnRegister(0);
+          }
+        worker->Cache=nhood;
+        oocRLock->Unlock();
+        if (!nhood)
           {
           vtkErrorMacro("Read neighborhood failed.");
           return;
           }
         // Initialize the vector field interpolator.
         interp=vtkInterpolatedVelocityField::New();
-        interp->AddDataSet(oocRCache);
+        interp->AddDataSet(nhood);
         interp->SelectVectors(vtkDataObject::FIELD_ASSOCIATION_POINTS,fieldName);
-        this->Integrator->SetFunctionSet(interp);
+        worker->Integrator->SetFunctionSet(interp);
+        worker->Interp=interp;
         interp->Delete();
         #if defined vtkSQFieldTracerTIME
         log->EndEvent("vtkSQFieldTracer::LoadBlock");
@@ -1339,7 +1938,7 @@ void vtkSQFieldTracer::IntegrateOne(
       interp->SetNormalizeVector(true);
       double error=0.0;
       double stepTaken=0.0;
-      int iErr=this->Integrator->ComputeNextStep(
+      int iErr=worker->Integrator->ComputeNextStep(
           p0,p1,0,
           stepSize,
           stepTaken,
@@ -26,11 +26,14 @@ class vtkMultiProcessController;
 class vtkInitialValueProblemSolver;
 class vtkPointSet;
 class vtkPVXMLElement;
+class vtkMutexLock;
 //BTX
 class IdBlock;
 class FieldLine;
 class FieldTraceData;
 class TerminationCondition;
+class FieldTraceWorker;
+class FieldTraceWorkerPool;
 //ETX
 
 
@@ -186,6 +189,23 @@ public:
   vtkSetMacro(UseDynamicScheduler,int);
   vtkGetMacro(UseDynamicScheduler,int);
 
+  // Description:
+  // Enable/disable work stealing. This replaces the master-slave scheme
+  // of the dynamic scheduler with a distributed one. Each process starts
+  // with a contiguous range of the seed cells and integrates it in blocks
+  // of WorkerBlockSize. Idle processes take half of the remaining range
+  // of a randomly selected process. Only used when the dynamic scheduler
+  // is enabled, and has the same requirements.
+  vtkSetMacro(UseWorkStealing,int);
+  vtkGetMacro(UseWorkStealing,int);
+
+  // Description:
+  // Set the number of threads each process uses to integrate its
+  // blocks of seed cells. Reads from the out-of-core reader are
+  // serialized.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_INT_MAX);
+  vtkGetMacro(NumberOfThreads,int);
+
   // Description:
   // Set the log level.
   // 0 -- no logging
@@ -214,10 +234,8 @@ private:
   // subset of the work (i.e. seed source cells are statically distributed),
   int IntegrateStatic(
       vtkIdType nCells,
-      const char *fieldName,
-      vtkSQOOCReader *oocr,
-      vtkDataSet *&oocrCache,
-      FieldTraceData *topoMap);
+      FieldTraceData *topoMap,
+      FieldTraceWorkerPool *workers);
 
   // Description:
   // Distribute the work load according to a master-slave self scheduling scheme. All
@@ -227,32 +245,44 @@ private:
       int procId,
       int nProcs,
       vtkIdType nCells,
-      const char *fieldName,
-      vtkSQOOCReader *oocr,
-      vtkDataSet *&oocrCache,
-      FieldTraceData *topoMap);
+      FieldTraceData *topoMap,
+      FieldTraceWorkerPool *workers);
+
+  // Description:
+  // Distribute the work load by randomized work stealing. All seed cells
+  // must be present on all processes. Each process starts with a contiguous
+  // range of cell ids, an idle process takes the back half of the remaining
+  // range of a randomly chosen victim.
+  int IntegrateWorkStealing(
+      int procId,
+      int nProcs,
+      vtkIdType nCells,
+      FieldTraceData *topoMap,
+      FieldTraceWorkerPool *workers);
 
   // Description:
   // Integrate field lines seeded from a block of consecutive cell ids.
+  // The lines are shared out to the threads of the worker pool.
   int IntegrateBlock(
         IdBlock *sourceIds,
         FieldTraceData *topoMap,
-        const char *fieldName,
-        vtkSQOOCReader *oocr,
-        vtkDataSet *&oocrCache);
+        FieldTraceWorkerPool *workers);
 
 
   // Description:
   // Trace one field line from the given seed point, using the given out-of-core
   // reader. As segments are generated they are tested using the stermination
-  // condition and terminated imediately. The last neighborhood read is stored
-  // in the nhood parameter. It is up to the caller to delete this.
+  // condition and terminated imediately. The worker provides the integrator,
+  // termination condition and the last neighborhood read, so that threads
+  // may integrate concurrently. Reads are serialized by oocRLock.
   void IntegrateOne(
         vtkSQOOCReader *oocR,
-        vtkDataSet *&oocRCache,
+        vtkMutexLock *oocRLock,
         const char *fieldName,
         FieldLine *line,
-        TerminationCondition *tcon);
+        FieldTraceWorker *worker);
+
+  friend class FieldTraceWorkerPool;
   //ETX
 
   // Description:
@@ -284,8 +314,10 @@ private:
 
   // Parameter controlling load balance
   int UseDynamicScheduler;
+  int UseWorkStealing;
   int WorkerBlockSize;
   int MasterBlockSize;
+  int NumberOfThreads;
 
   // Parameters controlling integration
   int ForwardOnly;
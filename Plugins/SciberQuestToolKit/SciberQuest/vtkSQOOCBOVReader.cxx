@@ -16,6 +16,9 @@ Copyright 2012 SciberQuest Inc.
 #include "vtkUnstructuredGrid.h"
 #include "vtkCellData.h"
 #include "vtkIntArray.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
+#include "vtkConditionVariable.h"
 
 #include "vtkSQLog.h"
 #include "BOVMetaData.h"
@@ -33,6 +36,10 @@ Copyright 2012 SciberQuest Inc.
 #include <sstream>
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <map>
 
 #ifndef SQTK_WITHOUT_MPI
 #include "SQMPICHWarningSupression.h"
@@ -89,6 +96,334 @@ void WriteBlockUse(
   data->Delete();
 }
 
+// ****************************************************************************
+static
+int PrefetchSupported(MPI_Comm comm)
+{
+  #ifdef SQTK_WITHOUT_MPI
+  (void)comm;
+  return 0;
+  #else
+  // Blocks are read through MPI-IO. The prefetch thread can only
+  // issue reads if MPI is thread safe, and if the files are not
+  // opened collectively.
+  int mpiOk=0;
+  MPI_Initialized(&mpiOk);
+  if (!mpiOk)
+    {
+    return 0;
+    }
+
+  int threadLevel=MPI_THREAD_SINGLE;
+  MPI_Query_thread(&threadLevel);
+  if (threadLevel<MPI_THREAD_MULTIPLE)
+    {
+    return 0;
+    }
+
+  int commSize=0;
+  MPI_Comm_size(comm,&commSize);
+  return commSize==1;
+  #endif
+}
+
+/// Reads blocks ahead of their use on a background thread.
+/**
+Blocks are read in the order they are requested. Read blocks are held
+until claimed by the reader, at most MaxPending blocks are queued, being
+read, or waiting to be claimed. When full the oldest queued request is
+dropped, or else the oldest unclaimed block is discarded, so that the
+most recent predictions are served.
+
+While the prefetcher runs all of the reads, including those the reader
+needs right away, are made by its thread. The MPI file handle and its
+view are never used by two threads at once.
+*/
+class vtkSQOOCBOVPrefetcher
+{
+public:
+  vtkSQOOCBOVPrefetcher(vtkSQOOCBOVReader *reader, int nBlocks, int maxPending);
+  ~vtkSQOOCBOVPrefetcher();
+
+  /**
+  Queue a block for reading. Ignored if it's already queued, being
+  read or waiting to be claimed.
+  */
+  void Request(int blockIndex);
+
+  /**
+  Get the dataset of the given block. If it was not prefetched it's read
+  ahead of the queued requests, and prefetched is cleared. waited is set
+  when the block was being prefetched and the read had to be waited for.
+  Returns 0 if the read failed. The caller owns the returned dataset.
+  */
+  vtkDataSet *Read(int blockIndex, int &prefetched, int &waited);
+
+  /**
+  Stop the thread and release the unclaimed blocks.
+  */
+  void Stop();
+
+  /**
+  Statistics.
+  */
+  long long GetNumberOfReads() const { return this->NumberOfReads; }
+  long long GetNumberOfDiscards() const { return this->NumberOfDiscards; }
+
+private:
+  static VTK_THREAD_RETURN_TYPE Run(void *arg);
+
+  void Discard(int blockIndex);
+
+  enum
+    {
+    IDLE=0,
+    QUEUED=1,
+    READING=2,
+    READY=3
+    };
+
+private:
+  vtkSQOOCBOVReader *Reader;
+  vtkMultiThreader *Threader;
+  int ThreadId;
+  size_t MaxPending;
+
+  // Protects all the members below.
+  vtkMutexLock *Lock;
+  vtkConditionVariable *BlockQueued;
+  vtkConditionVariable *BlockRead;
+  std::vector<int> State;
+  std::deque<int> Queue;
+  std::deque<int> ReadyOrder;
+  std::map<int,vtkDataSet*> Ready;
+  int NumberReading;
+  int Demand;
+  bool Exit;
+  long long NumberOfReads;
+  long long NumberOfDiscards;
+};
+
+//-----------------------------------------------------------------------------
+vtkSQOOCBOVPrefetcher::vtkSQOOCBOVPrefetcher(
+      vtkSQOOCBOVReader *reader,
+      int nBlocks,
+      int maxPending)
+      :
+  Reader(reader),
+  Threader(0),
+  ThreadId(-1),
+  MaxPending(std::max(1,maxPending)),
+  Lock(0),
+  BlockQueued(0),
+  BlockRead(0),
+  State(nBlocks,IDLE),
+  NumberReading(0),
+  Demand(-1),
+  Exit(false),
+  NumberOfReads(0),
+  NumberOfDiscards(0)
+{
+  this->Lock=vtkMutexLock::New();
+  this->BlockQueued=vtkConditionVariable::New();
+  this->BlockRead=vtkConditionVariable::New();
+  this->Threader=vtkMultiThreader::New();
+  this->ThreadId=this->Threader->SpawnThread(vtkSQOOCBOVPrefetcher::Run,this);
+}
+
+//-----------------------------------------------------------------------------
+vtkSQOOCBOVPrefetcher::~vtkSQOOCBOVPrefetcher()
+{
+  this->Stop();
+  this->Threader->Delete();
+  this->Lock->Delete();
+  this->BlockQueued->Delete();
+  this->BlockRead->Delete();
+}
+
+//-----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkSQOOCBOVPrefetcher::Run(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info
+    = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+
+  vtkSQOOCBOVPrefetcher *self
+    = static_cast<vtkSQOOCBOVPrefetcher*>(info->UserData);
+
+  self->Lock->Lock();
+  for (;;)
+    {
+    while (self->Queue.empty() && !self->Exit)
+      {
+      self->BlockQueued->Wait(self->Lock);
+      }
+    if (self->Exit)
+      {
+      break;
+      }
+    int blockIndex=self->Queue.front();
+    self->Queue.pop_front();
+    self->State[blockIndex]=READING;
+    self->NumberReading+=1;
+    self->Lock->Unlock();
+
+    vtkDataSet *data=self->Reader->ReadBlock(blockIndex);
+
+    self->Lock->Lock();
+    self->NumberReading-=1;
+    if (blockIndex!=self->Demand)
+      {
+      self->NumberOfReads+=1;
+      }
+    if (data)
+      {
+      self->State[blockIndex]=READY;
+      self->Ready[blockIndex]=data;
+      self->ReadyOrder.push_back(blockIndex);
+      }
+    else
+      {
+      // let the reader retry, and report the error.
+      self->State[blockIndex]=IDLE;
+      }
+    self->BlockRead->Broadcast();
+    }
+  self->Lock->Unlock();
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSQOOCBOVPrefetcher::Discard(int blockIndex)
+{
+  std::map<int,vtkDataSet*>::iterator it=this->Ready.find(blockIndex);
+  if (it!=this->Ready.end())
+    {
+    it->second->Delete();
+    this->Ready.erase(it);
+    }
+  std::deque<int>::iterator rit
+    = std::find(this->ReadyOrder.begin(),this->ReadyOrder.end(),blockIndex);
+  if (rit!=this->ReadyOrder.end())
+    {
+    this->ReadyOrder.erase(rit);
+    }
+  this->State[blockIndex]=IDLE;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSQOOCBOVPrefetcher::Request(int blockIndex)
+{
+  this->Lock->Lock();
+  if (this->State[blockIndex]!=IDLE)
+    {
+    this->Lock->Unlock();
+    return;
+    }
+
+  size_t nPending=this->Queue.size()+this->Ready.size()+this->NumberReading;
+  if (nPending>=this->MaxPending)
+    {
+    if (!this->Queue.empty())
+      {
+      // drop the oldest prediction
+      this->State[this->Queue.front()]=IDLE;
+      this->Queue.pop_front();
+      }
+    else
+    if (!this->ReadyOrder.empty())
+      {
+      // nobody asked for the oldest prefetched block
+      this->Discard(this->ReadyOrder.front());
+      this->NumberOfDiscards+=1;
+      }
+    else
+      {
+      // every slot is being read
+      this->Lock->Unlock();
+      return;
+      }
+    }
+
+  this->State[blockIndex]=QUEUED;
+  this->Queue.push_back(blockIndex);
+  this->BlockQueued->Signal();
+  this->Lock->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+vtkDataSet *vtkSQOOCBOVPrefetcher::Read(
+      int blockIndex,
+      int &prefetched,
+      int &waited)
+{
+  prefetched=0;
+  waited=0;
+  vtkDataSet *data=0;
+
+  this->Lock->Lock();
+  if (this->State[blockIndex]==QUEUED)
+    {
+    // it's needed now, move it to the head of the queue.
+    std::deque<int>::iterator it
+      = std::find(this->Queue.begin(),this->Queue.end(),blockIndex);
+    this->Queue.erase(it);
+    this->State[blockIndex]=IDLE;
+    }
+  if (this->State[blockIndex]==IDLE)
+    {
+    this->State[blockIndex]=QUEUED;
+    this->Queue.push_front(blockIndex);
+    this->Demand=blockIndex;
+    this->BlockQueued->Signal();
+    }
+  else
+    {
+    prefetched=1;
+    }
+  while ((this->State[blockIndex]==QUEUED)
+    || (this->State[blockIndex]==READING))
+    {
+    waited=prefetched;
+    this->BlockRead->Wait(this->Lock);
+    }
+  if (this->State[blockIndex]==READY)
+    {
+    data=this->Ready[blockIndex];
+    data->Register(0);
+    this->Discard(blockIndex);
+    }
+  this->Demand=-1;
+  this->Lock->Unlock();
+
+  return data;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSQOOCBOVPrefetcher::Stop()
+{
+  if (this->ThreadId<0)
+    {
+    return;
+    }
+
+  this->Lock->Lock();
+  this->Exit=true;
+  this->BlockQueued->Broadcast();
+  this->Lock->Unlock();
+
+  this->Threader->TerminateThread(this->ThreadId);
+  this->ThreadId=-1;
+
+  this->NumberOfDiscards+=this->Ready.size();
+  while (!this->ReadyOrder.empty())
+    {
+    this->Discard(this->ReadyOrder.front());
+    }
+  this->Queue.clear();
+  this->State.assign(this->State.size(),IDLE);
+}
+
 //-----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSQOOCBOVReader);
 
@@ -99,11 +434,21 @@ vtkSQOOCBOVReader::vtkSQOOCBOVReader()
   Image(0),
   BlockAccessTime(0),
   BlockCacheSize(10),
+  BlockCacheRam(0),
+  BlockCacheRamBudget(0),
+  CachedRam(0),
   DomainDecomp(0),
   LRUQueue(0),
   CloseClearsCachedBlocks(1),
   CacheHitCount(0),
   CacheMissCount(0),
+  PrefetchDepth(1),
+  CanPrefetch(-1),
+  Prefetcher(0),
+  PrefetchCount(0),
+  PrefetchHitCount(0),
+  PrefetchWaitCount(0),
+  PrefetchWasteCount(0),
   LogLevel(0)
 {
   this->LRUQueue=new PriorityQueue<unsigned long int>;
@@ -113,6 +458,7 @@ vtkSQOOCBOVReader::vtkSQOOCBOVReader()
 vtkSQOOCBOVReader::~vtkSQOOCBOVReader()
 {
   // this->Close(); expect the user to close
+  this->StopPrefetching();
   this->SetReader(0);
   this->SetDomainDecomp(0);
   delete this->LRUQueue;
@@ -131,7 +477,11 @@ void vtkSQOOCBOVReader::InitializeBlockCache()
 
   int nBlocks=(int)this->DomainDecomp->GetNumberOfBlocks();
 
-  this->LRUQueue->Initialize(this->BlockCacheSize,nBlocks);
+  // the cache is bounded by ram rather than by the number of blocks.
+  this->LRUQueue->Initialize(nBlocks,nBlocks);
+
+  this->BlockCacheRamBudget=this->BlockCacheRam;
+  this->BlockRam.assign(nBlocks,0);
 
   this->CacheHit.assign(nBlocks,0);
   this->CacheMiss.assign(nBlocks,0);
@@ -140,11 +490,18 @@ void vtkSQOOCBOVReader::InitializeBlockCache()
 //-----------------------------------------------------------------------------
 void vtkSQOOCBOVReader::ClearBlockCache()
 {
+  this->StopPrefetching();
+
   this->BlockAccessTime=0;
 
   this->CacheHitCount=0;
   this->CacheMissCount=0;
 
+  this->PrefetchCount=0;
+  this->PrefetchHitCount=0;
+  this->PrefetchWaitCount=0;
+  this->PrefetchWasteCount=0;
+
   while (!this->LRUQueue->Empty())
     {
     CartesianDataBlock *block
@@ -154,13 +511,30 @@ void vtkSQOOCBOVReader::ClearBlockCache()
     }
 
   int nBlocks=(int)this->DomainDecomp->GetNumberOfBlocks();
+  this->CachedRam=0;
+  this->BlockRam.assign(nBlocks,0);
   this->CacheHit.assign(nBlocks,0);
   this->CacheMiss.assign(nBlocks,0);
 }
 
+//-----------------------------------------------------------------------------
+void vtkSQOOCBOVReader::StopPrefetching()
+{
+  if (this->Prefetcher)
+    {
+    this->Prefetcher->Stop();
+    this->PrefetchCount+=this->Prefetcher->GetNumberOfReads();
+    this->PrefetchWasteCount+=this->Prefetcher->GetNumberOfDiscards();
+    delete this->Prefetcher;
+    this->Prefetcher=0;
+    }
+}
+
 //-----------------------------------------------------------------------------
 void vtkSQOOCBOVReader::SetCommunicator(MPI_Comm comm)
 {
+  this->StopPrefetching();
+  this->CanPrefetch=-1;
   this->Reader->SetCommunicator(comm);
 }
 
@@ -168,6 +542,7 @@ void vtkSQOOCBOVReader::SetCommunicator(MPI_Comm comm)
 int vtkSQOOCBOVReader::Open()
 {
   this->ClearBlockCache();
+  this->CanPrefetch=-1;
 
   if (this->Image)
     {
@@ -193,6 +568,9 @@ void vtkSQOOCBOVReader::Close()
   MPI_Comm_rank(MPI_COMM_WORLD,&worldRank);
   #endif
 
+  // fold the prefetcher's statistics in.
+  this->StopPrefetching();
+
   vtkSQLog *log=vtkSQLog::GetGlobalInstance();
   int globalLogLevel=log->GetGlobalLevel();
   if ((this->LogLevel>1) || (globalLogLevel>1))
@@ -260,13 +638,32 @@ void vtkSQOOCBOVReader::Close()
         }
       }
 
+    // a miss served by a prefetched block doesn't stall unless
+    // the read was still in progress.
+    long long stallCount
+      = this->CacheMissCount-this->PrefetchHitCount+this->PrefetchWaitCount;
+
+    double prefetchAccuracy=0.0;
+    if (this->PrefetchCount>0)
+      {
+      prefetchAccuracy=((double)this->PrefetchHitCount)/this->PrefetchCount;
+      }
+
     log->GetBody()
       << worldRank
       << " vtkSQOOCBOVReader::BlockCacheStats"
       << " CacheSize=" << this->BlockCacheSize
+      << " CacheRam=" << this->BlockCacheRamBudget
       << " nUniqueBlocks=" << nUsed
       << " HitCount=" << this->CacheHitCount
       << " MissCount=" << this->CacheMissCount
+      << " StallCount=" << stallCount
+      << " PrefetchDepth=" << (this->CanPrefetch==1?this->PrefetchDepth:0)
+      << " PrefetchCount=" << this->PrefetchCount
+      << " PrefetchHitCount=" << this->PrefetchHitCount
+      << " PrefetchWaitCount=" << this->PrefetchWaitCount
+      << " PrefetchWasteCount=" << this->PrefetchWasteCount
+      << " PrefetchAccuracy=" << prefetchAccuracy
       << "\n";
     }
 
@@ -282,6 +679,200 @@ void vtkSQOOCBOVReader::Close()
     }
 }
 
+//-----------------------------------------------------------------------------
+vtkDataSet *vtkSQOOCBOVReader::ReadBlock(int blockIndex)
+{
+  // configure a new dataset and read with ghost cells. Note: working
+  // domain is smaller than the bounds of the dataset that is read.
+  CartesianDataBlockIODescriptor *descr
+    = this->DomainDecomp->GetBlockIODescriptor(blockIndex);
+
+  const CartesianExtent &blockExt=descr->GetMemExtent();
+
+  vtkDataSet *data=0;
+  if (this->Reader->DataSetTypeIsImage())
+    {
+    ImageDecomp *idec=dynamic_cast<ImageDecomp*>(this->DomainDecomp);
+    double *X0=idec->GetOrigin();
+    double *dX=idec->GetSpacing();
+
+    int nPoints[3];
+    blockExt.Size(nPoints);
+
+    double blockX0[3];
+    blockExt.GetLowerBound(X0,dX,blockX0);
+
+    vtkImageData *idata=vtkImageData::New();
+    idata->SetDimensions(nPoints);
+    idata->SetOrigin(blockX0);
+    idata->SetSpacing(dX);
+
+    data=idata;
+    }
+  else
+  if (this->Reader->DataSetTypeIsRectilinear())
+    {
+    RectilinearDecomp *rdec=dynamic_cast<RectilinearDecomp*>(this->DomainDecomp);
+
+    int nPoints[3];
+    blockExt.Size(nPoints);
+
+    vtkRectilinearGrid *rdata=vtkRectilinearGrid::New();
+    rdata->SetExtent(const_cast<int*>(blockExt.GetData()));
+
+    vtkFloatArray *fa;
+    fa=vtkFloatArray::New();
+    fa->SetArray(rdec->SubsetCoordinate(0,blockExt),nPoints[0],0);
+    rdata->SetXCoordinates(fa);
+    fa->Delete();
+
+    fa=vtkFloatArray::New();
+    fa->SetArray(rdec->SubsetCoordinate(1,blockExt),nPoints[1],0);
+    rdata->SetYCoordinates(fa);
+    fa->Delete();
+
+    fa=vtkFloatArray::New();
+    fa->SetArray(rdec->SubsetCoordinate(2,blockExt),nPoints[2],0);
+    rdata->SetZCoordinates(fa);
+    fa->Delete();
+
+    data=rdata;
+    }
+  else
+  if (this->Reader->DataSetTypeIsStructured())
+    {
+    vtkErrorMacro("Path for vtkSturcturedData not implemented.");
+    return 0;
+    }
+  else
+    {
+    vtkErrorMacro("Unsupported dataset type \"" << this->Reader->GetDataSetType() << "\".");
+    return 0;
+    }
+
+  int ok=this->Reader->ReadTimeStep(this->Image,descr,data,(vtkAlgorithm*)0);
+  if (!ok)
+    {
+    data->Delete();
+    return 0;
+    }
+
+  return data;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSQOOCBOVReader::CacheBlock(CartesianDataBlock *block, vtkDataSet *data)
+{
+  unsigned long long blockRam=1024ull*data->GetActualMemorySize();
+
+  // with no explicit budget hold BlockCacheSize blocks like this one.
+  if (this->BlockCacheRamBudget==0)
+    {
+    this->BlockCacheRamBudget=this->BlockCacheSize*blockRam;
+    }
+
+  // remove the least recently used blocks and delete their datasets
+  // until the new one fits.
+  while (!this->LRUQueue->Empty()
+    && ((this->CachedRam+blockRam)>this->BlockCacheRamBudget))
+    {
+    int lruIndex=this->LRUQueue->Pop();
+    CartesianDataBlock *lruBlock=this->DomainDecomp->GetBlock(lruIndex);
+
+    lruBlock->SetData(0);
+    this->CachedRam-=this->BlockRam[lruIndex];
+    this->BlockRam[lruIndex]=0;
+
+    #if vtkSQOOCBOVReaderDEBUG>1
+    std::cerr << "\tRemoved " << Tuple<int>(lruBlock->GetId(),4);
+    #endif
+    }
+
+  #if vtkSQOOCBOVReaderDEBUG>1
+  std::cerr << "\tInserted " << Tuple<int>(block->GetId(),4) << std::endl;
+  #endif
+
+  // cache the newly read dataset, and insert this block into
+  // the lru queue.
+  block->SetData(data);
+  data->Delete();
+  this->BlockRam[block->GetIndex()]=blockRam;
+  this->CachedRam+=blockRam;
+  this->LRUQueue->Push(block->GetIndex(),++this->BlockAccessTime);
+}
+
+//-----------------------------------------------------------------------------
+void vtkSQOOCBOVReader::PrefetchNeighbors(
+      CartesianDataBlock *block,
+      const double pt[3])
+{
+  if (this->PrefetchDepth<1)
+    {
+    return;
+    }
+
+  if (this->CanPrefetch<0)
+    {
+    this->CanPrefetch
+      = (this->Reader->DataSetTypeIsImage()
+      || this->Reader->DataSetTypeIsRectilinear())
+      && PrefetchSupported(this->Reader->GetCommunicator());
+    }
+
+  if (!this->CanPrefetch)
+    {
+    return;
+    }
+
+  if (!this->Prefetcher)
+    {
+    this->Prefetcher=new vtkSQOOCBOVPrefetcher(
+          this,
+          (int)this->DomainDecomp->GetNumberOfBlocks(),
+          2*this->PrefetchDepth);
+    }
+
+  // A particle enters a block near the point it's requested at. Predict
+  // that it leaves through the opposite side, along the line from that
+  // point through the block center. Block k along that line is centered
+  // about center+2k(center-pt).
+  const CartesianBounds &bounds=block->GetBounds();
+  double center[3];
+  double dir[3];
+  int moving=0;
+  for (int q=0; q<3; ++q)
+    {
+    center[q]=0.5*(bounds[2*q]+bounds[2*q+1]);
+    dir[q]=center[q]-pt[q];
+    moving|=(fabs(dir[q])>0.01*(bounds[2*q+1]-bounds[2*q]));
+    }
+  if (!moving)
+    {
+    return;
+    }
+
+  for (int k=1; k<=this->PrefetchDepth; ++k)
+    {
+    double nextPt[3];
+    for (int q=0; q<3; ++q)
+      {
+      nextPt[q]=center[q]+2.0*k*dir[q];
+      }
+
+    CartesianDataBlock *next=this->DomainDecomp->GetBlock(nextPt);
+    if (next==0)
+      {
+      // left the domain
+      break;
+      }
+
+    if ((next!=block) && !next->GetData())
+      {
+      this->Prefetcher->Request(next->GetIndex());
+      }
+    }
+}
+
 //-----------------------------------------------------------------------------
 vtkDataSet *vtkSQOOCBOVReader::ReadNeighborhood(
     const double pt[3],
@@ -322,8 +913,6 @@ vtkDataSet *vtkSQOOCBOVReader::ReadNeighborhood(
     // The data is locally cached. Update the LRU queue with the block's
     // new access time, and return the cached dataset.
     this->LRUQueue->Update(block->GetIndex(),++this->BlockAccessTime);
-
-    return data;
     }
   else
     {
@@ -334,110 +923,40 @@ vtkDataSet *vtkSQOOCBOVReader::ReadNeighborhood(
     this->CacheMissCount+=1;
     this->CacheMiss[block->GetIndex()]+=1;
 
-    // The data is not cached. If the cache is full then remove
-    // the least recently used block and delete it's dataset. Insert
-    // the requested block into the cache, load and return it's
-    // associated dataset.
-    if ((this->BlockCacheSize>0) && this->LRUQueue->Full())
-      {
-      // get the oldest cahched block and delete it's associated data.
-      CartesianDataBlock *lruBlock
-        = this->DomainDecomp->GetBlock(this->LRUQueue->Pop());
-
-      lruBlock->SetData(0);
-
-      #if vtkSQOOCBOVReaderDEBUG>1
-      std::cerr << "\tRemoved " << Tuple<int>(lruBlock->GetId(),4);
-      #endif
-      }
-
-    // configure a new dataset and read with ghost cells. Note: working
-    // domain is smaller than the bounds of the dataset that is read.
-    CartesianDataBlockIODescriptor *descr
-      = this->DomainDecomp->GetBlockIODescriptor(block->GetIndex());
-
-    const CartesianExtent &blockExt=descr->GetMemExtent();
-
-    if (this->Reader->DataSetTypeIsImage())
-      {
-      ImageDecomp *idec=dynamic_cast<ImageDecomp*>(this->DomainDecomp);
-      double *X0=idec->GetOrigin();
-      double *dX=idec->GetSpacing();
-
-      int nPoints[3];
-      blockExt.Size(nPoints);
-
-      double blockX0[3];
-      blockExt.GetLowerBound(X0,dX,blockX0);
-
-      vtkImageData *idata=vtkImageData::New();
-      idata->SetDimensions(nPoints);
-      idata->SetOrigin(blockX0);
-      idata->SetSpacing(dX);
-
-      data=idata;
-      }
-    else
-    if (this->Reader->DataSetTypeIsRectilinear())
+    // The data is not cached. It may have been read ahead by the
+    // prefetcher, otherwise read it now. When prefetching, only the
+    // prefetch thread reads.
+    if (this->Prefetcher)
       {
-      RectilinearDecomp *rdec=dynamic_cast<RectilinearDecomp*>(this->DomainDecomp);
-
-      int nPoints[3];
-      blockExt.Size(nPoints);
-
-      vtkRectilinearGrid *rdata=vtkRectilinearGrid::New();
-      rdata->SetExtent(const_cast<int*>(blockExt.GetData()));
-
-      vtkFloatArray *fa;
-      fa=vtkFloatArray::New();
-      fa->SetArray(rdec->SubsetCoordinate(0,blockExt),nPoints[0],0);
-      rdata->SetXCoordinates(fa);
-      fa->Delete();
-
-      fa=vtkFloatArray::New();
-      fa->SetArray(rdec->SubsetCoordinate(1,blockExt),nPoints[1],0);
-      rdata->SetYCoordinates(fa);
-      fa->Delete();
-
-      fa=vtkFloatArray::New();
-      fa->SetArray(rdec->SubsetCoordinate(2,blockExt),nPoints[2],0);
-      rdata->SetZCoordinates(fa);
-      fa->Delete();
+      int prefetched=0;
+      int waited=0;
+      data=this->Prefetcher->Read(block->GetIndex(),prefetched,waited);
+      if (data && prefetched)
+        {
+        #if vtkSQOOCBOVReaderDEBUG>1
+        std::cerr << "\tPrefetched";
+        #endif
 
-      data=rdata;
-      }
-    else
-    if (this->Reader->DataSetTypeIsStructured())
-      {
-      vtkErrorMacro("Path for vtkSturcturedData not implemented.");
-      return 0;
+        this->PrefetchHitCount+=1;
+        this->PrefetchWaitCount+=waited;
+        }
       }
     else
       {
-      vtkErrorMacro("Unsupported dataset type \"" << this->Reader->GetDataSetType() << "\".");
-      return 0;
+      data=this->ReadBlock(block->GetIndex());
       }
 
-    int ok=this->Reader->ReadTimeStep(this->Image,descr,data,(vtkAlgorithm*)0);
-    if (!ok)
+    if (!data)
       {
-      data->Delete();
       vtkErrorMacro("Read failed.");
       return 0;
       }
 
-    // cache the dataset
-    if (this->BlockCacheSize>0)
+    // cache the dataset, the least recently used blocks are removed
+    // to make room for it.
+    if ((this->BlockCacheRam>0) || (this->BlockCacheSize>0))
       {
-      #if vtkSQOOCBOVReaderDEBUG>1
-      std::cerr << "\tInserted " << Tuple<int>(block->GetId(),4) << std::endl;
-      #endif
-
-      // cache the newly read dataset, and insert this block into
-      // the lru queue.
-      block->SetData(data);
-      data->Delete();
-      this->LRUQueue->Push(block->GetIndex(),++this->BlockAccessTime);
+      this->CacheBlock(block,data);
       }
 
     #if vtkSQOOCBOVReaderDEBUG>2
@@ -452,24 +971,30 @@ vtkDataSet *vtkSQOOCBOVReader::ReadNeighborhood(
     #endif
     }
 
+  // Keep the prefetcher ahead of the integration.
+  this->PrefetchNeighbors(block,pt);
+
   return data;
 }
 
 //-----------------------------------------------------------------------------
 void vtkSQOOCBOVReader::ActivateArray(const char *name)
 {
+  this->StopPrefetching();
   this->Reader->GetMetaData()->ActivateArray(name);
 }
 
 //-----------------------------------------------------------------------------
 void vtkSQOOCBOVReader::DeActivateArray(const char *name)
 {
+  this->StopPrefetching();
   this->Reader->GetMetaData()->DeactivateArray(name);
 }
 
 //-----------------------------------------------------------------------------
 void vtkSQOOCBOVReader::DeActivateAllArrays()
 {
+  this->StopPrefetching();
   size_t nArray=this->Reader->GetMetaData()->GetNumberOfArrays();
   for (size_t i=0; i<nArray; ++i)
     {
@@ -29,6 +29,7 @@ class BOVTimeStepImage;
 class CartesianDecomp;
 class CartesianDataBlock;
 template<typename T> class PriorityQueue;
+class vtkSQOOCBOVPrefetcher;
 
 /// Implementation for Brick-Of-Values (BOV) Out-Of-Core (OOC) file access.
 /**
@@ -61,14 +62,37 @@ public:
   */
   SetRefCountedPointer(DomainDecomp,CartesianDecomp);
 
+  /**
+  Set the amount of RAM (in bytes) the block cache may use during
+  out-of-core operation. When a newly read block would exceed it the
+  least recently used blocks are released. If 0 the budget is set to
+  BlockCacheSize times the size of the first block read.
+  */
+  vtkSetMacro(BlockCacheRam,unsigned long long);
+  vtkGetMacro(BlockCacheRam,unsigned long long);
+
   /**
   Set the number of block to cache during out-of-core operation.
+  Only used to size the cache when BlockCacheRam is not set.
   Setting the cache size greater than the number of blocks in the
   decomposition results in in-core operation, with multiple reads.
   */
   vtkSetMacro(BlockCacheSize,int);
   vtkGetMacro(BlockCacheSize,int);
 
+  /**
+  Set the number of blocks to read ahead on a background thread. When
+  a block is requested the blocks following it along the predicted
+  direction of travel (from the requested point through the block
+  center) are prefetched. 0 disables prefetching. Prefetching is only
+  done when MPI provides MPI_THREAD_MULTIPLE and the reader's
+  communicator has a single process, since reads are made through
+  MPI-IO. Up to 2*PrefetchDepth prefetched blocks are held on top
+  of the cache.
+  */
+  vtkSetMacro(PrefetchDepth,int);
+  vtkGetMacro(PrefetchDepth,int);
+
   /**
   After the set'ing of a domain and cahche size the cache must
   be initialized prior to any attempt to read data.
@@ -140,11 +164,42 @@ private:
   vtkSQOOCBOVReader(const vtkSQOOCBOVReader&); // Not implemented
   void operator=(const vtkSQOOCBOVReader&); // Not implemented
 
+  /**
+  Allocate a dataset for the given block and read it. Returns 0 if
+  the read fails. While prefetching it's only called from the prefetch
+  thread, otherwise from the caller's thread.
+  */
+  vtkDataSet *ReadBlock(int blockIndex);
+
+  /**
+  Insert a newly read block into the cache, releasing least recently
+  used blocks to stay within the ram budget.
+  */
+  void CacheBlock(CartesianDataBlock *block, vtkDataSet *data);
+
+  /**
+  Queue the blocks that follow the given block along the direction
+  from pt through its center for prefetching.
+  */
+  void PrefetchNeighbors(CartesianDataBlock *block, const double pt[3]);
+
+  /**
+  Stop the prefetch thread, discarding any prefetched block. It is
+  restarted on the next read.
+  */
+  void StopPrefetching();
+
+  friend class vtkSQOOCBOVPrefetcher;
+
 private:
   BOVReader *Reader;                            // reader
   BOVTimeStepImage *Image;                      // file handle
   unsigned long int BlockAccessTime;            // lru access time
   int BlockCacheSize;                           // number of block to keep in memory
+  unsigned long long BlockCacheRam;             // ram the cached blocks may use
+  unsigned long long BlockCacheRamBudget;       // effective ram budget
+  unsigned long long CachedRam;                 // ram used by the cached blocks
+  std::vector<unsigned long long> BlockRam;     // ram used by each cached block
   CartesianDecomp *DomainDecomp;                // domain decomposition
   PriorityQueue<unsigned long int> *LRUQueue;   // least-recently-used block queue
   int CloseClearsCachedBlocks;                  // controls cache flush on close
@@ -154,6 +209,14 @@ private:
   long long CacheHitCount;                      // track block cache hits
   long long CacheMissCount;                     // track block cache misses
 
+  int PrefetchDepth;                            // number of blocks to read ahead
+  int CanPrefetch;                              // -1 until checked, then 1 if prefetching is possible
+  vtkSQOOCBOVPrefetcher *Prefetcher;            // background reader
+  long long PrefetchCount;                      // blocks read by the prefetcher
+  long long PrefetchHitCount;                   // misses served by a prefetched block
+  long long PrefetchWaitCount;                  // misses that waited on a prefetch in progress
+  long long PrefetchWasteCount;                 // prefetched blocks discarded unused
+
   int LogLevel;                                 // enable logging
 };
 
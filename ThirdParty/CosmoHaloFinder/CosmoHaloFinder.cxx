@@ -49,7 +49,11 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <algorithm>
 
 #include "CosmoHaloFinder.h"
+#include "ChainingMesh.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 
 #include <sys/time.h>
@@ -63,6 +67,7 @@ CosmoHaloFinder::CosmoHaloFinder()
 {
 
   nmin = 1;
+  nthreads = 1;
 }
 
 /****************************************************************************/
@@ -70,6 +75,16 @@ CosmoHaloFinder::~CosmoHaloFinder()
 {
 }
 
+/****************************************************************************/
+bool CosmoHaloFinder::isThreaded()
+{
+#ifdef _OPENMP
+  return true;
+#else
+  return false;
+#endif
+}
+
 /****************************************************************************/
 void CosmoHaloFinder::Execute()
 {
@@ -290,6 +305,15 @@ void CosmoHaloFinder::Writing()
 /****************************************************************************/
 void CosmoHaloFinder::Finding()
 {
+  //
+  // The chaining mesh only reproduces the k-d tree halos when any single
+  // friend links two particles, and it does not wrap the periodic box
+  //
+  if (nthreads > 1 && nmin < 2 && !periodic && npart > 1) {
+    ChainingMeshFOF();
+    return;
+  }
+
   //
   // REORDER particles based on spatial locality
   //
@@ -363,6 +387,179 @@ void CosmoHaloFinder::Finding()
   return;
 }
 
+/****************************************************************************/
+//
+// Root of the set holding particle i, halving the path on the way up.
+// Sets are always joined under their lowest particle, so the root is the
+// halo tag the k-d tree would give.
+//
+static inline int FindRoot(int* parent, int i)
+{
+  while (parent[i] != i) {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
+}
+
+/****************************************************************************/
+void CosmoHaloFinder::ChainingMeshFOF()
+{
+#ifdef DEBUG
+  timeval tim;
+  gettimeofday(&tim, NULL);
+  double t1=tim.tv_sec+(tim.tv_usec/1000000.0);
+#endif
+
+  //
+  // BUCKET particles in a chaining mesh no finer than the linking length
+  //
+  POSVEL_T minLoc[numDataDims], maxLoc[numDataDims];
+  for (int dim = 0; dim < numDataDims; dim++) {
+    minLoc[dim] = data[dim][0];
+    maxLoc[dim] = data[dim][0];
+    for (int i = 1; i < npart; i++) {
+      minLoc[dim] = min(minLoc[dim], data[dim][i]);
+      maxLoc[dim] = max(maxLoc[dim], data[dim][i]);
+    }
+  }
+
+  // Buckets as small as the linking length keep the pairs tested in dense
+  // halos down, but limit the mesh to a few buckets per particle
+  double volume = 1.0;
+  for (int dim = 0; dim < numDataDims; dim++)
+    volume *= max((double)(maxLoc[dim] - minLoc[dim]), (double)bb);
+  POSVEL_T chainSize = max((POSVEL_T)pow(0.25 * volume / npart, 1.0 / 3.0), bb);
+
+  ChainingMesh* chain = new ChainingMesh(minLoc, maxLoc, chainSize, npart,
+                                         data[dataX], data[dataY], data[dataZ]);
+
+  int nlayer = chain->getMeshSize(0);
+  int nslab = min(nlayer, 4 * nthreads);
+  vector<int> slabStart(nslab + 1);
+  for (int s = 0; s <= nslab; s++)
+    slabStart[s] = (int)(((long)s * nlayer) / nslab);
+
+  vector<int> parent(npart);
+  for (int i = 0; i < npart; i++)
+    parent[i] = i;
+
+#ifdef DEBUG
+  gettimeofday(&tim, NULL);
+  double t2=tim.tv_sec+(tim.tv_usec/1000000.0);
+  printf("chaining mesh... %.2lfs\n", t2-t1);
+  gettimeofday(&tim, NULL);
+  t1=tim.tv_sec+(tim.tv_usec/1000000.0);
+#endif
+
+  //
+  // LINK friends within each slab of the mesh, a slab per thread
+  //
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+#endif
+  for (int s = 0; s < nslab; s++)
+    LinkBuckets(chain, &parent[0], slabStart[s], slabStart[s+1],
+                slabStart[s], slabStart[s+1]);
+
+  //
+  // LINK friends across the slab boundaries, pairing neighboring groups
+  // of slabs in each round so that no two threads share a set
+  //
+  for (int stride = 1; stride < nslab; stride *= 2) {
+    int nboundary = (nslab - stride + 2 * stride - 1) / (2 * stride);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+#endif
+    for (int b = 0; b < nboundary; b++) {
+      int layer = slabStart[(2 * b + 1) * stride];
+      LinkBuckets(chain, &parent[0], layer - 1, layer, layer, layer + 1);
+    }
+  }
+
+  delete chain;
+
+#ifdef DEBUG
+  gettimeofday(&tim, NULL);
+  t2=tim.tv_sec+(tim.tv_usec/1000000.0);
+  printf("link... %.2lfs\n", t2-t1);
+#endif
+
+  //
+  // TAG each particle with its root and chain the halo lists in order
+  //
+  for (int i = 0; i < npart; i++) {
+    ht[i] = (parent[i] == i) ? i : ht[parent[i]];
+    halo[i] = -1;
+    nextp[i] = -1;
+  }
+
+  for (int i = npart - 1; i >= 0; i--) {
+    nextp[i] = halo[ht[i]];
+    halo[ht[i]] = i;
+  }
+
+  return;
+}
+
+/****************************************************************************/
+//
+// Link the friends in the buckets of X layers [first,last) to those in the
+// buckets of X layers [nfirst,nlast).  Each pair of buckets is visited once,
+// from the bucket with the lower mesh index.
+//
+void CosmoHaloFinder::LinkBuckets(
+                        ChainingMesh* chain,
+                        int* parent,
+                        int first, int last,
+                        int nfirst, int nlast)
+{
+  int*** buckets = chain->getBuckets();
+  int* bucketList = chain->getBucketList();
+  int* meshSize = chain->getMeshSize();
+
+  for (int i = first; i < last; i++)
+  for (int j = 0; j < meshSize[1]; j++)
+  for (int k = 0; k < meshSize[2]; k++) {
+    if (buckets[i][j][k] == -1)
+      continue;
+
+    for (int ni = max(i - 1, nfirst); ni <= min(i + 1, nlast - 1); ni++)
+    for (int nj = max(j - 1, 0); nj <= min(j + 1, meshSize[1] - 1); nj++)
+    for (int nk = max(k - 1, 0); nk <= min(k + 1, meshSize[2] - 1); nk++) {
+
+      // visit each pair of buckets from the lower one only
+      if (ni < i || (ni == i && (nj < j || (nj == j && nk < k))))
+        continue;
+
+      bool sameBucket = (ni == i && nj == j && nk == k);
+
+      for (int ii = buckets[i][j][k]; ii != -1; ii = bucketList[ii]) {
+        int jj = sameBucket ? bucketList[ii] : buckets[ni][nj][nk];
+        for (; jj != -1; jj = bucketList[jj]) {
+
+          POSVEL_T xdist = fabs(data[dataX][jj] - data[dataX][ii]);
+          POSVEL_T ydist = fabs(data[dataY][jj] - data[dataY][ii]);
+          POSVEL_T zdist = fabs(data[dataZ][jj] - data[dataZ][ii]);
+
+          if ((xdist<bb) && (ydist<bb) && (zdist<bb)) {
+
+            POSVEL_T dist = xdist*xdist + ydist*ydist + zdist*zdist;
+            if (dist < bb*bb) {
+              int rootI = FindRoot(parent, ii);
+              int rootJ = FindRoot(parent, jj);
+              if (rootI < rootJ)
+                parent[rootJ] = rootI;
+              else if (rootJ < rootI)
+                parent[rootI] = rootJ;
+            }
+          }
+        } // jj-loop
+      } // ii-loop
+    } // neighbor bucket loop
+  } // bucket loop
+}
+
 /****************************************************************************/
 void CosmoHaloFinder::Reorder(
                         vector<int>::iterator first,
@@ -102,6 +102,17 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // particle is constantly altered so that each particle knows what halo it
 // is part of, and that halo tag is the id of the lowest particle in the halo.
 //
+// When more than one thread is requested, and nmin is less than two, the
+// halos are found instead with a union-find over the buckets of a chaining
+// mesh.  The buckets are at least the linking length bb wide so that friends
+// are found in neighboring buckets.  The mesh is cut into slabs on the X axis
+// which are linked concurrently, each thread only touching the particles of
+// its own slab.  The slab boundaries are then linked in rounds, pairing
+// neighboring groups of slabs, so that again no two threads touch the same
+// particles.  Sets are always joined under the particle with the lowest
+// index, which gives the same halo tags as the k-d tree.  The halo lists
+// are in increasing particle order.
+//
 
 #ifndef CosmoHaloFinder_h
 #define CosmoHaloFinder_h
@@ -109,6 +120,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <string>
 #include <vector>
 
+#include "vtkCosmoHaloFinderModule.h"
 #include "Definition.h"
 
 #define numDataDims 3
@@ -120,6 +132,7 @@ using namespace std;
 
 namespace cosmotk {
 
+class ChainingMesh;
 
 /****************************************************************************/
 typedef POSVEL_T* floatptr;
@@ -137,7 +150,7 @@ public:
 
 /****************************************************************************/
 
-class CosmoHaloFinder
+class VTKCOSMOHALOFINDER_EXPORT CosmoHaloFinder
 {
 public:
   // create a finder
@@ -176,6 +189,11 @@ public:
 
   void setNumberOfParticles(int n)      { npart = n; }
   void setMyProc(int r)                 { myProc = r; }
+  void setNumberOfThreads(int n)        { nthreads = n; }
+
+  // True when the library is built with OpenMP, otherwise the chaining
+  // mesh halo finder runs on a single thread
+  static bool isThreaded();
 
   // For standalone serial halo finder
   POSVEL_T* getXLoc()                   { return xx; }
@@ -207,6 +225,7 @@ private:
   // internal state
   int npart, nhalo, nhalopart;
   int myProc;
+  int nthreads;
 
   // data[][] stores xx[], yy[], zz[].
   POSVEL_T *data[numDataDims];
@@ -232,6 +251,10 @@ private:
   // Recurses through the k-d tree merging particles to create halos
   void myFOF(int, int, int);
   void Merge(int, int, int, int, int);
+
+  // Threaded friends-of-friends over the buckets of a chaining mesh
+  void ChainingMeshFOF();
+  void LinkBuckets(ChainingMesh*, int*, int, int, int, int);
 };
 
 } // END cosmotk namespace
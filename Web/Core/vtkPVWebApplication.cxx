@@ -31,6 +31,7 @@
 #include "vtkSmartPointer.h"
 #include "vtkSMContextViewProxy.h"
 #include "vtkSMPropertyHelper.h"
+#include "vtkSMPTools.h"
 #include "vtkSMRenderViewProxy.h"
 #include "vtkSMViewProxy.h"
 #include "vtkTimerLog.h"
@@ -40,8 +41,60 @@
 #include "vtkWebInteractionEvent.h"
 
 #include <assert.h>
+#include <algorithm>
 #include <cmath>
 #include <map>
+#include <vector>
+
+namespace
+{
+  // Computes the FNV-1a hash of each tile of an image. Each call processes
+  // the range of rows of tiles given.
+  class vtkPVWebApplicationTileHasher
+  {
+  public:
+    const unsigned char* Pixels;
+    int Width;
+    int Height;
+    int NumberOfComponents;
+    int TileSize;
+    int NumberOfTileColumns;
+    vtkTypeUInt64* Hashes;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      const vtkTypeUInt64 offsetBasis =
+        (static_cast<vtkTypeUInt64>(0xcbf29ce4) << 32) | 0x84222325;
+      const vtkTypeUInt64 prime = (static_cast<vtkTypeUInt64>(1) << 40) | 0x1b3;
+      const vtkIdType rowLength =
+        static_cast<vtkIdType>(this->Width) * this->NumberOfComponents;
+      for (vtkIdType tileRow = begin; tileRow < end; ++tileRow)
+        {
+        vtkTypeUInt64* hashes = this->Hashes + tileRow * this->NumberOfTileColumns;
+        std::fill(hashes, hashes + this->NumberOfTileColumns, offsetBasis);
+        int yEnd = std::min(this->Height,
+          static_cast<int>(tileRow + 1) * this->TileSize);
+        for (int y = static_cast<int>(tileRow) * this->TileSize; y < yEnd; ++y)
+          {
+          const unsigned char* row = this->Pixels + y * rowLength;
+          for (int tx = 0; tx < this->NumberOfTileColumns; ++tx)
+            {
+            vtkIdType first =
+              static_cast<vtkIdType>(tx) * this->TileSize * this->NumberOfComponents;
+            vtkIdType last = std::min(rowLength,
+              first + static_cast<vtkIdType>(this->TileSize) * this->NumberOfComponents);
+            vtkTypeUInt64 hash = hashes[tx];
+            for (vtkIdType cc = first; cc < last; ++cc)
+              {
+              hash = (hash ^ row[cc]) * prime;
+              }
+            hashes[tx] = hash;
+            }
+          }
+        }
+    }
+  };
+}
 
 class vtkPVWebApplication::vtkInternals
 {
@@ -54,7 +107,70 @@ public:
     bool HasImagesBeingProcessed;
     vtkObject* ViewPointer;
     unsigned long ObserverId;
-    ImageCacheValueType() : NeedsRender(true), HasImagesBeingProcessed(false), ViewPointer(NULL), ObserverId(0) { }
+
+    // Each view has its own encoder so that views don't wait on one another.
+    vtkSmartPointer<vtkDataEncoder> Encoder;
+    // Set while an image pushed to the encoder has not been retrieved yet.
+    bool Pending;
+    double PushTime;
+
+    // Hashes of the tiles of the last image captured.
+    std::vector<vtkTypeUInt64> TileHashes;
+    int TileSize;
+    int ImageSize[2];
+    int NumberOfComponents;
+    int Quality;
+
+    ImageCacheValueType() : NeedsRender(true), HasImagesBeingProcessed(false), ViewPointer(NULL), ObserverId(0),
+      Pending(false), PushTime(0.0), TileSize(0), NumberOfComponents(0), Quality(-1)
+    {
+      this->ImageSize[0] = this->ImageSize[1] = 0;
+    }
+
+    // Hashes the tiles of the image and returns true if the image differs from
+    // the last image given to this method.
+    bool UpdateTileHashes(vtkImageData* image, int tileSize, int quality)
+    {
+      int dims[3];
+      image->GetDimensions(dims);
+      int numComps = image->GetNumberOfScalarComponents();
+      unsigned char* pixels = static_cast<unsigned char*>(image->GetScalarPointer());
+      if (pixels == NULL || image->GetScalarType() != VTK_UNSIGNED_CHAR)
+        {
+        this->TileHashes.clear();
+        return true;
+        }
+
+      vtkPVWebApplicationTileHasher hasher;
+      hasher.Pixels = pixels;
+      hasher.Width = dims[0];
+      hasher.Height = dims[1];
+      hasher.NumberOfComponents = numComps;
+      hasher.TileSize = tileSize;
+      hasher.NumberOfTileColumns = (dims[0] + tileSize - 1) / tileSize;
+      int numTileRows = (dims[1] + tileSize - 1) / tileSize;
+      std::vector<vtkTypeUInt64> hashes(
+        static_cast<size_t>(hasher.NumberOfTileColumns) * numTileRows);
+      if (hashes.empty())
+        {
+        this->TileHashes.clear();
+        return true;
+        }
+      hasher.Hashes = &hashes[0];
+      vtkSMPTools::For(0, numTileRows, hasher);
+
+      bool changed = (this->TileSize != tileSize ||
+        this->ImageSize[0] != dims[0] || this->ImageSize[1] != dims[1] ||
+        this->NumberOfComponents != numComps || this->Quality != quality ||
+        this->TileHashes != hashes);
+      this->TileHashes.swap(hashes);
+      this->TileSize = tileSize;
+      this->ImageSize[0] = dims[0];
+      this->ImageSize[1] = dims[1];
+      this->NumberOfComponents = numComps;
+      this->Quality = quality;
+      return changed;
+    }
 
     void SetListener(vtkObject* view)
     {
@@ -96,7 +212,42 @@ public:
   typedef std::map<void*, unsigned int > ButtonStatesType;
   ButtonStatesType ButtonStates;
 
-  vtkNew<vtkDataEncoder> Encoder;
+  // Encoding statistics.
+  vtkIdType NumberOfEncodedFrames;
+  vtkIdType NumberOfDroppedFrames;
+  vtkIdType NumberOfUnchangedFrames;
+  double LastEncodeLatency;
+  double TotalEncodeLatency;
+
+  vtkInternals()
+    {
+    this->ResetStatistics();
+    }
+
+  void ResetStatistics()
+    {
+    this->NumberOfEncodedFrames = 0;
+    this->NumberOfDroppedFrames = 0;
+    this->NumberOfUnchangedFrames = 0;
+    this->LastEncodeLatency = 0.0;
+    this->TotalEncodeLatency = 0.0;
+    }
+
+  // Fetches the most recent encoded image of the view, if any, and returns
+  // true if it corresponds to the last image pushed to the encoder.
+  bool GetLatestOutput(vtkTypeUInt32 key, ImageCacheValueType& value)
+    {
+    bool latest = value.Encoder->GetLatestOutput(key, value.Data);
+    if (latest && value.Pending)
+      {
+      value.Pending = false;
+      this->LastEncodeLatency = vtkTimerLog::GetUniversalTime() - value.PushTime;
+      this->TotalEncodeLatency += this->LastEncodeLatency;
+      this->NumberOfEncodedFrames++;
+      }
+    value.HasImagesBeingProcessed = !latest;
+    return latest;
+    }
 
   // WebGL related struct
   struct WebGLObjCacheValue
@@ -118,6 +269,7 @@ vtkStandardNewMacro(vtkPVWebApplication);
 vtkPVWebApplication::vtkPVWebApplication():
   ImageEncoding(ENCODING_BASE64),
   ImageCompression(COMPRESSION_JPEG),
+  DeltaTileSize(64),
   Internals(new vtkPVWebApplication::vtkInternals())
 {
 }
@@ -160,45 +312,65 @@ vtkUnsignedCharArray* vtkPVWebApplication::StillRender(vtkSMViewProxy* view, int
 
   vtkInternals::ImageCacheValueType& value = this->Internals->ImageCache[view];
   value.SetListener(view);
+  if (value.Encoder == NULL)
+    {
+    value.Encoder = vtkSmartPointer<vtkDataEncoder>::New();
+    }
+  vtkTypeUInt32 key = view->GetGlobalID();
 
-  if (value.NeedsRender == false &&
-    value.Data != NULL &&
-    view->GetNeedsUpdate() == false)
+  bool needsRender = (value.NeedsRender || view->GetNeedsUpdate());
+  if (value.Data != NULL)
     {
-    //cout <<  "Reusing cache" << endl;
-    bool latest = this->Internals->Encoder->GetLatestOutput(view->GetGlobalID(), value.Data);
-    value.HasImagesBeingProcessed = !latest;
-    return value.Data;
+    bool latest = this->Internals->GetLatestOutput(key, value);
+    if (!latest)
+      {
+      // An image is still being encoded for this view. Don't queue another
+      // one: NeedsRender is left as is so that the state of the view at the
+      // time the encoder is done is captured instead.
+      if (needsRender)
+        {
+        this->Internals->NumberOfDroppedFrames++;
+        }
+      return value.Data;
+      }
+    if (!needsRender)
+      {
+      //cout <<  "Reusing cache" << endl;
+      return value.Data;
+      }
     }
 
   //cout <<  "Regenerating " << endl;
-  //vtkTimerLog::ResetLog();
-  //vtkTimerLog::CleanupLog();
-  //vtkTimerLog::MarkStartEvent("StillRenderToString");
-  //vtkTimerLog::MarkStartEvent("CaptureWindow");
-
-  // TODO: We should add logic to check if a new rendering needs to be done and
-  // then alone do a new rendering otherwise use the cached image.
   vtkImageData* image = view->CaptureWindow(1);
-  //vtkTimerLog::MarkEndEvent("CaptureWindow");
+  value.NeedsRender = false;
+  if (image == NULL)
+    {
+    return value.Data;
+    }
 
-  //vtkTimerLog::MarkEndEvent("StillRenderToString");
-  //vtkTimerLog::DumpLogWithIndents(&cout, 0.0);
+  if (this->DeltaTileSize > 0 &&
+    !value.UpdateTileHashes(image, this->DeltaTileSize, quality) &&
+    value.Data != NULL)
+    {
+    // Nothing changed since the last image, the last encoded image is still
+    // valid.
+    image->Delete();
+    this->Internals->NumberOfUnchangedFrames++;
+    return value.Data;
+    }
 
-  this->Internals->Encoder->PushAndTakeReference(view->GetGlobalID(), image, quality);
+  value.Pending = true;
+  value.PushTime = vtkTimerLog::GetUniversalTime();
+  value.Encoder->PushAndTakeReference(key, image, quality);
   assert(image == NULL);
 
   if (value.Data == NULL)
     {
     // we need to wait till output is processed.
-    //cout << "Flushing" << endl;
-    this->Internals->Encoder->Flush(view->GetGlobalID());
-    //cout << "Done Flushing" << endl;
+    value.Encoder->Flush(key);
     }
 
-  bool latest = this->Internals->Encoder->GetLatestOutput(view->GetGlobalID(), value.Data);
-  value.HasImagesBeingProcessed = !latest;
-  value.NeedsRender = false;
+  this->Internals->GetLatestOutput(key, value);
   return value.Data;
 }
 
@@ -403,10 +575,69 @@ const char* vtkPVWebApplication::GetWebGLBinaryData(
   return NULL;
 }
 
+//----------------------------------------------------------------------------
+int vtkPVWebApplication::GetEncodeQueueDepth()
+{
+  int depth = 0;
+  vtkInternals::ImageCacheType::iterator iter;
+  for (iter = this->Internals->ImageCache.begin();
+    iter != this->Internals->ImageCache.end(); ++iter)
+    {
+    if (iter->second.Pending)
+      {
+      depth++;
+      }
+    }
+  return depth;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPVWebApplication::GetNumberOfEncodedFrames()
+{
+  return this->Internals->NumberOfEncodedFrames;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPVWebApplication::GetNumberOfDroppedFrames()
+{
+  return this->Internals->NumberOfDroppedFrames;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPVWebApplication::GetNumberOfUnchangedFrames()
+{
+  return this->Internals->NumberOfUnchangedFrames;
+}
+
+//----------------------------------------------------------------------------
+double vtkPVWebApplication::GetLastEncodeLatency()
+{
+  return this->Internals->LastEncodeLatency;
+}
+
+//----------------------------------------------------------------------------
+double vtkPVWebApplication::GetAverageEncodeLatency()
+{
+  return this->Internals->NumberOfEncodedFrames > 0?
+    this->Internals->TotalEncodeLatency / this->Internals->NumberOfEncodedFrames : 0.0;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVWebApplication::ResetEncodingStatistics()
+{
+  this->Internals->ResetStatistics();
+}
+
 //----------------------------------------------------------------------------
 void vtkPVWebApplication::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "ImageEncoding: " << this->ImageEncoding << endl;
   os << indent << "ImageCompression: " << this->ImageCompression << endl;
+  os << indent << "DeltaTileSize: " << this->DeltaTileSize << endl;
+  os << indent << "EncodeQueueDepth: " << this->GetEncodeQueueDepth() << endl;
+  os << indent << "NumberOfEncodedFrames: " << this->GetNumberOfEncodedFrames() << endl;
+  os << indent << "NumberOfDroppedFrames: " << this->GetNumberOfDroppedFrames() << endl;
+  os << indent << "NumberOfUnchangedFrames: " << this->GetNumberOfUnchangedFrames() << endl;
+  os << indent << "AverageEncodeLatency: " << this->GetAverageEncodeLatency() << endl;
 }
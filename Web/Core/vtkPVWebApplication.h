@@ -17,6 +17,14 @@
 // vtkPVWebApplication defines the core interface for a ParaViewWeb application.
 // This exposes methods that make it easier to manage views and rendered images
 // from views.
+//
+// Rendered images are encoded asynchronously by an encoder dedicated to each
+// view so that views shown to different clients don't wait on one another.
+// While an image of a view is being encoded, new requests for that view reuse
+// the last encoded image instead of capturing and queueing more images: only
+// the most recent state of the view ends up being encoded. Captured images
+// are also compared tile by tile with the previous image of the view and
+// images identical to it are not encoded nor sent again.
 
 #ifndef __vtkPVWebApplication_h
 #define __vtkPVWebApplication_h
@@ -78,6 +86,28 @@ public:
   // Invalidate view cache
   void InvalidateCache(vtkSMViewProxy* view);
 
+  // Description:
+  // Size (in pixels) of the square tiles captured images are compared by to
+  // detect the images that did not change since the last one. Set to 0 to
+  // disable the comparison. Default is 64.
+  vtkSetClampMacro(DeltaTileSize, int, 0, VTK_INT_MAX);
+  vtkGetMacro(DeltaTileSize, int);
+
+  // Description:
+  // Encoding statistics. EncodeQueueDepth is the number of views with an
+  // image currently being encoded. NumberOfDroppedFrames counts the requests
+  // answered with the previous image because the view was still encoding one,
+  // and NumberOfUnchangedFrames the captured images that were not encoded
+  // because no tile changed. Latencies are in seconds, measured from the time
+  // an image is queued to the time its encoded result is first retrieved.
+  int GetEncodeQueueDepth();
+  vtkIdType GetNumberOfEncodedFrames();
+  vtkIdType GetNumberOfDroppedFrames();
+  vtkIdType GetNumberOfUnchangedFrames();
+  double GetLastEncodeLatency();
+  double GetAverageEncodeLatency();
+  void ResetEncodingStatistics();
+
   // Description:
   // Return the MTime of the last array exported by StillRenderToString.
   vtkGetMacro(LastStillRenderToStringMTime, unsigned long);
@@ -102,6 +132,7 @@ protected:
   int ImageEncoding;
   int ImageCompression;
   unsigned long LastStillRenderToStringMTime;
+  int DeltaTileSize;
 
 private:
   vtkPVWebApplication(const vtkPVWebApplication&); // Not implemented